@@ -35,7 +35,9 @@
 #include "bindings/core/v8/V8Binding.h"
 #include "core/inspector/ScriptArguments.h"
 #include "core/inspector/ScriptCallFrame.h"
+#include "core/inspector/ScriptCallFrameTable.h"
 #include "core/inspector/ScriptCallStack.h"
+#include "core/inspector/V8InspectorIsolateData.h"
 #include "platform/JSONValues.h"
 #include "wtf/text/StringBuilder.h"
 
@@ -45,42 +47,46 @@ namespace blink {
 
 class ExecutionContext;
 
-static ScriptCallFrame toScriptCallFrame(v8::Local<v8::StackFrame> frame)
+static ScriptCallFrameTable::FrameId internFrame(ScriptCallFrameTable& table, v8::Local<v8::StackFrame> frame)
 {
-    StringBuilder stringBuilder;
-    stringBuilder.appendNumber(frame->GetScriptId());
-    String scriptId = stringBuilder.toString();
-    String sourceName;
-    v8::Local<v8::String> sourceNameValue(frame->GetScriptNameOrSourceURL());
-    if (!sourceNameValue.IsEmpty())
-        sourceName = toCoreString(sourceNameValue);
-
+    // Only what identifies the frame is converted for frames that have been
+    // seen before.
+    int scriptId = frame->GetScriptId();
+    int sourceLineNumber = frame->GetLineNumber();
+    int sourceColumn = frame->GetColumn();
     String functionName;
     v8::Local<v8::String> functionNameValue(frame->GetFunctionName());
     if (!functionNameValue.IsEmpty())
         functionName = toCoreString(functionNameValue);
+    if (ScriptCallFrameTable::FrameId id = table.findFrame(scriptId, sourceLineNumber, sourceColumn, functionName))
+        return id;
 
-    int sourceLineNumber = frame->GetLineNumber();
-    int sourceColumn = frame->GetColumn();
-    return ScriptCallFrame(functionName, scriptId, sourceName, sourceLineNumber, sourceColumn);
+    String sourceName;
+    v8::Local<v8::String> sourceNameValue(frame->GetScriptNameOrSourceURL());
+    if (!sourceNameValue.IsEmpty())
+        sourceName = toCoreString(sourceNameValue);
+    return table.addFrame(scriptId, ScriptCallFrame(functionName, String::number(scriptId), sourceName, sourceLineNumber, sourceColumn));
 }
 
-static void toScriptCallFramesVector(v8::Local<v8::StackTrace> stackTrace, Vector<ScriptCallFrame>& scriptCallFrames, size_t maxStackSize, bool emptyStackIsAllowed, v8::Isolate* isolate)
+static ScriptCallFrameTable::NodeId internStackTrace(ScriptCallFrameTable& table, v8::Local<v8::StackTrace> stackTrace, size_t maxStackSize, bool emptyStackIsAllowed, v8::Isolate* isolate)
 {
     ASSERT(isolate->InContext());
     int frameCount = stackTrace->GetFrameCount();
     if (frameCount > static_cast<int>(maxStackSize))
         frameCount = maxStackSize;
-    for (int i = 0; i < frameCount; i++) {
+    ScriptCallFrameTable::NodeId top = ScriptCallFrameTable::emptyStack;
+    // Stacks are interned outermost frame first.
+    for (int i = frameCount - 1; i >= 0; i--) {
         v8::Local<v8::StackFrame> stackFrame = stackTrace->GetFrame(i);
-        scriptCallFrames.append(toScriptCallFrame(stackFrame));
+        top = table.appendFrame(top, internFrame(table, stackFrame));
     }
     if (!frameCount && !emptyStackIsAllowed) {
         // Successfully grabbed stack trace, but there are no frames. It may happen in case
         // when a bound function is called from native code for example.
         // Fallback to setting lineNumber to 0, and source and function name to "undefined".
-        scriptCallFrames.append(ScriptCallFrame());
+        top = table.appendFrame(top, table.internFrame(ScriptCallFrame()));
     }
+    return top;
 }
 
 static PassRefPtrWillBeRawPtr<ScriptCallStack> createScriptCallStack(v8::Isolate* isolate, v8::Local<v8::StackTrace> stackTrace, size_t maxStackSize, bool emptyStackIsAllowed)
@@ -88,10 +94,10 @@ static PassRefPtrWillBeRawPtr<ScriptCallStack> createScriptCallStack(v8::Isolate
     ASSERT(isolate->InContext());
     ASSERT(!stackTrace.IsEmpty());
     v8::HandleScope scope(isolate);
-    Vector<ScriptCallFrame> scriptCallFrames;
-    toScriptCallFramesVector(stackTrace, scriptCallFrames, maxStackSize, emptyStackIsAllowed, isolate);
+    RefPtr<ScriptCallFrameTable> table = V8InspectorIsolateData::from(isolate)->callFrameTable();
+    ScriptCallFrameTable::NodeId top = internStackTrace(*table, stackTrace, maxStackSize, emptyStackIsAllowed, isolate);
     // TODO: link to async call stack
-    return ScriptCallStack::create(scriptCallFrames);
+    return ScriptCallStack::create(table.release(), top);
 }
 
 PassRefPtrWillBeRawPtr<ScriptCallStack> createScriptCallStack(v8::Isolate* isolate, v8::Local<v8::StackTrace> stackTrace, size_t maxStackSize)
@@ -35,7 +35,8 @@
 
 namespace blink {
 
-ScriptRegexp::ScriptRegexp(const String& pattern, TextCaseSensitivity caseSensitivity, MultilineMode multilineMode)
+ScriptRegexp::ScriptRegexp(const String& pattern, TextCaseSensitivity caseSensitivity, MultilineMode multilineMode, GlobalMode globalMode)
+    : m_globalMode(globalMode)
 {
     v8::Isolate* isolate = v8::Isolate::GetCurrent();
     v8::HandleScope handleScope(isolate);
@@ -48,6 +49,8 @@ ScriptRegexp::ScriptRegexp(const String& pattern, TextCaseSensitivity caseSensit
         flags |= v8::RegExp::kIgnoreCase;
     if (multilineMode == MultilineEnabled)
         flags |= v8::RegExp::kMultiline;
+    if (globalMode == GlobalEnabled)
+        flags |= v8::RegExp::kGlobal;
 
     v8::Local<v8::RegExp> regex;
     if (v8::RegExp::New(context, v8String(isolate, pattern), static_cast<v8::RegExp::Flags>(flags)).ToLocal(&regex))
@@ -68,15 +71,39 @@ int ScriptRegexp::match(const String& string, int startFrom, int* matchLength) c
 
     v8::Isolate* isolate = v8::Isolate::GetCurrent();
     v8::HandleScope handleScope(isolate);
+    int matchOffset = exec(isolate, v8String(isolate, string.substring(startFrom)), 0, matchLength);
+    return matchOffset == -1 ? -1 : matchOffset + startFrom;
+}
+
+int ScriptRegexp::matchInPlace(v8::Local<v8::String> subject, int startFrom, int* matchLength) const
+{
+    ASSERT(m_globalMode == GlobalEnabled);
+    if (matchLength)
+        *matchLength = 0;
+
+    if (m_globalMode != GlobalEnabled || m_regex.isEmpty() || subject.IsEmpty() || startFrom > subject->Length())
+        return -1;
+
+    v8::Isolate* isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope handleScope(isolate);
+    return exec(isolate, subject, startFrom, matchLength);
+}
+
+int ScriptRegexp::exec(v8::Isolate* isolate, v8::Local<v8::String> subject, int lastIndex, int* matchLength) const
+{
     v8::Local<v8::Context> context = V8InspectorIsolateData::from(isolate)->ensureScriptRegexpContext();
     v8::Context::Scope contextScope(context);
     v8::TryCatch tryCatch;
 
+    // A global regexp starts at lastIndex, which exec() leaves after the
+    // previous match; other regexps always start at 0.
     v8::Local<v8::RegExp> regex = m_regex.newLocal(isolate);
+    if (m_globalMode == GlobalEnabled && !regex->Set(context, v8AtomicString(isolate, "lastIndex"), v8::Integer::New(isolate, lastIndex)).FromMaybe(false))
+        return -1;
     v8::Local<v8::Value> exec;
     if (!regex->Get(context, v8AtomicString(isolate, "exec")).ToLocal(&exec))
         return -1;
-    v8::Local<v8::Value> argv[] = { v8String(isolate, string.substring(startFrom)) };
+    v8::Local<v8::Value> argv[] = { subject };
     v8::Local<v8::Value> returnValue;
     if (!V8ScriptRunner::callInternalFunction(exec.As<v8::Function>(), regex, WTF_ARRAY_LENGTH(argv), argv, isolate).ToLocal(&returnValue))
         return -1;
@@ -103,7 +130,7 @@ int ScriptRegexp::match(const String& string, int startFrom, int* matchLength) c
         *matchLength = match.As<v8::String>()->Length();
     }
 
-    return matchOffset.As<v8::Int32>()->Value() + startFrom;
+    return matchOffset.As<v8::Int32>()->Value();
 }
 
 } // namespace blink
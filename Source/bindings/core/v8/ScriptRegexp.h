@@ -39,17 +39,32 @@ enum MultilineMode {
     MultilineEnabled
 };
 
+// A global regexp starts every match at its lastIndex, which lets
+// matchInPlace() search one string from several offsets.
+enum GlobalMode {
+    GlobalDisabled,
+    GlobalEnabled
+};
+
 class ScriptRegexp {
     WTF_MAKE_FAST_ALLOCATED(ScriptRegexp); WTF_MAKE_NONCOPYABLE(ScriptRegexp);
 public:
-    ScriptRegexp(const String&, TextCaseSensitivity, MultilineMode = MultilineDisabled);
+    ScriptRegexp(const String&, TextCaseSensitivity, MultilineMode = MultilineDisabled, GlobalMode = GlobalDisabled);
 
     int match(const String&, int startFrom = 0, int* matchLength = 0) const;
+    // Like match(), but searches |subject| from |startFrom| in place, so that
+    // repeated searches of one large string convert it to V8 only once. Note
+    // that '^' only matches at |startFrom| if it is a line start and the
+    // regexp is multiline. Only for GlobalEnabled regexps.
+    int matchInPlace(v8::Local<v8::String> subject, int startFrom, int* matchLength = 0) const;
 
     bool isValid() const { return !m_regex.isEmpty(); }
 
 private:
+    int exec(v8::Isolate*, v8::Local<v8::String> subject, int lastIndex, int* matchLength) const;
+
     ScopedPersistent<v8::RegExp> m_regex;
+    GlobalMode m_globalMode;
 };
 
 } // namespace blink
@@ -0,0 +1,64 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "bindings/core/v8/ScriptRegexp.h"
+
+#include "bindings/core/v8/V8Binding.h"
+#include <gtest/gtest.h>
+
+namespace blink {
+namespace {
+
+TEST(ScriptRegexpTest, MatchFromOffset)
+{
+    ScriptRegexp regexp("b+", TextCaseSensitive);
+    ASSERT_TRUE(regexp.isValid());
+    int matchLength;
+    EXPECT_EQ(1, regexp.match("abbab", 0, &matchLength));
+    EXPECT_EQ(2, matchLength);
+    EXPECT_EQ(4, regexp.match("abbab", 3, &matchLength));
+    EXPECT_EQ(1, matchLength);
+    EXPECT_EQ(-1, regexp.match("aaa", 0, &matchLength));
+    EXPECT_EQ(0, matchLength);
+}
+
+TEST(ScriptRegexpTest, RepeatedMatchesAreIndependent)
+{
+    // A non-global regexp keeps no state between matches, so the same
+    // subject matches at the same offset every time.
+    ScriptRegexp regexp("b", TextCaseInsensitive);
+    EXPECT_EQ(1, regexp.match("aBc"));
+    EXPECT_EQ(1, regexp.match("aBc"));
+    EXPECT_EQ(0, regexp.match("b"));
+}
+
+TEST(ScriptRegexpTest, StartFromAnchorsAtSubstring)
+{
+    // The String overload matches against the substring, so '^' matches at
+    // |startFrom| even in the middle of a line.
+    ScriptRegexp regexp("^b", TextCaseSensitive);
+    EXPECT_EQ(-1, regexp.match("ab", 0));
+    EXPECT_EQ(1, regexp.match("ab", 1));
+}
+
+TEST(ScriptRegexpTest, MatchInPlace)
+{
+    v8::Isolate* isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope handleScope(isolate);
+    v8::Local<v8::String> subject = v8String(isolate, "ab\nb\nab");
+    ScriptRegexp regexp("^b", TextCaseSensitive, MultilineEnabled, GlobalEnabled);
+    int matchLength;
+    EXPECT_EQ(3, regexp.matchInPlace(subject, 0, &matchLength));
+    EXPECT_EQ(1, matchLength);
+    EXPECT_EQ(3, regexp.matchInPlace(subject, 3, &matchLength));
+    EXPECT_EQ(-1, regexp.matchInPlace(subject, 4, &matchLength));
+    EXPECT_EQ(-1, regexp.matchInPlace(subject, 9, &matchLength));
+    // match() of a global regexp still starts at |startFrom|.
+    EXPECT_EQ(3, regexp.match("ab\nb", 0));
+    EXPECT_EQ(3, regexp.match("ab\nb", 0));
+}
+
+} // namespace
+} // namespace blink
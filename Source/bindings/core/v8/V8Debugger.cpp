@@ -38,6 +38,7 @@
 #include "core/inspector/JavaScriptCallFrame.h"
 #include "core/inspector/ScriptDebugListener.h"
 #include "platform/JSONValues.h"
+#include "wtf/Atomics.h"
 #include "wtf/StdLibExtras.h"
 #include "wtf/Vector.h"
 #include "wtf/dtoa/utils.h"
@@ -54,12 +55,10 @@ class V8Debugger::ThreadSafeTaskQueue {
     WTF_MAKE_NONCOPYABLE(ThreadSafeTaskQueue);
 public:
     ThreadSafeTaskQueue() { }
-    PassOwnPtr<Task> tryTake()
+    void takeAll(Deque<OwnPtr<Task>>& tasks)
     {
         MutexLocker lock(m_mutex);
-        if (m_queue.isEmpty())
-            return nullptr;
-        return m_queue.takeFirst();
+        m_queue.swap(tasks);
     }
     void append(PassOwnPtr<Task> task)
     {
@@ -85,6 +84,7 @@ V8Debugger::V8Debugger(v8::Isolate* isolate, Client* client)
     , m_breakpointsActivated(true)
     , m_runningNestedMessageLoop(false)
     , m_taskQueue(adoptPtr(new ThreadSafeTaskQueue))
+    , m_interruptRequested(0)
 {
 }
 
@@ -487,18 +487,22 @@ PassRefPtr<JavaScriptCallFrame> V8Debugger::callFrameNoScopes(int index)
 void V8Debugger::interruptAndRun(PassOwnPtr<Task> task)
 {
     m_taskQueue->append(task);
-    m_isolate->RequestInterrupt(&v8InterruptCallback, this);
+    // One interrupt runs all tasks queued before it starts.
+    if (!atomicTestAndSetToOne(&m_interruptRequested))
+        m_isolate->RequestInterrupt(&v8InterruptCallback, this);
 }
 
 void V8Debugger::runPendingTasks()
 {
     if (!enabled())
         return;
+    Deque<OwnPtr<Task>> tasks;
     while (true) {
-        OwnPtr<Task> task = m_taskQueue->tryTake();
-        if (!task)
+        m_taskQueue->takeAll(tasks);
+        if (tasks.isEmpty())
             return;
-        task->run();
+        while (!tasks.isEmpty())
+            tasks.takeFirst()->run();
     }
 }
 
@@ -564,6 +568,8 @@ void V8Debugger::handleProgramBreak(ScriptState* pausedScriptState, v8::Local<v8
 void V8Debugger::v8InterruptCallback(v8::Isolate*, void* data)
 {
     V8Debugger* server = static_cast<V8Debugger*>(data);
+    // Tasks queued from now on need another interrupt.
+    atomicSetOneToZero(&server->m_interruptRequested);
     server->runPendingTasks();
 }
 
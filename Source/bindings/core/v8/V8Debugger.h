@@ -171,6 +171,8 @@ private:
     bool m_runningNestedMessageLoop;
     class ThreadSafeTaskQueue;
     OwnPtr<ThreadSafeTaskQueue> m_taskQueue;
+    // Set while an interrupt is requested and has not started running tasks.
+    int m_interruptRequested;
 };
 
 } // namespace blink
@@ -0,0 +1,246 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "bindings/core/v8/V8JSONWriter.h"
+
+#include "bindings/core/v8/V8Binding.h"
+#include "platform/JSONValues.h"
+
+namespace blink {
+
+V8JSONWriter::V8JSONWriter(v8::Isolate* isolate, Client* client)
+    : m_isolate(isolate)
+    , m_context(isolate->GetCurrentContext())
+    , m_client(client)
+    , m_output(nullptr)
+    , m_rawMemberDepth(-1)
+    , m_closingObject(nullptr)
+    , m_objectHasMembers(false)
+{
+}
+
+bool V8JSONWriter::writeValue(v8::Local<v8::Value> value, StringBuilder* output)
+{
+    m_output = output;
+    m_rawMemberDepth = -1;
+    bool result = writeValue(value, 0);
+    m_output = nullptr;
+    return result;
+}
+
+PassRefPtr<JSONValue> V8JSONWriter::toRawValue(v8::Local<v8::Value> value)
+{
+    m_rawMemberDepth = -1;
+    return toRawValue(value, 0);
+}
+
+PassRefPtr<JSONValue> V8JSONWriter::toJSONValue(v8::Local<v8::Value> value, int rawMemberDepth, const String& rawMemberName)
+{
+    m_rawMemberDepth = rawMemberDepth;
+    m_rawMemberName = rawMemberName;
+    return toJSONValue(value, 0);
+}
+
+void V8JSONWriter::appendMember(const String& name, JSONValue* value)
+{
+    if (m_closingObject) {
+        m_closingObject->setValue(name, value);
+        return;
+    }
+    if (m_objectHasMembers)
+        m_output->append(',');
+    doubleQuoteStringForJSON(name, m_output);
+    m_output->append(':');
+    value->writeJSON(m_output);
+    m_objectHasMembers = true;
+}
+
+bool V8JSONWriter::writeValue(v8::Local<v8::Value> value, int depth)
+{
+    if (value.IsEmpty()) {
+        ASSERT_NOT_REACHED();
+        return false;
+    }
+    if (depth >= JSONValue::maxDepth)
+        return false;
+
+    if (value->IsNull() || value->IsUndefined()) {
+        m_output->appendLiteral("null");
+        return true;
+    }
+    if (value->IsBoolean()) {
+        if (value->BooleanValue())
+            m_output->appendLiteral("true");
+        else
+            m_output->appendLiteral("false");
+        return true;
+    }
+    if (value->IsNumber()) {
+        writeNumberForJSON(value.As<v8::Number>()->Value(), m_output);
+        return true;
+    }
+    if (value->IsString()) {
+        doubleQuoteStringForJSON(toCoreString(value.As<v8::String>()), m_output);
+        return true;
+    }
+    if (value->IsArray()) {
+        m_output->append('[');
+        if (!writeElements(value.As<v8::Array>(), depth))
+            return false;
+        m_output->append(']');
+        return true;
+    }
+    if (value->IsObject()) {
+        m_output->append('{');
+        if (!writeMembers(value.As<v8::Object>(), depth))
+            return false;
+        m_output->append('}');
+        return true;
+    }
+    ASSERT_NOT_REACHED();
+    return false;
+}
+
+bool V8JSONWriter::writeMembers(v8::Local<v8::Object> object, int depth)
+{
+    v8::Local<v8::Array> propertyNames;
+    if (!object->GetPropertyNames(m_context).ToLocal(&propertyNames))
+        return false;
+    bool hasMembers = false;
+    uint32_t length = propertyNames->Length();
+    for (uint32_t i = 0; i < length; ++i) {
+        v8::Local<v8::String> name;
+        v8::Local<v8::Value> value;
+        if (!getOwnProperty(object, propertyNames, i, &name, &value))
+            return false;
+        if (name.IsEmpty())
+            continue;
+        if (hasMembers)
+            m_output->append(',');
+        doubleQuoteStringForJSON(toCoreString(name), m_output);
+        m_output->append(':');
+        if (!writeValue(value, depth + 1))
+            return false;
+        hasMembers = true;
+    }
+    willCloseObject(object, depth, nullptr, hasMembers);
+    return true;
+}
+
+bool V8JSONWriter::writeElements(v8::Local<v8::Array> array, int depth)
+{
+    uint32_t length = array->Length();
+    for (uint32_t i = 0; i < length; ++i) {
+        v8::Local<v8::Value> value;
+        if (!array->Get(m_context, i).ToLocal(&value))
+            return false;
+        if (i)
+            m_output->append(',');
+        if (!writeValue(value, depth + 1))
+            return false;
+    }
+    return true;
+}
+
+PassRefPtr<JSONValue> V8JSONWriter::toJSONValue(v8::Local<v8::Value> value, int depth)
+{
+    if (value.IsEmpty()) {
+        ASSERT_NOT_REACHED();
+        return nullptr;
+    }
+    if (depth >= JSONValue::maxDepth)
+        return nullptr;
+
+    if (value->IsNull() || value->IsUndefined())
+        return JSONValue::null();
+    if (value->IsBoolean())
+        return JSONBasicValue::create(value->BooleanValue());
+    if (value->IsNumber())
+        return JSONBasicValue::create(value.As<v8::Number>()->Value());
+    if (value->IsString())
+        return JSONString::create(toCoreString(value.As<v8::String>()));
+    if (value->IsArray()) {
+        v8::Local<v8::Array> array = value.As<v8::Array>();
+        RefPtr<JSONArray> result = JSONArray::create();
+        uint32_t length = array->Length();
+        for (uint32_t i = 0; i < length; ++i) {
+            v8::Local<v8::Value> element;
+            if (!array->Get(m_context, i).ToLocal(&element))
+                return nullptr;
+            RefPtr<JSONValue> elementValue = toJSONValue(element, depth + 1);
+            if (!elementValue)
+                return nullptr;
+            result->pushValue(elementValue.release());
+        }
+        return result.release();
+    }
+    if (value->IsObject()) {
+        v8::Local<v8::Object> object = value.As<v8::Object>();
+        v8::Local<v8::Array> propertyNames;
+        if (!object->GetPropertyNames(m_context).ToLocal(&propertyNames))
+            return nullptr;
+        RefPtr<JSONObject> result = JSONObject::create();
+        uint32_t length = propertyNames->Length();
+        for (uint32_t i = 0; i < length; ++i) {
+            v8::Local<v8::String> name;
+            v8::Local<v8::Value> property;
+            if (!getOwnProperty(object, propertyNames, i, &name, &property))
+                return nullptr;
+            if (name.IsEmpty())
+                continue;
+            String nameString = toCoreString(name);
+            RefPtr<JSONValue> propertyValue;
+            if (depth == m_rawMemberDepth && property->IsObject() && nameString == m_rawMemberName)
+                propertyValue = toRawValue(property, depth + 1);
+            else
+                propertyValue = toJSONValue(property, depth + 1);
+            if (!propertyValue)
+                return nullptr;
+            result->setValue(nameString, propertyValue.release());
+        }
+        willCloseObject(object, depth, result.get(), result->size());
+        return result.release();
+    }
+    ASSERT_NOT_REACHED();
+    return nullptr;
+}
+
+PassRefPtr<JSONValue> V8JSONWriter::toRawValue(v8::Local<v8::Value> value, int depth)
+{
+    StringBuilder json;
+    StringBuilder* outerOutput = m_output;
+    m_output = &json;
+    bool written = writeValue(value, depth);
+    m_output = outerOutput;
+    if (!written)
+        return nullptr;
+    return JSONRawValue::create(json.toString());
+}
+
+bool V8JSONWriter::getOwnProperty(v8::Local<v8::Object> object, v8::Local<v8::Array> names, uint32_t index, v8::Local<v8::String>* name, v8::Local<v8::Value>* value)
+{
+    v8::Local<v8::Value> nameValue;
+    if (!names->Get(m_context, index).ToLocal(&nameValue))
+        return false;
+    // FIXME(yurys): v8::Object should support GetOwnPropertyNames
+    if (nameValue->IsString() && !object->HasRealNamedProperty(nameValue.As<v8::String>()))
+        return true;
+    return nameValue->ToString(m_context).ToLocal(name) && object->Get(m_context, nameValue).ToLocal(value);
+}
+
+void V8JSONWriter::willCloseObject(v8::Local<v8::Object> object, int depth, JSONObject* jsonObject, bool hasMembers)
+{
+    if (!m_client)
+        return;
+    JSONObject* outerClosingObject = m_closingObject;
+    bool outerObjectHasMembers = m_objectHasMembers;
+    m_closingObject = jsonObject;
+    m_objectHasMembers = hasMembers;
+    m_client->willCloseObject(*this, object, depth);
+    m_closingObject = outerClosingObject;
+    m_objectHasMembers = outerObjectHasMembers;
+}
+
+} // namespace blink
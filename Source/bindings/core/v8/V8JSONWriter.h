@@ -0,0 +1,82 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8JSONWriter_h
+#define V8JSONWriter_h
+
+#include "platform/heap/Handle.h"
+#include "wtf/Noncopyable.h"
+#include "wtf/PassRefPtr.h"
+#include "wtf/text/StringBuilder.h"
+#include <v8.h>
+
+namespace blink {
+
+class JSONObject;
+class JSONValue;
+
+// Turns a V8 value into JSON with the same rules as ScriptValue::toJSONValue():
+// undefined becomes null, objects contribute their own named properties, and
+// nesting deeper than JSONValue::maxDepth fails. Used for protocol results,
+// whose by-value payloads are written straight to JSON text instead of
+// becoming a JSONValue tree that is only serialized again.
+class V8JSONWriter {
+    STACK_ALLOCATED();
+    WTF_MAKE_NONCOPYABLE(V8JSONWriter);
+public:
+    class Client {
+    public:
+        virtual ~Client() { }
+        // Called before every object is finished, with the nesting depth of
+        // that object (0 for the value passed to the writer). Extra members
+        // may be added with appendMember().
+        virtual void willCloseObject(V8JSONWriter&, v8::Local<v8::Object>, int depth) = 0;
+    };
+
+    // Must be used inside a context.
+    V8JSONWriter(v8::Isolate*, Client* = nullptr);
+
+    // Writes |value| as JSON text. Returns false if the value is nested too
+    // deep; the output is then incomplete.
+    bool writeValue(v8::Local<v8::Value>, StringBuilder*);
+
+    // Writes |value| as JSON text and keeps it in a JSONRawValue, for results
+    // that are only sent to the frontend. Returns null if the value is nested
+    // too deep.
+    PassRefPtr<JSONValue> toRawValue(v8::Local<v8::Value>);
+
+    // Converts |value| to a JSONValue. The |rawMemberName| members of the
+    // objects at |rawMemberDepth| that are objects or arrays are written as
+    // text and kept as JSONRawValues. Returns null if the value is nested too
+    // deep.
+    PassRefPtr<JSONValue> toJSONValue(v8::Local<v8::Value>, int rawMemberDepth, const String& rawMemberName);
+
+    void appendMember(const String& name, JSONValue*);
+
+private:
+    bool writeValue(v8::Local<v8::Value>, int depth);
+    bool writeMembers(v8::Local<v8::Object>, int depth);
+    bool writeElements(v8::Local<v8::Array>, int depth);
+    PassRefPtr<JSONValue> toJSONValue(v8::Local<v8::Value>, int depth);
+    PassRefPtr<JSONValue> toRawValue(v8::Local<v8::Value>, int depth);
+    // Leaves |*name| empty if the |index|th of |names| is not an own property.
+    bool getOwnProperty(v8::Local<v8::Object>, v8::Local<v8::Array> names, uint32_t index, v8::Local<v8::String>* name, v8::Local<v8::Value>*);
+    void willCloseObject(v8::Local<v8::Object>, int depth, JSONObject*, bool hasMembers);
+
+    v8::Isolate* m_isolate;
+    v8::Local<v8::Context> m_context;
+    Client* m_client;
+    StringBuilder* m_output;
+    int m_rawMemberDepth;
+    String m_rawMemberName;
+    // The object that appendMember() adds to while the client is called: a
+    // JSONObject, or the text in m_output when null. Whether that text
+    // already has a member decides whether a comma is needed.
+    JSONObject* m_closingObject;
+    bool m_objectHasMembers;
+};
+
+} // namespace blink
+
+#endif // V8JSONWriter_h
@@ -0,0 +1,121 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "bindings/core/v8/V8JSONWriter.h"
+
+#include "bindings/core/v8/V8Binding.h"
+#include "platform/JSONValues.h"
+#include <gtest/gtest.h>
+
+namespace blink {
+namespace {
+
+class V8JSONWriterTest : public ::testing::Test {
+protected:
+    V8JSONWriterTest()
+        : m_isolate(v8::Isolate::GetCurrent())
+        , m_context(v8::Context::New(m_isolate))
+        , m_contextScope(m_context)
+    {
+    }
+
+    v8::Local<v8::Value> evaluate(const char* source)
+    {
+        v8::Local<v8::Script> script = v8::Script::Compile(m_context, v8String(m_isolate, source)).ToLocalChecked();
+        return script->Run(m_context).ToLocalChecked();
+    }
+
+    v8::Isolate* m_isolate;
+    v8::Local<v8::Context> m_context;
+    v8::Context::Scope m_contextScope;
+};
+
+class AppendDepthClient final : public V8JSONWriter::Client {
+public:
+    void willCloseObject(V8JSONWriter& writer, v8::Local<v8::Object>, int depth) override
+    {
+        RefPtr<JSONValue> value = JSONBasicValue::create(depth);
+        writer.appendMember("depth", value.get());
+    }
+};
+
+TEST_F(V8JSONWriterTest, WriteValue)
+{
+    StringBuilder output;
+    V8JSONWriter writer(m_isolate);
+    EXPECT_TRUE(writer.writeValue(evaluate("({a: 1, b: [true, null, undefined], c: 'x\"'})"), &output));
+    EXPECT_EQ("{\"a\":1,\"b\":[true,null,null],\"c\":\"x\\\"\"}", output.toString());
+}
+
+TEST_F(V8JSONWriterTest, RawValue)
+{
+    AppendDepthClient client;
+    V8JSONWriter writer(m_isolate, &client);
+    RefPtr<JSONValue> value = writer.toRawValue(evaluate("[{value: {}}]"));
+    ASSERT_TRUE(value);
+    EXPECT_EQ(JSONValue::TypeRaw, value->type());
+    EXPECT_FALSE(value->asArray());
+    EXPECT_FALSE(value->asObject());
+    EXPECT_EQ("[{\"value\":{\"depth\":2},\"depth\":1}]", value->toJSONString());
+}
+
+TEST_F(V8JSONWriterTest, RawMembersKeepOtherMembersVisible)
+{
+    V8JSONWriter writer(m_isolate);
+    RefPtr<JSONValue> value = writer.toJSONValue(evaluate("({type: 'object', value: {a: [1, 2]}})"), 0, "value");
+    ASSERT_TRUE(value);
+    RefPtr<JSONObject> object = value->asObject();
+    ASSERT_TRUE(object);
+    EXPECT_EQ(2, object->size());
+    String type;
+    EXPECT_TRUE(object->getString("type", &type));
+    EXPECT_EQ("object", type);
+    RefPtr<JSONValue> payload = object->get("value");
+    ASSERT_TRUE(payload);
+    EXPECT_EQ(JSONValue::TypeRaw, payload->type());
+    EXPECT_FALSE(payload->asObject());
+    EXPECT_EQ("{\"type\":\"object\",\"value\":{\"a\":[1,2]}}", object->toJSONString());
+}
+
+TEST_F(V8JSONWriterTest, RawMembersOnlyAtTheirDepth)
+{
+    V8JSONWriter writer(m_isolate);
+    RefPtr<JSONValue> value = writer.toJSONValue(evaluate("[{value: {value: {}}}]"), 1, "value");
+    ASSERT_TRUE(value);
+    RefPtr<JSONArray> array = value->asArray();
+    ASSERT_TRUE(array);
+    EXPECT_EQ(1u, array->length());
+    RefPtr<JSONObject> descriptor = array->get(0)->asObject();
+    ASSERT_TRUE(descriptor);
+    EXPECT_FALSE(descriptor->get("value")->asObject());
+    EXPECT_EQ("[{\"value\":{\"value\":{}}}]", array->toJSONString());
+}
+
+TEST_F(V8JSONWriterTest, ClientAppendsToObjectsAndText)
+{
+    AppendDepthClient client;
+    V8JSONWriter writer(m_isolate, &client);
+    RefPtr<JSONValue> value = writer.toJSONValue(evaluate("({value: {a: {}}, b: {}})"), 0, "value");
+    ASSERT_TRUE(value);
+    RefPtr<JSONObject> object = value->asObject();
+    ASSERT_TRUE(object);
+    int depth = -1;
+    EXPECT_TRUE(object->getNumber("depth", &depth));
+    EXPECT_EQ(0, depth);
+    EXPECT_EQ("{\"value\":{\"a\":{\"depth\":2},\"depth\":1},\"b\":{\"depth\":1},\"depth\":0}", object->toJSONString());
+}
+
+TEST_F(V8JSONWriterTest, TooDeep)
+{
+    V8JSONWriter writer(m_isolate);
+    v8::Local<v8::Value> deep = evaluate("var o = {}; for (var i = 0; i < 2000; ++i) o = {value: o}; o");
+    EXPECT_FALSE(writer.toJSONValue(deep, 0, "value"));
+    EXPECT_FALSE(writer.toRawValue(deep));
+    StringBuilder output;
+    EXPECT_FALSE(writer.writeValue(deep, &output));
+}
+
+} // namespace
+} // namespace blink
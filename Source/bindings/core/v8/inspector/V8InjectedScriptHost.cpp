@@ -14,6 +14,7 @@
 #include "core/inspector/InjectedScriptHost.h"
 #include "core/inspector/JavaScriptCallFrame.h"
 #include "platform/JSONValues.h"
+#include "wtf/CurrentTime.h"
 #include "wtf/RefPtr.h"
 #include "wtf/StdLibExtras.h"
 #include <algorithm>
@@ -57,16 +58,12 @@ static v8::Local<v8::String> functionDisplayName(v8::Local<v8::Function> functio
     return v8::Local<v8::String>();
 }
 
-void V8InjectedScriptHost::internalConstructorNameCallback(const v8::FunctionCallbackInfo<v8::Value>& info)
+v8::Local<v8::String> V8InjectedScriptHost::internalConstructorName(v8::Isolate* isolate, v8::Local<v8::Object> object)
 {
-    if (info.Length() < 1 || !info[0]->IsObject())
-        return;
-
-    v8::Local<v8::Object> object = info[0].As<v8::Object>();
     v8::Local<v8::String> result = object->GetConstructorName();
 
     if (!result.IsEmpty() && toCoreStringWithUndefinedOrNullCheck(result) == "Object") {
-        v8::Local<v8::String> constructorSymbol = v8AtomicString(info.GetIsolate(), "constructor");
+        v8::Local<v8::String> constructorSymbol = v8AtomicString(isolate, "constructor");
         if (object->HasRealNamedProperty(constructorSymbol) && !object->HasRealNamedCallbackProperty(constructorSymbol)) {
             v8::TryCatch tryCatch;
             v8::Local<v8::Value> constructor = object->GetRealNamedProperty(constructorSymbol);
@@ -77,10 +74,17 @@ void V8InjectedScriptHost::internalConstructorNameCallback(const v8::FunctionCal
             }
         }
         if (toCoreStringWithUndefinedOrNullCheck(result) == "Object" && object->IsFunction())
-            result = v8AtomicString(info.GetIsolate(), "Function");
+            result = v8AtomicString(isolate, "Function");
     }
+    return result;
+}
 
-    v8SetReturnValue(info, result);
+void V8InjectedScriptHost::internalConstructorNameCallback(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    if (info.Length() < 1 || !info[0]->IsObject())
+        return;
+
+    v8SetReturnValue(info, internalConstructorName(info.GetIsolate(), info[0].As<v8::Object>()));
 }
 
 void V8InjectedScriptHost::isDOMWrapperCallback(const v8::FunctionCallbackInfo<v8::Value>& info)
@@ -98,45 +102,117 @@ void V8InjectedScriptHost::isTypedArrayCallback(const v8::FunctionCallbackInfo<v
     v8SetReturnValue(info, info[0]->IsTypedArray());
 }
 
-void V8InjectedScriptHost::subtypeCallback(const v8::FunctionCallbackInfo<v8::Value>& info)
+// Returns [nextIndex, index, value, attributes, ...] for the elements of an
+// array, typed array or arguments object in [fromIndex, toIndex), stopping
+// after maxCount elements or once timeBudgetMs is spent. Accessor elements are
+// reported with attributes -1 and no value so that their getters are never
+// called.
+void V8InjectedScriptHost::indexedDataPropertiesCallback(const v8::FunctionCallbackInfo<v8::Value>& info)
 {
-    if (info.Length() < 1)
+    if (info.Length() < 5 || !info[0]->IsObject() || !info[1]->IsUint32() || !info[2]->IsUint32() || !info[3]->IsUint32() || !info[4]->IsNumber())
+        return;
+    v8::Local<v8::Object> object = info[0].As<v8::Object>();
+    bool isTypedArray = object->IsTypedArray();
+    if (!isTypedArray && !object->IsArray() && !object->IsArgumentsObject())
         return;
+    // Elements that cannot be accessors are read directly. The others, e.g.
+    // those of sparse arrays and sloppy mode arguments, need a descriptor each.
+    bool plainDataElements = !isTypedArray && object->HasPlainDataElements();
+
     v8::Isolate* isolate = info.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    uint32_t index = info[1].As<v8::Uint32>()->Value();
+    uint32_t toIndex = info[2].As<v8::Uint32>()->Value();
+    uint32_t maxCount = info[3].As<v8::Uint32>()->Value();
+    double deadline = monotonicallyIncreasingTime() + info[4].As<v8::Number>()->Value() / 1000;
+    v8::Local<v8::String> valueKey = v8AtomicString(isolate, "value");
+    v8::Local<v8::String> writableKey = v8AtomicString(isolate, "writable");
+    v8::Local<v8::String> enumerableKey = v8AtomicString(isolate, "enumerable");
+    v8::Local<v8::String> configurableKey = v8AtomicString(isolate, "configurable");
 
-    v8::Local<v8::Value> value = info[0];
-    if (value->IsArray() || value->IsTypedArray() || value->IsArgumentsObject()) {
-        v8SetReturnValue(info, v8AtomicString(isolate, "array"));
-        return;
-    }
-    if (value->IsDate()) {
-        v8SetReturnValue(info, v8AtomicString(isolate, "date"));
-        return;
-    }
-    if (value->IsRegExp()) {
-        v8SetReturnValue(info, v8AtomicString(isolate, "regexp"));
-        return;
-    }
-    if (value->IsMap() || value->IsWeakMap()) {
-        v8SetReturnValue(info, v8AtomicString(isolate, "map"));
-        return;
-    }
-    if (value->IsSet() || value->IsWeakSet()) {
-        v8SetReturnValue(info, v8AtomicString(isolate, "set"));
-        return;
-    }
-    if (value->IsMapIterator() || value->IsSetIterator()) {
-        v8SetReturnValue(info, v8AtomicString(isolate, "iterator"));
-        return;
-    }
-    if (value->IsGeneratorObject()) {
-        v8SetReturnValue(info, v8AtomicString(isolate, "generator"));
-        return;
+    v8::TryCatch tryCatch;
+    v8::Local<v8::Array> result = v8::Array::New(isolate);
+    uint32_t resultLength = 1;
+    uint32_t count = 0;
+    uint32_t scanned = 0;
+    for (; index < toIndex && count < maxCount; ++index) {
+        // Sparse arrays may have few elements in a huge range; the time check
+        // keeps a slice bounded while still making progress.
+        if (++scanned % 1024 == 0 && monotonicallyIncreasingTime() > deadline)
+            break;
+        if (!object->HasRealIndexedProperty(context, index).FromMaybe(false))
+            continue;
+        v8::Local<v8::Value> value = v8::Undefined(isolate);
+        int attributes;
+        if (isTypedArray) {
+            if (!object->Get(context, index).ToLocal(&value))
+                break;
+            attributes = v8::DontDelete;
+        } else if (plainDataElements) {
+            if (!object->Get(context, index).ToLocal(&value))
+                break;
+            attributes = v8::None;
+        } else {
+            v8::Local<v8::String> name;
+            v8::Local<v8::Value> descriptorValue;
+            if (!v8::Integer::NewFromUnsigned(isolate, index)->ToString(context).ToLocal(&name) || !object->GetOwnPropertyDescriptor(context, name).ToLocal(&descriptorValue) || !descriptorValue->IsObject())
+                continue;
+            v8::Local<v8::Object> descriptor = descriptorValue.As<v8::Object>();
+            if (descriptor->HasOwnProperty(context, valueKey).FromMaybe(false)) {
+                if (!descriptor->Get(context, valueKey).ToLocal(&value))
+                    break;
+                attributes = v8::None;
+                if (!descriptor->Get(context, writableKey).ToLocalChecked()->BooleanValue())
+                    attributes |= v8::ReadOnly;
+                if (!descriptor->Get(context, enumerableKey).ToLocalChecked()->BooleanValue())
+                    attributes |= v8::DontEnum;
+                if (!descriptor->Get(context, configurableKey).ToLocalChecked()->BooleanValue())
+                    attributes |= v8::DontDelete;
+            } else {
+                attributes = -1;
+            }
+        }
+        result->Set(context, resultLength++, v8::Integer::NewFromUnsigned(isolate, index));
+        result->Set(context, resultLength++, value);
+        result->Set(context, resultLength++, v8::Integer::New(isolate, attributes));
+        ++count;
     }
-    if (value->IsNativeError()) {
-        v8SetReturnValue(info, v8AtomicString(isolate, "error"));
+    result->Set(context, 0, v8::Integer::NewFromUnsigned(isolate, index));
+    v8SetReturnValue(info, result);
+}
+
+void V8InjectedScriptHost::monotonicTimeCallback(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    v8SetReturnValue(info, monotonicallyIncreasingTime() * 1000);
+}
+
+const char* V8InjectedScriptHost::subtype(v8::Local<v8::Value> value)
+{
+    if (value->IsArray() || value->IsTypedArray() || value->IsArgumentsObject())
+        return "array";
+    if (value->IsDate())
+        return "date";
+    if (value->IsRegExp())
+        return "regexp";
+    if (value->IsMap() || value->IsWeakMap())
+        return "map";
+    if (value->IsSet() || value->IsWeakSet())
+        return "set";
+    if (value->IsMapIterator() || value->IsSetIterator())
+        return "iterator";
+    if (value->IsGeneratorObject())
+        return "generator";
+    if (value->IsNativeError())
+        return "error";
+    return nullptr;
+}
+
+void V8InjectedScriptHost::subtypeCallback(const v8::FunctionCallbackInfo<v8::Value>& info)
+{
+    if (info.Length() < 1)
         return;
-    }
+    if (const char* result = subtype(info[0]))
+        v8SetReturnValue(info, v8AtomicString(info.GetIsolate(), result));
 }
 
 void V8InjectedScriptHost::functionDetailsCallback(const v8::FunctionCallbackInfo<v8::Value>& info)
@@ -479,6 +555,8 @@ const InjectedScriptHostWrapper::V8MethodConfiguration V8InjectedScriptHostMetho
     {"isDOMWrapper", V8InjectedScriptHost::isDOMWrapperCallback},
     {"isHTMLAllCollection", V8InjectedScriptHost::isHTMLAllCollectionCallback},
     {"isTypedArray", V8InjectedScriptHost::isTypedArrayCallback},
+    {"indexedDataProperties", V8InjectedScriptHost::indexedDataPropertiesCallback},
+    {"monotonicTime", V8InjectedScriptHost::monotonicTimeCallback},
     {"subtype", V8InjectedScriptHost::subtypeCallback},
     {"functionDetails", V8InjectedScriptHost::functionDetailsCallback},
     {"generatorObjectDetails", V8InjectedScriptHost::generatorObjectDetailsCallback},
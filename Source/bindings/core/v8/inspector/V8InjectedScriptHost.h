@@ -19,6 +19,10 @@ public:
     static InjectedScriptHost* unwrap(v8::Local<v8::Object>);
     static v8::Local<v8::FunctionTemplate> createWrapperTemplate(v8::Isolate*);
 
+    // Shared with the native object preview builder.
+    static v8::Local<v8::String> internalConstructorName(v8::Isolate*, v8::Local<v8::Object>);
+    static const char* subtype(v8::Local<v8::Value>);
+
     static void clearConsoleMessagesCallback(const v8::FunctionCallbackInfo<v8::Value>&);
     static void inspectCallback(const v8::FunctionCallbackInfo<v8::Value>&);
     static void inspectedObjectCallback(const v8::FunctionCallbackInfo<v8::Value>&);
@@ -26,6 +30,8 @@ public:
     static void isDOMWrapperCallback(const v8::FunctionCallbackInfo<v8::Value>&);
     static void isHTMLAllCollectionCallback(const v8::FunctionCallbackInfo<v8::Value>&);
     static void isTypedArrayCallback(const v8::FunctionCallbackInfo<v8::Value>&);
+    static void indexedDataPropertiesCallback(const v8::FunctionCallbackInfo<v8::Value>&);
+    static void monotonicTimeCallback(const v8::FunctionCallbackInfo<v8::Value>&);
     static void subtypeCallback(const v8::FunctionCallbackInfo<v8::Value>&);
     static void functionDetailsCallback(const v8::FunctionCallbackInfo<v8::Value>&);
     static void generatorObjectDetailsCallback(const v8::FunctionCallbackInfo<v8::Value>&);
@@ -742,6 +742,8 @@
         'server/http_server_response_info.h',
         'server/web_socket.cc',
         'server/web_socket.h',
+        'server/web_socket_adaptive_deflate_predictor.cc',
+        'server/web_socket_adaptive_deflate_predictor.h',
         'server/web_socket_encoder.cc',
         'server/web_socket_encoder.h',
       ],
@@ -108,6 +108,11 @@ void HttpServer::Close(int connection_id) {
   if (connection == NULL)
     return;
 
+  if (connection->web_socket() && connection->web_socket()->encoder()) {
+    delegate_->OnWebSocketDeflateStats(
+        connection_id, connection->web_socket()->encoder()->deflate_stats());
+  }
+
   id_to_connection_.erase(connection_id);
   delegate_->OnClose(connection_id);
 
@@ -122,6 +127,18 @@ int HttpServer::GetLocalAddress(IPEndPoint* address) {
   return server_socket_->GetLocalAddress(address);
 }
 
+bool HttpServer::GetWebSocketDeflateStats(
+    int connection_id,
+    WebSocketEncoder::DeflateStats* stats) {
+  HttpConnection* connection = FindConnection(connection_id);
+  if (connection == NULL || !connection->web_socket() ||
+      !connection->web_socket()->encoder()) {
+    return false;
+  }
+  *stats = connection->web_socket()->encoder()->deflate_stats();
+  return true;
+}
+
 void HttpServer::SetReceiveBufferSize(int connection_id, int32 size) {
   HttpConnection* connection = FindConnection(connection_id);
   if (connection)
@@ -218,7 +235,7 @@ int HttpServer::HandleReadResult(HttpConnection* connection, int rv) {
         Close(connection->id());
         return ERR_CONNECTION_CLOSED;
       }
-      delegate_->OnWebSocketMessage(connection->id(), message);
+      delegate_->OnWebSocketMessage(connection->id(), &message);
       if (HasClosedConnection(connection))
         return ERR_CONNECTION_CLOSED;
       continue;
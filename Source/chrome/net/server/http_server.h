@@ -13,6 +13,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "net/http/http_status_code.h"
+#include "net/server/web_socket_encoder.h"
 
 namespace net {
 
@@ -35,8 +36,14 @@ class HttpServer {
                                const HttpServerRequestInfo& info) = 0;
     virtual void OnWebSocketRequest(int connection_id,
                                     const HttpServerRequestInfo& info) = 0;
+    // The delegate may take the contents of |data|.
     virtual void OnWebSocketMessage(int connection_id,
-                                    const std::string& data) = 0;
+                                    std::string* data) = 0;
+    // Called just before OnClose() for a WebSocket connection, with what
+    // permessage-deflate did on it.
+    virtual void OnWebSocketDeflateStats(
+        int connection_id,
+        const WebSocketEncoder::DeflateStats& stats) {}
     virtual void OnClose(int connection_id) = 0;
   };
 
@@ -69,6 +76,11 @@ class HttpServer {
 
   void Close(int connection_id);
 
+  // Copies what permessage-deflate did on the WebSocket connection so far to
+  // |stats|. Returns false if there is no such WebSocket connection.
+  bool GetWebSocketDeflateStats(int connection_id,
+                                WebSocketEncoder::DeflateStats* stats);
+
   void SetReceiveBufferSize(int connection_id, int32 size);
   void SetSendBufferSize(int connection_id, int32 size);
 
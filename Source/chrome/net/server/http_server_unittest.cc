@@ -203,7 +203,7 @@ class HttpServerTest : public testing::Test,
     NOTREACHED();
   }
 
-  void OnWebSocketMessage(int connection_id, const std::string& data) override {
+  void OnWebSocketMessage(int connection_id, std::string* data) override {
     NOTREACHED();
   }
 
@@ -257,7 +257,7 @@ class WebSocketTest : public HttpServerTest {
     HttpServerTest::OnHttpRequest(connection_id, info);
   }
 
-  void OnWebSocketMessage(int connection_id, const std::string& data) override {
+  void OnWebSocketMessage(int connection_id, std::string* data) override {
   }
 };
 
@@ -5,6 +5,7 @@
 #include "net/server/web_socket.h"
 
 #include "base/base64.h"
+#include "base/bind.h"
 #include "base/logging.h"
 #include "base/md5.h"
 #include "base/sha1.h"
@@ -152,6 +153,9 @@ const int WebSocketHixie76::kWebSocketHandshakeBodyLen = 8;
 
 class WebSocketHybi17 : public WebSocket {
  public:
+  // RFC 6455, section 7.4.1.
+  static const uint16 kCloseStatusMessageTooBig = 1009;
+
   static WebSocket* Create(HttpServer* server,
                            HttpConnection* connection,
                            const HttpServerRequestInfo& request,
@@ -196,22 +200,39 @@ class WebSocketHybi17 : public WebSocket {
     base::StringPiece frame(read_buf->StartOfBuffer(), read_buf->GetSize());
     int bytes_consumed = 0;
     ParseResult result = encoder_->DecodeFrame(frame, &bytes_consumed, message);
-    if (result == FRAME_OK)
+    // Leading fragments of an incomplete message are already buffered in the
+    // encoder.
+    if (result == FRAME_OK || result == FRAME_INCOMPLETE)
       read_buf->DidConsume(bytes_consumed);
     if (result == FRAME_CLOSE)
       closed_ = true;
+    if (result == FRAME_MESSAGE_TOO_BIG) {
+      std::string close_frame;
+      encoder_->EncodeCloseFrame(kCloseStatusMessageTooBig, 0, &close_frame);
+      server_->SendRaw(connection_->id(), close_frame);
+      closed_ = true;
+      return FRAME_ERROR;
+    }
     return result;
   }
 
   void Send(const std::string& message) override {
     if (closed_)
       return;
-    std::string encoded;
-    encoder_->EncodeFrame(message, 0, &encoded);
-    server_->SendRaw(connection_->id(), encoded);
+    // The encoder is owned by this object and does not run the callback once
+    // destroyed.
+    encoder_->EncodeFrameAsync(
+        message, 0,
+        base::Bind(&WebSocketHybi17::SendEncoded, base::Unretained(this)));
   }
 
+  const WebSocketEncoder* encoder() const override { return encoder_.get(); }
+
  private:
+  void SendEncoded(const std::string& encoded) {
+    server_->SendRaw(connection_->id(), encoded);
+  }
+
   WebSocketHybi17(HttpServer* server,
                   HttpConnection* connection,
                   const HttpServerRequestInfo& request,
@@ -256,4 +277,8 @@ WebSocket::WebSocket(HttpServer* server, HttpConnection* connection)
 WebSocket::~WebSocket() {
 }
 
+const WebSocketEncoder* WebSocket::encoder() const {
+  return NULL;
+}
+
 }  // namespace net
@@ -15,6 +15,7 @@ namespace net {
 class HttpConnection;
 class HttpServer;
 class HttpServerRequestInfo;
+class WebSocketEncoder;
 
 class WebSocket {
  public:
@@ -22,7 +23,10 @@ class WebSocket {
     FRAME_OK,
     FRAME_INCOMPLETE,
     FRAME_CLOSE,
-    FRAME_ERROR
+    FRAME_ERROR,
+    // The message is longer than the receiver accepts. Read() answers it
+    // with a close frame and returns FRAME_ERROR instead.
+    FRAME_MESSAGE_TOO_BIG
   };
 
   static WebSocket* CreateWebSocket(HttpServer* server,
@@ -33,6 +37,8 @@ class WebSocket {
   virtual void Accept(const HttpServerRequestInfo& request) = 0;
   virtual ParseResult Read(std::string* message) = 0;
   virtual void Send(const std::string& message) = 0;
+  // NULL for the protocol versions without one.
+  virtual const WebSocketEncoder* encoder() const;
   virtual ~WebSocket();
 
  protected:
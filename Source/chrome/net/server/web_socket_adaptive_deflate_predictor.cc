@@ -0,0 +1,92 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/server/web_socket_adaptive_deflate_predictor.h"
+
+#include "base/logging.h"
+#include "net/websockets/websocket_frame.h"
+
+namespace net {
+
+namespace {
+
+// Weight of the latest message in the moving average of the ratio.
+const double kRatioWeight = 0.25;
+// The average starts here, so that the first messages are deflated at the
+// default level.
+const double kInitialRatio = 0.5;
+// Above this ratio deflating is not worth it and messages are skipped.
+const double kSkipRatio = 0.9;
+// While skipping, every this many messages one is deflated anyway.
+const int kProbeInterval = 32;
+// Below this ratio the fastest level is used.
+const double kFastLevelRatio = 0.3;
+
+const int kFastCompressionLevel = 1;
+const int kDefaultCompressionLevel = 6;
+
+}  // namespace
+
+WebSocketAdaptiveDeflatePredictor::WebSocketAdaptiveDeflatePredictor(
+    size_t min_size)
+    : min_size_(min_size),
+      average_ratio_(kInitialRatio),
+      skipped_messages_(0),
+      input_length_(0),
+      written_length_(0),
+      written_deflated_(false) {
+}
+
+WebSocketAdaptiveDeflatePredictor::~WebSocketAdaptiveDeflatePredictor() {
+}
+
+WebSocketDeflatePredictor::Result WebSocketAdaptiveDeflatePredictor::Predict(
+    const ScopedVector<WebSocketFrame>& frames,
+    size_t frame_index) {
+  uint64 length = 0;
+  for (size_t i = frame_index; i < frames.size(); ++i) {
+    const WebSocketFrameHeader& header = frames[i]->header;
+    if (!WebSocketFrameHeader::IsKnownDataOpCode(header.opcode))
+      continue;
+    length += header.payload_length;
+    if (header.final)
+      break;
+  }
+  if (length < min_size_)
+    return DO_NOT_DEFLATE;
+  if (average_ratio_ > kSkipRatio && ++skipped_messages_ < kProbeInterval)
+    return DO_NOT_DEFLATE;
+  skipped_messages_ = 0;
+  return DEFLATE;
+}
+
+void WebSocketAdaptiveDeflatePredictor::RecordInputDataFrame(
+    const WebSocketFrame* frame) {
+  input_length_ += frame->header.payload_length;
+}
+
+void WebSocketAdaptiveDeflatePredictor::RecordWrittenDataFrame(
+    const WebSocketFrame* frame) {
+  const WebSocketFrameHeader& header = frame->header;
+  if (header.opcode != WebSocketFrameHeader::kOpCodeContinuation)
+    written_deflated_ = header.reserved1;
+  written_length_ += header.payload_length;
+  if (!header.final)
+    return;
+
+  if (written_deflated_ && input_length_) {
+    double ratio = static_cast<double>(written_length_) / input_length_;
+    average_ratio_ += (ratio - average_ratio_) * kRatioWeight;
+  }
+  input_length_ = 0;
+  written_length_ = 0;
+  written_deflated_ = false;
+}
+
+int WebSocketAdaptiveDeflatePredictor::compression_level() const {
+  return average_ratio_ < kFastLevelRatio ? kFastCompressionLevel
+                                          : kDefaultCompressionLevel;
+}
+
+}  // namespace net
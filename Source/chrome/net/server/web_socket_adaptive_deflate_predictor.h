@@ -0,0 +1,60 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_SERVER_WEB_SOCKET_ADAPTIVE_DEFLATE_PREDICTOR_H_
+#define NET_SERVER_WEB_SOCKET_ADAPTIVE_DEFLATE_PREDICTOR_H_
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_vector.h"
+#include "net/websockets/websocket_deflate_predictor.h"
+
+namespace net {
+
+struct WebSocketFrame;
+
+// Decides per message whether the server deflates it, from the compression
+// ratio observed on the connection so far:
+// - Messages shorter than min_size() are sent as is, since deflating them
+//   costs more CPU than it saves on the wire.
+// - While messages hardly shrink, deflating is skipped, except for one probe
+//   message every so often to notice when the traffic changes.
+// - Traffic that deflates very well is compressed at the fastest zlib level,
+//   which gets most of the gain for a fraction of the CPU time.
+// Only whole unfragmented messages are expected; a message is accounted when
+// its final frame is written.
+class WebSocketAdaptiveDeflatePredictor : public WebSocketDeflatePredictor {
+ public:
+  explicit WebSocketAdaptiveDeflatePredictor(size_t min_size);
+  ~WebSocketAdaptiveDeflatePredictor() override;
+
+  Result Predict(const ScopedVector<WebSocketFrame>& frames,
+                 size_t frame_index) override;
+  void RecordInputDataFrame(const WebSocketFrame* frame) override;
+  void RecordWrittenDataFrame(const WebSocketFrame* frame) override;
+
+  // The zlib level to deflate the next message with.
+  int compression_level() const;
+
+  // Moving average of the deflated size over the original size.
+  double average_ratio() const { return average_ratio_; }
+
+  size_t min_size() const { return min_size_; }
+  void set_min_size(size_t min_size) { min_size_ = min_size; }
+
+ private:
+  size_t min_size_;
+  double average_ratio_;
+  // Messages skipped since the last one that was deflated.
+  int skipped_messages_;
+  // Lengths of the message being written.
+  uint64 input_length_;
+  uint64 written_length_;
+  bool written_deflated_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebSocketAdaptiveDeflatePredictor);
+};
+
+}  // namespace net
+
+#endif  // NET_SERVER_WEB_SOCKET_ADAPTIVE_DEFLATE_PREDICTOR_H_
@@ -0,0 +1,90 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/server/web_socket_adaptive_deflate_predictor.h"
+
+#include "base/memory/scoped_vector.h"
+#include "net/websockets/websocket_frame.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+typedef WebSocketDeflatePredictor::Result Result;
+
+scoped_ptr<WebSocketFrame> CreateFrame(size_t length, bool deflated) {
+  scoped_ptr<WebSocketFrame> frame(
+      new WebSocketFrame(WebSocketFrameHeader::kOpCodeText));
+  frame->header.final = true;
+  frame->header.reserved1 = deflated;
+  frame->header.payload_length = length;
+  return frame.Pass();
+}
+
+// Predicts for a message of |length| bytes and records it as written with
+// |written_length| bytes if deflated.
+Result SendMessage(WebSocketAdaptiveDeflatePredictor* predictor,
+                   size_t length,
+                   size_t written_length) {
+  ScopedVector<WebSocketFrame> frames;
+  frames.push_back(CreateFrame(length, false).release());
+  Result result = predictor->Predict(frames, 0);
+  predictor->RecordInputDataFrame(frames[0]);
+  bool deflated = result != WebSocketDeflatePredictor::DO_NOT_DEFLATE;
+  scoped_ptr<WebSocketFrame> written =
+      CreateFrame(deflated ? written_length : length, deflated);
+  predictor->RecordWrittenDataFrame(written.get());
+  return result;
+}
+
+}  // namespace
+
+TEST(WebSocketAdaptiveDeflatePredictorTest, MinSize) {
+  WebSocketAdaptiveDeflatePredictor predictor(100);
+  EXPECT_EQ(WebSocketDeflatePredictor::DO_NOT_DEFLATE,
+            SendMessage(&predictor, 99, 10));
+  EXPECT_EQ(WebSocketDeflatePredictor::DEFLATE,
+            SendMessage(&predictor, 100, 10));
+}
+
+TEST(WebSocketAdaptiveDeflatePredictorTest, SkipIncompressibleTraffic) {
+  WebSocketAdaptiveDeflatePredictor predictor(0);
+  for (int i = 0; i < 20; ++i)
+    SendMessage(&predictor, 1000, 1000);
+  EXPECT_LT(0.9, predictor.average_ratio());
+
+  // Skipped messages do not change the ratio, but one message in a while is
+  // deflated to notice when the traffic changes.
+  int deflated = 0;
+  for (int i = 0; i < 64; ++i) {
+    if (SendMessage(&predictor, 1000, 1000) ==
+        WebSocketDeflatePredictor::DEFLATE) {
+      ++deflated;
+    }
+  }
+  EXPECT_EQ(2, deflated);
+
+  while (SendMessage(&predictor, 1000, 100) !=
+         WebSocketDeflatePredictor::DEFLATE) {
+  }
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(WebSocketDeflatePredictor::DEFLATE,
+              SendMessage(&predictor, 1000, 100));
+  EXPECT_GT(0.9, predictor.average_ratio());
+}
+
+TEST(WebSocketAdaptiveDeflatePredictorTest, CompressionLevel) {
+  WebSocketAdaptiveDeflatePredictor predictor(0);
+  int default_level = predictor.compression_level();
+  for (int i = 0; i < 20; ++i)
+    SendMessage(&predictor, 1000, 100);
+  EXPECT_LT(predictor.compression_level(), default_level);
+
+  for (int i = 0; i < 20; ++i)
+    SendMessage(&predictor, 1000, 600);
+  EXPECT_EQ(default_level, predictor.compression_level());
+}
+
+}  // namespace net
@@ -4,11 +4,22 @@
 
 #include "net/server/web_socket_encoder.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "base/bind.h"
+#include "base/location.h"
 #include "base/logging.h"
+#include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
+#include "base/threading/worker_pool.h"
 #include "net/base/io_buffer.h"
+#include "net/server/web_socket_adaptive_deflate_predictor.h"
 #include "net/websockets/websocket_extension_parser.h"
+#include "net/websockets/websocket_frame.h"
 
 namespace net {
 
@@ -42,44 +53,98 @@ const size_t kMaxSingleBytePayloadLength = 125;
 const size_t kTwoBytePayloadLengthField = 126;
 const size_t kEightBytePayloadLengthField = 127;
 const size_t kMaskingKeyWidthInBytes = 4;
+const size_t kMaxFrameHeaderLength = 2 + 8 + kMaskingKeyWidthInBytes;
+
+// Outgoing messages are split into frames of at most this many payload bytes,
+// so that a frame never has to be buffered whole by an intermediary.
+const size_t kDefaultMaxFramePayloadLength = 1024 * 1024;
+// Longer incoming messages are refused, so that a peer cannot make the
+// encoder buffer continuation frames without bound.
+const size_t kDefaultMaxMessageSize = 64 * 1024 * 1024;
+
+// Messages shorter than this are not deflated by default.
+const size_t kDefaultDeflateMinSize = 512;
+// EncodeFrameAsync() deflates messages at least this long on a worker thread.
+const size_t kWorkerDeflateMinSize = 256 * 1024;
+// The level WebSocketDeflater is initialized with, Z_DEFAULT_COMPRESSION.
+const int kInitialCompressionLevel = -1;
+
+struct FrameHeader {
+  bool final;
+  bool reserved1;
+  OpCode op_code;
+  const char* masking_key;  // NULL if the frame is not masked.
+  const char* payload;
+  size_t payload_length;
+};
+
+// XORs |length| bytes of |source| with the masking key into |destination|,
+// which may be |source|. |key_offset| is the position in the payload of the
+// first byte, so that a payload can be masked in pieces. The bulk is done
+// eight bytes at a time with a key repeated to word width; memcpy keeps the
+// loads and stores free of alignment requirements and lets the compiler
+// vectorize the loop.
+void ApplyMask(const char* source,
+               char* destination,
+               size_t length,
+               const char* masking_key,
+               size_t key_offset) {
+  char key_bytes[8];
+  for (size_t i = 0; i < sizeof(key_bytes); ++i)
+    key_bytes[i] = masking_key[(key_offset + i) % kMaskingKeyWidthInBytes];
+  uint64 key;
+  memcpy(&key, key_bytes, sizeof(key));
+
+  size_t i = 0;
+  for (; i + sizeof(key) <= length; i += sizeof(key)) {
+    uint64 word;
+    memcpy(&word, source + i, sizeof(word));
+    word ^= key;
+    memcpy(destination + i, &word, sizeof(word));
+  }
+  for (; i < length; ++i)
+    destination[i] = source[i] ^ key_bytes[i % sizeof(key)];
+}
 
-WebSocket::ParseResult DecodeFrameHybi17(const base::StringPiece& frame,
-                                         bool client_frame,
-                                         int* bytes_consumed,
-                                         std::string* output,
-                                         bool* compressed) {
-  size_t data_length = frame.length();
+// Parses the frame at the start of |buffer|. On FRAME_OK, |header| points into
+// |buffer| and |frame_length| is the length of the whole frame. Ping and pong
+// frames are reported as errors since the server does not answer them.
+WebSocket::ParseResult ParseFrameHybi17(const base::StringPiece& buffer,
+                                        bool client_frame,
+                                        FrameHeader* header,
+                                        size_t* frame_length) {
+  size_t data_length = buffer.length();
   if (data_length < 2)
     return WebSocket::FRAME_INCOMPLETE;
 
-  const char* buffer_begin = const_cast<char*>(frame.data());
+  const char* buffer_begin = buffer.data();
   const char* p = buffer_begin;
   const char* buffer_end = p + data_length;
 
   unsigned char first_byte = *p++;
   unsigned char second_byte = *p++;
 
-  bool final = (first_byte & kFinalBit) != 0;
-  bool reserved1 = (first_byte & kReserved1Bit) != 0;
+  header->final = (first_byte & kFinalBit) != 0;
+  header->reserved1 = (first_byte & kReserved1Bit) != 0;
   bool reserved2 = (first_byte & kReserved2Bit) != 0;
   bool reserved3 = (first_byte & kReserved3Bit) != 0;
-  int op_code = first_byte & kOpCodeMask;
+  header->op_code = first_byte & kOpCodeMask;
   bool masked = (second_byte & kMaskBit) != 0;
-  *compressed = reserved1;
-  if (!final || reserved2 || reserved3)
+  if (reserved2 || reserved3)
     return WebSocket::FRAME_ERROR;  // Only compression extension is supported.
 
-  bool closed = false;
-  switch (op_code) {
+  switch (header->op_code) {
     case kOpCodeClose:
-      closed = true;
+      // Control frames must not be fragmented.
+      if (!header->final)
+        return WebSocket::FRAME_ERROR;
       break;
     case kOpCodeText:
+    case kOpCodeContinuation:
       break;
-    case kOpCodeBinary:        // We don't support binary frames yet.
-    case kOpCodeContinuation:  // We don't support binary frames yet.
-    case kOpCodePing:          // We don't support binary frames yet.
-    case kOpCodePong:          // We don't support binary frames yet.
+    case kOpCodeBinary:  // We don't support binary frames yet.
+    case kOpCodePing:    // We don't support ping and pong frames yet.
+    case kOpCodePong:
     default:
       return WebSocket::FRAME_ERROR;
   }
@@ -119,62 +184,125 @@ WebSocket::ParseResult DecodeFrameHybi17(const base::StringPiece& frame,
   if (static_cast<size_t>(buffer_end - p) < total_length)
     return WebSocket::FRAME_INCOMPLETE;
 
-  if (masked) {
-    output->resize(payload_length);
-    const char* masking_key = p;
-    char* payload = const_cast<char*>(p + kMaskingKeyWidthInBytes);
-    for (size_t i = 0; i < payload_length; ++i)  // Unmask the payload.
-      (*output)[i] = payload[i] ^ masking_key[i % kMaskingKeyWidthInBytes];
-  } else {
-    output->assign(p, p + payload_length);
-  }
+  header->masking_key = masked ? p : NULL;
+  header->payload = p + actual_masking_key_length;
+  header->payload_length = payload_length;
+  *frame_length = p + total_length - buffer_begin;
+  return WebSocket::FRAME_OK;
+}
 
-  size_t pos = p + actual_masking_key_length + payload_length - buffer_begin;
-  *bytes_consumed = pos;
-  return closed ? WebSocket::FRAME_CLOSE : WebSocket::FRAME_OK;
+size_t FrameHeaderLength(size_t payload_length, bool masked) {
+  size_t length = 2;
+  if (payload_length > 0xFFFF)
+    length += 8;
+  else if (payload_length > kMaxSingleBytePayloadLength)
+    length += 2;
+  return masked ? length + kMaskingKeyWidthInBytes : length;
 }
 
-void EncodeFrameHybi17(const std::string& message,
-                       int masking_key,
+// Appends a single frame to |output|. The header is written in place into
+// space grown once for the whole frame, and the payload is masked while it
+// is copied.
+void AppendFrameHybi17(const char* payload,
+                       size_t payload_length,
+                       OpCode op_code,
+                       bool final,
                        bool compressed,
+                       int masking_key,
                        std::string* output) {
-  std::vector<char> frame;
-  OpCode op_code = kOpCodeText;
-  size_t data_length = message.length();
-
-  int reserved1 = compressed ? kReserved1Bit : 0;
-  frame.push_back(kFinalBit | op_code | reserved1);
-  char mask_key_bit = masking_key != 0 ? kMaskBit : 0;
-  if (data_length <= kMaxSingleBytePayloadLength)
-    frame.push_back(data_length | mask_key_bit);
-  else if (data_length <= 0xFFFF) {
-    frame.push_back(kTwoBytePayloadLengthField | mask_key_bit);
-    frame.push_back((data_length & 0xFF00) >> 8);
-    frame.push_back(data_length & 0xFF);
+  bool masked = masking_key != 0;
+  size_t header_length = FrameHeaderLength(payload_length, masked);
+  size_t frame_start = output->size();
+  output->resize(frame_start + header_length + payload_length);
+  char* p = &(*output)[frame_start];
+
+  *p++ = (final ? kFinalBit : 0) | (compressed ? kReserved1Bit : 0) | op_code;
+  char mask_key_bit = masked ? kMaskBit : 0;
+  if (payload_length <= kMaxSingleBytePayloadLength) {
+    *p++ = payload_length | mask_key_bit;
+  } else if (payload_length <= 0xFFFF) {
+    *p++ = kTwoBytePayloadLengthField | mask_key_bit;
+    *p++ = (payload_length & 0xFF00) >> 8;
+    *p++ = payload_length & 0xFF;
   } else {
-    frame.push_back(kEightBytePayloadLengthField | mask_key_bit);
-    char extended_payload_length[8];
-    size_t remaining = data_length;
-    // Fill the length into extended_payload_length in the network byte order.
-    for (int i = 0; i < 8; ++i) {
-      extended_payload_length[7 - i] = remaining & 0xFF;
+    *p++ = kEightBytePayloadLengthField | mask_key_bit;
+    // Fill the length in the network byte order.
+    uint64 remaining = payload_length;
+    for (int i = 7; i >= 0; --i) {
+      p[i] = remaining & 0xFF;
       remaining >>= 8;
     }
-    frame.insert(frame.end(), extended_payload_length,
-                 extended_payload_length + 8);
-    DCHECK(!remaining);
+    p += 8;
   }
 
-  const char* data = const_cast<char*>(message.data());
-  if (masking_key != 0) {
-    const char* mask_bytes = reinterpret_cast<char*>(&masking_key);
-    frame.insert(frame.end(), mask_bytes, mask_bytes + 4);
-    for (size_t i = 0; i < data_length; ++i)  // Mask the payload.
-      frame.push_back(data[i] ^ mask_bytes[i % kMaskingKeyWidthInBytes]);
-  } else {
-    frame.insert(frame.end(), data, data + data_length);
+  if (masked) {
+    const char* mask_bytes = reinterpret_cast<const char*>(&masking_key);
+    memcpy(p, mask_bytes, kMaskingKeyWidthInBytes);
+    p += kMaskingKeyWidthInBytes;
+    ApplyMask(payload, p, payload_length, mask_bytes, 0);
+  } else if (payload_length) {
+    memcpy(p, payload, payload_length);
   }
-  *output = std::string(&frame[0], frame.size());
+}
+
+// Appends |message| to |output| as one text message, split into frames of at
+// most |max_frame_payload| bytes. Only the first frame carries the RSV1 bit.
+void EncodeMessageHybi17(const base::StringPiece& message,
+                         int masking_key,
+                         bool compressed,
+                         size_t max_frame_payload,
+                         std::string* output) {
+  size_t length = message.length();
+  size_t frame_count =
+      length ? (length + max_frame_payload - 1) / max_frame_payload : 1;
+  output->reserve(output->size() + length + frame_count * kMaxFrameHeaderLength);
+
+  size_t offset = 0;
+  OpCode op_code = kOpCodeText;
+  do {
+    size_t frame_length = std::min(max_frame_payload, length - offset);
+    bool final = offset + frame_length == length;
+    AppendFrameHybi17(message.data() + offset, frame_length, op_code, final,
+                      compressed && op_code == kOpCodeText, masking_key,
+                      output);
+    offset += frame_length;
+    op_code = kOpCodeContinuation;
+  } while (offset < length);
+}
+
+// Returns false if deflating failed, in which case the message is sent as is.
+bool DeflateMessage(WebSocketDeflater* deflater,
+                    const std::string& message,
+                    std::string* output) {
+  if (!deflater->AddBytes(message.data(), message.length())) {
+    deflater->Finish();
+    return false;
+  }
+  if (!deflater->Finish())
+    return false;
+  scoped_refptr<IOBufferWithSize> buffer =
+      deflater->GetOutput(deflater->CurrentOutputSize());
+  if (!buffer.get())
+    return false;
+  *output = std::string(buffer->data(), buffer->size());
+  return true;
+}
+
+// The frame a message is sent in, as seen by the deflate predictor. |data|
+// may be null since the predictor only looks at the header.
+WebSocketFrame* CreateTextFrame(const char* data, size_t length, bool deflated) {
+  WebSocketFrame* frame = new WebSocketFrame(WebSocketFrameHeader::kOpCodeText);
+  frame->header.final = true;
+  frame->header.reserved1 = deflated;
+  frame->header.payload_length = length;
+  if (data)
+    frame->data = new WrappedIOBuffer(data);
+  return frame;
+}
+
+base::TimeTicks ThreadCpuNow() {
+  return base::TimeTicks::IsThreadNowSupported() ? base::TimeTicks::ThreadNow()
+                                                 : base::TimeTicks::Now();
 }
 
 }  // anonymous namespace
@@ -293,14 +421,44 @@ void WebSocketEncoder::ParseExtensions(const std::string& header_value,
   }
 }
 
-WebSocketEncoder::WebSocketEncoder(bool is_server) : is_server_(is_server) {
+WebSocketEncoder::DeflateStats::DeflateStats()
+    : messages(0), deflated_messages(0), input_bytes(0), output_bytes(0) {
+}
+
+// Owned by the reply closure; the deflater is handed back when it runs.
+struct WebSocketEncoder::DeflateJob {
+  scoped_ptr<WebSocketDeflater> deflater;
+  std::string message;
+  int masking_key;
+  EncodeCallback callback;
+  std::string compressed;
+  bool deflated;
+  base::TimeDelta cpu_time;
+};
+
+WebSocketEncoder::WebSocketEncoder(bool is_server)
+    : is_server_(is_server),
+      max_frame_payload_(kDefaultMaxFramePayloadLength),
+      max_message_size_(kDefaultMaxMessageSize),
+      compression_level_(kInitialCompressionLevel),
+      deflate_job_running_(false),
+      in_fragmented_message_(false),
+      fragmented_message_compressed_(false),
+      weak_factory_(this) {
 }
 
 WebSocketEncoder::WebSocketEncoder(bool is_server,
                                    int deflate_bits,
                                    int inflate_bits,
                                    bool no_context_takeover)
-    : is_server_(is_server) {
+    : is_server_(is_server),
+      max_frame_payload_(kDefaultMaxFramePayloadLength),
+      max_message_size_(kDefaultMaxMessageSize),
+      compression_level_(kInitialCompressionLevel),
+      deflate_job_running_(false),
+      in_fragmented_message_(false),
+      fragmented_message_compressed_(false),
+      weak_factory_(this) {
   deflater_.reset(new WebSocketDeflater(
       no_context_takeover ? WebSocketDeflater::DO_NOT_TAKE_OVER_CONTEXT
                           : WebSocketDeflater::TAKE_OVER_CONTEXT));
@@ -312,37 +470,267 @@ WebSocketEncoder::WebSocketEncoder(bool is_server,
     // Disable deflate support.
     deflater_.reset();
     inflater_.reset();
+    return;
   }
+  predictor_.reset(
+      new WebSocketAdaptiveDeflatePredictor(kDefaultDeflateMinSize));
 }
 
 WebSocketEncoder::~WebSocketEncoder() {
+  DVLOG(1) << "WebSocket deflated " << deflate_stats_.deflated_messages
+           << " of " << deflate_stats_.messages << " messages, "
+           << deflate_stats_.input_bytes << " to "
+           << deflate_stats_.output_bytes << " bytes in "
+           << deflate_stats_.cpu_time.InMillisecondsF() << " ms";
+}
+
+size_t WebSocketEncoder::deflate_min_size() const {
+  return predictor_ ? predictor_->min_size() : 0;
+}
+
+void WebSocketEncoder::set_deflate_min_size(size_t size) {
+  if (predictor_)
+    predictor_->set_min_size(size);
 }
 
 WebSocket::ParseResult WebSocketEncoder::DecodeFrame(
     const base::StringPiece& frame,
     int* bytes_consumed,
     std::string* output) {
-  bool compressed;
-  WebSocket::ParseResult result =
-      DecodeFrameHybi17(frame, is_server_, bytes_consumed, output, &compressed);
-  if (result == WebSocket::FRAME_OK && compressed) {
-    if (!Inflate(output))
-      result = WebSocket::FRAME_ERROR;
+  *bytes_consumed = 0;
+  size_t consumed = 0;
+  while (true) {
+    base::StringPiece remaining = frame.substr(consumed);
+    FrameHeader header;
+    size_t frame_length;
+    WebSocket::ParseResult result =
+        ParseFrameHybi17(remaining, is_server_, &header, &frame_length);
+    if (result != WebSocket::FRAME_OK)
+      return result;
+    consumed += frame_length;
+
+    if (header.op_code == kOpCodeClose) {
+      *bytes_consumed = consumed;
+      return WebSocket::FRAME_CLOSE;
+    }
+
+    bool continuation = header.op_code == kOpCodeContinuation;
+    if (continuation != in_fragmented_message_)
+      return WebSocket::FRAME_ERROR;
+    // Per-message compression is signalled on the first frame only.
+    if (continuation && header.reserved1)
+      return WebSocket::FRAME_ERROR;
+
+    if (fragmented_message_.size() + header.payload_length >
+        max_message_size_) {
+      in_fragmented_message_ = false;
+      fragmented_message_.clear();
+      return WebSocket::FRAME_MESSAGE_TOO_BIG;
+    }
+
+    if (!in_fragmented_message_ && header.final) {
+      // The common case: the whole message is in one frame, so unmask it
+      // straight into |output|.
+      if (header.masking_key) {
+        output->resize(header.payload_length);
+        ApplyMask(header.payload, string_as_array(output),
+                  header.payload_length, header.masking_key, 0);
+      } else {
+        output->assign(header.payload, header.payload_length);
+      }
+      *bytes_consumed = consumed;
+      bool too_big = false;
+      if (header.reserved1 && !Inflate(output, &too_big)) {
+        return too_big ? WebSocket::FRAME_MESSAGE_TOO_BIG
+                       : WebSocket::FRAME_ERROR;
+      }
+      return WebSocket::FRAME_OK;
+    }
+
+    if (!in_fragmented_message_) {
+      in_fragmented_message_ = true;
+      fragmented_message_compressed_ = header.reserved1;
+      fragmented_message_.clear();
+    }
+    size_t message_length = fragmented_message_.size();
+    fragmented_message_.resize(message_length + header.payload_length);
+    if (header.masking_key) {
+      ApplyMask(header.payload, &fragmented_message_[message_length],
+                header.payload_length, header.masking_key, 0);
+    } else if (header.payload_length) {
+      memcpy(&fragmented_message_[message_length], header.payload,
+             header.payload_length);
+    }
+    // Fragments already copied out are consumed even if the message is not
+    // complete yet, so that they are not parsed again.
+    *bytes_consumed = consumed;
+    if (!header.final)
+      continue;
+
+    in_fragmented_message_ = false;
+    output->swap(fragmented_message_);
+    fragmented_message_.clear();
+    bool too_big = false;
+    if (fragmented_message_compressed_ && !Inflate(output, &too_big)) {
+      return too_big ? WebSocket::FRAME_MESSAGE_TOO_BIG
+                     : WebSocket::FRAME_ERROR;
+    }
+    return WebSocket::FRAME_OK;
   }
-  return result;
 }
 
 void WebSocketEncoder::EncodeFrame(const std::string& frame,
                                    int masking_key,
                                    std::string* output) {
+  // The deflater belongs to the running job.
+  CHECK(!deflate_job_running_);
+  EncodeMessage(frame, masking_key, ShouldDeflate(frame), output);
+}
+
+void WebSocketEncoder::EncodeFrameAsync(const std::string& frame,
+                                        int masking_key,
+                                        const EncodeCallback& callback) {
+  if (deflate_job_running_) {
+    pending_messages_.push_back(PendingMessage());
+    PendingMessage& pending = pending_messages_.back();
+    pending.message = frame;
+    pending.masking_key = masking_key;
+    pending.callback = callback;
+    return;
+  }
+  EncodeFrameOrStartDeflateJob(frame, masking_key, callback);
+}
+
+bool WebSocketEncoder::EncodeFrameOrStartDeflateJob(
+    const std::string& frame,
+    int masking_key,
+    const EncodeCallback& callback) {
+  bool deflate = ShouldDeflate(frame);
+  if (!deflate || frame.length() < kWorkerDeflateMinSize) {
+    std::string encoded;
+    EncodeMessage(frame, masking_key, deflate, &encoded);
+    callback.Run(encoded);
+    return true;
+  }
+
+  // The deflater moves to the job, so no other message can be encoded until
+  // it comes back.
+  DeflateJob* job = new DeflateJob;
+  job->deflater = deflater_.Pass();
+  job->message = frame;
+  job->masking_key = masking_key;
+  job->callback = callback;
+  job->deflated = false;
+  deflate_job_running_ = true;
+  base::WorkerPool::PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&WebSocketEncoder::RunDeflateJob, base::Unretained(job)),
+      base::Bind(&WebSocketEncoder::DidRunDeflateJob,
+                 weak_factory_.GetWeakPtr(), base::Owned(job)),
+      true /* task_is_slow */);
+  return false;
+}
+
+// static
+void WebSocketEncoder::RunDeflateJob(DeflateJob* job) {
+  base::TimeTicks start = ThreadCpuNow();
+  job->deflated =
+      DeflateMessage(job->deflater.get(), job->message, &job->compressed);
+  job->cpu_time = ThreadCpuNow() - start;
+}
+
+void WebSocketEncoder::DidRunDeflateJob(DeflateJob* job) {
+  deflater_ = job->deflater.Pass();
+  deflate_job_running_ = false;
+
+  const std::string& payload = job->deflated ? job->compressed : job->message;
+  DidWriteMessage(job->message.length(), payload.length(), job->deflated,
+                  job->cpu_time);
+  std::string encoded;
+  EncodeMessageHybi17(payload, job->masking_key, job->deflated,
+                      max_frame_payload_, &encoded);
+  job->callback.Run(encoded);
+
+  while (!pending_messages_.empty()) {
+    PendingMessage pending;
+    pending.message.swap(pending_messages_.front().message);
+    pending.masking_key = pending_messages_.front().masking_key;
+    pending.callback = pending_messages_.front().callback;
+    pending_messages_.pop_front();
+    if (!EncodeFrameOrStartDeflateJob(pending.message, pending.masking_key,
+                                      pending.callback)) {
+      break;
+    }
+  }
+}
+
+void WebSocketEncoder::EncodeMessage(const std::string& frame,
+                                     int masking_key,
+                                     bool deflate,
+                                     std::string* output) {
+  output->clear();
   std::string compressed;
-  if (Deflate(frame, &compressed))
-    EncodeFrameHybi17(compressed, masking_key, true, output);
-  else
-    EncodeFrameHybi17(frame, masking_key, false, output);
+  if (deflate) {
+    base::TimeTicks start = ThreadCpuNow();
+    bool deflated = DeflateMessage(deflater_.get(), frame, &compressed);
+    DidWriteMessage(frame.length(),
+                    deflated ? compressed.length() : frame.length(), deflated,
+                    ThreadCpuNow() - start);
+    if (deflated) {
+      EncodeMessageHybi17(compressed, masking_key, true, max_frame_payload_,
+                          output);
+      return;
+    }
+  } else {
+    DidWriteMessage(frame.length(), frame.length(), false, base::TimeDelta());
+  }
+  EncodeMessageHybi17(frame, masking_key, false, max_frame_payload_, output);
+}
+
+bool WebSocketEncoder::ShouldDeflate(const std::string& message) {
+  if (!predictor_)
+    return false;
+  ScopedVector<WebSocketFrame> frames;
+  frames.push_back(CreateTextFrame(message.data(), message.length(), false));
+  bool deflate =
+      predictor_->Predict(frames, 0) != WebSocketDeflatePredictor::DO_NOT_DEFLATE;
+  predictor_->RecordInputDataFrame(frames[0]);
+  if (deflate && message.length()) {
+    int level = predictor_->compression_level();
+    if (level != compression_level_ && deflater_->SetCompressionLevel(level))
+      compression_level_ = level;
+  }
+  return deflate;
+}
+
+void WebSocketEncoder::DidWriteMessage(size_t length,
+                                       size_t written_length,
+                                       bool deflated,
+                                       base::TimeDelta cpu_time) {
+  ++deflate_stats_.messages;
+  if (deflated) {
+    ++deflate_stats_.deflated_messages;
+    deflate_stats_.input_bytes += length;
+    deflate_stats_.output_bytes += written_length;
+  }
+  deflate_stats_.cpu_time += cpu_time;
+  if (predictor_) {
+    scoped_ptr<WebSocketFrame> frame(
+        CreateTextFrame(NULL, written_length, deflated));
+    predictor_->RecordWrittenDataFrame(frame.get());
+  }
 }
 
-bool WebSocketEncoder::Inflate(std::string* message) {
+void WebSocketEncoder::EncodeCloseFrame(uint16 status_code,
+                                        int masking_key,
+                                        std::string* output) {
+  char payload[2] = {static_cast<char>(status_code >> 8),
+                     static_cast<char>(status_code & 0xFF)};
+  AppendFrameHybi17(payload, sizeof(payload), kOpCodeClose, true, false,
+                    masking_key, output);
+}
+
+bool WebSocketEncoder::Inflate(std::string* message, bool* too_big) {
   if (!inflater_)
     return false;
   if (!inflater_->AddBytes(message->data(), message->length()))
@@ -356,6 +744,10 @@ bool WebSocketEncoder::Inflate(std::string* message) {
         inflater_->GetOutput(inflater_->CurrentOutputSize());
     if (!chunk.get())
       return false;
+    if (output.size() + chunk->size() > max_message_size_) {
+      *too_big = true;
+      return false;
+    }
     output.insert(output.end(), chunk->data(), chunk->data() + chunk->size());
   }
 
@@ -364,22 +756,4 @@ bool WebSocketEncoder::Inflate(std::string* message) {
   return true;
 }
 
-bool WebSocketEncoder::Deflate(const std::string& message,
-                               std::string* output) {
-  if (!deflater_)
-    return false;
-  if (!deflater_->AddBytes(message.data(), message.length())) {
-    deflater_->Finish();
-    return false;
-  }
-  if (!deflater_->Finish())
-    return false;
-  scoped_refptr<IOBufferWithSize> buffer =
-      deflater_->GetOutput(deflater_->CurrentOutputSize());
-  if (!buffer.get())
-    return false;
-  *output = std::string(buffer->data(), buffer->size());
-  return true;
-}
-
 }  // namespace net
@@ -5,19 +5,41 @@
 #ifndef NET_SERVER_WEB_SOCKET_ENCODER_H_
 #define NET_SERVER_WEB_SOCKET_ENCODER_H_
 
+#include <deque>
 #include <string>
 
 #include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "base/strings/string_piece.h"
+#include "base/time/time.h"
 #include "net/server/web_socket.h"
 #include "net/websockets/websocket_deflater.h"
 #include "net/websockets/websocket_inflater.h"
 
 namespace net {
 
+class WebSocketAdaptiveDeflatePredictor;
+
 class WebSocketEncoder {
  public:
+  typedef base::Callback<void(const std::string& encoded)> EncodeCallback;
+
+  // What permessage-deflate did for the messages sent so far.
+  struct DeflateStats {
+    DeflateStats();
+
+    int64 messages;
+    int64 deflated_messages;
+    // Sizes of the deflated messages before and after deflating.
+    int64 input_bytes;
+    int64 output_bytes;
+    // Thread time spent deflating, on whichever thread did it.
+    base::TimeDelta cpu_time;
+  };
+
   ~WebSocketEncoder();
 
   static WebSocketEncoder* CreateServer(const std::string& request_extensions,
@@ -26,14 +48,54 @@ class WebSocketEncoder {
   static const char kClientExtensions[];
   static WebSocketEncoder* CreateClient(const std::string& response_extensions);
 
+  // Decodes the message at the start of |frame|. A message may be split
+  // into continuation frames; complete fragments are buffered in the encoder
+  // and counted in |bytes_consumed| even when FRAME_INCOMPLETE is returned,
+  // and must be dropped from the input by the caller in that case too.
+  // Returns FRAME_MESSAGE_TOO_BIG once a message, inflated or not, grows
+  // beyond max_message_size().
   WebSocket::ParseResult DecodeFrame(const base::StringPiece& frame,
                                      int* bytes_consumed,
                                      std::string* output);
 
+  // Encodes |frame| as one text message, split into frames of at most
+  // max_frame_payload() bytes each. Must not be called while a message
+  // passed to EncodeFrameAsync() is being deflated.
   void EncodeFrame(const std::string& frame,
                    int masking_key,
                    std::string* output);
 
+  // Like EncodeFrame(), but messages large enough to be worth it are deflated
+  // on a worker thread and |callback| is run later. Messages passed in the
+  // meantime are held back so that callbacks run in order. Callbacks are not
+  // run once the encoder is destroyed. Must be called on a thread with a
+  // message loop.
+  void EncodeFrameAsync(const std::string& frame,
+                        int masking_key,
+                        const EncodeCallback& callback);
+
+  // Appends a close frame carrying |status_code| to |output|.
+  void EncodeCloseFrame(uint16 status_code,
+                        int masking_key,
+                        std::string* output);
+
+  size_t max_frame_payload() const { return max_frame_payload_; }
+  void set_max_frame_payload_for_testing(size_t max_frame_payload) {
+    DCHECK(max_frame_payload);
+    max_frame_payload_ = max_frame_payload;
+  }
+
+  size_t max_message_size() const { return max_message_size_; }
+  void set_max_message_size_for_testing(size_t max_message_size) {
+    max_message_size_ = max_message_size;
+  }
+
+  // Messages shorter than this are never deflated.
+  size_t deflate_min_size() const;
+  void set_deflate_min_size(size_t size);
+
+  const DeflateStats& deflate_stats() const { return deflate_stats_; }
+
  private:
   explicit WebSocketEncoder(bool is_server);
   WebSocketEncoder(bool is_server,
@@ -65,12 +127,54 @@ class WebSocketEncoder {
                               bool* client_no_context_takeover,
                               bool* server_no_context_takeover);
 
-  bool Inflate(std::string* message);
-  bool Deflate(const std::string& message, std::string* output);
-
+  struct PendingMessage {
+    std::string message;
+    int masking_key;
+    EncodeCallback callback;
+  };
+  struct DeflateJob;
+
+  // Sets |*too_big| if the inflated message would exceed max_message_size().
+  bool Inflate(std::string* message, bool* too_big);
+
+  // Asks the predictor whether |message| should be deflated, and if so sets
+  // the compression level it should be deflated with.
+  bool ShouldDeflate(const std::string& message);
+  void EncodeMessage(const std::string& frame,
+                     int masking_key,
+                     bool deflate,
+                     std::string* output);
+  // Accounts a message that has been deflated or not.
+  void DidWriteMessage(size_t length,
+                       size_t written_length,
+                       bool deflated,
+                       base::TimeDelta cpu_time);
+  // Encodes |frame|, or returns false after starting to deflate it on a
+  // worker thread.
+  bool EncodeFrameOrStartDeflateJob(const std::string& frame,
+                                    int masking_key,
+                                    const EncodeCallback& callback);
+  static void RunDeflateJob(DeflateJob* job);
+  void DidRunDeflateJob(DeflateJob* job);
+
+  // Null while a deflate job owns it.
   scoped_ptr<WebSocketDeflater> deflater_;
   scoped_ptr<WebSocketInflater> inflater_;
+  scoped_ptr<WebSocketAdaptiveDeflatePredictor> predictor_;
   bool is_server_;
+  size_t max_frame_payload_;
+  size_t max_message_size_;
+  int compression_level_;
+  bool deflate_job_running_;
+  std::deque<PendingMessage> pending_messages_;
+  DeflateStats deflate_stats_;
+
+  // The payload received so far of a message split into several frames.
+  std::string fragmented_message_;
+  bool in_fragmented_message_;
+  bool fragmented_message_compressed_;
+
+  base::WeakPtrFactory<WebSocketEncoder> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(WebSocketEncoder);
 };
@@ -3,10 +3,30 @@
 // found in the LICENSE file.
 
 #include "net/server/web_socket_encoder.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace net {
 
+namespace {
+
+void AppendEncoded(std::vector<std::string>* encoded,
+                   size_t expected_count,
+                   const base::Closure& done,
+                   const std::string& frame) {
+  encoded->push_back(frame);
+  if (encoded->size() == expected_count)
+    done.Run();
+}
+
+}  // namespace
+
 TEST(WebSocketEncoderHandshakeTest,
      CreateServerWithoutClientMaxWindowBitsParameter) {
   std::string response_extensions;
@@ -58,6 +78,9 @@ class WebSocketEncoderCompressionTest : public WebSocketEncoderTest {
         "client_max_window_bits=15",
         response_extensions);
     client_.reset(WebSocketEncoder::CreateClient(response_extensions));
+    // Deflate even the short messages used below.
+    server_->set_deflate_min_size(0);
+    client_->set_deflate_min_size(0);
   }
 };
 
@@ -117,6 +140,105 @@ TEST_F(WebSocketEncoderTest, ServerToClient) {
       client_->DecodeFrame(std::string("abcde"), &bytes_consumed, &decoded));
 }
 
+TEST_F(WebSocketEncoderTest, MaskedPayloadLengths) {
+  // Covers the word-wide masking loop and its byte-wise tail.
+  int mask = 0x12345678;
+  std::string frame;
+  for (int length = 0; length < 40; ++length) {
+    std::string encoded;
+    int bytes_consumed;
+    std::string decoded;
+    client_->EncodeFrame(frame, mask, &encoded);
+    EXPECT_EQ(WebSocket::FRAME_OK,
+              server_->DecodeFrame(encoded, &bytes_consumed, &decoded));
+    EXPECT_EQ(frame, decoded);
+    EXPECT_EQ((int)encoded.length(), bytes_consumed);
+    frame += (char)('a' + length);
+  }
+}
+
+TEST_F(WebSocketEncoderTest, FragmentedClientToServer) {
+  std::string frame("FragmentedClientToServer");
+  int mask = 123456;
+  std::string encoded;
+  int bytes_consumed;
+  std::string decoded;
+
+  client_->set_max_frame_payload_for_testing(7);
+  client_->EncodeFrame(frame, mask, &encoded);
+  EXPECT_EQ(WebSocket::FRAME_OK,
+            server_->DecodeFrame(encoded, &bytes_consumed, &decoded));
+  EXPECT_EQ(frame, decoded);
+  EXPECT_EQ((int)encoded.length(), bytes_consumed);
+
+  // Each frame carries 7 bytes of payload behind a 6 byte header. Complete
+  // fragments are consumed even though the message is not done yet.
+  std::string partial = encoded.substr(0, 20);
+  EXPECT_EQ(WebSocket::FRAME_INCOMPLETE,
+            server_->DecodeFrame(partial, &bytes_consumed, &decoded));
+  EXPECT_EQ(13, bytes_consumed);
+  EXPECT_EQ(WebSocket::FRAME_OK,
+            server_->DecodeFrame(encoded.substr(13), &bytes_consumed,
+                                 &decoded));
+  EXPECT_EQ(frame, decoded);
+  EXPECT_EQ((int)encoded.length() - 13, bytes_consumed);
+}
+
+TEST_F(WebSocketEncoderTest, UnexpectedContinuation) {
+  // Two frames of six bytes behind a two byte header: a text frame that
+  // starts the message and a continuation that ends it.
+  std::string encoded;
+  server_->set_max_frame_payload_for_testing(6);
+  server_->EncodeFrame("ServerClient", 0, &encoded);
+  std::string first = encoded.substr(0, 8);
+  std::string continuation = encoded.substr(8);
+
+  int bytes_consumed;
+  std::string decoded;
+  EXPECT_EQ(WebSocket::FRAME_ERROR,
+            client_->DecodeFrame(first + first, &bytes_consumed, &decoded));
+
+  scoped_ptr<WebSocketEncoder> client(WebSocketEncoder::CreateClient(""));
+  EXPECT_EQ(WebSocket::FRAME_ERROR,
+            client->DecodeFrame(continuation, &bytes_consumed, &decoded));
+}
+
+TEST_F(WebSocketEncoderTest, MessageTooBig) {
+  std::string frame("FragmentedClientToServer");
+  int mask = 123456;
+  std::string encoded;
+  int bytes_consumed;
+  std::string decoded;
+
+  server_->set_max_message_size_for_testing(frame.length());
+  client_->set_max_frame_payload_for_testing(7);
+  client_->EncodeFrame(frame, mask, &encoded);
+  EXPECT_EQ(WebSocket::FRAME_OK,
+            server_->DecodeFrame(encoded, &bytes_consumed, &decoded));
+  EXPECT_EQ(frame, decoded);
+
+  // The fragments are refused as soon as they add up to more than the limit.
+  client_->EncodeFrame(frame + "!", mask, &encoded);
+  EXPECT_EQ(WebSocket::FRAME_MESSAGE_TOO_BIG,
+            server_->DecodeFrame(encoded, &bytes_consumed, &decoded));
+
+  server_->set_max_message_size_for_testing(4);
+  client_->EncodeFrame("short", mask, &encoded);
+  EXPECT_EQ(WebSocket::FRAME_MESSAGE_TOO_BIG,
+            server_->DecodeFrame(encoded, &bytes_consumed, &decoded));
+}
+
+TEST_F(WebSocketEncoderTest, EncodeCloseFrame) {
+  std::string encoded;
+  server_->EncodeCloseFrame(1009, 0, &encoded);
+  EXPECT_EQ(std::string("\x88\x02\x03\xF1", 4), encoded);
+
+  int bytes_consumed;
+  std::string decoded;
+  EXPECT_EQ(WebSocket::FRAME_CLOSE,
+            client_->DecodeFrame(encoded, &bytes_consumed, &decoded));
+}
+
 TEST_F(WebSocketEncoderCompressionTest, ClientToServer) {
   std::string frame("CompressionCompressionCompressionCompression");
   int mask = 654321;
@@ -147,6 +269,21 @@ TEST_F(WebSocketEncoderCompressionTest, ServerToClient) {
   EXPECT_EQ((int)encoded.length(), bytes_consumed);
 }
 
+TEST_F(WebSocketEncoderCompressionTest, InflatedMessageTooBig) {
+  // Deflates to far less than the limit, but inflates to more.
+  std::string frame(1000, 'a');
+  int mask = 654321;
+  std::string encoded;
+  int bytes_consumed;
+  std::string decoded;
+
+  server_->set_max_message_size_for_testing(100);
+  client_->EncodeFrame(frame, mask, &encoded);
+  EXPECT_LT(encoded.length(), 100u);
+  EXPECT_EQ(WebSocket::FRAME_MESSAGE_TOO_BIG,
+            server_->DecodeFrame(encoded, &bytes_consumed, &decoded));
+}
+
 TEST_F(WebSocketEncoderCompressionTest, LongFrame) {
   int length = 1000000;
   std::string temp;
@@ -172,6 +309,66 @@ TEST_F(WebSocketEncoderCompressionTest, LongFrame) {
             client_->DecodeFrame(encoded, &bytes_consumed, &decoded));
   EXPECT_EQ(frame, decoded);
   EXPECT_EQ((int)encoded.length(), bytes_consumed);
+
+  EXPECT_EQ(1, server_->deflate_stats().deflated_messages);
+  EXPECT_EQ(length, server_->deflate_stats().input_bytes);
+  EXPECT_LT(server_->deflate_stats().output_bytes,
+            server_->deflate_stats().input_bytes);
+
+  // The compressed payload is split into continuation frames.
+  server_->set_max_frame_payload_for_testing(4096);
+  server_->EncodeFrame(frame, mask, &encoded);
+  EXPECT_EQ(WebSocket::FRAME_OK,
+            client_->DecodeFrame(encoded, &bytes_consumed, &decoded));
+  EXPECT_EQ(frame, decoded);
+  EXPECT_EQ((int)encoded.length(), bytes_consumed);
+}
+
+TEST_F(WebSocketEncoderCompressionTest, ShortMessageNotDeflated) {
+  std::string frame("CompressionCompressionCompressionCompression");
+  int mask = 0;
+  std::string encoded;
+  int bytes_consumed;
+  std::string decoded;
+
+  server_->set_deflate_min_size(frame.length() + 1);
+  server_->EncodeFrame(frame, mask, &encoded);
+  EXPECT_EQ(frame.length() + 2, encoded.length());
+  EXPECT_EQ(WebSocket::FRAME_OK,
+            client_->DecodeFrame(encoded, &bytes_consumed, &decoded));
+  EXPECT_EQ(frame, decoded);
+  EXPECT_EQ(1, server_->deflate_stats().messages);
+  EXPECT_EQ(0, server_->deflate_stats().deflated_messages);
+}
+
+TEST_F(WebSocketEncoderCompressionTest, EncodeFrameAsync) {
+  base::MessageLoop message_loop;
+  std::string large;
+  for (int i = 0; i < 100000; ++i)
+    large += base::IntToString(i);
+  std::string small("CompressionCompressionCompressionCompression");
+
+  // The large message is deflated on a worker thread, and the small one must
+  // not overtake it.
+  std::vector<std::string> encoded;
+  base::RunLoop run_loop;
+  server_->EncodeFrameAsync(
+      large, 0, base::Bind(&AppendEncoded, &encoded, 2, run_loop.QuitClosure()));
+  server_->EncodeFrameAsync(
+      small, 0, base::Bind(&AppendEncoded, &encoded, 2, run_loop.QuitClosure()));
+  EXPECT_TRUE(encoded.empty());
+  run_loop.Run();
+
+  ASSERT_EQ(2u, encoded.size());
+  int bytes_consumed;
+  std::string decoded;
+  EXPECT_EQ(WebSocket::FRAME_OK,
+            client_->DecodeFrame(encoded[0], &bytes_consumed, &decoded));
+  EXPECT_EQ(large, decoded);
+  EXPECT_EQ(WebSocket::FRAME_OK,
+            client_->DecodeFrame(encoded[1], &bytes_consumed, &decoded));
+  EXPECT_EQ(small, decoded);
+  EXPECT_EQ(2, server_->deflate_stats().deflated_messages);
 }
 
 }  // namespace net
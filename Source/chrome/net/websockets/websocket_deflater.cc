@@ -90,6 +90,18 @@ bool WebSocketDeflater::Finish() {
   return true;
 }
 
+bool WebSocketDeflater::SetCompressionLevel(int level) {
+  DCHECK(!are_bytes_added_);
+  stream_->next_in = NULL;
+  stream_->avail_in = 0;
+  stream_->next_out = reinterpret_cast<Bytef*>(&fixed_buffer_[0]);
+  stream_->avail_out = fixed_buffer_.size();
+  int result = deflateParams(stream_.get(), level, Z_DEFAULT_STRATEGY);
+  size_t size = fixed_buffer_.size() - stream_->avail_out;
+  buffer_.insert(buffer_.end(), &fixed_buffer_[0], &fixed_buffer_[0] + size);
+  return result == Z_OK;
+}
+
 void WebSocketDeflater::PushSyncMark() {
   DCHECK(!are_bytes_added_);
   const char data[] = {'\x00', '\x00', '\xff', '\xff'};
@@ -46,6 +46,12 @@ class NET_EXPORT_PRIVATE WebSocketDeflater {
   // Returns true if there is no error and false otherwise.
   bool Finish();
 
+  // Changes the zlib compression level used for the following messages.
+  // Must be called between messages, right before adding the bytes of a
+  // non-empty one, since zlib may flush a block boundary into the output.
+  // Returns true if there is no error and false otherwise.
+  bool SetCompressionLevel(int level);
+
   // Pushes "\x00\x00\xff\xff" to the end of the buffer.
   void PushSyncMark();
 
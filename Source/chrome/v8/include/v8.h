@@ -2818,6 +2818,13 @@ class V8_EXPORT Object : public Value {
   /** Tests for an index lookup interceptor.*/
   bool HasIndexedLookupInterceptor();
 
+  /**
+   * Returns true if the elements of this object are all plain data
+   * properties with default attributes, so that they can be read with Get()
+   * without calling accessors. Returns false if that is not known.
+   */
+  bool HasPlainDataElements();
+
   /**
    * Turns on access check on the object if the object is an instance of
    * a template that has access check callbacks. If an object has no
@@ -4865,6 +4872,15 @@ typedef void (*GCEpilogueCallback)(GCType type, GCCallbackFlags flags);
 
 typedef void (*InterruptCallback)(Isolate* isolate, void* data);
 
+/**
+ * GCEventCallback is invoked on the isolate's thread after a garbage
+ * collection has been recorded in the GC history, see
+ * Isolate::SetGCEventCallback. The garbage collection is still in progress at
+ * this point, so the callback must neither allocate on the V8 heap nor call
+ * into JavaScript.
+ */
+typedef void (*GCEventCallback)(Isolate* isolate, void* data);
+
 
 /**
  * Collection of V8 heap information.
@@ -4933,6 +4949,55 @@ class V8_EXPORT HeapObjectStatistics {
 };
 
 
+/**
+ * Timing and size information about one completed garbage collection.
+ *
+ * Instances of this class can be passed to Isolate::GetGCEventStatistics to
+ * read an entry of the GC history. Times are in milliseconds of the
+ * platform's monotonic clock. All strings are statically allocated.
+ */
+class V8_EXPORT GCEventStatistics {
+ public:
+  GCEventStatistics();
+  size_t gc_id() { return gc_id_; }
+  GCType gc_type() { return gc_type_; }
+  bool incremental() { return incremental_; }
+  const char* gc_reason() { return gc_reason_; }
+  double start_time() { return start_time_; }
+  double pause_duration() { return pause_duration_; }
+  size_t promoted_bytes() { return promoted_bytes_; }
+  size_t survived_bytes() { return survived_bytes_; }
+  size_t heap_size_before() { return heap_size_before_; }
+  size_t heap_size_after() { return heap_size_after_; }
+  size_t number_of_scopes() { return number_of_scopes_; }
+  const char* scope_name(size_t index) {
+    return index < number_of_scopes_ ? scope_names_[index] : NULL;
+  }
+  double scope_duration(size_t index) {
+    return index < number_of_scopes_ ? scope_durations_[index] : 0;
+  }
+
+ private:
+  static const size_t kMaxScopes = 32;
+
+  size_t gc_id_;
+  GCType gc_type_;
+  bool incremental_;
+  const char* gc_reason_;
+  double start_time_;
+  double pause_duration_;
+  size_t promoted_bytes_;
+  size_t survived_bytes_;
+  size_t heap_size_before_;
+  size_t heap_size_after_;
+  size_t number_of_scopes_;
+  const char* scope_names_[kMaxScopes];
+  double scope_durations_[kMaxScopes];
+
+  friend class Isolate;
+};
+
+
 class RetainedObjectInfo;
 
 
@@ -5338,6 +5403,35 @@ class V8_EXPORT Isolate {
   bool GetHeapObjectStatisticsAtLastGC(HeapObjectStatistics* object_statistics,
                                        size_t type_index);
 
+  /**
+   * Sets the number of completed garbage collections retained in the GC
+   * history. The initial size is given by the --gc-history-size flag. A size
+   * of zero disables the history.
+   */
+  void SetGCHistorySize(size_t size);
+
+  /**
+   * Returns the number of garbage collections currently retained in the GC
+   * history.
+   */
+  size_t NumberOfGCEvents();
+
+  /**
+   * Get statistics about a garbage collection retained in the GC history.
+   *
+   * \param event_statistics The GCEventStatistics object to fill in.
+   * \param index The index of the event, which ranges from 0 (the oldest
+   *   event) to NumberOfGCEvents() - 1 (the most recent one).
+   * \returns true on success.
+   */
+  bool GetGCEventStatistics(GCEventStatistics* event_statistics, size_t index);
+
+  /**
+   * Sets a callback that is invoked after each garbage collection has been
+   * added to the GC history. Passing NULL removes the callback.
+   */
+  void SetGCEventCallback(GCEventCallback callback, void* data = NULL);
+
   /**
    * Get a call stack sample from the isolate.
    * \param state Execution state.
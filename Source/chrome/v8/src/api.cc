@@ -53,6 +53,7 @@
 #include "src/v8threads.h"
 #include "src/version.h"
 #include "src/vm-state-inl.h"
+#include "src/zone-segment-pool.h"
 
 
 namespace v8 {
@@ -4016,6 +4017,14 @@ bool v8::Object::HasIndexedLookupInterceptor() {
 }
 
 
+bool v8::Object::HasPlainDataElements() {
+  auto self = Utils::OpenHandle(this);
+  // Accessors and non-default attributes force dictionary elements.
+  return self->HasFastElements() && !self->HasIndexedInterceptor() &&
+         !self->IsAccessCheckNeeded();
+}
+
+
 MaybeLocal<Value> v8::Object::GetRealNamedPropertyInPrototypeChain(
     Local<Context> context, Local<Name> key) {
   PREPARE_FOR_EXECUTION(
@@ -5348,6 +5357,20 @@ HeapObjectStatistics::HeapObjectStatistics()
       object_count_(0),
       object_size_(0) {}
 
+
+GCEventStatistics::GCEventStatistics()
+    : gc_id_(0),
+      gc_type_(kGCTypeScavenge),
+      incremental_(false),
+      gc_reason_(nullptr),
+      start_time_(0),
+      pause_duration_(0),
+      promoted_bytes_(0),
+      survived_bytes_(0),
+      heap_size_before_(0),
+      heap_size_after_(0),
+      number_of_scopes_(0) {}
+
 bool v8::V8::InitializeICU(const char* icu_data_file) {
   return i::InitializeICU(icu_data_file);
 }
@@ -6981,6 +7004,57 @@ bool Isolate::GetHeapObjectStatisticsAtLastGC(
 }
 
 
+void Isolate::SetGCHistorySize(size_t size) {
+  i::Isolate* isolate = reinterpret_cast<i::Isolate*>(this);
+  isolate->heap()->tracer()->SetHistorySize(size);
+}
+
+
+size_t Isolate::NumberOfGCEvents() {
+  i::Isolate* isolate = reinterpret_cast<i::Isolate*>(this);
+  return isolate->heap()->tracer()->history_length();
+}
+
+
+bool Isolate::GetGCEventStatistics(GCEventStatistics* event_statistics,
+                                   size_t index) {
+  STATIC_ASSERT(i::GCTracer::Scope::NUMBER_OF_SCOPES <=
+                GCEventStatistics::kMaxScopes);
+  if (!event_statistics) return false;
+  i::Isolate* isolate = reinterpret_cast<i::Isolate*>(this);
+  i::GCTracer* tracer = isolate->heap()->tracer();
+  if (index >= tracer->history_length()) return false;
+
+  const i::GCTracer::Event& event = tracer->HistoryEventAt(index);
+  event_statistics->gc_id_ = event.id;
+  event_statistics->gc_type_ = event.type == i::GCTracer::Event::SCAVENGER
+                                   ? kGCTypeScavenge
+                                   : kGCTypeMarkSweepCompact;
+  event_statistics->incremental_ =
+      event.type == i::GCTracer::Event::INCREMENTAL_MARK_COMPACTOR;
+  event_statistics->gc_reason_ = event.gc_reason;
+  event_statistics->start_time_ = event.start_time;
+  event_statistics->pause_duration_ = event.end_time - event.start_time;
+  event_statistics->promoted_bytes_ = event.promoted_bytes;
+  event_statistics->survived_bytes_ = event.survived_bytes;
+  event_statistics->heap_size_before_ = event.start_object_size;
+  event_statistics->heap_size_after_ = event.end_object_size;
+  event_statistics->number_of_scopes_ = i::GCTracer::Scope::NUMBER_OF_SCOPES;
+  for (int scope = 0; scope < i::GCTracer::Scope::NUMBER_OF_SCOPES; scope++) {
+    event_statistics->scope_names_[scope] = i::GCTracer::Scope::Name(
+        static_cast<i::GCTracer::Scope::ScopeId>(scope));
+    event_statistics->scope_durations_[scope] = event.scopes[scope];
+  }
+  return true;
+}
+
+
+void Isolate::SetGCEventCallback(GCEventCallback callback, void* data) {
+  i::Isolate* isolate = reinterpret_cast<i::Isolate*>(this);
+  isolate->heap()->tracer()->SetEventCallback(callback, data);
+}
+
+
 void Isolate::GetStackSample(const RegisterState& state, void** frames,
                              size_t frames_limit, SampleInfo* sample_info) {
   i::Isolate* isolate = reinterpret_cast<i::Isolate*>(this);
@@ -7104,6 +7178,7 @@ void Isolate::LowMemoryNotification() {
         isolate->counters()->gc_low_memory_notification());
     isolate->heap()->CollectAllAvailableGarbage("low memory notification");
   }
+  i::ZoneSegmentPool::Trim(0);
 }
 
 
@@ -47,6 +47,8 @@ void CompilationStatistics::RecordTotalStats(size_t source_size,
 void CompilationStatistics::BasicStats::Accumulate(const BasicStats& stats) {
   delta_ += stats.delta_;
   total_allocated_bytes_ += stats.total_allocated_bytes_;
+  segment_pool_hits_ += stats.segment_pool_hits_;
+  segment_pool_misses_ += stats.segment_pool_misses_;
   if (stats.absolute_max_allocated_bytes_ > absolute_max_allocated_bytes_) {
     absolute_max_allocated_bytes_ = stats.absolute_max_allocated_bytes_;
     max_allocated_bytes_ = stats.max_allocated_bytes_;
@@ -136,6 +138,9 @@ std::ostream& operator<<(std::ostream& os, const CompilationStatistics& s) {
   }
   WriteFullLine(os);
   WriteLine(os, "totals", s.total_stats_, s.total_stats_);
+  os << "Zone segments: " << s.total_stats_.segment_pool_hits_
+     << " reused / " << s.total_stats_.segment_pool_misses_ << " allocated"
+     << std::endl;
 
   return os;
 }
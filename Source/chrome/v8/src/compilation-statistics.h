@@ -25,7 +25,9 @@ class CompilationStatistics final : public Malloced {
     BasicStats()
         : total_allocated_bytes_(0),
           max_allocated_bytes_(0),
-          absolute_max_allocated_bytes_(0) {}
+          absolute_max_allocated_bytes_(0),
+          segment_pool_hits_(0),
+          segment_pool_misses_(0) {}
 
     void Accumulate(const BasicStats& stats);
 
@@ -33,6 +35,8 @@ class CompilationStatistics final : public Malloced {
     size_t total_allocated_bytes_;
     size_t max_allocated_bytes_;
     size_t absolute_max_allocated_bytes_;
+    size_t segment_pool_hits_;
+    size_t segment_pool_misses_;
     std::string function_name_;
   };
 
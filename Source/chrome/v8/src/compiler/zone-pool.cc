@@ -12,6 +12,7 @@ ZonePool::StatsScope::StatsScope(ZonePool* zone_pool)
     : zone_pool_(zone_pool),
       total_allocated_bytes_at_start_(zone_pool->GetTotalAllocatedBytes()),
       max_allocated_bytes_(0) {
+  ZoneSegmentPool::GetStatistics(&segment_pool_statistics_at_start_);
   zone_pool_->stats_.push_back(this);
   for (auto zone : zone_pool_->used_) {
     size_t size = static_cast<size_t>(zone->allocation_size());
@@ -53,6 +54,20 @@ size_t ZonePool::StatsScope::GetTotalAllocatedBytes() {
 }
 
 
+size_t ZonePool::StatsScope::GetSegmentPoolHits() {
+  ZoneSegmentPool::Statistics statistics;
+  ZoneSegmentPool::GetStatistics(&statistics);
+  return statistics.hits - segment_pool_statistics_at_start_.hits;
+}
+
+
+size_t ZonePool::StatsScope::GetSegmentPoolMisses() {
+  ZoneSegmentPool::Statistics statistics;
+  ZoneSegmentPool::GetStatistics(&statistics);
+  return statistics.misses - segment_pool_statistics_at_start_.misses;
+}
+
+
 void ZonePool::StatsScope::ZoneReturned(Zone* zone) {
   size_t current_total = GetCurrentAllocatedBytes();
   // Update max.
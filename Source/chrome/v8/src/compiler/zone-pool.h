@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "src/zone.h"
+#include "src/zone-segment-pool.h"
 
 namespace v8 {
 namespace internal {
@@ -46,6 +47,12 @@ class ZonePool final {
     size_t GetCurrentAllocatedBytes();
     size_t GetTotalAllocatedBytes();
 
+    // Segment allocations served by the ZoneSegmentPool and by malloc() since
+    // the scope was entered. The pool is shared by the whole process, so
+    // these include other threads' zones.
+    size_t GetSegmentPoolHits();
+    size_t GetSegmentPoolMisses();
+
    private:
     friend class ZonePool;
     void ZoneReturned(Zone* zone);
@@ -56,6 +63,7 @@ class ZonePool final {
     InitialValues initial_values_;
     size_t total_allocated_bytes_at_start_;
     size_t max_allocated_bytes_;
+    ZoneSegmentPool::Statistics segment_pool_statistics_at_start_;
 
     DISALLOW_COPY_AND_ASSIGN(StatsScope);
   };
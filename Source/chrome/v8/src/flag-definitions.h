@@ -604,6 +604,9 @@ DEFINE_BOOL(print_max_heap_committed, false,
             "in name=value format on exit")
 DEFINE_BOOL(trace_gc_verbose, false,
             "print more details following each garbage collection")
+DEFINE_INT(gc_history_size, 0,
+           "number of completed garbage collections retained for the embedder "
+           "(see v8::Isolate::GetGCEventStatistics)")
 DEFINE_INT(trace_allocation_stack_interval, -1,
            "print stack trace after <n> free-list allocations")
 DEFINE_BOOL(trace_fragmentation, false, "report fragmentation for old space")
@@ -633,6 +636,17 @@ DEFINE_INT(min_progress_during_object_groups_marking, 128,
 DEFINE_INT(max_object_groups_marking_rounds, 3,
            "at most try this many times to over approximate the weak closure")
 DEFINE_BOOL(concurrent_sweeping, true, "use concurrent sweeping")
+DEFINE_BOOL(parallel_marking, false,
+            "use helper threads for marking in full garbage collections")
+DEFINE_INT(parallel_marking_tasks, 0,
+           "number of helper threads for parallel marking "
+           "(0: one less than the number of processors, at most 7)")
+DEFINE_BOOL(parallel_scavenge, false,
+            "use helper threads for scavenges that no incremental marking, "
+            "logging or profiling observes")
+DEFINE_INT(parallel_scavenge_tasks, 0,
+           "number of helper threads for parallel scavenges "
+           "(0: one less than the number of processors, at most 7)")
 DEFINE_BOOL(trace_incremental_marking, false,
             "trace progress of the incremental marking")
 DEFINE_BOOL(track_gc_object_stats, false,
@@ -747,6 +761,10 @@ DEFINE_INT(hash_seed, 0,
            "Fixed seed to use to hash property keys (0 means random)"
            "(with snapshots this option cannot override the baked-in seed)")
 
+// zone-segment-pool.cc
+DEFINE_INT(zone_segment_pool_size, 16,
+           "megabytes of zone memory kept for reuse by other zones")
+
 // snapshot-common.cc
 DEFINE_BOOL(profile_deserialization, false,
             "Print the time it takes to deserialize the snapshot.")
@@ -783,6 +801,8 @@ DEFINE_BOOL(predictable, false, "enable predictable mode")
 DEFINE_NEG_IMPLICATION(predictable, concurrent_recompilation)
 DEFINE_NEG_IMPLICATION(predictable, concurrent_osr)
 DEFINE_NEG_IMPLICATION(predictable, concurrent_sweeping)
+DEFINE_NEG_IMPLICATION(predictable, parallel_marking)
+DEFINE_NEG_IMPLICATION(predictable, parallel_scavenge)
 
 // mark-compact.cc
 DEFINE_BOOL(force_marking_deque_overflows, false,
@@ -932,7 +952,7 @@ DEFINE_BOOL(perf_basic_prof, false,
             "Enable perf linux profiler (basic support).")
 DEFINE_NEG_IMPLICATION(perf_basic_prof, compact_code_space)
 DEFINE_BOOL(perf_jit_prof, false,
-            "Enable perf linux profiler (experimental annotate support).")
+            "Enable perf linux profiler (jitdump for perf inject --jit).")
 DEFINE_NEG_IMPLICATION(perf_jit_prof, compact_code_space)
 DEFINE_STRING(gc_fake_mmap, "/tmp/__v8_gc__",
               "Specify the name of the file for fake gc mmap used in ll_prof")
@@ -57,10 +57,69 @@ GCTracer::Event::Event(Type type, const char* gc_reason,
       incremental_marking_duration(0.0),
       cumulative_pure_incremental_marking_duration(0.0),
       pure_incremental_marking_duration(0.0),
-      longest_incremental_marking_step(0.0) {
+      longest_incremental_marking_step(0.0),
+      promoted_bytes(0),
+      survived_bytes(0),
+      id(0),
+      parallel_scavenge_workers(0) {
   for (int i = 0; i < Scope::NUMBER_OF_SCOPES; i++) {
     scopes[i] = 0;
   }
+  for (int i = 0; i < kMaxParallelScavengeWorkers; i++) {
+    parallel_scavenge_durations[i] = 0;
+  }
+}
+
+
+const char* GCTracer::Scope::Name(ScopeId scope) {
+  switch (scope) {
+    case EXTERNAL:
+      return "external";
+    case MC_MARK:
+      return "mark";
+    case MC_SWEEP:
+      return "sweep";
+    case MC_SWEEP_NEWSPACE:
+      return "sweepns";
+    case MC_SWEEP_OLDSPACE:
+      return "sweepos";
+    case MC_SWEEP_CODE:
+      return "sweepcode";
+    case MC_SWEEP_CELL:
+      return "sweepcell";
+    case MC_SWEEP_MAP:
+      return "sweepmap";
+    case MC_EVACUATE_PAGES:
+      return "evacuate";
+    case MC_UPDATE_NEW_TO_NEW_POINTERS:
+      return "new_new";
+    case MC_UPDATE_ROOT_TO_NEW_POINTERS:
+      return "root_new";
+    case MC_UPDATE_OLD_TO_NEW_POINTERS:
+      return "old_new";
+    case MC_UPDATE_POINTERS_TO_EVACUATED:
+      return "compaction_ptrs";
+    case MC_UPDATE_POINTERS_BETWEEN_EVACUATED:
+      return "intracompaction_ptrs";
+    case MC_UPDATE_MISC_POINTERS:
+      return "misc_compaction";
+    case MC_INCREMENTAL_WEAKCLOSURE:
+      return "inc_weak_closure";
+    case MC_WEAKCLOSURE:
+      return "weak_closure";
+    case MC_WEAKCOLLECTION_PROCESS:
+      return "weakcollection_process";
+    case MC_WEAKCOLLECTION_CLEAR:
+      return "weakcollection_clear";
+    case MC_WEAKCOLLECTION_ABORT:
+      return "weakcollection_abort";
+    case MC_FLUSH_CODE:
+      return "flush_code";
+    case NUMBER_OF_SCOPES:
+      break;
+  }
+  UNREACHABLE();
+  return NULL;
 }
 
 
@@ -103,13 +162,26 @@ GCTracer::GCTracer(Heap* heap)
       new_space_allocation_counter_bytes_(0),
       new_space_allocation_duration_since_gc_(0.0),
       new_space_allocation_in_bytes_since_gc_(0),
-      start_counter_(0) {
+      start_counter_(0),
+      event_count_(0),
+      history_(NULL),
+      history_size_(0),
+      history_begin_(0),
+      history_length_(0),
+      event_callback_(NULL),
+      event_callback_data_(NULL) {
   current_ = Event(Event::START, NULL, NULL);
   current_.end_time = base::OS::TimeCurrentMillis();
   previous_ = previous_incremental_mark_compactor_event_ = current_;
+  if (FLAG_gc_history_size > 0) {
+    SetHistorySize(static_cast<size_t>(FLAG_gc_history_size));
+  }
 }
 
 
+GCTracer::~GCTracer() { DeleteArray(history_); }
+
+
 void GCTracer::Start(GarbageCollector collector, const char* gc_reason,
                      const char* collector_reason) {
   start_counter_++;
@@ -182,6 +254,9 @@ void GCTracer::Stop(GarbageCollector collector) {
   current_.end_object_size = heap_->SizeOfObjects();
   current_.end_memory_size = heap_->isolate()->memory_allocator()->Size();
   current_.end_holes_size = CountTotalHolesSize(heap_);
+  current_.promoted_bytes = heap_->promoted_objects_size_;
+  current_.survived_bytes = heap_->semi_space_copied_object_size_;
+  current_.id = event_count_++;
 
   AddNewSpaceAllocation(current_.end_time);
 
@@ -233,6 +308,8 @@ void GCTracer::Stop(GarbageCollector collector) {
     mark_compactor_events_.push_front(current_);
   }
 
+  AddToHistory();
+
   // TODO(ernstm): move the code below out of GCTracer.
 
   if (!FLAG_trace_gc && !FLAG_print_cumulative_gc_stat) return;
@@ -301,6 +378,40 @@ void GCTracer::AddSurvivalRatio(double promotion_ratio) {
 }
 
 
+void GCTracer::SetHistorySize(size_t size) {
+  if (size == history_size_) return;
+  Event* history = size > 0 ? NewArray<Event>(size) : NULL;
+  // Keep the most recent events that fit into the new history.
+  size_t length = Min(history_length_, size);
+  for (size_t i = 0; i < length; i++) {
+    history[i] = HistoryEventAt(history_length_ - length + i);
+  }
+  DeleteArray(history_);
+  history_ = history;
+  history_size_ = size;
+  history_begin_ = 0;
+  history_length_ = length;
+}
+
+
+void GCTracer::AddToHistory() {
+  if (history_size_ > 0) {
+    if (history_length_ < history_size_) {
+      history_[(history_begin_ + history_length_) % history_size_] = current_;
+      history_length_++;
+    } else {
+      // Overwrite the oldest event.
+      history_[history_begin_] = current_;
+      history_begin_ = (history_begin_ + 1) % history_size_;
+    }
+  }
+  if (event_callback_ != NULL) {
+    event_callback_(reinterpret_cast<v8::Isolate*>(heap_->isolate()),
+                    event_callback_data_);
+  }
+}
+
+
 void GCTracer::AddIncrementalMarkingStep(double duration, intptr_t bytes) {
   cumulative_incremental_marking_steps_++;
   cumulative_incremental_marking_bytes_ += bytes;
@@ -314,6 +425,16 @@ void GCTracer::AddIncrementalMarkingStep(double duration, intptr_t bytes) {
 }
 
 
+void GCTracer::AddParallelScavengeDurations(int workers,
+                                            const double* durations) {
+  DCHECK(workers <= kMaxParallelScavengeWorkers);
+  current_.parallel_scavenge_workers = workers;
+  for (int i = 0; i < workers; i++) {
+    current_.parallel_scavenge_durations[i] = durations[i];
+  }
+}
+
+
 void GCTracer::Print() const {
   PrintIsolate(heap_->isolate(), "%8.0f ms: ",
                heap_->isolate()->time_millis_since_init());
@@ -427,6 +548,11 @@ void GCTracer::PrintNVP() const {
     PrintF("steps_took=%.1f ", current_.incremental_marking_duration);
     PrintF("scavenge_throughput=%" V8_PTR_PREFIX "d ",
            ScavengeSpeedInBytesPerMillisecond());
+    PrintF("scavenge_workers=%d ", current_.parallel_scavenge_workers);
+    for (int i = 0; i < current_.parallel_scavenge_workers; i++) {
+      PrintF("scavenge_worker%d=%.1f ", i,
+             current_.parallel_scavenge_durations[i]);
+    }
   } else {
     PrintF("steps_count=%d ", current_.incremental_marking_steps);
     PrintF("steps_took=%.1f ", current_.incremental_marking_duration);
@@ -90,6 +90,8 @@ class RingBuffer {
 // TODO(ernstm): Unit tests.
 class GCTracer {
  public:
+  static const int kMaxParallelScavengeWorkers = 8;
+
   class Scope {
    public:
     enum ScopeId {
@@ -127,6 +129,9 @@ class GCTracer {
           base::OS::TimeCurrentMillis() - start_time_;
     }
 
+    // Returns the short name used for the scope in --trace-gc-nvp output.
+    static const char* Name(ScopeId scope);
+
    private:
     GCTracer* tracer_;
     ScopeId scope_;
@@ -228,6 +233,16 @@ class GCTracer {
     // Size of new space objects in constructor.
     intptr_t new_space_object_size;
 
+    // Size of objects promoted to the old generation, set in destructor.
+    intptr_t promoted_bytes;
+
+    // Size of objects copied within the new space, set in destructor.
+    intptr_t survived_bytes;
+
+    // Sequence number of the event among all completed events, set in
+    // destructor.
+    size_t id;
+
     // Number of incremental marking steps since creation of tracer.
     // (value at start of event)
     int cumulative_incremental_marking_steps;
@@ -273,6 +288,14 @@ class GCTracer {
 
     // Amounts of time spent in different scopes during GC.
     double scopes[Scope::NUMBER_OF_SCOPES];
+
+    // Number of threads that copied objects in a parallel scavenge, zero if
+    // the scavenge ran on the main thread only.
+    int parallel_scavenge_workers;
+
+    // Time each of those threads spent in the scavenge, the main thread
+    // first.
+    double parallel_scavenge_durations[kMaxParallelScavengeWorkers];
   };
 
   static const size_t kRingBufferMaxSize = 10;
@@ -287,6 +310,7 @@ class GCTracer {
   typedef RingBuffer<SurvivalEvent, kRingBufferMaxSize> SurvivalEventBuffer;
 
   explicit GCTracer(Heap* heap);
+  ~GCTracer();
 
   // Start collecting data.
   void Start(GarbageCollector collector, const char* gc_reason,
@@ -308,6 +332,10 @@ class GCTracer {
   // Log an incremental marking step.
   void AddIncrementalMarkingStep(double duration, intptr_t bytes);
 
+  // Log the time each of the |workers| threads of a parallel scavenge spent
+  // copying objects, the main thread first.
+  void AddParallelScavengeDurations(int workers, const double* durations);
+
   // Log time spent in marking.
   void AddMarkingTime(double duration) {
     cumulative_marking_duration_ += duration;
@@ -411,7 +439,32 @@ class GCTracer {
   // Discard all recorded survival events.
   void ResetSurvivalEvents();
 
+  // Changes the number of completed events kept in the history. Existing
+  // events are preserved as far as they fit. A size of zero disables the
+  // history.
+  void SetHistorySize(size_t size);
+
+  // Number of events currently kept in the history.
+  size_t history_length() const { return history_length_; }
+
+  // Returns the |index|-th event of the history, the oldest event being at
+  // index zero.
+  const Event& HistoryEventAt(size_t index) const {
+    DCHECK(index < history_length_);
+    return history_[(history_begin_ + index) % history_size_];
+  }
+
+  // Sets a callback that is invoked once a completed event has been added to
+  // the history.
+  void SetEventCallback(v8::GCEventCallback callback, void* data) {
+    event_callback_ = callback;
+    event_callback_data_ = data;
+  }
+
  private:
+  // Append the current event to the history and notify the embedder.
+  void AddToHistory();
+
   // Print one detailed trace line in name=value format.
   // TODO(ernstm): Move to Heap.
   void PrintNVP() const;
@@ -508,6 +561,20 @@ class GCTracer {
   // Counts how many tracers were started without stopping.
   int start_counter_;
 
+  // Number of events that completed since creation of tracer.
+  size_t event_count_;
+
+  // Circular buffer of the last |history_size_| completed events of all
+  // collector types. Unlike the RingBuffers above it is not used by any heap
+  // heuristic and is sized at runtime (see --gc-history-size).
+  Event* history_;
+  size_t history_size_;
+  size_t history_begin_;
+  size_t history_length_;
+
+  v8::GCEventCallback event_callback_;
+  void* event_callback_data_;
+
   DISALLOW_COPY_AND_ASSIGN(GCTracer);
 };
 }
@@ -22,6 +22,7 @@
 #include "src/heap/mark-compact.h"
 #include "src/heap/objects-visiting-inl.h"
 #include "src/heap/objects-visiting.h"
+#include "src/heap/parallel-scavenger.h"
 #include "src/heap/store-buffer.h"
 #include "src/heap-profiler.h"
 #include "src/runtime-profiler.h"
@@ -136,6 +137,7 @@ Heap::Heap()
       last_gc_time_(0.0),
       mark_compact_collector_(this),
       store_buffer_(this),
+      parallel_scavenger_(NULL),
       marking_(this),
       incremental_marking_(this),
       gc_count_at_last_idle_gc_(0),
@@ -1616,43 +1618,49 @@ void Heap::Scavenge() {
   Address new_space_front = new_space_.ToSpaceStart();
   promotion_queue_.Initialize();
 
-  ScavengeVisitor scavenge_visitor(this);
-  // Copy roots.
-  IterateRoots(&scavenge_visitor, VISIT_ALL_IN_SCAVENGE);
-
-  // Copy objects reachable from the old generation.
-  {
-    StoreBufferRebuildScope scope(this, store_buffer(),
-                                  &ScavengeStoreBufferCallback);
-    store_buffer()->IteratePointersToNewSpace(&ScavengeObject);
-  }
+  int parallel_scavenge_tasks = ParallelScavenger::NumberOfTasks(this);
+  if (parallel_scavenge_tasks > 0) {
+    ScavengeInParallel(parallel_scavenge_tasks);
+    new_space_front = new_space_.top();
+  } else {
+    ScavengeVisitor scavenge_visitor(this);
+    // Copy roots.
+    IterateRoots(&scavenge_visitor, VISIT_ALL_IN_SCAVENGE);
 
-  // Copy objects reachable from the encountered weak collections list.
-  scavenge_visitor.VisitPointer(&encountered_weak_collections_);
-  // Copy objects reachable from the encountered weak cells.
-  scavenge_visitor.VisitPointer(&encountered_weak_cells_);
+    // Copy objects reachable from the old generation.
+    {
+      StoreBufferRebuildScope scope(this, store_buffer(),
+                                    &ScavengeStoreBufferCallback);
+      store_buffer()->IteratePointersToNewSpace(&ScavengeObject);
+    }
 
-  // Copy objects reachable from the code flushing candidates list.
-  MarkCompactCollector* collector = mark_compact_collector();
-  if (collector->is_code_flushing_enabled()) {
-    collector->code_flusher()->IteratePointersToFromSpace(&scavenge_visitor);
-  }
+    // Copy objects reachable from the encountered weak collections list.
+    scavenge_visitor.VisitPointer(&encountered_weak_collections_);
+    // Copy objects reachable from the encountered weak cells.
+    scavenge_visitor.VisitPointer(&encountered_weak_cells_);
 
-  new_space_front = DoScavenge(&scavenge_visitor, new_space_front);
+    // Copy objects reachable from the code flushing candidates list.
+    MarkCompactCollector* collector = mark_compact_collector();
+    if (collector->is_code_flushing_enabled()) {
+      collector->code_flusher()->IteratePointersToFromSpace(&scavenge_visitor);
+    }
 
-  while (isolate()->global_handles()->IterateObjectGroups(
-      &scavenge_visitor, &IsUnscavengedHeapObject)) {
     new_space_front = DoScavenge(&scavenge_visitor, new_space_front);
-  }
-  isolate()->global_handles()->RemoveObjectGroups();
-  isolate()->global_handles()->RemoveImplicitRefGroups();
 
-  isolate()->global_handles()->IdentifyNewSpaceWeakIndependentHandles(
-      &IsUnscavengedHeapObject);
+    while (isolate()->global_handles()->IterateObjectGroups(
+        &scavenge_visitor, &IsUnscavengedHeapObject)) {
+      new_space_front = DoScavenge(&scavenge_visitor, new_space_front);
+    }
+    isolate()->global_handles()->RemoveObjectGroups();
+    isolate()->global_handles()->RemoveImplicitRefGroups();
 
-  isolate()->global_handles()->IterateNewSpaceWeakIndependentRoots(
-      &scavenge_visitor);
-  new_space_front = DoScavenge(&scavenge_visitor, new_space_front);
+    isolate()->global_handles()->IdentifyNewSpaceWeakIndependentHandles(
+        &IsUnscavengedHeapObject);
+
+    isolate()->global_handles()->IterateNewSpaceWeakIndependentRoots(
+        &scavenge_visitor);
+    new_space_front = DoScavenge(&scavenge_visitor, new_space_front);
+  }
 
   UpdateNewSpaceReferencesInExternalStringTable(
       &UpdateNewSpaceReferenceInExternalStringTableEntry);
@@ -1682,6 +1690,42 @@ void Heap::Scavenge() {
 }
 
 
+void Heap::ScavengeInParallel(int tasks) {
+  if (parallel_scavenger_ == NULL) {
+    parallel_scavenger_ = new ParallelScavenger(this);
+  }
+  ParallelScavenger* scavenger = parallel_scavenger_;
+  // The helper tasks copy objects reachable from the old generation while
+  // the main thread copies roots.
+  scavenger->Start(tasks);
+  ObjectVisitor* scavenge_visitor = scavenger->main_thread_visitor();
+  IterateRoots(scavenge_visitor, VISIT_ALL_IN_SCAVENGE);
+  scavenge_visitor->VisitPointer(&encountered_weak_collections_);
+  scavenge_visitor->VisitPointer(&encountered_weak_cells_);
+  MarkCompactCollector* collector = mark_compact_collector();
+  if (collector->is_code_flushing_enabled()) {
+    collector->code_flusher()->IteratePointersToFromSpace(scavenge_visitor);
+  }
+  scavenger->Join();
+
+  while (isolate()->global_handles()->IterateObjectGroups(
+      scavenge_visitor, &IsUnscavengedHeapObject)) {
+    scavenger->ProcessCopiedObjects();
+  }
+  isolate()->global_handles()->RemoveObjectGroups();
+  isolate()->global_handles()->RemoveImplicitRefGroups();
+
+  isolate()->global_handles()->IdentifyNewSpaceWeakIndependentHandles(
+      &IsUnscavengedHeapObject);
+
+  isolate()->global_handles()->IterateNewSpaceWeakIndependentRoots(
+      scavenge_visitor);
+  scavenger->ProcessCopiedObjects();
+
+  scavenger->Finish();
+}
+
+
 String* Heap::UpdateNewSpaceReferenceInExternalStringTableEntry(Heap* heap,
                                                                 Object** p) {
   MapWord first_word = HeapObject::cast(*p)->map_word();
@@ -5404,6 +5448,7 @@ V8_DECLARE_ONCE(initialize_gc_once);
 static void InitializeGCOnce() {
   InitializeScavengingVisitorsTables();
   NewSpaceScavenger::Initialize();
+  ParallelScavenger::Initialize();
   MarkCompactCollector::Initialize();
 }
 
@@ -5590,6 +5635,9 @@ void Heap::TearDown() {
 
   mark_compact_collector()->TearDown();
 
+  delete parallel_scavenger_;
+  parallel_scavenger_ = NULL;
+
   new_space_.TearDown();
 
   if (old_space_ != NULL) {
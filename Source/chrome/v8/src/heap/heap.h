@@ -383,6 +383,7 @@ namespace internal {
 // Forward declarations.
 class HeapStats;
 class Isolate;
+class ParallelScavenger;
 class WeakObjectRetainer;
 
 
@@ -1346,6 +1347,9 @@ class Heap {
 
   StoreBuffer* store_buffer() { return &store_buffer_; }
 
+  // NULL until the first parallel scavenge.
+  ParallelScavenger* parallel_scavenger() { return parallel_scavenger_; }
+
   Marking* marking() { return &marking_; }
 
   IncrementalMarking* incremental_marking() { return &incremental_marking_; }
@@ -2028,6 +2032,10 @@ class Heap {
   // Performs a minor collection in new generation.
   void Scavenge();
 
+  // The part of Scavenge() that copies the survivors, on the main thread and
+  // |tasks| helper tasks.
+  void ScavengeInParallel(int tasks);
+
   // Commits from space if it is uncommitted.
   void EnsureFromSpaceIsCommitted();
 
@@ -2187,6 +2195,8 @@ class Heap {
 
   StoreBuffer store_buffer_;
 
+  ParallelScavenger* parallel_scavenger_;
+
   Marking marking_;
 
   IncrementalMarking incremental_marking_;
@@ -2253,6 +2263,7 @@ class Heap {
   friend class MarkCompactMarkingVisitor;
   friend class MapCompact;
   friend class Page;
+  friend class ParallelScavenger;
 
   DISALLOW_COPY_AND_ASSIGN(Heap);
 };
@@ -6,6 +6,7 @@
 
 #include "src/base/atomicops.h"
 #include "src/base/bits.h"
+#include "src/base/sys-info.h"
 #include "src/code-stubs.h"
 #include "src/compilation-cache.h"
 #include "src/cpu-profiler.h"
@@ -48,6 +49,11 @@ MarkCompactCollector::MarkCompactCollector(Heap* heap)
       was_marked_incrementally_(false),
       sweeping_in_progress_(false),
       pending_sweeper_jobs_semaphore_(0),
+      marking_tasks_(0),
+      parallel_marking_workers_(0),
+      marking_workers_(NULL),
+      active_marking_workers_(0),
+      pending_marking_tasks_semaphore_(0),
       evacuation_(false),
       migration_slots_buffer_(NULL),
       heap_(heap),
@@ -233,6 +239,7 @@ void MarkCompactCollector::SetUp() {
 void MarkCompactCollector::TearDown() {
   AbortCompaction();
   delete marking_deque_memory_;
+  delete[] marking_workers_;
 }
 
 
@@ -2080,6 +2087,11 @@ void MarkCompactCollector::MarkImplicitRefGroups(
 void MarkCompactCollector::EmptyMarkingDeque() {
   Map* filler_map = heap_->one_pointer_filler_map();
   while (!marking_deque_.IsEmpty()) {
+    if (marking_tasks_ > 0 &&
+        marking_deque_.Size() >= kMinObjectsForParallelMarking) {
+      MarkInParallel();
+      continue;
+    }
     HeapObject* object = marking_deque_.Pop();
     // Explicitly skip one word fillers. Incremental markbit patterns are
     // correct only for objects that occupy at least two words.
@@ -2127,6 +2139,309 @@ void MarkCompactCollector::RefillMarkingDeque() {
 }
 
 
+void ParallelMarkingDeque::Initialize(int capacity) {
+  DCHECK(base::bits::IsPowerOfTwo32(capacity));
+  DCHECK(!IsInitialized());
+  array_ = NewArray<HeapObject*>(capacity);
+  mask_ = capacity - 1;
+  top_ = bottom_ = 0;
+}
+
+
+bool ParallelMarkingDeque::Push(HeapObject* object) {
+  base::LockGuard<base::Mutex> guard(&mutex_);
+  if (((top_ + 1) & mask_) == bottom_) return false;
+  array_[top_] = object;
+  top_ = (top_ + 1) & mask_;
+  return true;
+}
+
+
+bool ParallelMarkingDeque::Pop(HeapObject** object) {
+  base::LockGuard<base::Mutex> guard(&mutex_);
+  if (top_ == bottom_) return false;
+  top_ = (top_ - 1) & mask_;
+  *object = array_[top_];
+  return true;
+}
+
+
+bool ParallelMarkingDeque::StealFrom(ParallelMarkingDeque* victim) {
+  DCHECK(IsEmpty());
+  // Copy out first, so that no thread ever holds two deque locks.
+  HeapObject* stolen[kStealBatchSize];
+  int count = 0;
+  {
+    base::LockGuard<base::Mutex> guard(&victim->mutex_);
+    int size = (victim->top_ - victim->bottom_) & victim->mask_;
+    count = Min((size + 1) / 2, kStealBatchSize);
+    for (int i = 0; i < count; i++) {
+      stolen[i] = victim->array_[victim->bottom_];
+      victim->bottom_ = (victim->bottom_ + 1) & victim->mask_;
+    }
+  }
+  for (int i = 0; i < count; i++) {
+    bool pushed = Push(stolen[i]);
+    DCHECK(pushed);
+    USE(pushed);
+  }
+  return count > 0;
+}
+
+
+void ParallelMarkingDeque::BackOff(int round) {
+  // Objects usually show up again soon while the other workers are busy, so
+  // the first rounds only spin. After that the wait doubles, but stays short
+  // because the last worker to finish is not waited for any longer than this.
+  const int kSpinRounds = 16;
+  const int kMaxSleepMicroseconds = 128;
+  if (round < kSpinRounds) return;
+  int sleep_microseconds =
+      Min(1 << Min(round - kSpinRounds, 7), kMaxSleepMicroseconds);
+  base::OS::Sleep(base::TimeDelta::FromMicroseconds(sleep_microseconds));
+}
+
+
+// Visits objects on behalf of one participant in parallel marking. It only
+// marks; it never records slots or writes to the heap, so objects that need
+// more than that are left to the main thread.
+class ParallelMarkingVisitor : public ObjectVisitor {
+ public:
+  ParallelMarkingVisitor(MarkCompactCollector* collector, int worker)
+      : collector_(collector),
+        worker_(worker),
+        compacting_(collector->is_compacting()),
+        filler_map_(collector->heap()->one_pointer_filler_map()),
+        needs_main_thread_(false) {}
+
+  void VisitPointers(Object** start, Object** end) override {
+    for (Object** p = start; p < end; p++) {
+      Object* value = *p;
+      if (!value->IsHeapObject()) continue;
+      HeapObject* object = HeapObject::cast(value);
+      // The slot has to be recorded, and slots buffers are not thread-safe.
+      if (compacting_ && MarkCompactCollector::IsOnEvacuationCandidate(object)) {
+        needs_main_thread_ = true;
+      }
+      MarkObject(object);
+    }
+  }
+
+  void MarkObject(HeapObject* object) {
+    if (Marking::WhiteToBlackAtomically(Marking::MarkBitFrom(object))) {
+      MemoryChunk::IncrementLiveBytesFromGCAtomically(object->address(),
+                                                      object->Size());
+      collector_->PushInParallel(worker_, object);
+    }
+  }
+
+  // The counterpart of the loop body in EmptyMarkingDeque().
+  void VisitObject(HeapObject* object) {
+    Map* map = object->map();
+    if (map == filler_map_) return;
+    MarkObject(map);
+    needs_main_thread_ = false;
+    if (!VisitBody(map, object) || needs_main_thread_) {
+      collector_->marking_workers_[worker_].deferred_objects.Add(object);
+    }
+  }
+
+ private:
+  // Returns false if the body has to be visited by MarkCompactMarkingVisitor,
+  // which treats some fields of these objects as weak or has other side
+  // effects. Everything that is visited here has to match what that visitor
+  // does.
+  bool VisitBody(Map* map, HeapObject* object) {
+    int id = map->visitor_id();
+    if (id >= StaticVisitorBase::kVisitDataObject &&
+        id <= StaticVisitorBase::kVisitDataObjectGeneric) {
+      return true;
+    }
+    if (id >= StaticVisitorBase::kVisitJSObject &&
+        id <= StaticVisitorBase::kVisitJSObjectGeneric) {
+      JSObject::BodyDescriptor::IterateBody(object, object->SizeFromMap(map),
+                                            this);
+      return true;
+    }
+    if (id >= StaticVisitorBase::kVisitStruct &&
+        id <= StaticVisitorBase::kVisitStructGeneric) {
+      StructBodyDescriptor::IterateBody(object, map->instance_size(), this);
+      return true;
+    }
+    switch (id) {
+      case StaticVisitorBase::kVisitSeqOneByteString:
+      case StaticVisitorBase::kVisitSeqTwoByteString:
+      case StaticVisitorBase::kVisitByteArray:
+      case StaticVisitorBase::kVisitFreeSpace:
+      case StaticVisitorBase::kVisitFixedDoubleArray:
+      case StaticVisitorBase::kVisitFixedTypedArray:
+      case StaticVisitorBase::kVisitFixedFloat64Array:
+        return true;
+      case StaticVisitorBase::kVisitShortcutCandidate:
+      case StaticVisitorBase::kVisitConsString:
+        ConsString::BodyDescriptor::IterateBody(object, this);
+        return true;
+      case StaticVisitorBase::kVisitSlicedString:
+        SlicedString::BodyDescriptor::IterateBody(object, this);
+        return true;
+      case StaticVisitorBase::kVisitSymbol:
+        Symbol::BodyDescriptor::IterateBody(object, this);
+        return true;
+      case StaticVisitorBase::kVisitOddball:
+        Oddball::BodyDescriptor::IterateBody(object, this);
+        return true;
+      case StaticVisitorBase::kVisitCell:
+        Cell::BodyDescriptor::IterateBody(object, this);
+        return true;
+      case StaticVisitorBase::kVisitFixedArray:
+        FixedArray::BodyDescriptor::IterateBody(
+            object, object->SizeFromMap(map), this);
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  MarkCompactCollector* collector_;
+  int worker_;
+  bool compacting_;
+  Map* filler_map_;
+  bool needs_main_thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelMarkingVisitor);
+};
+
+
+class MarkCompactCollector::MarkingTask : public v8::Task {
+ public:
+  MarkingTask(Heap* heap, int worker) : heap_(heap), worker_(worker) {}
+
+  virtual ~MarkingTask() {}
+
+ private:
+  // v8::Task overrides.
+  void Run() override {
+    MarkCompactCollector* collector = heap_->mark_compact_collector();
+    // The worker's deque is empty, so joining late cannot hide work from
+    // TerminateMarkingWorker().
+    base::Barrier_AtomicIncrement(&collector->active_marking_workers_, 1);
+    collector->DrainMarkingWorker(worker_);
+    collector->pending_marking_tasks_semaphore_.Signal();
+  }
+
+  Heap* heap_;
+  int worker_;
+
+  DISALLOW_COPY_AND_ASSIGN(MarkingTask);
+};
+
+
+int MarkCompactCollector::NumberOfMarkingTasks() {
+  // Object statistics are only collected by MarkCompactMarkingVisitor.
+  if (!FLAG_parallel_marking || FLAG_track_gc_object_stats) return 0;
+  int tasks = FLAG_parallel_marking_tasks;
+  if (tasks <= 0) tasks = base::SysInfo::NumberOfProcessors() - 1;
+  return Max(0, Min(tasks, kMaxMarkingWorkers - 1));
+}
+
+
+void MarkCompactCollector::MarkInParallel() {
+  const int kDequeCapacity = 64 * KB;
+  if (marking_workers_ == NULL) {
+    marking_workers_ = new MarkingWorker[kMaxMarkingWorkers];
+  }
+  int worker_count = marking_tasks_ + 1;
+  parallel_marking_workers_ = worker_count;
+  for (int i = 0; i < worker_count; i++) {
+    MarkingWorker* worker = &marking_workers_[i];
+    if (!worker->deque.IsInitialized()) worker->deque.Initialize(kDequeCapacity);
+    DCHECK(worker->deque.IsEmpty());
+    DCHECK(worker->deferred_objects.is_empty());
+  }
+
+  base::NoBarrier_Store(&active_marking_workers_, 1);
+  for (int i = 1; i < worker_count; i++) {
+    V8::GetCurrentPlatform()->CallOnBackgroundThread(
+        new MarkingTask(heap(), i), v8::Platform::kShortRunningTask);
+  }
+  DrainMarkingWorker(0);
+  for (int i = 1; i < worker_count; i++) {
+    pending_marking_tasks_semaphore_.Wait();
+  }
+
+  // Back to the main thread only. Visiting the deferred objects pushes what
+  // they point to onto the marking stack.
+  for (int i = 0; i < worker_count; i++) {
+    MarkingWorker* worker = &marking_workers_[i];
+    if (worker->overflowed) {
+      marking_deque_.SetOverflowed();
+      worker->overflowed = false;
+    }
+    List<HeapObject*>* deferred = &worker->deferred_objects;
+    for (int j = 0; j < deferred->length(); j++) {
+      HeapObject* object = deferred->at(j);
+      DCHECK(heap()->Contains(object));
+      DCHECK(!Marking::IsWhite(Marking::MarkBitFrom(object)));
+      MarkCompactMarkingVisitor::IterateBody(object->map(), object);
+    }
+    deferred->Rewind(0);
+  }
+}
+
+
+void MarkCompactCollector::DrainMarkingWorker(int worker) {
+  ParallelMarkingDeque* deque = &marking_workers_[worker].deque;
+  ParallelMarkingVisitor visitor(this, worker);
+  do {
+    while (true) {
+      HeapObject* object;
+      if (!deque->Pop(&object)) {
+        // Thieves may empty the deque again before the main thread gets to
+        // it, but it only stops once the marking stack is empty.
+        if (worker == 0 && RefillMainMarkingWorker()) continue;
+        break;
+      }
+      DCHECK(object->IsHeapObject());
+      DCHECK(heap()->Contains(object));
+      visitor.VisitObject(object);
+    }
+  } while (!TerminateMarkingWorker(worker));
+}
+
+
+bool MarkCompactCollector::RefillMainMarkingWorker() {
+  const int kRefillBatchSize = 256;
+  ParallelMarkingDeque* deque = &marking_workers_[0].deque;
+  int count = 0;
+  while (count < kRefillBatchSize && !marking_deque_.IsEmpty()) {
+    HeapObject* object = marking_deque_.Pop();
+    if (!deque->Push(object)) {
+      marking_deque_.PushBlack(object);
+      break;
+    }
+    count++;
+  }
+  return count > 0;
+}
+
+
+bool MarkCompactCollector::TerminateMarkingWorker(int worker) {
+  return ParallelMarkingDeque::TerminateWorker(
+      &active_marking_workers_, marking_workers_, marking_tasks_ + 1, worker);
+}
+
+
+void MarkCompactCollector::PushInParallel(int worker, HeapObject* object) {
+  if (marking_workers_[worker].deque.Push(object)) return;
+  // Like MarkingDeque::PushBlack(), leave the object grey in the heap for
+  // RefillMarkingDeque() to find.
+  Marking::BlackToGreyAtomically(object);
+  MemoryChunk::IncrementLiveBytesFromGCAtomically(object->address(),
+                                                  -object->Size());
+  marking_workers_[worker].overflowed = true;
+}
+
+
 // Mark all objects reachable (transitively) from objects on the marking
 // stack.  Before: the marking stack contains zero or more heap object
 // pointers.  After: the marking stack is empty and there are no overflowed
@@ -2331,6 +2646,9 @@ void MarkCompactCollector::MarkLiveObjects() {
 
   EnsureMarkingDequeIsCommittedAndInitialize();
 
+  marking_tasks_ = NumberOfMarkingTasks();
+  parallel_marking_workers_ = 0;
+
   PrepareForCodeFlushing();
 
   RootMarkingVisitor root_visitor(heap());
@@ -2372,6 +2690,8 @@ void MarkCompactCollector::MarkLiveObjects() {
     ProcessEphemeralMarking(&root_visitor, true);
   }
 
+  marking_tasks_ = 0;
+
   AfterMarking();
 
   if (FLAG_print_cumulative_gc_stat) {
@@ -111,6 +111,17 @@ class Marking {
     BlackToGrey(MarkBitFrom(obj));
   }
 
+  // Variants for parallel marking, which may race with other threads marking
+  // objects whose mark bits share a cell. Returns false if the object was
+  // marked already.
+  INLINE(static bool WhiteToBlackAtomically(MarkBit markbit)) {
+    return markbit.SetAtomically();
+  }
+
+  INLINE(static void BlackToGreyAtomically(HeapObject* obj)) {
+    MarkBitFrom(obj).Next().SetAtomically();
+  }
+
   INLINE(static void AnyToGrey(MarkBit markbit)) {
     markbit.Set();
     markbit.Next().Set();
@@ -199,6 +210,8 @@ class MarkingDeque {
 
   inline bool IsEmpty() { return top_ == bottom_; }
 
+  inline int Size() { return (top_ - bottom_) & mask_; }
+
   bool overflowed() const { return overflowed_; }
 
   void ClearOverflowed() { overflowed_ = false; }
@@ -284,6 +297,82 @@ class MarkingDeque {
 };
 
 
+// The marking deque of one participant in parallel marking. The owner pushes
+// and pops at the top, and the other participants steal from the bottom once
+// they run out of work. Unlike MarkingDeque it does not handle overflow
+// itself: Push() fails if the deque is full.
+class ParallelMarkingDeque {
+ public:
+  ParallelMarkingDeque() : array_(NULL), mask_(0), top_(0), bottom_(0) {}
+  ~ParallelMarkingDeque() { DeleteArray(array_); }
+
+  // |capacity| must be a power of two.
+  void Initialize(int capacity);
+
+  bool IsInitialized() const { return array_ != NULL; }
+
+  // Without the lock, so only a hint while other threads use the deque.
+  bool IsEmpty() const { return top_ == bottom_; }
+
+  bool Push(HeapObject* object);
+
+  bool Pop(HeapObject** object);
+
+  // Moves some of the objects of |victim| into this deque, which must be
+  // empty. Returns false if there was nothing to steal.
+  bool StealFrom(ParallelMarkingDeque* victim);
+
+  // The termination protocol of the work-stealing loops built on these
+  // deques, used by parallel marking and the parallel scavenger. Each of the
+  // |count| |workers| owns a |deque|, and |active_workers| counts the ones
+  // that may still hold objects. Worker |index| calls this once its deque is
+  // empty. Returns false after stealing objects into that deque, and true
+  // once no worker is active any more. A worker that keeps finding nothing
+  // to steal backs off, first spinning and then sleeping, so that it leaves
+  // the CPU to the workers that still have objects.
+  template <typename Worker>
+  static bool TerminateWorker(base::Atomic32* active_workers, Worker* workers,
+                              int count, int index);
+
+ private:
+  static const int kStealBatchSize = 64;
+
+  // Waits before the next round of TerminateWorker() after |round| rounds
+  // that found nothing to steal.
+  static void BackOff(int round);
+
+  base::Mutex mutex_;
+  HeapObject** array_;
+  int mask_;
+  // Same layout as in MarkingDeque.
+  int top_;
+  int bottom_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelMarkingDeque);
+};
+
+
+template <typename Worker>
+bool ParallelMarkingDeque::TerminateWorker(base::Atomic32* active_workers,
+                                           Worker* workers, int count,
+                                           int index) {
+  ParallelMarkingDeque* deque = &workers[index].deque;
+  base::Barrier_AtomicIncrement(active_workers, -1);
+  for (int round = 0; base::Acquire_Load(active_workers) > 0; round++) {
+    // Only active workers hold objects, so there is something to steal.
+    for (int i = 0; i < count; i++) {
+      ParallelMarkingDeque* victim = &workers[i].deque;
+      if (i == index || victim->IsEmpty()) continue;
+      base::Barrier_AtomicIncrement(active_workers, 1);
+      if (deque->StealFrom(victim)) return false;
+      base::Barrier_AtomicIncrement(active_workers, -1);
+    }
+    BackOff(round);
+  }
+  return true;
+}
+
+
 class SlotsBufferAllocator {
  public:
   SlotsBuffer* AllocateBuffer(SlotsBuffer* next_buffer);
@@ -566,6 +655,7 @@ class CodeFlusher {
 
 // Defined in isolate.h.
 class ThreadLocalTop;
+class ParallelMarkingVisitor;
 
 
 // -------------------------------------------------------------------------
@@ -677,6 +767,10 @@ class MarkCompactCollector {
 
   bool is_compacting() const { return compacting_; }
 
+  // Number of threads, the main thread included, that marked in parallel
+  // during the last full GC, zero if it marked on the main thread only.
+  int parallel_marking_workers() const { return parallel_marking_workers_; }
+
   MarkingParity marking_parity() { return marking_parity_; }
 
   // Concurrent and parallel sweeping support. If required_freed_bytes was set
@@ -732,6 +826,24 @@ class MarkCompactCollector {
 
  private:
   class SweeperTask;
+  class MarkingTask;
+
+  // Participants in parallel marking, including the main thread.
+  static const int kMaxMarkingWorkers = 8;
+
+  // The marking deque is handed to helper threads only when it holds at
+  // least this many objects.
+  static const int kMinObjectsForParallelMarking = 1024;
+
+  struct MarkingWorker {
+    MarkingWorker() : overflowed(false) {}
+
+    ParallelMarkingDeque deque;
+    // Black objects the worker may not visit, see MarkInParallel().
+    List<HeapObject*> deferred_objects;
+    // Whether the worker left grey objects in the heap.
+    bool overflowed;
+  };
 
   explicit MarkCompactCollector(Heap* heap);
   ~MarkCompactCollector();
@@ -780,6 +892,17 @@ class MarkCompactCollector {
 
   base::Semaphore pending_sweeper_jobs_semaphore_;
 
+  // Helper tasks used by EmptyMarkingDeque() in the current GC.
+  int marking_tasks_;
+
+  // See parallel_marking_workers().
+  int parallel_marking_workers_;
+
+  // Parallel marking state, allocated on first use.
+  MarkingWorker* marking_workers_;
+  base::Atomic32 active_marking_workers_;
+  base::Semaphore pending_marking_tasks_semaphore_;
+
   bool evacuation_;
 
   SlotsBufferAllocator slots_buffer_allocator_;
@@ -803,6 +926,7 @@ class MarkCompactCollector {
   friend class MarkCompactMarkingVisitor;
   friend class CodeMarkingVisitor;
   friend class SharedFunctionInfoMarkingVisitor;
+  friend class ParallelMarkingVisitor;
 
   // Mark code objects that are active on the stack to prevent them
   // from being flushed.
@@ -863,6 +987,31 @@ class MarkCompactCollector {
   // flag on the marking stack.
   void RefillMarkingDeque();
 
+  // Number of helper tasks that EmptyMarkingDeque() should use, 0 if it
+  // should mark on the main thread only.
+  static int NumberOfMarkingTasks();
+
+  // Empties the marking stack together with helper tasks. The helpers only
+  // visit objects whose bodies are plain tagged fields and that do not point
+  // to evacuation candidates; they leave all others to the main thread,
+  // which visits them once the helpers are done. This may leave objects on
+  // the marking stack and overflowed objects in the heap.
+  void MarkInParallel();
+
+  // Marks objects until no participant in parallel marking has work left.
+  // Called by the main thread (worker 0) and by the helper tasks.
+  void DrainMarkingWorker(int worker);
+
+  // Moves objects from the marking stack to the main thread's parallel
+  // marking deque, so that the helpers can steal them.
+  bool RefillMainMarkingWorker();
+
+  // Called by a worker that ran out of work. Returns false if it stole some
+  // from another worker, true once all workers are out of work.
+  bool TerminateMarkingWorker(int worker);
+
+  void PushInParallel(int worker, HeapObject* object);
+
   // Callback function for telling whether the object *p is an unmarked
   // heap object.
   static bool IsUnmarkedHeapObject(Object** p);
@@ -0,0 +1,528 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/v8.h"
+
+#include "src/heap/parallel-scavenger.h"
+
+#include "src/base/sys-info.h"
+#include "src/code-stubs.h"
+#include "src/cpu-profiler.h"
+#include "src/heap/objects-visiting.h"
+#include "src/heap/objects-visiting-inl.h"
+#include "src/heap/spaces-inl.h"
+#include "src/heap/store-buffer.h"
+#include "src/heap-profiler.h"
+
+namespace v8 {
+namespace internal {
+
+namespace {
+
+// Whether copies of objects with |map| have to be scanned. Like
+// HeapObject::MayContainRawValues(), but without reading the map word of the
+// object, which other workers may be forwarding.
+bool HasPointers(Map* map) {
+  InstanceType type = map->instance_type();
+  if (type <= LAST_NAME_TYPE) {
+    return type == SYMBOL_TYPE ||
+           (type & kIsIndirectStringMask) == kIsIndirectStringTag;
+  }
+  return type > LAST_DATA_TYPE;
+}
+
+
+// The alignment the sequential scavenger copies objects with |map| with.
+AllocationAlignment AlignmentFor(Map* map) {
+#ifdef V8_HOST_ARCH_32_BIT
+  InstanceType type = map->instance_type();
+  if (type == FIXED_DOUBLE_ARRAY_TYPE || type == FIXED_FLOAT64_ARRAY_TYPE) {
+    return kDoubleAligned;
+  }
+#endif
+  return kWordAligned;
+}
+
+
+int AllocationSize(int size, AllocationAlignment alignment) {
+  return alignment == kWordAligned ? size : size + kPointerSize;
+}
+
+}  // namespace
+
+
+// Visits the copies a worker scans. Pointers to from-space are updated through
+// the worker that runs on the current thread.
+class ParallelScavengeVisitor
+    : public StaticNewSpaceVisitor<ParallelScavengeVisitor> {
+ public:
+  static inline void VisitPointer(Heap* heap, Object** p) {
+    heap->parallel_scavenger()->ScavengePointers(p, p + 1);
+  }
+
+  static inline void VisitPointers(Heap* heap, Object** start, Object** end) {
+    heap->parallel_scavenger()->ScavengePointers(start, end);
+  }
+};
+
+
+class ParallelScavenger::ScavengingTask : public v8::Task {
+ public:
+  ScavengingTask(ParallelScavenger* scavenger, int worker)
+      : scavenger_(scavenger), worker_(worker) {}
+
+  virtual ~ScavengingTask() {}
+
+ private:
+  // v8::Task overrides.
+  void Run() override {
+    if (scavenger_->phase_ != SCAN_CHUNKS) {
+      // Counted in only once its round has started; its deque is still
+      // empty then, so the other workers cannot terminate without its
+      // objects.
+      base::Barrier_AtomicIncrement(&scavenger_->active_workers_, 1);
+    }
+    scavenger_->Run(worker_);
+    scavenger_->pending_tasks_semaphore_.Signal();
+  }
+
+  ParallelScavenger* scavenger_;
+  int worker_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScavengingTask);
+};
+
+
+base::Thread::LocalStorageKey ParallelScavenger::current_worker_key_;
+
+
+ParallelScavenger::Worker::Worker()
+    : semi_space_copied_bytes(0), promoted_bytes(0), duration(0.0) {}
+
+
+ParallelScavenger::ParallelScavenger(Heap* heap)
+    : heap_(heap),
+      tasks_(0),
+      phase_(COPY),
+      workers_(NULL),
+      main_thread_visitor_(this),
+      store_buffer_start_(NULL),
+      store_buffer_end_(NULL),
+      next_store_buffer_chunk_(0),
+      next_chunk_(0),
+      active_workers_(0),
+      pending_tasks_semaphore_(0) {}
+
+
+ParallelScavenger::~ParallelScavenger() { delete[] workers_; }
+
+
+void ParallelScavenger::Initialize() {
+  current_worker_key_ = base::Thread::CreateThreadLocalKey();
+  ParallelScavengeVisitor::Initialize();
+}
+
+
+int ParallelScavenger::NumberOfTasks(Heap* heap) {
+  if (!FLAG_parallel_scavenge) return 0;
+  // Only the sequential scavenger transfers mark bits and reports the moves
+  // of objects.
+  Isolate* isolate = heap->isolate();
+  if (!heap->incremental_marking()->IsStopped() || FLAG_verify_predictable ||
+      FLAG_log_gc || isolate->logger()->is_logging() ||
+      isolate->cpu_profiler()->is_profiling() ||
+      (isolate->heap_profiler() != NULL &&
+       isolate->heap_profiler()->is_tracking_object_moves())) {
+    return 0;
+  }
+#ifdef DEBUG
+  if (FLAG_heap_stats) return 0;
+#endif
+  int tasks = FLAG_parallel_scavenge_tasks;
+  if (tasks <= 0) tasks = base::SysInfo::NumberOfProcessors() - 1;
+  return Max(0, Min(tasks, kMaxWorkers - 1));
+}
+
+
+void ParallelScavenger::Start(int tasks) {
+  DCHECK(tasks > 0 && tasks < kMaxWorkers);
+  tasks_ = tasks;
+  if (workers_ == NULL) workers_ = new Worker[kMaxWorkers];
+  for (int i = 0; i <= tasks_; i++) {
+    Worker* worker = &workers_[i];
+    if (!worker->deque.IsInitialized()) {
+      worker->deque.Initialize(kDequeCapacity);
+    }
+    worker->semi_space_copied_bytes = 0;
+    worker->promoted_bytes = 0;
+    worker->duration = 0.0;
+  }
+
+  heap_->store_buffer()->TakePointersToNewSpace(
+      &store_buffer_start_, &store_buffer_end_, &chunks_);
+  if (!chunks_.is_empty()) {
+    // Nothing may be promoted while the chunks are iterated.
+    base::NoBarrier_Store(&next_chunk_, 0);
+    StartRound(SCAN_CHUNKS);
+    JoinRound();
+    chunks_.Rewind(0);
+  }
+
+  base::NoBarrier_Store(&next_store_buffer_chunk_, 0);
+  StartRound(COPY_FROM_OLD_GENERATION);
+}
+
+
+void ParallelScavenger::Join() { JoinRound(); }
+
+
+void ParallelScavenger::ProcessCopiedObjects() {
+  StartRound(COPY);
+  JoinRound();
+}
+
+
+void ParallelScavenger::Finish() {
+  {
+    StoreBufferRebuildScope scope(heap_, heap_->store_buffer(),
+                                  &Heap::ScavengeStoreBufferCallback);
+    for (int i = 0; i <= tasks_; i++) {
+      List<Address>* slots = &workers_[i].old_to_new_slots;
+      for (int j = 0; j < slots->length(); j++) {
+        heap_->store_buffer()->EnterDirectlyIntoStoreBuffer(slots->at(j));
+      }
+      slots->Rewind(0);
+    }
+  }
+
+  double durations[kMaxWorkers];
+  for (int i = 0; i <= tasks_; i++) {
+    Worker* worker = &workers_[i];
+    DCHECK(worker->deque.IsEmpty() && worker->overflow.is_empty());
+    DCHECK(worker->from_space_slots.is_empty());
+    ReleaseLab(NEW_SPACE, &worker->new_space_lab);
+    ReleaseLab(OLD_SPACE, &worker->old_space_lab);
+    heap_->IncrementSemiSpaceCopiedObjectSize(
+        static_cast<int>(worker->semi_space_copied_bytes));
+    heap_->IncrementPromotedObjectsSize(
+        static_cast<int>(worker->promoted_bytes));
+    durations[i] = worker->duration;
+  }
+  heap_->tracer()->AddParallelScavengeDurations(tasks_ + 1, durations);
+}
+
+
+void ParallelScavenger::ScavengePointers(Object** start, Object** end) {
+  Worker* worker = CurrentWorker();
+  // Promoted objects keep their pointers to new space in the store buffer.
+  bool record_slots = !heap_->InNewSpace(reinterpret_cast<Address>(start));
+  for (Object** p = start; p < end; p++) {
+    Object* object = *p;
+    if (!heap_->InFromSpace(object)) continue;
+    HeapObject* target =
+        Evacuate(worker, reinterpret_cast<HeapObject*>(object));
+    *p = target;
+    if (record_slots && heap_->InToSpace(target)) {
+      worker->old_to_new_slots.Add(reinterpret_cast<Address>(p));
+    }
+  }
+}
+
+
+void ParallelScavenger::RootVisitor::VisitPointers(Object** start,
+                                                   Object** end) {
+  Heap* heap = scavenger_->heap_;
+  Worker* worker = &scavenger_->workers_[0];
+  for (Object** p = start; p < end; p++) {
+    Object* object = *p;
+    if (!heap->InFromSpace(object)) continue;
+    *p = scavenger_->Evacuate(worker, reinterpret_cast<HeapObject*>(object));
+  }
+}
+
+
+ParallelScavenger::Worker* ParallelScavenger::CurrentWorker() {
+  return reinterpret_cast<Worker*>(
+      base::Thread::GetExistingThreadLocal(current_worker_key_));
+}
+
+
+void ParallelScavenger::CollectFromSpaceSlot(HeapObject** slot,
+                                             HeapObject* object) {
+  CurrentWorker()->from_space_slots.Add(reinterpret_cast<Address>(slot));
+}
+
+
+void ParallelScavenger::StartRound(Phase phase) {
+  phase_ = phase;
+  base::NoBarrier_Store(&active_workers_, 1);
+  for (int i = 1; i <= tasks_; i++) {
+    V8::GetCurrentPlatform()->CallOnBackgroundThread(
+        new ScavengingTask(this, i), v8::Platform::kShortRunningTask);
+  }
+}
+
+
+void ParallelScavenger::JoinRound() {
+  Run(0);
+  for (int i = 1; i <= tasks_; i++) {
+    pending_tasks_semaphore_.Wait();
+  }
+}
+
+
+void ParallelScavenger::Run(int index) {
+  Worker* worker = &workers_[index];
+  double start_time = base::OS::TimeCurrentMillis();
+  base::Thread::SetThreadLocal(current_worker_key_, worker);
+  if (phase_ == SCAN_CHUNKS) {
+    ScanChunks(worker);
+  } else {
+    if (phase_ == COPY_FROM_OLD_GENERATION) {
+      ScavengeStoreBuffer(worker);
+      List<Address>* slots = &worker->from_space_slots;
+      for (int i = 0; i < slots->length(); i++) {
+        ScavengeOldToNewSlot(worker, slots->at(i));
+      }
+      slots->Rewind(0);
+    }
+    do {
+      ScanCopiedObjects(worker);
+    } while (!Terminate(index));
+  }
+  base::Thread::SetThreadLocal(current_worker_key_, NULL);
+  worker->duration += base::OS::TimeCurrentMillis() - start_time;
+}
+
+
+bool ParallelScavenger::Terminate(int index) {
+  return ParallelMarkingDeque::TerminateWorker(&active_workers_, workers_,
+                                               tasks_ + 1, index);
+}
+
+
+void ParallelScavenger::ScanChunks(Worker* worker) {
+  StoreBuffer* store_buffer = heap_->store_buffer();
+  while (true) {
+    int index = base::NoBarrier_AtomicIncrement(&next_chunk_, 1) - 1;
+    if (index >= chunks_.length()) return;
+    store_buffer->FindPointersToNewSpaceOnChunk(chunks_[index],
+                                                &CollectFromSpaceSlot);
+  }
+}
+
+
+void ParallelScavenger::ScavengeStoreBuffer(Worker* worker) {
+  int chunks = static_cast<int>((store_buffer_end_ - store_buffer_start_ +
+                                 kStoreBufferChunkSize - 1) /
+                                kStoreBufferChunkSize);
+  while (true) {
+    int chunk =
+        base::NoBarrier_AtomicIncrement(&next_store_buffer_chunk_, 1) - 1;
+    if (chunk >= chunks) return;
+    Address* start = store_buffer_start_ + chunk * kStoreBufferChunkSize;
+    Address* end = Min(start + kStoreBufferChunkSize, store_buffer_end_);
+    for (Address* current = start; current < end; current++) {
+      ScavengeOldToNewSlot(worker, *current);
+    }
+    // Keep the overflow small, and share what was copied early.
+    ScanCopiedObjects(worker);
+  }
+}
+
+
+void ParallelScavenger::ScavengeOldToNewSlot(Worker* worker,
+                                             Address slot_address) {
+  Object** slot = reinterpret_cast<Object**>(slot_address);
+  Object* object = *slot;
+  // If the object is not in from space, the slot was updated through a
+  // duplicate entry already.
+  if (!heap_->InFromSpace(object)) return;
+  HeapObject* target = Evacuate(worker, reinterpret_cast<HeapObject*>(object));
+  *slot = target;
+  if (heap_->InToSpace(target)) worker->old_to_new_slots.Add(slot_address);
+}
+
+
+void ParallelScavenger::ScanCopiedObjects(Worker* worker) {
+  const int kRefillBatchSize = 256;
+  while (true) {
+    HeapObject* object;
+    if (!worker->deque.Pop(&object)) {
+      if (worker->overflow.is_empty()) return;
+      // Move some of the overflow back to where other workers can steal it.
+      for (int i = 0; i < kRefillBatchSize && !worker->overflow.is_empty();
+           i++) {
+        if (!worker->deque.Push(worker->overflow.last())) break;
+        worker->overflow.RemoveLast();
+      }
+      continue;
+    }
+    ParallelScavengeVisitor::IterateBody(object->map(), object);
+  }
+}
+
+
+void ParallelScavenger::Push(Worker* worker, HeapObject* object) {
+  if (!worker->deque.Push(object)) worker->overflow.Add(object);
+}
+
+
+HeapObject* ParallelScavenger::Evacuate(Worker* worker, HeapObject* object) {
+  DCHECK(heap_->InFromSpace(object));
+  MapWord map_word = object->synchronized_map_word();
+  if (map_word.IsForwardingAddress()) return map_word.ToForwardingAddress();
+
+  Map* map = map_word.ToMap();
+  int size = object->SizeFromMap(map);
+  SLOW_DCHECK(size <= Page::kMaxRegularHeapObjectSize);
+  AllocationAlignment alignment = AlignmentFor(map);
+  AllocationMemento* memento = FindAllocationMemento(object, map, size);
+
+  // Same order as in the sequential scavenger: a semi-space copy may fail
+  // due to fragmentation, and promotion may fail when the old generation is
+  // full.
+  AllocationInfo* lab = NULL;
+  HeapObject* target = NULL;
+  if (!heap_->ShouldBePromoted(object->address(), size)) {
+    lab = &worker->new_space_lab;
+    target = Allocate(NEW_SPACE, lab, size, alignment);
+  }
+  if (target == NULL) {
+    lab = &worker->old_space_lab;
+    target = Allocate(OLD_SPACE, lab, size, alignment);
+  }
+  if (target == NULL) {
+    lab = &worker->new_space_lab;
+    target = Allocate(NEW_SPACE, lab, size, alignment);
+  }
+  CHECK_NOT_NULL(target);
+
+  heap_->CopyBlock(target->address(), object->address(), size);
+  base::AtomicWord expected =
+      static_cast<base::AtomicWord>(map_word.ToRawValue());
+  base::AtomicWord forwarding = static_cast<base::AtomicWord>(
+      MapWord::FromForwardingAddress(target).ToRawValue());
+  base::AtomicWord found = base::Release_CompareAndSwap(
+      reinterpret_cast<base::AtomicWord*>(object->address()), expected,
+      forwarding);
+  if (found != expected) {
+    // Another worker copied the object first.
+    UndoAllocation(lab, size, alignment);
+    return MapWord::FromRawValue(static_cast<uintptr_t>(found))
+        .ToForwardingAddress();
+  }
+
+  if (memento != NULL) RecordMementoFound(memento);
+  if (lab == &worker->old_space_lab) {
+    worker->promoted_bytes += size;
+  } else {
+    worker->semi_space_copied_bytes += size;
+  }
+  if (HasPointers(map)) Push(worker, target);
+  return target;
+}
+
+
+HeapObject* ParallelScavenger::Allocate(AllocationSpace space,
+                                        AllocationInfo* lab, int size,
+                                        AllocationAlignment alignment) {
+  int allocation_size = AllocationSize(size, alignment);
+  if (lab->limit() - lab->top() < allocation_size &&
+      !RefillLab(space, lab, allocation_size)) {
+    return NULL;
+  }
+  HeapObject* object = HeapObject::FromAddress(lab->top());
+  lab->set_top(lab->top() + allocation_size);
+  if (alignment != kWordAligned) {
+    object = heap_->EnsureAligned(object, size, alignment);
+  }
+  return object;
+}
+
+
+void ParallelScavenger::UndoAllocation(AllocationInfo* lab, int size,
+                                       AllocationAlignment alignment) {
+  // Allocate() always bumps the current buffer, and nothing was allocated
+  // since.
+  lab->set_top(lab->top() - AllocationSize(size, alignment));
+}
+
+
+bool ParallelScavenger::RefillLab(AllocationSpace space, AllocationInfo* lab,
+                                  int size) {
+  DCHECK(space == NEW_SPACE || space == OLD_SPACE);
+  base::LockGuard<base::Mutex> guard(&allocation_mutex_);
+  ReleaseLab(space, lab);
+  int lab_size = Max(size, kLabSize);
+  HeapObject* memory;
+  while (true) {
+    AllocationResult allocation =
+        space == NEW_SPACE
+            ? heap_->new_space()->AllocateRaw(lab_size, kWordAligned)
+            : heap_->old_space()->AllocateRaw(lab_size, kWordAligned);
+    if (allocation.To(&memory)) break;
+    // A smaller buffer may still fit.
+    if (lab_size == size) return false;
+    lab_size = size;
+  }
+  lab->set_top(memory->address());
+  lab->set_limit(memory->address() + lab_size);
+  return true;
+}
+
+
+void ParallelScavenger::ReleaseLab(AllocationSpace space, AllocationInfo* lab) {
+  int remaining = static_cast<int>(lab->limit() - lab->top());
+  if (remaining > 0) {
+    if (space == NEW_SPACE) {
+      heap_->CreateFillerObjectAt(lab->top(), remaining);
+    } else {
+      heap_->old_space()->Free(lab->top(), remaining);
+    }
+  }
+  lab->set_top(NULL);
+  lab->set_limit(NULL);
+}
+
+
+AllocationMemento* ParallelScavenger::FindAllocationMemento(HeapObject* object,
+                                                            Map* map,
+                                                            int size) {
+  if (!FLAG_allocation_site_pretenuring ||
+      !AllocationSite::CanTrack(map->instance_type())) {
+    return NULL;
+  }
+  // Like Heap::FindAllocationMemento(), which cannot be used because it reads
+  // the map word of |object|. The allocation top of from-space is covered by
+  // a filler, so there is no need to compare against it.
+  Address object_address = object->address();
+  Address memento_address = object_address + size;
+  Address last_memento_word_address = memento_address + kPointerSize;
+  if (!NewSpacePage::OnSamePage(object_address, last_memento_word_address)) {
+    return NULL;
+  }
+  HeapObject* candidate = HeapObject::FromAddress(memento_address);
+  MapWord candidate_map_word = candidate->synchronized_map_word();
+  MSAN_MEMORY_IS_INITIALIZED(&candidate_map_word, sizeof(candidate_map_word));
+  if (candidate_map_word.ToRawValue() !=
+      reinterpret_cast<uintptr_t>(heap_->allocation_memento_map())) {
+    return NULL;
+  }
+  AllocationMemento* memento = AllocationMemento::cast(candidate);
+  if (!memento->IsValid()) return NULL;
+  return memento;
+}
+
+
+void ParallelScavenger::RecordMementoFound(AllocationMemento* memento) {
+  base::LockGuard<base::Mutex> guard(&feedback_mutex_);
+  AllocationSite* site = memento->GetAllocationSite();
+  if (site->IncrementMementoFoundCount()) {
+    heap_->AddAllocationSiteToScratchpad(site, Heap::IGNORE_SCRATCHPAD_SLOT);
+  }
+}
+
+}  // namespace internal
+}  // namespace v8
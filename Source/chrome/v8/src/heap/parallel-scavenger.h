@@ -0,0 +1,171 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_HEAP_PARALLEL_SCAVENGER_H_
+#define V8_HEAP_PARALLEL_SCAVENGER_H_
+
+#include "src/base/atomicops.h"
+#include "src/base/platform/mutex.h"
+#include "src/base/platform/platform.h"
+#include "src/base/platform/semaphore.h"
+#include "src/heap/gc-tracer.h"
+#include "src/heap/mark-compact.h"
+#include "src/heap/spaces.h"
+#include "src/list.h"
+
+namespace v8 {
+namespace internal {
+
+class AllocationMemento;
+class Heap;
+
+// Copies the survivors of a scavenge with the main thread and helper tasks.
+// Heap::Scavenge() uses it when --parallel-scavenge is on and neither
+// incremental marking nor any logger or profiler watches objects move.
+//
+// The old-to-new pointers are found first: the store buffer is split into
+// chunks, and the pages flagged scan_on_scavenge are scanned by all workers
+// before anything is promoted onto them. The main thread copies what the
+// roots point to at the same time. Every worker allocates its copies in its
+// own linear buffers in to-space and old space, claims an object by swapping
+// in its forwarding address, and keeps the copies it still has to scan in a
+// deque that idle workers steal from. Old-to-new slots are collected per
+// worker and entered into the store buffer by the main thread at the end.
+class ParallelScavenger {
+ public:
+  static const int kMaxWorkers = GCTracer::kMaxParallelScavengeWorkers;
+
+  explicit ParallelScavenger(Heap* heap);
+  ~ParallelScavenger();
+
+  static void Initialize();
+
+  // Number of helper tasks the next scavenge of |heap| can use, zero if it
+  // has to run on the main thread only.
+  static int NumberOfTasks(Heap* heap);
+
+  // Takes over the store buffer and starts |tasks| helper tasks on it. The
+  // main thread then passes the roots to main_thread_visitor() and calls
+  // Join().
+  void Start(int tasks);
+
+  // Copies the from-space objects that the visited pointers point to.
+  ObjectVisitor* main_thread_visitor() { return &main_thread_visitor_; }
+
+  // Works along with the helper tasks until all copies are scanned.
+  void Join();
+
+  // Scans, with the helper tasks again, what main_thread_visitor() copied
+  // since the last Join().
+  void ProcessCopiedObjects();
+
+  // Rebuilds the store buffer, gives back unused allocation buffers and
+  // reports the statistics of the scavenge.
+  void Finish();
+
+  // Called for the pointers of the objects that a worker scans.
+  void ScavengePointers(Object** start, Object** end);
+
+ private:
+  class RootVisitor : public ObjectVisitor {
+   public:
+    explicit RootVisitor(ParallelScavenger* scavenger)
+        : scavenger_(scavenger) {}
+
+    void VisitPointers(Object** start, Object** end) override;
+
+   private:
+    ParallelScavenger* scavenger_;
+  };
+
+  class ScavengingTask;
+
+  enum Phase {
+    SCAN_CHUNKS,
+    COPY_FROM_OLD_GENERATION,
+    COPY
+  };
+
+  struct Worker {
+    Worker();
+
+    // Copies that still have to be scanned. Other workers steal from here.
+    ParallelMarkingDeque deque;
+    // Copies that did not fit into the deque.
+    List<HeapObject*> overflow;
+    // Slots pointing to from-space found on the chunks to scan.
+    List<Address> from_space_slots;
+    // Slots outside of new space that point to to-space after the scavenge.
+    List<Address> old_to_new_slots;
+    AllocationInfo new_space_lab;
+    AllocationInfo old_space_lab;
+    intptr_t semi_space_copied_bytes;
+    intptr_t promoted_bytes;
+    double duration;
+  };
+
+  // Size of the linear allocation buffers, unless an object needs more.
+  static const int kLabSize = 8 * KB;
+  static const int kDequeCapacity = 16 * KB;
+  static const int kStoreBufferChunkSize = 1 * KB;
+
+  static Worker* CurrentWorker();
+  static void CollectFromSpaceSlot(HeapObject** slot, HeapObject* object);
+
+  void StartRound(Phase phase);
+  void JoinRound();
+  void Run(int index);
+  bool Terminate(int index);
+
+  void ScanChunks(Worker* worker);
+  void ScavengeStoreBuffer(Worker* worker);
+  void ScavengeOldToNewSlot(Worker* worker, Address slot_address);
+  void ScanCopiedObjects(Worker* worker);
+  void Push(Worker* worker, HeapObject* object);
+
+  // Returns the copy of |object|, copying it first unless another worker
+  // did.
+  HeapObject* Evacuate(Worker* worker, HeapObject* object);
+  HeapObject* Allocate(AllocationSpace space, AllocationInfo* lab, int size,
+                       AllocationAlignment alignment);
+  void UndoAllocation(AllocationInfo* lab, int size,
+                      AllocationAlignment alignment);
+  bool RefillLab(AllocationSpace space, AllocationInfo* lab, int size);
+  void ReleaseLab(AllocationSpace space, AllocationInfo* lab);
+
+  AllocationMemento* FindAllocationMemento(HeapObject* object, Map* map,
+                                           int size);
+  void RecordMementoFound(AllocationMemento* memento);
+
+  static base::Thread::LocalStorageKey current_worker_key_;
+
+  Heap* heap_;
+  int tasks_;
+  Phase phase_;
+  // kMaxWorkers of them, allocated by the first parallel scavenge. The
+  // main thread is the first.
+  Worker* workers_;
+  RootVisitor main_thread_visitor_;
+
+  Address* store_buffer_start_;
+  Address* store_buffer_end_;
+  base::Atomic32 next_store_buffer_chunk_;
+  List<MemoryChunk*> chunks_;
+  base::Atomic32 next_chunk_;
+
+  base::Atomic32 active_workers_;
+  base::Semaphore pending_tasks_semaphore_;
+
+  // Guards allocation in new space and old space.
+  base::Mutex allocation_mutex_;
+  // Guards allocation site feedback.
+  base::Mutex feedback_mutex_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelScavenger);
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_HEAP_PARALLEL_SCAVENGER_H_
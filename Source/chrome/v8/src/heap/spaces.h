@@ -127,6 +127,21 @@ class MarkBit {
   inline bool Get() { return (*cell_ & mask_) != 0; }
   inline void Clear() { *cell_ &= ~mask_; }
 
+  // Sets the bit even if other threads are setting bits of the same cell.
+  // Returns false if the bit was set already.
+  inline bool SetAtomically() {
+    base::Atomic32* cell = reinterpret_cast<base::Atomic32*>(cell_);
+    base::Atomic32 mask = static_cast<base::Atomic32>(mask_);
+    base::Atomic32 old_value = base::NoBarrier_Load(cell);
+    while ((old_value & mask) == 0) {
+      base::Atomic32 seen =
+          base::NoBarrier_CompareAndSwap(cell, old_value, old_value | mask);
+      if (seen == old_value) return true;
+      old_value = seen;
+    }
+    return false;
+  }
+
   CellType* cell_;
   CellType mask_;
 
@@ -519,6 +534,14 @@ class MemoryChunk {
     MemoryChunk::FromAddress(address)->IncrementLiveBytes(by);
   }
 
+  // For parallel marking, where several threads update the same page.
+  static void IncrementLiveBytesFromGCAtomically(Address address, int by) {
+    MemoryChunk* chunk = MemoryChunk::FromAddress(address);
+    STATIC_ASSERT(sizeof(chunk->live_byte_count_) == sizeof(base::Atomic32));
+    base::NoBarrier_AtomicIncrement(
+        reinterpret_cast<base::Atomic32*>(&chunk->live_byte_count_), by);
+  }
+
   static void IncrementLiveBytesFromMutator(Address address, int by);
 
   static const intptr_t kAlignment =
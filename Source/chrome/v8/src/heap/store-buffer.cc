@@ -443,89 +443,124 @@ void StoreBuffer::IteratePointersToNewSpace(ObjectSlotCallback slot_callback) {
         if (callback_ != NULL) {
           (*callback_)(heap_, chunk, kStoreBufferScanningPageEvent);
         }
-        if (chunk->owner() == heap_->lo_space()) {
-          LargePage* large_page = reinterpret_cast<LargePage*>(chunk);
-          HeapObject* array = large_page->GetObject();
-          DCHECK(array->IsFixedArray());
-          Address start = array->address();
-          Address end = start + array->Size();
-          FindPointersToNewSpaceInRegion(start, end, slot_callback);
-        } else {
-          Page* page = reinterpret_cast<Page*>(chunk);
-          PagedSpace* owner = reinterpret_cast<PagedSpace*>(page->owner());
-          if (owner == heap_->map_space()) {
-            DCHECK(page->WasSwept());
-            HeapObjectIterator iterator(page, NULL);
-            for (HeapObject* heap_object = iterator.Next(); heap_object != NULL;
-                 heap_object = iterator.Next()) {
-              // We skip free space objects.
-              if (!heap_object->IsFiller()) {
-                DCHECK(heap_object->IsMap());
+        PrepareChunkForScanning(chunk);
+        FindPointersToNewSpaceOnChunk(chunk, slot_callback);
+      }
+    }
+    if (callback_ != NULL) {
+      (*callback_)(heap_, NULL, kStoreBufferScanningPageEvent);
+    }
+  }
+}
+
+
+void StoreBuffer::TakePointersToNewSpace(Address** start, Address** end,
+                                         List<MemoryChunk*>* chunks) {
+  bool some_pages_to_scan = PrepareForIteration();
+  *start = old_start_;
+  *end = old_top_;
+  old_top_ = old_start_;
+  if (some_pages_to_scan) {
+    PointerChunkIterator it(heap_);
+    MemoryChunk* chunk;
+    while ((chunk = it.next()) != NULL) {
+      if (chunk->scan_on_scavenge()) {
+        chunk->set_scan_on_scavenge(false);
+        PrepareChunkForScanning(chunk);
+        chunks->Add(chunk);
+      }
+    }
+  }
+}
+
+
+void StoreBuffer::PrepareChunkForScanning(MemoryChunk* chunk) {
+  if (chunk->owner() == heap_->lo_space()) return;
+  Page* page = reinterpret_cast<Page*>(chunk);
+  PagedSpace* owner = reinterpret_cast<PagedSpace*>(page->owner());
+  if (owner == heap_->map_space()) {
+    DCHECK(page->WasSwept());
+  } else if (!page->SweepingCompleted()) {
+    heap_->mark_compact_collector()->SweepInParallel(page, owner);
+    if (!page->SweepingCompleted()) {
+      // We were not able to sweep that page, i.e., a concurrent
+      // sweeper thread currently owns this page.
+      // TODO(hpayer): This may introduce a huge pause here. We
+      // just care about finish sweeping of the scan on scavenge page.
+      heap_->mark_compact_collector()->EnsureSweepingCompleted();
+    }
+  }
+}
+
+
+void StoreBuffer::FindPointersToNewSpaceOnChunk(
+    MemoryChunk* chunk, ObjectSlotCallback slot_callback) {
+  if (chunk->owner() == heap_->lo_space()) {
+    LargePage* large_page = reinterpret_cast<LargePage*>(chunk);
+    HeapObject* array = large_page->GetObject();
+    DCHECK(array->IsFixedArray());
+    Address start = array->address();
+    Address end = start + array->Size();
+    FindPointersToNewSpaceInRegion(start, end, slot_callback);
+  } else {
+    Page* page = reinterpret_cast<Page*>(chunk);
+    PagedSpace* owner = reinterpret_cast<PagedSpace*>(page->owner());
+    if (owner == heap_->map_space()) {
+      DCHECK(page->WasSwept());
+      HeapObjectIterator iterator(page, NULL);
+      for (HeapObject* heap_object = iterator.Next(); heap_object != NULL;
+           heap_object = iterator.Next()) {
+        // We skip free space objects.
+        if (!heap_object->IsFiller()) {
+          DCHECK(heap_object->IsMap());
+          FindPointersToNewSpaceInRegion(
+              heap_object->address() + Map::kPointerFieldsBeginOffset,
+              heap_object->address() + Map::kPointerFieldsEndOffset,
+              slot_callback);
+        }
+      }
+    } else {
+      DCHECK(page->SweepingCompleted());
+      CHECK(page->owner() == heap_->old_space());
+      HeapObjectIterator iterator(page, NULL);
+      for (HeapObject* heap_object = iterator.Next(); heap_object != NULL;
+           heap_object = iterator.Next()) {
+        // We iterate over objects that contain new space pointers only.
+        bool may_contain_raw_values = heap_object->MayContainRawValues();
+        if (!may_contain_raw_values) {
+          Address obj_address = heap_object->address();
+          const int start_offset = HeapObject::kHeaderSize;
+          const int end_offset = heap_object->Size();
+#if V8_DOUBLE_FIELDS_UNBOXING
+          LayoutDescriptorHelper helper(heap_object->map());
+          bool has_only_tagged_fields = helper.all_fields_tagged();
+
+          if (!has_only_tagged_fields) {
+            for (int offset = start_offset; offset < end_offset;) {
+              int end_of_region_offset;
+              if (helper.IsTagged(offset, end_offset, &end_of_region_offset)) {
                 FindPointersToNewSpaceInRegion(
-                    heap_object->address() + Map::kPointerFieldsBeginOffset,
-                    heap_object->address() + Map::kPointerFieldsEndOffset,
+                    obj_address + offset, obj_address + end_of_region_offset,
                     slot_callback);
               }
+              offset = end_of_region_offset;
             }
           } else {
-            if (!page->SweepingCompleted()) {
-              heap_->mark_compact_collector()->SweepInParallel(page, owner);
-              if (!page->SweepingCompleted()) {
-                // We were not able to sweep that page, i.e., a concurrent
-                // sweeper thread currently owns this page.
-                // TODO(hpayer): This may introduce a huge pause here. We
-                // just care about finish sweeping of the scan on scavenge page.
-                heap_->mark_compact_collector()->EnsureSweepingCompleted();
-              }
-            }
-            CHECK(page->owner() == heap_->old_space());
-            HeapObjectIterator iterator(page, NULL);
-            for (HeapObject* heap_object = iterator.Next(); heap_object != NULL;
-                 heap_object = iterator.Next()) {
-              // We iterate over objects that contain new space pointers only.
-              bool may_contain_raw_values = heap_object->MayContainRawValues();
-              if (!may_contain_raw_values) {
-                Address obj_address = heap_object->address();
-                const int start_offset = HeapObject::kHeaderSize;
-                const int end_offset = heap_object->Size();
-#if V8_DOUBLE_FIELDS_UNBOXING
-                LayoutDescriptorHelper helper(heap_object->map());
-                bool has_only_tagged_fields = helper.all_fields_tagged();
-
-                if (!has_only_tagged_fields) {
-                  for (int offset = start_offset; offset < end_offset;) {
-                    int end_of_region_offset;
-                    if (helper.IsTagged(offset, end_offset,
-                                        &end_of_region_offset)) {
-                      FindPointersToNewSpaceInRegion(
-                          obj_address + offset,
-                          obj_address + end_of_region_offset, slot_callback);
-                    }
-                    offset = end_of_region_offset;
-                  }
-                } else {
 #endif
-                  Address start_address = obj_address + start_offset;
-                  Address end_address = obj_address + end_offset;
-                  // Object has only tagged fields.
-                  FindPointersToNewSpaceInRegion(start_address, end_address,
-                                                 slot_callback);
+            Address start_address = obj_address + start_offset;
+            Address end_address = obj_address + end_offset;
+            // Object has only tagged fields.
+            FindPointersToNewSpaceInRegion(start_address, end_address,
+                                           slot_callback);
 #if V8_DOUBLE_FIELDS_UNBOXING
-                }
-#endif
-              }
-            }
           }
+#endif
         }
       }
     }
-    if (callback_ != NULL) {
-      (*callback_)(heap_, NULL, kStoreBufferScanningPageEvent);
-    }
   }
 }
 
-
 void StoreBuffer::Compact() {
   CHECK(hash_set_1_ == heap_->isolate()->store_buffer_hash_set_1_address());
   CHECK(hash_set_2_ == heap_->isolate()->store_buffer_hash_set_2_address());
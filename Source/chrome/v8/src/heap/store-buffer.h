@@ -9,10 +9,12 @@
 #include "src/base/logging.h"
 #include "src/base/platform/platform.h"
 #include "src/globals.h"
+#include "src/list.h"
 
 namespace v8 {
 namespace internal {
 
+class MemoryChunk;
 class Page;
 class PagedSpace;
 class StoreBuffer;
@@ -59,6 +61,21 @@ class StoreBuffer {
   // surviving old-to-new pointers into the store buffer to rebuild it.
   void IteratePointersToNewSpace(ObjectSlotCallback callback);
 
+  // Hands the pointers that IteratePointersToNewSpace() would visit to the
+  // parallel scavenger. The store buffer entries are returned in
+  // |*start|..|*end|; they are removed from the store buffer but stay valid
+  // until it is rebuilt. The chunks that were flagged scan_on_scavenge are
+  // swept, unflagged and added to |chunks|.
+  void TakePointersToNewSpace(Address** start, Address** end,
+                              List<MemoryChunk*>* chunks);
+
+  // Calls |slot_callback| for the slots on |chunk| that point to from-space.
+  // Only reads the chunk, so several threads can scan chunks at a time, as
+  // long as nothing is allocated on them and the callback leaves the slots
+  // pointing to from-space.
+  void FindPointersToNewSpaceOnChunk(MemoryChunk* chunk,
+                                     ObjectSlotCallback slot_callback);
+
   static const int kStoreBufferOverflowBit = 1 << (14 + kPointerSizeLog2);
   static const int kStoreBufferSize = kStoreBufferOverflowBit;
   static const int kStoreBufferLength = kStoreBufferSize / sizeof(Address);
@@ -142,6 +159,9 @@ class StoreBuffer {
   void FindPointersToNewSpaceInRegion(Address start, Address end,
                                       ObjectSlotCallback slot_callback);
 
+  // Makes sure that the objects on a chunk to scan are iterable.
+  void PrepareChunkForScanning(MemoryChunk* chunk);
+
   // For each region of pointers on a page in use from an old space call
   // visit_pointer_region callback.
   // If either visit_pointer_region or callback can cause an allocation
@@ -27,8 +27,14 @@
 
 #include "src/perf-jit.h"
 
+#include <algorithm>
+
+#include "src/assembler.h"
+
 #if V8_OS_LINUX
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
 #include <unistd.h>
 #include "src/third_party/kernel/tools/perf/util/jitdump.h"
 #endif  // V8_OS_LINUX
@@ -38,53 +44,84 @@ namespace internal {
 
 #if V8_OS_LINUX
 
-const char PerfJitLogger::kFilenameFormatString[] = "perfjit-%d.dump";
+const char PerfJitLogger::kFilenameFormatString[] = "jit-%d.dump";
 
 // Extra padding for the PID in the filename
 const int PerfJitLogger::kFilenameBufferPadding = 16;
 
 
-PerfJitLogger::PerfJitLogger() : perf_output_handle_(NULL), code_index_(0) {
-  if (!base::TimeTicks::KernelTimestampAvailable()) {
-    FATAL("Cannot profile with perf JIT - kernel timestamps not available.");
-  }
-
+PerfJitLogger::PerfJitLogger()
+    : perf_output_fd_(-1),
+      marker_address_(NULL),
+      buffer_(NULL),
+      buffer_offset_(0),
+      buffer_position_(0),
+      code_index_(0),
+      code_indices_(HashMap::PointersMatch),
+      line_ends_script_id_(-1),
+      line_ends_source_length_(0) {
   // Open the perf JIT dump file.
   int bufferSize = sizeof(kFilenameFormatString) + kFilenameBufferPadding;
   ScopedVector<char> perf_dump_name(bufferSize);
   int size = SNPrintF(perf_dump_name, kFilenameFormatString,
                       base::OS::GetCurrentProcessId());
   CHECK_NE(size, -1);
-  perf_output_handle_ =
-      base::OS::FOpen(perf_dump_name.start(), base::OS::LogFileOpenMode);
-  CHECK_NOT_NULL(perf_output_handle_);
-  setvbuf(perf_output_handle_, NULL, _IOFBF, kLogBufferSize);
+  perf_output_fd_ = open(perf_dump_name.start(), O_CREAT | O_TRUNC | O_RDWR,
+                         S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  CHECK_NE(perf_output_fd_, -1);
+  MapNextBuffer();
+
+  marker_address_ =
+      mmap(NULL, base::OS::CommitPageSize(), PROT_READ | PROT_EXEC,
+           MAP_PRIVATE, perf_output_fd_, 0);
+  CHECK_NE(marker_address_, MAP_FAILED);
 
   LogWriteHeader();
 }
 
 
 PerfJitLogger::~PerfJitLogger() {
-  fclose(perf_output_handle_);
-  perf_output_handle_ = NULL;
+  jr_code_close code_close;
+  code_close.p.id = JIT_CODE_CLOSE;
+  code_close.p.total_size = sizeof(code_close);
+  code_close.p.timestamp = GetTimestamp();
+  LogWriteBytes(reinterpret_cast<const char*>(&code_close),
+                sizeof(code_close));
+
+  munmap(buffer_, kLogBufferSize);
+  buffer_ = NULL;
+  // Cut off the unused rest of the last buffer.
+  int result = ftruncate(perf_output_fd_, buffer_offset_ + buffer_position_);
+  DCHECK_EQ(0, result);
+  USE(result);
+  munmap(marker_address_, base::OS::CommitPageSize());
+  marker_address_ = NULL;
+  close(perf_output_fd_);
+  perf_output_fd_ = -1;
 }
 
 
 uint64_t PerfJitLogger::GetTimestamp() {
-  return static_cast<int64_t>(
-      base::TimeTicks::KernelTimestampNow().ToInternalValue());
+  // The clock of "perf record -k mono".
+  struct timespec ts;
+  int result = clock_gettime(CLOCK_MONOTONIC, &ts);
+  DCHECK_EQ(0, result);
+  USE(result);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
 }
 
 
-void PerfJitLogger::LogRecordedBuffer(Code* code, SharedFunctionInfo*,
+void PerfJitLogger::LogRecordedBuffer(Code* code, SharedFunctionInfo* shared,
                                       const char* name, int length) {
   DCHECK(code->instruction_start() == code->address() + Code::kHeaderSize);
-  DCHECK(perf_output_handle_ != NULL);
+  DCHECK(perf_output_fd_ != -1);
 
   const char* code_name = name;
   uint8_t* code_pointer = reinterpret_cast<uint8_t*>(code->instruction_start());
-  uint32_t code_size = code->is_crankshafted() ? code->safepoint_table_offset()
-                                               : code->instruction_size();
+  uint32_t code_size = CodeSize(code);
+
+  // perf inject attaches a debug info record to the load record after it.
+  if (shared != NULL) LogWriteDebugInfo(code, shared);
 
   static const char string_terminator[] = "\0";
 
@@ -99,6 +136,10 @@ void PerfJitLogger::LogRecordedBuffer(Code* code, SharedFunctionInfo*,
   code_load.code_size = code_size;
   code_load.code_index = code_index_;
 
+  HashMap::Entry* entry = code_indices_.LookupOrInsert(
+      code->address(), ComputePointerHash(code->address()));
+  entry->value = reinterpret_cast<void*>(code_index_);
+
   code_index_++;
 
   LogWriteBytes(reinterpret_cast<const char*>(&code_load), sizeof(code_load));
@@ -108,14 +149,142 @@ void PerfJitLogger::LogRecordedBuffer(Code* code, SharedFunctionInfo*,
 }
 
 
+void PerfJitLogger::LogWriteDebugInfo(Code* code, SharedFunctionInfo* shared) {
+  if (!shared->script()->IsScript()) return;
+  Script* script = Script::cast(shared->script());
+  if (!script->source()->IsString()) return;
+
+  // Code positions first, so that the line ends are looked up in one go.
+  List<int> pc_offsets;
+  List<int> positions;
+  for (RelocIterator it(code); !it.done(); it.next()) {
+    if (!RelocInfo::IsPosition(it.rinfo()->rmode())) continue;
+    int position = static_cast<int>(it.rinfo()->data());
+    if (position < 0) continue;
+    pc_offsets.Add(static_cast<int>(it.rinfo()->pc() -
+                                    code->instruction_start()));
+    positions.Add(position);
+  }
+  if (positions.is_empty()) return;
+  List<int> line_numbers(positions.length());
+  GetLineNumbers(script, positions, &line_numbers);
+
+  // One entry per change of line, like the line tables of the CPU profiler.
+  List<debug_entry> entries;
+  for (int i = 0; i < positions.length(); i++) {
+    int line_number = line_numbers[i];
+    if (!entries.is_empty() && entries.last().lineno == line_number) continue;
+    debug_entry entry;
+    entry.addr = reinterpret_cast<uint64_t>(code->instruction_start()) +
+                 pc_offsets[i] + kElfHeaderSize;
+    entry.lineno = line_number;
+    entry.discrim = 0;
+    entries.Add(entry);
+  }
+  if (entries.is_empty()) return;
+
+  SmartArrayPointer<char> script_name;
+  int script_name_length = 0;
+  if (script->name()->IsString()) {
+    script_name = String::cast(script->name())->ToCString(
+        DISALLOW_NULLS, ROBUST_STRING_TRAVERSAL, &script_name_length);
+  }
+  const char* file_name = script_name.get();
+  if (script_name_length == 0) {
+    static const char kUnknownScriptName[] = "<unknown>";
+    file_name = kUnknownScriptName;
+    script_name_length = sizeof(kUnknownScriptName) - 1;
+  }
+
+  static const char padding[] = "\0\0\0\0\0\0\0";
+  int size = static_cast<int>(sizeof(jr_code_debug_info)) +
+             entries.length() * (static_cast<int>(sizeof(debug_entry)) +
+                                 script_name_length + 1);
+  int padding_size = RoundUp(size, 8) - size;
+
+  jr_code_debug_info debug_info;
+  debug_info.p.id = JIT_CODE_DEBUG_INFO;
+  debug_info.p.total_size = size + padding_size;
+  debug_info.p.timestamp = GetTimestamp();
+  debug_info.code_addr = reinterpret_cast<uint64_t>(code->instruction_start());
+  debug_info.nr_entry = entries.length();
+
+  LogWriteBytes(reinterpret_cast<const char*>(&debug_info),
+                sizeof(debug_info));
+  for (int i = 0; i < entries.length(); i++) {
+    LogWriteBytes(reinterpret_cast<const char*>(&entries[i]),
+                  sizeof(debug_entry));
+    LogWriteBytes(file_name, script_name_length + 1);
+  }
+  LogWriteBytes(padding, padding_size);
+}
+
+
+void PerfJitLogger::GetLineNumbers(Script* script, const List<int>& positions,
+                                   List<int>* line_numbers) {
+  DisallowHeapAllocation no_allocation;
+  if (script->line_ends()->IsFixedArray()) {
+    // Script::GetLineNumber() only searches the line ends then.
+    for (int i = 0; i < positions.length(); i++) {
+      line_numbers->Add(script->GetLineNumber(positions[i]) + 1);
+    }
+    return;
+  }
+
+  String* source = String::cast(script->source());
+  int script_id = script->id()->value();
+  if (script_id != line_ends_script_id_ ||
+      source->length() != line_ends_source_length_) {
+    line_ends_.Rewind(0);
+    StringCharacterStream stream(source);
+    for (int position = 0; stream.HasMore(); position++) {
+      if (stream.GetNext() == '\n') line_ends_.Add(position);
+    }
+    line_ends_script_id_ = script_id;
+    line_ends_source_length_ = source->length();
+  }
+  // Like Script::GetLineNumberWithArray(), which includes the line break in
+  // the line it ends.
+  int line_offset = script->line_offset()->value();
+  for (int i = 0; i < positions.length(); i++) {
+    const int* line_end = std::lower_bound(
+        line_ends_.begin(), line_ends_.begin() + line_ends_.length(),
+        positions[i]);
+    int line = static_cast<int>(line_end - line_ends_.begin());
+    line_numbers->Add(line + line_offset + 1);
+  }
+}
+
+
 void PerfJitLogger::CodeMoveEvent(Address from, Address to) {
-  // Code relocation not supported.
-  UNREACHABLE();
+  HashMap::Entry* entry =
+      code_indices_.Lookup(from, ComputePointerHash(from));
+  if (entry == NULL) return;
+  uint64_t code_index = reinterpret_cast<uintptr_t>(entry->value);
+  code_indices_.Remove(from, ComputePointerHash(from));
+  code_indices_.LookupOrInsert(to, ComputePointerHash(to))->value =
+      reinterpret_cast<void*>(code_index);
+
+  // The code object at |from| is still intact.
+  Code* code = Code::cast(HeapObject::FromAddress(from));
+  jr_code_move code_move;
+  code_move.p.id = JIT_CODE_MOVE;
+  code_move.p.total_size = sizeof(code_move);
+  code_move.p.timestamp = GetTimestamp();
+  code_move.pid = static_cast<uint32_t>(base::OS::GetCurrentProcessId());
+  code_move.tid = static_cast<uint32_t>(base::OS::GetCurrentThreadId());
+  code_move.vma = 0x0;
+  code_move.old_code_addr =
+      reinterpret_cast<uint64_t>(from + Code::kHeaderSize);
+  code_move.new_code_addr = reinterpret_cast<uint64_t>(to + Code::kHeaderSize);
+  code_move.code_size = CodeSize(code);
+  code_move.code_index = code_index;
+  LogWriteBytes(reinterpret_cast<const char*>(&code_move), sizeof(code_move));
 }
 
 
 void PerfJitLogger::CodeDeleteEvent(Address from) {
-  // V8 does not send notification on code unload
+  code_indices_.Remove(from, ComputePointerHash(from));
 }
 
 
@@ -123,14 +292,36 @@ void PerfJitLogger::SnapshotPositionEvent(Address addr, int pos) {}
 
 
 void PerfJitLogger::LogWriteBytes(const char* bytes, int size) {
-  size_t rv = fwrite(bytes, 1, size, perf_output_handle_);
-  DCHECK(static_cast<size_t>(size) == rv);
-  USE(rv);
+  while (size > 0) {
+    if (buffer_position_ == static_cast<size_t>(kLogBufferSize)) {
+      MapNextBuffer();
+    }
+    int chunk = Min(size, kLogBufferSize - static_cast<int>(buffer_position_));
+    MemCopy(buffer_ + buffer_position_, bytes, chunk);
+    buffer_position_ += chunk;
+    bytes += chunk;
+    size -= chunk;
+  }
+}
+
+
+void PerfJitLogger::MapNextBuffer() {
+  if (buffer_ != NULL) {
+    munmap(buffer_, kLogBufferSize);
+    buffer_offset_ += kLogBufferSize;
+  }
+  int result = ftruncate(perf_output_fd_, buffer_offset_ + kLogBufferSize);
+  CHECK_EQ(0, result);
+  void* buffer = mmap(NULL, kLogBufferSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, perf_output_fd_, buffer_offset_);
+  CHECK_NE(buffer, MAP_FAILED);
+  buffer_ = reinterpret_cast<char*>(buffer);
+  buffer_position_ = 0;
 }
 
 
 void PerfJitLogger::LogWriteHeader() {
-  DCHECK(perf_output_handle_ != NULL);
+  DCHECK(perf_output_fd_ != -1);
   jitheader header;
   header.magic = JITHEADER_MAGIC;
   header.version = JITHEADER_VERSION;
@@ -138,8 +329,10 @@ void PerfJitLogger::LogWriteHeader() {
   header.pad1 = 0xdeadbeef;
   header.elf_mach = GetElfMach();
   header.pid = base::OS::GetCurrentProcessId();
-  header.timestamp =
-      static_cast<uint64_t>(base::OS::TimeCurrentMillis() * 1000.0);
+  // perf inject compares the header's time with the records', so they use
+  // the same clock.
+  header.timestamp = GetTimestamp();
+  header.flags = 0;
   LogWriteBytes(reinterpret_cast<const char*>(&header), sizeof(header));
 }
 
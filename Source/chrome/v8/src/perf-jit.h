@@ -30,12 +30,18 @@
 
 #include "src/v8.h"
 
+#include "src/hashmap.h"
+
 namespace v8 {
 namespace internal {
 
 #if V8_OS_LINUX
 
-// Linux perf tool logging support
+// Linux perf tool logging support. Writes code objects, their moves and
+// their source line tables in the jitdump format to jit-<pid>.dump, which
+// "perf inject --jit" merges into a profile recorded with "perf record -k
+// mono". Records are copied into a window of the file that is mapped into
+// memory, so that logging a code object does not make a system call.
 class PerfJitLogger : public CodeEventLogger {
  public:
   PerfJitLogger();
@@ -50,22 +56,39 @@ class PerfJitLogger : public CodeEventLogger {
   uint64_t GetTimestamp();
   virtual void LogRecordedBuffer(Code* code, SharedFunctionInfo* shared,
                                  const char* name, int length);
-
-  // Extension added to V8 log file name to get the low-level log name.
+  void LogWriteDebugInfo(Code* code, SharedFunctionInfo* shared);
+  // Returns the line of each of the |positions| in |script|, counting from
+  // one. Scripts without line ends of their own have them computed here,
+  // without allocating, and kept for the next code object of the script.
+  void GetLineNumbers(Script* script, const List<int>& positions,
+                      List<int>* line_numbers);
+
+  // Perf only picks up dump files named like this.
   static const char kFilenameFormatString[];
   static const int kFilenameBufferPadding;
 
-  // File buffer size of the low-level log. We don't use the default to
-  // minimize the associated overhead.
+  // Size of the part of the dump file that is mapped at a time. A multiple
+  // of the page size.
   static const int kLogBufferSize = 2 * MB;
 
+  // perf inject places the code of each function right after the ELF header
+  // of the shared object it generates for it.
+  static const int kElfHeaderSize = 0x40;
+
   void LogWriteBytes(const char* bytes, int size);
   void LogWriteHeader();
+  void MapNextBuffer();
+
+  static uint32_t CodeSize(Code* code) {
+    return code->is_crankshafted() ? code->safepoint_table_offset()
+                                   : code->instruction_size();
+  }
 
   static const uint32_t kElfMachIA32 = 3;
   static const uint32_t kElfMachX64 = 62;
   static const uint32_t kElfMachARM = 40;
   static const uint32_t kElfMachMIPS = 10;
+  static const uint32_t kElfMachARM64 = 183;
 
   uint32_t GetElfMach() {
 #if V8_TARGET_ARCH_IA32
@@ -76,14 +99,31 @@ class PerfJitLogger : public CodeEventLogger {
     return kElfMachARM;
 #elif V8_TARGET_ARCH_MIPS
     return kElfMachMIPS;
+#elif V8_TARGET_ARCH_ARM64
+    return kElfMachARM64;
 #else
     UNIMPLEMENTED();
     return 0;
 #endif
   }
 
-  FILE* perf_output_handle_;
+  int perf_output_fd_;
+  // A mapping of the start of the dump file with execute permission, which
+  // makes the file show up in the perf.data of "perf record".
+  void* marker_address_;
+  // The mapped part of the dump file, which starts at |buffer_offset_|.
+  char* buffer_;
+  size_t buffer_offset_;
+  size_t buffer_position_;
   uint64_t code_index_;
+  // Index of the load record of each logged code object, by address.
+  HashMap code_indices_;
+  // Positions of the line breaks in the source of the script with id
+  // |line_ends_script_id_|, the last one GetLineNumbers() computed them for.
+  // The functions of a script are usually compiled one after the other.
+  int line_ends_script_id_;
+  int line_ends_source_length_;
+  List<int> line_ends_;
 };
 
 #else
@@ -13,6 +13,13 @@
 
 #define JITHEADER_VERSION 1
 
+enum jitdump_flags_bits {
+  JITDUMP_FLAGS_ARCH_TIMESTAMP_BIT,
+  JITDUMP_FLAGS_MAX_BIT
+};
+
+#define JITDUMP_FLAGS_ARCH_TIMESTAMP (1ULL << JITDUMP_FLAGS_ARCH_TIMESTAMP_BIT)
+
 struct jitheader {
   uint32_t magic;      /* characters "jItD" */
   uint32_t version;    /* header version */
@@ -21,6 +28,7 @@ struct jitheader {
   uint32_t pad1;       /* reserved */
   uint32_t pid;        /* JIT process id */
   uint64_t timestamp;  /* timestamp */
+  uint64_t flags;      /* flags */
 };
 
 enum jit_record_type {
@@ -28,6 +36,7 @@ enum jit_record_type {
   JIT_CODE_MOVE = 1,
   JIT_CODE_DEBUG_INFO = 2,
   JIT_CODE_CLOSE = 3,
+  JIT_CODE_UNWINDING_INFO = 4,
   JIT_CODE_MAX
 };
 
@@ -65,11 +74,28 @@ struct jr_code_move {
   uint64_t code_index;
 };
 
+struct debug_entry {
+  uint64_t addr;
+  int lineno;  /* source line number starting at 1 */
+  int discrim; /* column discriminator, 0 is default */
+  /* followed by the null-terminated source file name */
+};
+
 struct jr_code_debug_info {
   struct jr_prefix p;
 
   uint64_t code_addr;
   uint64_t nr_entry;
+  /* followed by nr_entry struct debug_entry */
+};
+
+struct jr_code_unwinding_info {
+  struct jr_prefix p;
+
+  uint64_t unwinding_size;
+  uint64_t eh_frame_hdr_size;
+  uint64_t mapped_size;
+  /* followed by unwinding_size bytes of unwinding data */
 };
 
 union jr_entry {
@@ -77,6 +103,7 @@ union jr_entry {
   struct jr_code_close close;
   struct jr_code_load load;
   struct jr_code_move move;
+  struct jr_code_unwinding_info unwinding;
   struct jr_prefix prefix;
 };
 
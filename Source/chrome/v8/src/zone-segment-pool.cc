@@ -0,0 +1,142 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/zone-segment-pool.h"
+
+#include <algorithm>
+
+#include "src/allocation.h"
+#include "src/base/bits.h"
+#include "src/base/platform/mutex.h"
+#include "src/flags.h"
+#include "src/utils.h"
+
+namespace v8 {
+namespace internal {
+
+namespace {
+
+// Pooled memory is kept in singly linked lists, one per size class, threaded
+// through the first word of each block.
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+// 8 KB to 1 MB.
+const int kSizeClassCount = 8;
+STATIC_ASSERT((ZoneSegmentPool::kMinimumPooledSize << (kSizeClassCount - 1)) ==
+              ZoneSegmentPool::kMaximumPooledSize);
+
+struct PoolState {
+  FreeBlock* free_lists[kSizeClassCount];
+  ZoneSegmentPool::Statistics statistics;
+};
+
+base::LazyMutex pool_mutex = LAZY_MUTEX_INITIALIZER;
+PoolState pool_state;  // Guarded by pool_mutex.
+
+
+size_t ClassSize(size_t size) {
+  if (size <= ZoneSegmentPool::kMinimumPooledSize) {
+    return ZoneSegmentPool::kMinimumPooledSize;
+  }
+  if (size > ZoneSegmentPool::kMaximumPooledSize) return size;
+  return base::bits::RoundUpToPowerOfTwo32(static_cast<uint32_t>(size));
+}
+
+
+// Returns -1 if blocks of |size| bytes are not pooled.
+int SizeClass(size_t size) {
+  if (size < ZoneSegmentPool::kMinimumPooledSize ||
+      size > ZoneSegmentPool::kMaximumPooledSize ||
+      !base::bits::IsPowerOfTwo32(static_cast<uint32_t>(size))) {
+    return -1;
+  }
+  return WhichPowerOf2(static_cast<uint32_t>(size)) -
+         WhichPowerOf2(ZoneSegmentPool::kMinimumPooledSize);
+}
+
+
+size_t RetainedBytesLimit() {
+  return static_cast<size_t>(std::max(FLAG_zone_segment_pool_size, 0)) * MB;
+}
+
+}  // namespace
+
+
+void* ZoneSegmentPool::Allocate(size_t* size) {
+  *size = ClassSize(*size);
+  int size_class = SizeClass(*size);
+  if (size_class >= 0) {
+    base::LockGuard<base::Mutex> guard(pool_mutex.Pointer());
+    FreeBlock* block = pool_state.free_lists[size_class];
+    if (block != nullptr) {
+      pool_state.free_lists[size_class] = block->next;
+      pool_state.statistics.pooled_bytes -= *size;
+      pool_state.statistics.hits++;
+      return block;
+    }
+    pool_state.statistics.misses++;
+  }
+  return Malloced::New(*size);
+}
+
+
+void ZoneSegmentPool::Free(void* memory, size_t size) {
+  int size_class = SizeClass(size);
+  if (size_class >= 0) {
+    base::LockGuard<base::Mutex> guard(pool_mutex.Pointer());
+    Statistics& statistics = pool_state.statistics;
+    if (statistics.pooled_bytes + size <= RetainedBytesLimit()) {
+      FreeBlock* block = reinterpret_cast<FreeBlock*>(memory);
+      block->next = pool_state.free_lists[size_class];
+      pool_state.free_lists[size_class] = block;
+      statistics.pooled_bytes += size;
+      statistics.max_pooled_bytes =
+          std::max(statistics.max_pooled_bytes, statistics.pooled_bytes);
+      return;
+    }
+    statistics.released_bytes += size;
+  }
+  Malloced::Delete(memory);
+}
+
+
+void ZoneSegmentPool::Trim(size_t retained_bytes) {
+  FreeBlock* released = nullptr;
+  {
+    base::LockGuard<base::Mutex> guard(pool_mutex.Pointer());
+    Statistics& statistics = pool_state.statistics;
+    // Large blocks go first; they are the least likely to be reused.
+    for (int size_class = kSizeClassCount - 1;
+         size_class >= 0 && statistics.pooled_bytes > retained_bytes;
+         size_class--) {
+      size_t size = kMinimumPooledSize << size_class;
+      while (pool_state.free_lists[size_class] != nullptr &&
+             statistics.pooled_bytes > retained_bytes) {
+        FreeBlock* block = pool_state.free_lists[size_class];
+        pool_state.free_lists[size_class] = block->next;
+        block->next = released;
+        released = block;
+        statistics.pooled_bytes -= size;
+        statistics.released_bytes += size;
+      }
+    }
+  }
+  // Free outside the lock so that other threads can keep allocating.
+  while (released != nullptr) {
+    FreeBlock* next = released->next;
+    Malloced::Delete(released);
+    released = next;
+  }
+}
+
+
+void ZoneSegmentPool::GetStatistics(Statistics* statistics) {
+  base::LockGuard<base::Mutex> guard(pool_mutex.Pointer());
+  *statistics = pool_state.statistics;
+}
+
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,52 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_ZONE_SEGMENT_POOL_H_
+#define V8_ZONE_SEGMENT_POOL_H_
+
+#include "src/allocation.h"
+
+namespace v8 {
+namespace internal {
+
+// A process-wide cache of the memory zones are made of. Zones give their
+// segments back to the pool instead of freeing them, and take them out again
+// when they expand, so that parsing and compilation, which create and drop
+// zones all the time, mostly stay off malloc(). Memory is pooled in
+// power-of-two size classes between kMinimumPooledSize and
+// kMaximumPooledSize, and at most --zone-segment-pool-size megabytes are
+// retained. Thread-safe.
+class ZoneSegmentPool final : public AllStatic {
+ public:
+  struct Statistics {
+    // Bytes currently retained by the pool.
+    size_t pooled_bytes;
+    size_t max_pooled_bytes;
+    // Allocations served from the pool and from malloc().
+    size_t hits;
+    size_t misses;
+    // Bytes freed because the pool was over budget or trimmed.
+    size_t released_bytes;
+  };
+
+  static const size_t kMinimumPooledSize = 8 * KB;
+  static const size_t kMaximumPooledSize = 1 * MB;
+
+  // Returns at least |*size| bytes for a segment, and rounds |*size| up to
+  // its size class.
+  static void* Allocate(size_t* size);
+
+  // |size| must be the one Allocate() returned.
+  static void Free(void* memory, size_t size);
+
+  // Frees pooled memory until at most |retained_bytes| are left.
+  static void Trim(size_t retained_bytes);
+
+  static void GetStatistics(Statistics* statistics);
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_ZONE_SEGMENT_POOL_H_
@@ -7,6 +7,7 @@
 #include <cstring>
 
 #include "src/v8.h"
+#include "src/zone-segment-pool.h"
 
 #ifdef V8_USE_ADDRESS_SANITIZER
 #include <sanitizer/asan_interface.h>
@@ -45,8 +46,8 @@ const size_t kASanRedzoneBytes = 0;
 // Segments represent chunks of memory: They have starting address
 // (encoded in the this pointer) and a size in bytes. Segments are
 // chained together forming a LIFO structure with the newest segment
-// available as segment_head_. Segments are allocated using malloc()
-// and de-allocated using free().
+// available as segment_head_. Segments come from and go back to the
+// ZoneSegmentPool.
 
 class Segment {
  public:
@@ -201,7 +202,9 @@ void Zone::DeleteKeptSegment() {
 // Creates a new segment, sets it size, and pushes it to the front
 // of the segment chain. Returns the new segment.
 Segment* Zone::NewSegment(size_t size) {
-  Segment* result = reinterpret_cast<Segment*>(Malloced::New(size));
+  // The pool may round the size up.
+  Segment* result =
+      reinterpret_cast<Segment*>(ZoneSegmentPool::Allocate(&size));
   segment_bytes_allocated_ += size;
   if (result != nullptr) {
     result->Initialize(segment_head_, size);
@@ -214,7 +217,10 @@ Segment* Zone::NewSegment(size_t size) {
 // Deletes the given segment. Does not touch the segment chain.
 void Zone::DeleteSegment(Segment* segment, size_t size) {
   segment_bytes_allocated_ -= size;
-  Malloced::Delete(segment);
+  // Another zone may get the memory next, and it must not find redzones
+  // poisoned by this one.
+  ASAN_UNPOISON_MEMORY_REGION(segment, size);
+  ZoneSegmentPool::Free(segment, size);
 }
 
 
@@ -228,26 +234,27 @@ Address Zone::NewExpand(size_t size) {
   // strategy, where we increase the segment size every time we expand
   // except that we employ a maximum segment size when we delete. This
   // is to avoid excessive malloc() and free() overhead.
+  //
+  // Segments come in the power-of-two size classes of ZoneSegmentPool and
+  // their size includes the segment overhead, so the next class is simply
+  // twice the current one. Adding the overhead on top of that would make the
+  // pool round up to the class after it.
   Segment* head = segment_head_;
   const size_t old_size = (head == nullptr) ? 0 : head->size();
   static const size_t kSegmentOverhead = sizeof(Segment) + kAlignment;
-  const size_t new_size_no_overhead = size + (old_size << 1);
-  size_t new_size = kSegmentOverhead + new_size_no_overhead;
   const size_t min_new_size = kSegmentOverhead + size;
   // Guard against integer overflow.
-  if (new_size_no_overhead < size || new_size < kSegmentOverhead) {
+  if (min_new_size < size) {
     V8::FatalProcessOutOfMemory("Zone");
     return nullptr;
   }
-  if (new_size < kMinimumSegmentSize) {
-    new_size = kMinimumSegmentSize;
-  } else if (new_size > kMaximumSegmentSize) {
-    // Limit the size of new segments to avoid growing the segment size
-    // exponentially, thus putting pressure on contiguous virtual address space.
-    // All the while making sure to allocate a segment large enough to hold the
-    // requested size.
-    new_size = Max(min_new_size, kMaximumSegmentSize);
-  }
+  // Limit the size of new segments to avoid growing the segment size
+  // exponentially, thus putting pressure on contiguous virtual address space.
+  size_t new_size =
+      Min(Max(old_size << 1, kMinimumSegmentSize), kMaximumSegmentSize);
+  // A request that does not fit gets a segment large enough to hold it, which
+  // the pool rounds up to its size class.
+  new_size = Max(new_size, min_new_size);
   if (new_size > INT_MAX) {
     V8::FatalProcessOutOfMemory("Zone");
     return nullptr;
@@ -29,7 +29,7 @@ class Segment;
 //
 // Note: There is no need to initialize the Zone; the first time an
 // allocation is attempted, a segment of memory will be requested
-// through a call to malloc().
+// from the ZoneSegmentPool.
 //
 // Note: The implementation is inherently not thread safe. Do not use
 // from multi-threaded code.
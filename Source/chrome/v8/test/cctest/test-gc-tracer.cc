@@ -123,3 +123,49 @@ TEST(RingBufferPushFront) {
   }
   CHECK_EQ(i, 8);  // one past last element.
 }
+
+
+static int gc_event_callback_count = 0;
+
+static void CountGCEvents(v8::Isolate* isolate, void* data) {
+  CHECK_EQ(data, &gc_event_callback_count);
+  gc_event_callback_count++;
+}
+
+
+TEST(GCHistory) {
+  CcTest::InitializeVM();
+  Heap* heap = CcTest::heap();
+  GCTracer* tracer = heap->tracer();
+  const size_t history_size = 3;
+  tracer->SetHistorySize(history_size);
+  tracer->SetEventCallback(CountGCEvents, &gc_event_callback_count);
+  gc_event_callback_count = 0;
+
+  heap->CollectGarbage(NEW_SPACE);
+  CHECK_EQ(1, gc_event_callback_count);
+  CHECK_EQ(1, static_cast<int>(tracer->history_length()));
+  CHECK_EQ(GCTracer::Event::SCAVENGER, tracer->HistoryEventAt(0).type);
+
+  for (int i = 0; i < 4; i++) heap->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK_EQ(5, gc_event_callback_count);
+  CHECK_EQ(history_size, tracer->history_length());
+  for (size_t i = 0; i < history_size; i++) {
+    const GCTracer::Event& event = tracer->HistoryEventAt(i);
+    CHECK_NE(GCTracer::Event::SCAVENGER, event.type);
+    CHECK(event.end_time >= event.start_time);
+    if (i > 0) CHECK_EQ(tracer->HistoryEventAt(i - 1).id + 1, event.id);
+  }
+
+  // Shrinking keeps the most recent events.
+  size_t last_id = tracer->HistoryEventAt(history_size - 1).id;
+  tracer->SetHistorySize(1);
+  CHECK_EQ(1, static_cast<int>(tracer->history_length()));
+  CHECK_EQ(last_id, tracer->HistoryEventAt(0).id);
+
+  tracer->SetHistorySize(0);
+  tracer->SetEventCallback(NULL, NULL);
+  heap->CollectGarbage(NEW_SPACE);
+  CHECK_EQ(0, static_cast<int>(tracer->history_length()));
+  CHECK_EQ(5, gc_event_callback_count);
+}
@@ -1910,6 +1910,51 @@ TEST(CollectingAllAvailableGarbageShrinksNewSpace) {
 }
 
 
+TEST(ParallelScavenge) {
+  FLAG_parallel_scavenge = true;
+  FLAG_parallel_scavenge_tasks = 3;
+  FLAG_incremental_marking = false;
+  CcTest::InitializeVM();
+  v8::HandleScope scope(CcTest::isolate());
+  Heap* heap = CcTest::heap();
+
+  // Tenure the holder, so that everything below is only reachable through
+  // the store buffer.
+  CompileRun("var holder = new Array(2000);");
+  heap->CollectAllGarbage(Heap::kNoGCFlags);
+  CompileRun(
+      "for (var i = 0; i < holder.length; i++) {"
+      "  var shared = { index: i };"
+      "  holder[i] = { name: 'object' + i, items: [shared, [i], shared],"
+      "                value: i + 0.5 };"
+      "}");
+  // The first scavenge copies within new space, the second one promotes.
+  GCTracer* tracer = heap->tracer();
+  tracer->SetHistorySize(2);
+  heap->CollectGarbage(NEW_SPACE);
+  heap->CollectGarbage(NEW_SPACE);
+  CHECK_EQ(2u, tracer->history_length());
+  for (size_t i = 0; i < tracer->history_length(); i++) {
+    const GCTracer::Event& event = tracer->HistoryEventAt(i);
+    CHECK_EQ(GCTracer::Event::SCAVENGER, event.type);
+    CHECK_EQ(FLAG_parallel_scavenge_tasks + 1,
+             event.parallel_scavenge_workers);
+  }
+  tracer->SetHistorySize(0);
+
+  v8::Local<v8::Value> result = CompileRun(
+      "var ok = true;"
+      "for (var i = 0; i < holder.length; i++) {"
+      "  var o = holder[i];"
+      "  ok = ok && o.name == 'object' + i && o.items[0].index == i &&"
+      "       o.items[0] === o.items[2] && o.items[1][0] == i &&"
+      "       o.value == i + 0.5;"
+      "}"
+      "ok;");
+  CHECK(result->BooleanValue());
+}
+
+
 static int NumberOfGlobalObjects() {
   int count = 0;
   HeapIterator iterator(CcTest::heap());
@@ -388,6 +388,78 @@ TEST(EmptyObjectGroups) {
 }
 
 
+TEST(ParallelMarkingDeque) {
+  const int kCapacity = 16;
+  ParallelMarkingDeque owner;
+  ParallelMarkingDeque thief;
+  owner.Initialize(kCapacity);
+  thief.Initialize(kCapacity);
+  CHECK(owner.IsEmpty());
+
+  // One slot stays unused, as in MarkingDeque.
+  Address base = reinterpret_cast<Address>(&owner);
+  int pushed = 0;
+  while (owner.Push(HeapObject::FromAddress(base + pushed * kPointerSize))) {
+    pushed++;
+  }
+  CHECK_EQ(kCapacity - 1, pushed);
+
+  // Thieves take the oldest half from the bottom.
+  CHECK(thief.StealFrom(&owner));
+  HeapObject* object;
+  int stolen = 0;
+  while (thief.Pop(&object)) stolen++;
+  CHECK_EQ(pushed / 2 + 1, stolen);
+
+  // The owner keeps popping the newest objects from the top.
+  int popped = 0;
+  while (owner.Pop(&object)) {
+    popped++;
+    CHECK_EQ(base + (pushed - popped) * kPointerSize, object->address());
+  }
+  CHECK_EQ(pushed, stolen + popped);
+  CHECK(!thief.StealFrom(&owner));
+}
+
+
+TEST(ParallelMarking) {
+  FLAG_parallel_marking = true;
+  FLAG_parallel_marking_tasks = 3;
+  FLAG_incremental_marking = false;
+  CcTest::InitializeVM();
+  v8::HandleScope scope(CcTest::isolate());
+
+  // A wide graph of plain objects, arrays and strings, with functions and
+  // maps mixed in that only the main thread may visit.
+  CompileRun(
+      "var objects = [];"
+      "for (var i = 0; i < 20000; i++) {"
+      "  var o = { index: i, name: 'object' + i, items: [i, [i], {}] };"
+      "  if (i % 100 == 0) o.f = function() { return this.index; };"
+      "  objects.push(o);"
+      "}");
+  MarkCompactCollector* collector = CcTest::heap()->mark_compact_collector();
+  CcTest::heap()->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK_EQ(FLAG_parallel_marking_tasks + 1,
+           collector->parallel_marking_workers());
+  FLAG_stress_compaction = true;
+  CcTest::heap()->CollectAllGarbage(Heap::kNoGCFlags);
+  FLAG_stress_compaction = false;
+  CHECK_EQ(FLAG_parallel_marking_tasks + 1,
+           collector->parallel_marking_workers());
+
+  v8::Local<v8::Value> result = CompileRun(
+      "var ok = objects.length == 20000;"
+      "for (var i = 0; i < objects.length; i++) {"
+      "  var o = objects[i];"
+      "  ok = ok && o.index == i && o.name == 'object' + i &&"
+      "       o.items[1][0] == i && (i % 100 != 0 || o.f() == i);"
+      "}"
+      "ok;");
+  CHECK(result->BooleanValue());
+}
+
+
 #if defined(__has_feature)
 #if __has_feature(address_sanitizer)
 #define V8_WITH_ASAN 1
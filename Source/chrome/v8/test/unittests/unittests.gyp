@@ -88,6 +88,7 @@
         'libplatform/task-queue-unittest.cc',
         'libplatform/worker-thread-unittest.cc',
         'heap/gc-idle-time-handler-unittest.cc',
+        'zone-segment-pool-unittest.cc',
         'run-all-unittests.cc',
         'test-utils.h',
         'test-utils.cc',
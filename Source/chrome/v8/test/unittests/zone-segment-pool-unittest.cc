@@ -0,0 +1,99 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/zone-segment-pool.h"
+
+#include "src/zone.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace v8 {
+namespace internal {
+
+class ZoneSegmentPoolTest : public ::testing::Test {
+ public:
+  ZoneSegmentPoolTest() { ZoneSegmentPool::Trim(0); }
+  ~ZoneSegmentPoolTest() override { ZoneSegmentPool::Trim(0); }
+
+ protected:
+  static ZoneSegmentPool::Statistics GetStatistics() {
+    ZoneSegmentPool::Statistics statistics;
+    ZoneSegmentPool::GetStatistics(&statistics);
+    return statistics;
+  }
+};
+
+
+TEST_F(ZoneSegmentPoolTest, RoundsUpToSizeClass) {
+  size_t size = 1;
+  void* memory = ZoneSegmentPool::Allocate(&size);
+  EXPECT_EQ(ZoneSegmentPool::kMinimumPooledSize, size);
+  ZoneSegmentPool::Free(memory, size);
+
+  size = ZoneSegmentPool::kMinimumPooledSize + 1;
+  memory = ZoneSegmentPool::Allocate(&size);
+  EXPECT_EQ(2 * ZoneSegmentPool::kMinimumPooledSize, size);
+  ZoneSegmentPool::Free(memory, size);
+
+  size = ZoneSegmentPool::kMaximumPooledSize + 1;
+  memory = ZoneSegmentPool::Allocate(&size);
+  EXPECT_EQ(ZoneSegmentPool::kMaximumPooledSize + 1, size);
+  ZoneSegmentPool::Free(memory, size);
+}
+
+
+TEST_F(ZoneSegmentPoolTest, ReusesFreedSegments) {
+  size_t size = 64 * KB;
+  void* memory = ZoneSegmentPool::Allocate(&size);
+  ZoneSegmentPool::Free(memory, size);
+  ZoneSegmentPool::Statistics before = GetStatistics();
+  EXPECT_EQ(size, before.pooled_bytes);
+
+  void* reused = ZoneSegmentPool::Allocate(&size);
+  ZoneSegmentPool::Statistics after = GetStatistics();
+  EXPECT_EQ(memory, reused);
+  EXPECT_EQ(before.hits + 1, after.hits);
+  EXPECT_EQ(before.misses, after.misses);
+  EXPECT_EQ(0u, after.pooled_bytes);
+  ZoneSegmentPool::Free(reused, size);
+}
+
+
+TEST_F(ZoneSegmentPoolTest, DoesNotPoolLargeSegments) {
+  size_t size = 2 * ZoneSegmentPool::kMaximumPooledSize;
+  void* memory = ZoneSegmentPool::Allocate(&size);
+  ZoneSegmentPool::Free(memory, size);
+  EXPECT_EQ(0u, GetStatistics().pooled_bytes);
+}
+
+
+TEST_F(ZoneSegmentPoolTest, TrimKeepsRetainedBytes) {
+  size_t small_size = ZoneSegmentPool::kMinimumPooledSize;
+  size_t large_size = ZoneSegmentPool::kMaximumPooledSize;
+  void* small = ZoneSegmentPool::Allocate(&small_size);
+  void* large = ZoneSegmentPool::Allocate(&large_size);
+  ZoneSegmentPool::Free(small, small_size);
+  ZoneSegmentPool::Free(large, large_size);
+  EXPECT_EQ(small_size + large_size, GetStatistics().pooled_bytes);
+
+  // The large segment is released first.
+  ZoneSegmentPool::Trim(small_size);
+  EXPECT_EQ(small_size, GetStatistics().pooled_bytes);
+
+  ZoneSegmentPool::Trim(0);
+  EXPECT_EQ(0u, GetStatistics().pooled_bytes);
+}
+
+
+TEST_F(ZoneSegmentPoolTest, ZoneSegmentsGrowOneSizeClassAtATime) {
+  {
+    Zone zone;
+    for (int i = 0; i < 100; i++) zone.New(1 * KB);
+  }
+  // 8 + 16 + 32 + 64 KB hold 100 KB. Skipping a class each time would take
+  // 8 + 32 + 128 KB.
+  EXPECT_EQ(120 * KB, GetStatistics().pooled_bytes);
+}
+
+}  // namespace internal
+}  // namespace v8
@@ -20,6 +20,9 @@ const char InspectorBackendDispatcher::commandNames[] = {
     "Inspector.enable\0"
     "Inspector.disable\0"
     "Memory.getDOMCounters\0"
+    "Memory.startTrackingGC\0"
+    "Memory.stopTrackingGC\0"
+    "Memory.getGCStatistics\0"
     "Page.enable\0"
     "Page.disable\0"
     "Page.addScriptToEvaluateOnLoad\0"
@@ -195,9 +198,13 @@ const char InspectorBackendDispatcher::commandNames[] = {
     "Debugger.enablePromiseTracker\0"
     "Debugger.disablePromiseTracker\0"
     "Debugger.getPromiseById\0"
+    "Debugger.getPromiseCensus\0"
+    "Debugger.getLongPendingPromises\0"
     "Debugger.flushAsyncOperationEvents\0"
     "Debugger.setAsyncOperationBreakpoint\0"
     "Debugger.removeAsyncOperationBreakpoint\0"
+    "Debugger.searchInAllScripts\0"
+    "Debugger.cancelSearch\0"
     "DOMDebugger.setDOMBreakpoint\0"
     "DOMDebugger.removeDOMBreakpoint\0"
     "DOMDebugger.setEventListenerBreakpoint\0"
@@ -255,233 +262,240 @@ const unsigned short InspectorBackendDispatcher::commandNamesIndex[] = {
     17,
     35,
     57,
-    69,
-    82,
-    113,
-    147,
-    159,
-    173,
-    194,
-    218,
-    240,
-    264,
-    298,
-    334,
-    364,
-    385,
-    405,
-    438,
-    461,
-    489,
-    519,
-    547,
-    586,
-    625,
-    665,
-    694,
-    731,
-    766,
-    793,
-    810,
-    833,
-    855,
-    877,
-    904,
-    916,
-    931,
-    947,
-    969,
-    1009,
-    1024,
-    1040,
-    1062,
+    80,
+    102,
+    125,
+    137,
+    150,
+    181,
+    215,
+    227,
+    241,
+    262,
+    286,
+    308,
+    332,
+    366,
+    402,
+    432,
+    453,
+    473,
+    506,
+    529,
+    557,
+    587,
+    615,
+    654,
+    693,
+    733,
+    762,
+    799,
+    834,
+    861,
+    878,
+    901,
+    923,
+    945,
+    972,
+    984,
+    999,
+    1015,
+    1037,
     1077,
-    1093,
-    1122,
-    1150,
-    1174,
-    1192,
-    1224,
-    1253,
-    1284,
-    1317,
-    1342,
-    1375,
-    1391,
-    1408,
-    1439,
+    1092,
+    1108,
+    1130,
+    1145,
+    1161,
+    1190,
+    1218,
+    1242,
+    1260,
+    1292,
+    1321,
+    1352,
+    1385,
+    1410,
+    1443,
     1459,
     1476,
-    1494,
-    1525,
-    1551,
-    1573,
-    1600,
-    1631,
-    1659,
-    1684,
-    1709,
+    1507,
+    1527,
+    1544,
+    1562,
+    1593,
+    1619,
+    1641,
+    1668,
+    1699,
     1727,
-    1746,
-    1776,
-    1805,
-    1837,
-    1877,
-    1901,
-    1938,
-    1983,
-    2001,
-    2020,
-    2053,
+    1752,
+    1777,
+    1795,
+    1814,
+    1844,
+    1873,
+    1905,
+    1945,
+    1969,
+    2006,
+    2051,
+    2069,
     2088,
-    2115,
-    2145,
-    2168,
-    2179,
-    2191,
-    2207,
-    2229,
+    2121,
+    2156,
+    2183,
+    2213,
+    2236,
     2247,
-    2268,
-    2284,
-    2301,
-    2316,
-    2338,
-    2362,
-    2382,
-    2399,
-    2416,
-    2434,
-    2455,
-    2480,
-    2496,
-    2522,
-    2540,
-    2558,
-    2576,
-    2594,
-    2613,
-    2642,
-    2678,
-    2699,
-    2715,
-    2733,
-    2744,
-    2755,
-    2764,
-    2773,
-    2795,
-    2805,
-    2827,
-    2843,
-    2866,
-    2890,
-    2920,
-    2931,
-    2943,
-    2971,
-    2998,
-    3026,
-    3054,
-    3076,
-    3098,
-    3118,
-    3138,
-    3155,
-    3176,
-    3188,
-    3209,
-    3229,
-    3245,
-    3262,
+    2259,
+    2275,
+    2297,
+    2315,
+    2336,
+    2352,
+    2369,
+    2384,
+    2406,
+    2430,
+    2450,
+    2467,
+    2484,
+    2502,
+    2523,
+    2548,
+    2564,
+    2590,
+    2608,
+    2626,
+    2644,
+    2662,
+    2681,
+    2710,
+    2746,
+    2767,
+    2783,
+    2801,
+    2812,
+    2823,
+    2832,
+    2841,
+    2863,
+    2873,
+    2895,
+    2911,
+    2934,
+    2958,
+    2988,
+    2999,
+    3011,
+    3039,
+    3066,
+    3094,
+    3122,
+    3144,
+    3166,
+    3186,
+    3206,
+    3223,
+    3244,
+    3256,
     3277,
-    3291,
-    3307,
-    3324,
-    3354,
-    3380,
-    3408,
-    3431,
-    3457,
-    3485,
-    3503,
-    3521,
-    3538,
+    3297,
+    3313,
+    3330,
+    3345,
+    3359,
+    3375,
+    3392,
+    3422,
+    3448,
+    3476,
+    3499,
+    3525,
     3553,
-    3569,
-    3592,
-    3617,
-    3645,
-    3670,
-    3692,
-    3717,
-    3745,
-    3780,
-    3810,
-    3840,
-    3869,
-    3892,
-    3911,
+    3571,
+    3589,
+    3606,
+    3621,
+    3637,
+    3660,
+    3685,
+    3713,
+    3738,
+    3760,
+    3785,
+    3813,
+    3848,
+    3878,
+    3908,
     3937,
-    3965,
-    3987,
-    4012,
-    4044,
-    4074,
-    4105,
-    4129,
-    4164,
-    4201,
-    4241,
-    4270,
-    4302,
-    4341,
-    4383,
-    4424,
-    4468,
-    4497,
-    4529,
+    3960,
+    3979,
+    4005,
+    4033,
+    4055,
+    4080,
+    4112,
+    4142,
+    4173,
+    4197,
+    4223,
+    4255,
+    4290,
+    4327,
+    4367,
+    4395,
+    4417,
+    4446,
+    4478,
+    4517,
     4559,
-    4575,
-    4592,
-    4621,
-    4636,
-    4650,
-    4670,
-    4691,
-    4729,
-    4766,
-    4796,
-    4824,
-    4861,
-    4897,
-    4926,
-    4940,
-    4955,
-    4982,
-    5005,
-    5033,
-    5064,
-    5089,
-    5106,
-    5124,
-    5153,
-    5176,
-    5199,
-    5225,
-    5251,
-    5276,
-    5305,
+    4600,
+    4644,
+    4673,
+    4705,
+    4735,
+    4751,
+    4768,
+    4797,
+    4812,
+    4826,
+    4846,
+    4867,
+    4905,
+    4942,
+    4972,
+    5000,
+    5037,
+    5073,
+    5102,
+    5116,
+    5131,
+    5158,
+    5181,
+    5209,
+    5240,
+    5265,
+    5282,
+    5300,
+    5329,
     5352,
+    5375,
     5401,
-    5415,
     5427,
-    5444,
+    5452,
     5481,
-    5507,
-    5533,
-    5558,
-    5578,
+    5528,
+    5577,
+    5591,
+    5603,
+    5620,
+    5657,
+    5683,
+    5709,
+    5734,
+    5754,
 };
 
 const char* InspectorBackendDispatcher::commandName(MethodNames index) {
@@ -489,6 +503,518 @@ const char* InspectorBackendDispatcher::commandName(MethodNames index) {
     return commandNames + commandNamesIndex[index];
 }
 
+const unsigned short InspectorBackendDispatcher::methodNameHashSeeds[] = {
+    1,
+    2,
+    6,
+    2,
+    5,
+    1,
+    1,
+    2,
+    1,
+    1,
+    0,
+    0,
+    2,
+    4,
+    1,
+    7,
+    0,
+    0,
+    0,
+    2,
+    7,
+    0,
+    0,
+    1,
+    0,
+    1,
+    1,
+    4,
+    1,
+    1,
+    4,
+    1,
+    1,
+    1,
+    0,
+    3,
+    0,
+    0,
+    0,
+    0,
+    0,
+    4,
+    0,
+    3,
+    1,
+    0,
+    0,
+    1,
+    2,
+    1,
+    3,
+    5,
+    0,
+    1,
+    2,
+    0,
+    9,
+    1,
+    1,
+    10,
+    0,
+    1,
+    4,
+    0,
+    0,
+    1,
+    1,
+    0,
+    4,
+    0,
+    0,
+    5,
+    12,
+    1,
+    1,
+    2,
+    0,
+    0,
+    4,
+    6,
+    1,
+    0,
+    0,
+    0,
+    3,
+    0,
+    2,
+    2,
+    0,
+    1,
+    0,
+    0,
+    0,
+    9,
+    2,
+    1,
+    0,
+    0,
+    1,
+    6,
+    1,
+    0,
+    0,
+    1,
+    1,
+    5,
+    0,
+    5,
+    1,
+    3,
+    7,
+    3,
+    2,
+    2,
+    0,
+    0,
+    0,
+    3,
+    10,
+    2,
+    3,
+    5,
+    4,
+    7,
+    0,
+    0,
+    1,
+    0,
+    5,
+    2,
+    0,
+    4,
+    0,
+    16,
+    3,
+    0,
+    4,
+    1,
+    11,
+    0,
+    7,
+    2,
+    0,
+    0,
+    1,
+    6,
+    6,
+    2,
+    2,
+    1,
+    1,
+    2,
+    2,
+    0,
+    1,
+    3,
+    1,
+    0,
+    1,
+    2,
+    0,
+    0,
+    2,
+    1,
+    0,
+    0,
+    0,
+    8,
+    9,
+    1,
+    33,
+    30,
+    2,
+    1,
+    3,
+    0,
+    0,
+    13,
+    2,
+    1,
+    3,
+    2,
+    0,
+    13,
+    13,
+    10,
+    2,
+    0,
+    31,
+    17,
+    0,
+    0,
+    0,
+    1,
+    2,
+    4,
+    44,
+    11,
+    0,
+    6,
+    6,
+    2,
+    8,
+    5,
+    0,
+    40,
+    43,
+    0,
+    3,
+    12,
+    0,
+    27,
+    2,
+    0,
+    0,
+    23,
+    37,
+    4,
+    0,
+    11,
+    202,
+    0,
+    0,
+    0,
+    0,
+    238,
+    5,
+    0,
+    0,
+    7,
+    1,
+    0,
+    0,
+    0,
+    0,
+    0,
+    1,
+    330,
+};
+
+const unsigned short InspectorBackendDispatcher::methodNameHashSlots[] = {
+    5,
+    135,
+    212,
+    188,
+    181,
+    226,
+    154,
+    194,
+    21,
+    180,
+    163,
+    18,
+    123,
+    191,
+    204,
+    0,
+    47,
+    168,
+    114,
+    190,
+    148,
+    89,
+    7,
+    42,
+    150,
+    99,
+    107,
+    53,
+    149,
+    187,
+    183,
+    13,
+    173,
+    40,
+    2,
+    121,
+    221,
+    119,
+    184,
+    171,
+    54,
+    176,
+    164,
+    100,
+    229,
+    23,
+    94,
+    144,
+    33,
+    224,
+    36,
+    225,
+    64,
+    62,
+    12,
+    110,
+    15,
+    169,
+    141,
+    132,
+    116,
+    95,
+    165,
+    28,
+    162,
+    83,
+    46,
+    82,
+    210,
+    143,
+    124,
+    19,
+    133,
+    85,
+    51,
+    35,
+    129,
+    92,
+    219,
+    205,
+    192,
+    104,
+    111,
+    196,
+    170,
+    206,
+    232,
+    24,
+    202,
+    220,
+    227,
+    175,
+    93,
+    1,
+    134,
+    127,
+    109,
+    156,
+    78,
+    161,
+    97,
+    58,
+    198,
+    151,
+    186,
+    233,
+    214,
+    60,
+    90,
+    185,
+    25,
+    50,
+    108,
+    117,
+    41,
+    29,
+    217,
+    32,
+    27,
+    10,
+    106,
+    197,
+    9,
+    17,
+    167,
+    20,
+    112,
+    142,
+    73,
+    200,
+    138,
+    209,
+    136,
+    174,
+    105,
+    88,
+    131,
+    193,
+    236,
+    237,
+    178,
+    96,
+    44,
+    215,
+    65,
+    72,
+    223,
+    75,
+    3,
+    30,
+    120,
+    137,
+    102,
+    61,
+    11,
+    66,
+    157,
+    56,
+    81,
+    37,
+    128,
+    234,
+    43,
+    39,
+    146,
+    207,
+    80,
+    208,
+    126,
+    203,
+    158,
+    195,
+    222,
+    31,
+    216,
+    63,
+    103,
+    115,
+    139,
+    55,
+    76,
+    145,
+    230,
+    172,
+    22,
+    52,
+    166,
+    235,
+    199,
+    70,
+    140,
+    6,
+    113,
+    14,
+    69,
+    228,
+    38,
+    59,
+    211,
+    159,
+    4,
+    153,
+    48,
+    155,
+    34,
+    67,
+    125,
+    218,
+    179,
+    8,
+    86,
+    57,
+    231,
+    71,
+    152,
+    84,
+    122,
+    147,
+    213,
+    77,
+    79,
+    91,
+    98,
+    101,
+    160,
+    87,
+    182,
+    26,
+    201,
+    130,
+    49,
+    68,
+    45,
+    177,
+    16,
+    118,
+    74,
+    189,
+};
+
+// FNV-1a from |seed|, as computed by the generator. Command names are ASCII.
+static bool methodNameHash(const String& name, unsigned seed, unsigned* hash)
+{
+    for (unsigned i = 0; i < name.length(); ++i) {
+        UChar c = name[i];
+        if (c > 0x7f)
+            return false;
+        seed = (seed ^ c) * 0x01000193;
+    }
+    *hash = seed;
+    return true;
+}
+
+bool InspectorBackendDispatcher::findCommand(const String& name, MethodNames* result)
+{
+    static_assert(static_cast<int>(kMethodNamesEnumSize) == WTF_ARRAY_LENGTH(methodNameHashSeeds), "MethodNames enum should have the same number of elements as methodNameHashSeeds");
+    static_assert(static_cast<int>(kMethodNamesEnumSize) == WTF_ARRAY_LENGTH(methodNameHashSlots), "MethodNames enum should have the same number of elements as methodNameHashSlots");
+    // The first hash picks the seed of the second, which leads to the only
+    // command the name can be.
+    unsigned hash;
+    if (!methodNameHash(name, 0x811c9dc5, &hash))
+        return false;
+    methodNameHash(name, methodNameHashSeeds[hash % kMethodNamesEnumSize], &hash);
+    MethodNames candidate = static_cast<MethodNames>(methodNameHashSlots[hash % kMethodNamesEnumSize]);
+    if (name != commandName(candidate))
+        return false;
+    *result = candidate;
+    return true;
+}
+
 class InspectorBackendDispatcherImpl : public InspectorBackendDispatcher {
 public:
     InspectorBackendDispatcherImpl(InspectorFrontendChannel* inspectorFrontendChannel)
@@ -523,244 +1049,8 @@ public:
         , m_powerAgent(0)
         , m_animationAgent(0)
         , m_accessibilityAgent(0)
+        , m_observer(nullptr)
     {
-        // Initialize dispatch map.
-        const CallHandler handlers[] = {
-              &InspectorBackendDispatcherImpl::Inspector_enable,
-            &InspectorBackendDispatcherImpl::Inspector_disable,
-            &InspectorBackendDispatcherImpl::Memory_getDOMCounters,
-            &InspectorBackendDispatcherImpl::Page_enable,
-            &InspectorBackendDispatcherImpl::Page_disable,
-            &InspectorBackendDispatcherImpl::Page_addScriptToEvaluateOnLoad,
-            &InspectorBackendDispatcherImpl::Page_removeScriptToEvaluateOnLoad,
-            &InspectorBackendDispatcherImpl::Page_reload,
-            &InspectorBackendDispatcherImpl::Page_navigate,
-            &InspectorBackendDispatcherImpl::Page_getResourceTree,
-            &InspectorBackendDispatcherImpl::Page_getResourceContent,
-            &InspectorBackendDispatcherImpl::Page_searchInResource,
-            &InspectorBackendDispatcherImpl::Page_setDocumentContent,
-            &InspectorBackendDispatcherImpl::Page_setDeviceOrientationOverride,
-            &InspectorBackendDispatcherImpl::Page_clearDeviceOrientationOverride,
-            &InspectorBackendDispatcherImpl::Page_setTouchEmulationEnabled,
-            &InspectorBackendDispatcherImpl::Page_startScreencast,
-            &InspectorBackendDispatcherImpl::Page_stopScreencast,
-            &InspectorBackendDispatcherImpl::Page_setShowViewportSizeOnResize,
-            &InspectorBackendDispatcherImpl::Page_setOverlayMessage,
-            &InspectorBackendDispatcherImpl::Rendering_setShowPaintRects,
-            &InspectorBackendDispatcherImpl::Rendering_setShowDebugBorders,
-            &InspectorBackendDispatcherImpl::Rendering_setShowFPSCounter,
-            &InspectorBackendDispatcherImpl::Rendering_setContinuousPaintingEnabled,
-            &InspectorBackendDispatcherImpl::Rendering_setShowScrollBottleneckRects,
-            &InspectorBackendDispatcherImpl::Emulation_resetScrollAndPageScaleFactor,
-            &InspectorBackendDispatcherImpl::Emulation_setPageScaleFactor,
-            &InspectorBackendDispatcherImpl::Emulation_setScriptExecutionDisabled,
-            &InspectorBackendDispatcherImpl::Emulation_setTouchEmulationEnabled,
-            &InspectorBackendDispatcherImpl::Emulation_setEmulatedMedia,
-            &InspectorBackendDispatcherImpl::Runtime_evaluate,
-            &InspectorBackendDispatcherImpl::Runtime_callFunctionOn,
-            &InspectorBackendDispatcherImpl::Runtime_getProperties,
-            &InspectorBackendDispatcherImpl::Runtime_releaseObject,
-            &InspectorBackendDispatcherImpl::Runtime_releaseObjectGroup,
-            &InspectorBackendDispatcherImpl::Runtime_run,
-            &InspectorBackendDispatcherImpl::Runtime_enable,
-            &InspectorBackendDispatcherImpl::Runtime_disable,
-            &InspectorBackendDispatcherImpl::Runtime_isRunRequired,
-            &InspectorBackendDispatcherImpl::Runtime_setCustomObjectFormatterEnabled,
-            &InspectorBackendDispatcherImpl::Console_enable,
-            &InspectorBackendDispatcherImpl::Console_disable,
-            &InspectorBackendDispatcherImpl::Console_clearMessages,
-            &InspectorBackendDispatcherImpl::Network_enable,
-            &InspectorBackendDispatcherImpl::Network_disable,
-            &InspectorBackendDispatcherImpl::Network_setUserAgentOverride,
-            &InspectorBackendDispatcherImpl::Network_setExtraHTTPHeaders,
-            &InspectorBackendDispatcherImpl::Network_getResponseBody,
-            &InspectorBackendDispatcherImpl::Network_replayXHR,
-            &InspectorBackendDispatcherImpl::Network_setMonitoringXHREnabled,
-            &InspectorBackendDispatcherImpl::Network_canClearBrowserCache,
-            &InspectorBackendDispatcherImpl::Network_canClearBrowserCookies,
-            &InspectorBackendDispatcherImpl::Network_emulateNetworkConditions,
-            &InspectorBackendDispatcherImpl::Network_setCacheDisabled,
-            &InspectorBackendDispatcherImpl::Network_setDataSizeLimitsForTest,
-            &InspectorBackendDispatcherImpl::Database_enable,
-            &InspectorBackendDispatcherImpl::Database_disable,
-            &InspectorBackendDispatcherImpl::Database_getDatabaseTableNames,
-            &InspectorBackendDispatcherImpl::Database_executeSQL,
-            &InspectorBackendDispatcherImpl::IndexedDB_enable,
-            &InspectorBackendDispatcherImpl::IndexedDB_disable,
-            &InspectorBackendDispatcherImpl::IndexedDB_requestDatabaseNames,
-            &InspectorBackendDispatcherImpl::IndexedDB_requestDatabase,
-            &InspectorBackendDispatcherImpl::IndexedDB_requestData,
-            &InspectorBackendDispatcherImpl::IndexedDB_clearObjectStore,
-            &InspectorBackendDispatcherImpl::CacheStorage_requestCacheNames,
-            &InspectorBackendDispatcherImpl::CacheStorage_requestEntries,
-            &InspectorBackendDispatcherImpl::CacheStorage_deleteCache,
-            &InspectorBackendDispatcherImpl::CacheStorage_deleteEntry,
-            &InspectorBackendDispatcherImpl::DOMStorage_enable,
-            &InspectorBackendDispatcherImpl::DOMStorage_disable,
-            &InspectorBackendDispatcherImpl::DOMStorage_getDOMStorageItems,
-            &InspectorBackendDispatcherImpl::DOMStorage_setDOMStorageItem,
-            &InspectorBackendDispatcherImpl::DOMStorage_removeDOMStorageItem,
-            &InspectorBackendDispatcherImpl::ApplicationCache_getFramesWithManifests,
-            &InspectorBackendDispatcherImpl::ApplicationCache_enable,
-            &InspectorBackendDispatcherImpl::ApplicationCache_getManifestForFrame,
-            &InspectorBackendDispatcherImpl::ApplicationCache_getApplicationCacheForFrame,
-            &InspectorBackendDispatcherImpl::FileSystem_enable,
-            &InspectorBackendDispatcherImpl::FileSystem_disable,
-            &InspectorBackendDispatcherImpl::FileSystem_requestFileSystemRoot,
-            &InspectorBackendDispatcherImpl::FileSystem_requestDirectoryContent,
-            &InspectorBackendDispatcherImpl::FileSystem_requestMetadata,
-            &InspectorBackendDispatcherImpl::FileSystem_requestFileContent,
-            &InspectorBackendDispatcherImpl::FileSystem_deleteEntry,
-            &InspectorBackendDispatcherImpl::DOM_enable,
-            &InspectorBackendDispatcherImpl::DOM_disable,
-            &InspectorBackendDispatcherImpl::DOM_getDocument,
-            &InspectorBackendDispatcherImpl::DOM_requestChildNodes,
-            &InspectorBackendDispatcherImpl::DOM_querySelector,
-            &InspectorBackendDispatcherImpl::DOM_querySelectorAll,
-            &InspectorBackendDispatcherImpl::DOM_setNodeName,
-            &InspectorBackendDispatcherImpl::DOM_setNodeValue,
-            &InspectorBackendDispatcherImpl::DOM_removeNode,
-            &InspectorBackendDispatcherImpl::DOM_setAttributeValue,
-            &InspectorBackendDispatcherImpl::DOM_setAttributesAsText,
-            &InspectorBackendDispatcherImpl::DOM_removeAttribute,
-            &InspectorBackendDispatcherImpl::DOM_getOuterHTML,
-            &InspectorBackendDispatcherImpl::DOM_setOuterHTML,
-            &InspectorBackendDispatcherImpl::DOM_performSearch,
-            &InspectorBackendDispatcherImpl::DOM_getSearchResults,
-            &InspectorBackendDispatcherImpl::DOM_discardSearchResults,
-            &InspectorBackendDispatcherImpl::DOM_requestNode,
-            &InspectorBackendDispatcherImpl::DOM_setInspectModeEnabled,
-            &InspectorBackendDispatcherImpl::DOM_highlightRect,
-            &InspectorBackendDispatcherImpl::DOM_highlightQuad,
-            &InspectorBackendDispatcherImpl::DOM_highlightNode,
-            &InspectorBackendDispatcherImpl::DOM_hideHighlight,
-            &InspectorBackendDispatcherImpl::DOM_highlightFrame,
-            &InspectorBackendDispatcherImpl::DOM_pushNodeByPathToFrontend,
-            &InspectorBackendDispatcherImpl::DOM_pushNodesByBackendIdsToFrontend,
-            &InspectorBackendDispatcherImpl::DOM_setInspectedNode,
-            &InspectorBackendDispatcherImpl::DOM_resolveNode,
-            &InspectorBackendDispatcherImpl::DOM_getAttributes,
-            &InspectorBackendDispatcherImpl::DOM_copyTo,
-            &InspectorBackendDispatcherImpl::DOM_moveTo,
-            &InspectorBackendDispatcherImpl::DOM_undo,
-            &InspectorBackendDispatcherImpl::DOM_redo,
-            &InspectorBackendDispatcherImpl::DOM_markUndoableState,
-            &InspectorBackendDispatcherImpl::DOM_focus,
-            &InspectorBackendDispatcherImpl::DOM_setFileInputFiles,
-            &InspectorBackendDispatcherImpl::DOM_getBoxModel,
-            &InspectorBackendDispatcherImpl::DOM_getNodeForLocation,
-            &InspectorBackendDispatcherImpl::DOM_getRelayoutBoundary,
-            &InspectorBackendDispatcherImpl::DOM_getHighlightObjectForTest,
-            &InspectorBackendDispatcherImpl::CSS_enable,
-            &InspectorBackendDispatcherImpl::CSS_disable,
-            &InspectorBackendDispatcherImpl::CSS_getMatchedStylesForNode,
-            &InspectorBackendDispatcherImpl::CSS_getInlineStylesForNode,
-            &InspectorBackendDispatcherImpl::CSS_getComputedStyleForNode,
-            &InspectorBackendDispatcherImpl::CSS_getPlatformFontsForNode,
-            &InspectorBackendDispatcherImpl::CSS_getStyleSheetText,
-            &InspectorBackendDispatcherImpl::CSS_setStyleSheetText,
-            &InspectorBackendDispatcherImpl::CSS_setPropertyText,
-            &InspectorBackendDispatcherImpl::CSS_setRuleSelector,
-            &InspectorBackendDispatcherImpl::CSS_setMediaText,
-            &InspectorBackendDispatcherImpl::CSS_createStyleSheet,
-            &InspectorBackendDispatcherImpl::CSS_addRule,
-            &InspectorBackendDispatcherImpl::CSS_forcePseudoState,
-            &InspectorBackendDispatcherImpl::CSS_getMediaQueries,
-            &InspectorBackendDispatcherImpl::Timeline_enable,
-            &InspectorBackendDispatcherImpl::Timeline_disable,
-            &InspectorBackendDispatcherImpl::Timeline_start,
-            &InspectorBackendDispatcherImpl::Timeline_stop,
-            &InspectorBackendDispatcherImpl::Debugger_enable,
-            &InspectorBackendDispatcherImpl::Debugger_disable,
-            &InspectorBackendDispatcherImpl::Debugger_setBreakpointsActive,
-            &InspectorBackendDispatcherImpl::Debugger_setSkipAllPauses,
-            &InspectorBackendDispatcherImpl::Debugger_setBreakpointByUrl,
-            &InspectorBackendDispatcherImpl::Debugger_setBreakpoint,
-            &InspectorBackendDispatcherImpl::Debugger_removeBreakpoint,
-            &InspectorBackendDispatcherImpl::Debugger_continueToLocation,
-            &InspectorBackendDispatcherImpl::Debugger_stepOver,
-            &InspectorBackendDispatcherImpl::Debugger_stepInto,
-            &InspectorBackendDispatcherImpl::Debugger_stepOut,
-            &InspectorBackendDispatcherImpl::Debugger_pause,
-            &InspectorBackendDispatcherImpl::Debugger_resume,
-            &InspectorBackendDispatcherImpl::Debugger_stepIntoAsync,
-            &InspectorBackendDispatcherImpl::Debugger_searchInContent,
-            &InspectorBackendDispatcherImpl::Debugger_canSetScriptSource,
-            &InspectorBackendDispatcherImpl::Debugger_setScriptSource,
-            &InspectorBackendDispatcherImpl::Debugger_restartFrame,
-            &InspectorBackendDispatcherImpl::Debugger_getScriptSource,
-            &InspectorBackendDispatcherImpl::Debugger_getFunctionDetails,
-            &InspectorBackendDispatcherImpl::Debugger_getGeneratorObjectDetails,
-            &InspectorBackendDispatcherImpl::Debugger_getCollectionEntries,
-            &InspectorBackendDispatcherImpl::Debugger_setPauseOnExceptions,
-            &InspectorBackendDispatcherImpl::Debugger_evaluateOnCallFrame,
-            &InspectorBackendDispatcherImpl::Debugger_compileScript,
-            &InspectorBackendDispatcherImpl::Debugger_runScript,
-            &InspectorBackendDispatcherImpl::Debugger_setVariableValue,
-            &InspectorBackendDispatcherImpl::Debugger_getStepInPositions,
-            &InspectorBackendDispatcherImpl::Debugger_getBacktrace,
-            &InspectorBackendDispatcherImpl::Debugger_skipStackFrames,
-            &InspectorBackendDispatcherImpl::Debugger_setAsyncCallStackDepth,
-            &InspectorBackendDispatcherImpl::Debugger_enablePromiseTracker,
-            &InspectorBackendDispatcherImpl::Debugger_disablePromiseTracker,
-            &InspectorBackendDispatcherImpl::Debugger_getPromiseById,
-            &InspectorBackendDispatcherImpl::Debugger_flushAsyncOperationEvents,
-            &InspectorBackendDispatcherImpl::Debugger_setAsyncOperationBreakpoint,
-            &InspectorBackendDispatcherImpl::Debugger_removeAsyncOperationBreakpoint,
-            &InspectorBackendDispatcherImpl::DOMDebugger_setDOMBreakpoint,
-            &InspectorBackendDispatcherImpl::DOMDebugger_removeDOMBreakpoint,
-            &InspectorBackendDispatcherImpl::DOMDebugger_setEventListenerBreakpoint,
-            &InspectorBackendDispatcherImpl::DOMDebugger_removeEventListenerBreakpoint,
-            &InspectorBackendDispatcherImpl::DOMDebugger_setInstrumentationBreakpoint,
-            &InspectorBackendDispatcherImpl::DOMDebugger_removeInstrumentationBreakpoint,
-            &InspectorBackendDispatcherImpl::DOMDebugger_setXHRBreakpoint,
-            &InspectorBackendDispatcherImpl::DOMDebugger_removeXHRBreakpoint,
-            &InspectorBackendDispatcherImpl::DOMDebugger_getEventListeners,
-            &InspectorBackendDispatcherImpl::Profiler_enable,
-            &InspectorBackendDispatcherImpl::Profiler_disable,
-            &InspectorBackendDispatcherImpl::Profiler_setSamplingInterval,
-            &InspectorBackendDispatcherImpl::Profiler_start,
-            &InspectorBackendDispatcherImpl::Profiler_stop,
-            &InspectorBackendDispatcherImpl::HeapProfiler_enable,
-            &InspectorBackendDispatcherImpl::HeapProfiler_disable,
-            &InspectorBackendDispatcherImpl::HeapProfiler_startTrackingHeapObjects,
-            &InspectorBackendDispatcherImpl::HeapProfiler_stopTrackingHeapObjects,
-            &InspectorBackendDispatcherImpl::HeapProfiler_takeHeapSnapshot,
-            &InspectorBackendDispatcherImpl::HeapProfiler_collectGarbage,
-            &InspectorBackendDispatcherImpl::HeapProfiler_getObjectByHeapObjectId,
-            &InspectorBackendDispatcherImpl::HeapProfiler_addInspectedHeapObject,
-            &InspectorBackendDispatcherImpl::HeapProfiler_getHeapObjectId,
-            &InspectorBackendDispatcherImpl::Worker_enable,
-            &InspectorBackendDispatcherImpl::Worker_disable,
-            &InspectorBackendDispatcherImpl::Worker_sendMessageToWorker,
-            &InspectorBackendDispatcherImpl::Worker_connectToWorker,
-            &InspectorBackendDispatcherImpl::Worker_disconnectFromWorker,
-            &InspectorBackendDispatcherImpl::Worker_setAutoconnectToWorkers,
-            &InspectorBackendDispatcherImpl::Input_dispatchTouchEvent,
-            &InspectorBackendDispatcherImpl::LayerTree_enable,
-            &InspectorBackendDispatcherImpl::LayerTree_disable,
-            &InspectorBackendDispatcherImpl::LayerTree_compositingReasons,
-            &InspectorBackendDispatcherImpl::LayerTree_makeSnapshot,
-            &InspectorBackendDispatcherImpl::LayerTree_loadSnapshot,
-            &InspectorBackendDispatcherImpl::LayerTree_releaseSnapshot,
-            &InspectorBackendDispatcherImpl::LayerTree_profileSnapshot,
-            &InspectorBackendDispatcherImpl::LayerTree_replaySnapshot,
-            &InspectorBackendDispatcherImpl::LayerTree_snapshotCommandLog,
-            &InspectorBackendDispatcherImpl::DeviceOrientation_setDeviceOrientationOverride,
-            &InspectorBackendDispatcherImpl::DeviceOrientation_clearDeviceOrientationOverride,
-            &InspectorBackendDispatcherImpl::Tracing_start,
-            &InspectorBackendDispatcherImpl::Tracing_end,
-            &InspectorBackendDispatcherImpl::Animation_enable,
-            &InspectorBackendDispatcherImpl::Animation_getAnimationPlayersForNode,
-            &InspectorBackendDispatcherImpl::Animation_getPlaybackRate,
-            &InspectorBackendDispatcherImpl::Animation_setPlaybackRate,
-            &InspectorBackendDispatcherImpl::Animation_setCurrentTime,
-            &InspectorBackendDispatcherImpl::Animation_setTiming,
-            &InspectorBackendDispatcherImpl::Accessibility_getAXNode,
-        };
-        for (size_t i = 0; i < kMethodNamesEnumSize; ++i)
-            m_dispatchMap.add(commandName(static_cast<MethodNames>(i)), handlers[i]);
-
         // Initialize common errors.
         m_commonErrors.insert(ParseError, -32700);
         m_commonErrors.insert(InvalidRequest, -32600);
@@ -771,8 +1061,9 @@ public:
     }
 
     virtual void clearFrontend() { m_inspectorFrontendChannel = 0; }
+    virtual void setObserver(Observer* observer) { m_observer = observer; }
     virtual void dispatch(const String& message);
-    virtual void reportProtocolError(int callId, CommonErrorCode, const String& errorMessage, PassRefPtr<JSONValue> data) const;
+    virtual void reportProtocolError(int callId, CommonErrorCode, const String& errorMessage, PassRefPtr<JSONValue> data);
     using InspectorBackendDispatcher::reportProtocolError;
 
     void sendResponse(int callId, const ErrorString& invocationError, PassRefPtr<JSONValue> errorData, PassRefPtr<JSONObject> result);
@@ -810,11 +1101,16 @@ public:
     virtual void registerAgent(AccessibilityCommandHandler* accessibilityAgent) { ASSERT(!m_accessibilityAgent); m_accessibilityAgent = accessibilityAgent; }
 private:
     using CallHandler = void (InspectorBackendDispatcherImpl::*)(int callId, JSONObject* messageObject, JSONArray* protocolErrors);
-    using DispatchMap = HashMap<String, CallHandler>;
+
+    void dispatchCommand(JSONObject* messageObject);
+    void sendProtocolResponse(int callId, PassRefPtr<JSONObject> message);
 
     void Inspector_enable(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
     void Inspector_disable(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
     void Memory_getDOMCounters(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
+    void Memory_startTrackingGC(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
+    void Memory_stopTrackingGC(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
+    void Memory_getGCStatistics(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
     void Page_enable(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
     void Page_disable(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
     void Page_addScriptToEvaluateOnLoad(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
@@ -990,9 +1286,13 @@ private:
     void Debugger_enablePromiseTracker(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
     void Debugger_disablePromiseTracker(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
     void Debugger_getPromiseById(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
+    void Debugger_getPromiseCensus(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
+    void Debugger_getLongPendingPromises(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
     void Debugger_flushAsyncOperationEvents(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
     void Debugger_setAsyncOperationBreakpoint(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
     void Debugger_removeAsyncOperationBreakpoint(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
+    void Debugger_searchInAllScripts(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
+    void Debugger_cancelSearch(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
     void DOMDebugger_setDOMBreakpoint(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
     void DOMDebugger_removeDOMBreakpoint(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
     void DOMDebugger_setEventListenerBreakpoint(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);
@@ -1095,13 +1395,258 @@ private:
         sendResponse(callId, invocationError, RefPtr<JSONValue>(), JSONObject::create());
     }
     static const char InvalidParamsFormatString[];
+    // Indexed by MethodNames.
+    static const CallHandler s_handlers[];
 
-    DispatchMap m_dispatchMap;
     Vector<int> m_commonErrors;
+    // Responses of the batch being dispatched, sent together when it ends.
+    RefPtr<JSONArray> m_batchResponses;
+    Observer* m_observer;
 };
 
 const char InspectorBackendDispatcherImpl::InvalidParamsFormatString[] = "Some arguments of method '%s' can't be processed";
 
+const InspectorBackendDispatcherImpl::CallHandler InspectorBackendDispatcherImpl::s_handlers[] = {
+    &InspectorBackendDispatcherImpl::Inspector_enable,
+    &InspectorBackendDispatcherImpl::Inspector_disable,
+    &InspectorBackendDispatcherImpl::Memory_getDOMCounters,
+    &InspectorBackendDispatcherImpl::Memory_startTrackingGC,
+    &InspectorBackendDispatcherImpl::Memory_stopTrackingGC,
+    &InspectorBackendDispatcherImpl::Memory_getGCStatistics,
+    &InspectorBackendDispatcherImpl::Page_enable,
+    &InspectorBackendDispatcherImpl::Page_disable,
+    &InspectorBackendDispatcherImpl::Page_addScriptToEvaluateOnLoad,
+    &InspectorBackendDispatcherImpl::Page_removeScriptToEvaluateOnLoad,
+    &InspectorBackendDispatcherImpl::Page_reload,
+    &InspectorBackendDispatcherImpl::Page_navigate,
+    &InspectorBackendDispatcherImpl::Page_getResourceTree,
+    &InspectorBackendDispatcherImpl::Page_getResourceContent,
+    &InspectorBackendDispatcherImpl::Page_searchInResource,
+    &InspectorBackendDispatcherImpl::Page_setDocumentContent,
+    &InspectorBackendDispatcherImpl::Page_setDeviceOrientationOverride,
+    &InspectorBackendDispatcherImpl::Page_clearDeviceOrientationOverride,
+    &InspectorBackendDispatcherImpl::Page_setTouchEmulationEnabled,
+    &InspectorBackendDispatcherImpl::Page_startScreencast,
+    &InspectorBackendDispatcherImpl::Page_stopScreencast,
+    &InspectorBackendDispatcherImpl::Page_setShowViewportSizeOnResize,
+    &InspectorBackendDispatcherImpl::Page_setOverlayMessage,
+    &InspectorBackendDispatcherImpl::Rendering_setShowPaintRects,
+    &InspectorBackendDispatcherImpl::Rendering_setShowDebugBorders,
+    &InspectorBackendDispatcherImpl::Rendering_setShowFPSCounter,
+    &InspectorBackendDispatcherImpl::Rendering_setContinuousPaintingEnabled,
+    &InspectorBackendDispatcherImpl::Rendering_setShowScrollBottleneckRects,
+    &InspectorBackendDispatcherImpl::Emulation_resetScrollAndPageScaleFactor,
+    &InspectorBackendDispatcherImpl::Emulation_setPageScaleFactor,
+    &InspectorBackendDispatcherImpl::Emulation_setScriptExecutionDisabled,
+    &InspectorBackendDispatcherImpl::Emulation_setTouchEmulationEnabled,
+    &InspectorBackendDispatcherImpl::Emulation_setEmulatedMedia,
+    &InspectorBackendDispatcherImpl::Runtime_evaluate,
+    &InspectorBackendDispatcherImpl::Runtime_callFunctionOn,
+    &InspectorBackendDispatcherImpl::Runtime_getProperties,
+    &InspectorBackendDispatcherImpl::Runtime_releaseObject,
+    &InspectorBackendDispatcherImpl::Runtime_releaseObjectGroup,
+    &InspectorBackendDispatcherImpl::Runtime_run,
+    &InspectorBackendDispatcherImpl::Runtime_enable,
+    &InspectorBackendDispatcherImpl::Runtime_disable,
+    &InspectorBackendDispatcherImpl::Runtime_isRunRequired,
+    &InspectorBackendDispatcherImpl::Runtime_setCustomObjectFormatterEnabled,
+    &InspectorBackendDispatcherImpl::Console_enable,
+    &InspectorBackendDispatcherImpl::Console_disable,
+    &InspectorBackendDispatcherImpl::Console_clearMessages,
+    &InspectorBackendDispatcherImpl::Network_enable,
+    &InspectorBackendDispatcherImpl::Network_disable,
+    &InspectorBackendDispatcherImpl::Network_setUserAgentOverride,
+    &InspectorBackendDispatcherImpl::Network_setExtraHTTPHeaders,
+    &InspectorBackendDispatcherImpl::Network_getResponseBody,
+    &InspectorBackendDispatcherImpl::Network_replayXHR,
+    &InspectorBackendDispatcherImpl::Network_setMonitoringXHREnabled,
+    &InspectorBackendDispatcherImpl::Network_canClearBrowserCache,
+    &InspectorBackendDispatcherImpl::Network_canClearBrowserCookies,
+    &InspectorBackendDispatcherImpl::Network_emulateNetworkConditions,
+    &InspectorBackendDispatcherImpl::Network_setCacheDisabled,
+    &InspectorBackendDispatcherImpl::Network_setDataSizeLimitsForTest,
+    &InspectorBackendDispatcherImpl::Database_enable,
+    &InspectorBackendDispatcherImpl::Database_disable,
+    &InspectorBackendDispatcherImpl::Database_getDatabaseTableNames,
+    &InspectorBackendDispatcherImpl::Database_executeSQL,
+    &InspectorBackendDispatcherImpl::IndexedDB_enable,
+    &InspectorBackendDispatcherImpl::IndexedDB_disable,
+    &InspectorBackendDispatcherImpl::IndexedDB_requestDatabaseNames,
+    &InspectorBackendDispatcherImpl::IndexedDB_requestDatabase,
+    &InspectorBackendDispatcherImpl::IndexedDB_requestData,
+    &InspectorBackendDispatcherImpl::IndexedDB_clearObjectStore,
+    &InspectorBackendDispatcherImpl::CacheStorage_requestCacheNames,
+    &InspectorBackendDispatcherImpl::CacheStorage_requestEntries,
+    &InspectorBackendDispatcherImpl::CacheStorage_deleteCache,
+    &InspectorBackendDispatcherImpl::CacheStorage_deleteEntry,
+    &InspectorBackendDispatcherImpl::DOMStorage_enable,
+    &InspectorBackendDispatcherImpl::DOMStorage_disable,
+    &InspectorBackendDispatcherImpl::DOMStorage_getDOMStorageItems,
+    &InspectorBackendDispatcherImpl::DOMStorage_setDOMStorageItem,
+    &InspectorBackendDispatcherImpl::DOMStorage_removeDOMStorageItem,
+    &InspectorBackendDispatcherImpl::ApplicationCache_getFramesWithManifests,
+    &InspectorBackendDispatcherImpl::ApplicationCache_enable,
+    &InspectorBackendDispatcherImpl::ApplicationCache_getManifestForFrame,
+    &InspectorBackendDispatcherImpl::ApplicationCache_getApplicationCacheForFrame,
+    &InspectorBackendDispatcherImpl::FileSystem_enable,
+    &InspectorBackendDispatcherImpl::FileSystem_disable,
+    &InspectorBackendDispatcherImpl::FileSystem_requestFileSystemRoot,
+    &InspectorBackendDispatcherImpl::FileSystem_requestDirectoryContent,
+    &InspectorBackendDispatcherImpl::FileSystem_requestMetadata,
+    &InspectorBackendDispatcherImpl::FileSystem_requestFileContent,
+    &InspectorBackendDispatcherImpl::FileSystem_deleteEntry,
+    &InspectorBackendDispatcherImpl::DOM_enable,
+    &InspectorBackendDispatcherImpl::DOM_disable,
+    &InspectorBackendDispatcherImpl::DOM_getDocument,
+    &InspectorBackendDispatcherImpl::DOM_requestChildNodes,
+    &InspectorBackendDispatcherImpl::DOM_querySelector,
+    &InspectorBackendDispatcherImpl::DOM_querySelectorAll,
+    &InspectorBackendDispatcherImpl::DOM_setNodeName,
+    &InspectorBackendDispatcherImpl::DOM_setNodeValue,
+    &InspectorBackendDispatcherImpl::DOM_removeNode,
+    &InspectorBackendDispatcherImpl::DOM_setAttributeValue,
+    &InspectorBackendDispatcherImpl::DOM_setAttributesAsText,
+    &InspectorBackendDispatcherImpl::DOM_removeAttribute,
+    &InspectorBackendDispatcherImpl::DOM_getOuterHTML,
+    &InspectorBackendDispatcherImpl::DOM_setOuterHTML,
+    &InspectorBackendDispatcherImpl::DOM_performSearch,
+    &InspectorBackendDispatcherImpl::DOM_getSearchResults,
+    &InspectorBackendDispatcherImpl::DOM_discardSearchResults,
+    &InspectorBackendDispatcherImpl::DOM_requestNode,
+    &InspectorBackendDispatcherImpl::DOM_setInspectModeEnabled,
+    &InspectorBackendDispatcherImpl::DOM_highlightRect,
+    &InspectorBackendDispatcherImpl::DOM_highlightQuad,
+    &InspectorBackendDispatcherImpl::DOM_highlightNode,
+    &InspectorBackendDispatcherImpl::DOM_hideHighlight,
+    &InspectorBackendDispatcherImpl::DOM_highlightFrame,
+    &InspectorBackendDispatcherImpl::DOM_pushNodeByPathToFrontend,
+    &InspectorBackendDispatcherImpl::DOM_pushNodesByBackendIdsToFrontend,
+    &InspectorBackendDispatcherImpl::DOM_setInspectedNode,
+    &InspectorBackendDispatcherImpl::DOM_resolveNode,
+    &InspectorBackendDispatcherImpl::DOM_getAttributes,
+    &InspectorBackendDispatcherImpl::DOM_copyTo,
+    &InspectorBackendDispatcherImpl::DOM_moveTo,
+    &InspectorBackendDispatcherImpl::DOM_undo,
+    &InspectorBackendDispatcherImpl::DOM_redo,
+    &InspectorBackendDispatcherImpl::DOM_markUndoableState,
+    &InspectorBackendDispatcherImpl::DOM_focus,
+    &InspectorBackendDispatcherImpl::DOM_setFileInputFiles,
+    &InspectorBackendDispatcherImpl::DOM_getBoxModel,
+    &InspectorBackendDispatcherImpl::DOM_getNodeForLocation,
+    &InspectorBackendDispatcherImpl::DOM_getRelayoutBoundary,
+    &InspectorBackendDispatcherImpl::DOM_getHighlightObjectForTest,
+    &InspectorBackendDispatcherImpl::CSS_enable,
+    &InspectorBackendDispatcherImpl::CSS_disable,
+    &InspectorBackendDispatcherImpl::CSS_getMatchedStylesForNode,
+    &InspectorBackendDispatcherImpl::CSS_getInlineStylesForNode,
+    &InspectorBackendDispatcherImpl::CSS_getComputedStyleForNode,
+    &InspectorBackendDispatcherImpl::CSS_getPlatformFontsForNode,
+    &InspectorBackendDispatcherImpl::CSS_getStyleSheetText,
+    &InspectorBackendDispatcherImpl::CSS_setStyleSheetText,
+    &InspectorBackendDispatcherImpl::CSS_setPropertyText,
+    &InspectorBackendDispatcherImpl::CSS_setRuleSelector,
+    &InspectorBackendDispatcherImpl::CSS_setMediaText,
+    &InspectorBackendDispatcherImpl::CSS_createStyleSheet,
+    &InspectorBackendDispatcherImpl::CSS_addRule,
+    &InspectorBackendDispatcherImpl::CSS_forcePseudoState,
+    &InspectorBackendDispatcherImpl::CSS_getMediaQueries,
+    &InspectorBackendDispatcherImpl::Timeline_enable,
+    &InspectorBackendDispatcherImpl::Timeline_disable,
+    &InspectorBackendDispatcherImpl::Timeline_start,
+    &InspectorBackendDispatcherImpl::Timeline_stop,
+    &InspectorBackendDispatcherImpl::Debugger_enable,
+    &InspectorBackendDispatcherImpl::Debugger_disable,
+    &InspectorBackendDispatcherImpl::Debugger_setBreakpointsActive,
+    &InspectorBackendDispatcherImpl::Debugger_setSkipAllPauses,
+    &InspectorBackendDispatcherImpl::Debugger_setBreakpointByUrl,
+    &InspectorBackendDispatcherImpl::Debugger_setBreakpoint,
+    &InspectorBackendDispatcherImpl::Debugger_removeBreakpoint,
+    &InspectorBackendDispatcherImpl::Debugger_continueToLocation,
+    &InspectorBackendDispatcherImpl::Debugger_stepOver,
+    &InspectorBackendDispatcherImpl::Debugger_stepInto,
+    &InspectorBackendDispatcherImpl::Debugger_stepOut,
+    &InspectorBackendDispatcherImpl::Debugger_pause,
+    &InspectorBackendDispatcherImpl::Debugger_resume,
+    &InspectorBackendDispatcherImpl::Debugger_stepIntoAsync,
+    &InspectorBackendDispatcherImpl::Debugger_searchInContent,
+    &InspectorBackendDispatcherImpl::Debugger_canSetScriptSource,
+    &InspectorBackendDispatcherImpl::Debugger_setScriptSource,
+    &InspectorBackendDispatcherImpl::Debugger_restartFrame,
+    &InspectorBackendDispatcherImpl::Debugger_getScriptSource,
+    &InspectorBackendDispatcherImpl::Debugger_getFunctionDetails,
+    &InspectorBackendDispatcherImpl::Debugger_getGeneratorObjectDetails,
+    &InspectorBackendDispatcherImpl::Debugger_getCollectionEntries,
+    &InspectorBackendDispatcherImpl::Debugger_setPauseOnExceptions,
+    &InspectorBackendDispatcherImpl::Debugger_evaluateOnCallFrame,
+    &InspectorBackendDispatcherImpl::Debugger_compileScript,
+    &InspectorBackendDispatcherImpl::Debugger_runScript,
+    &InspectorBackendDispatcherImpl::Debugger_setVariableValue,
+    &InspectorBackendDispatcherImpl::Debugger_getStepInPositions,
+    &InspectorBackendDispatcherImpl::Debugger_getBacktrace,
+    &InspectorBackendDispatcherImpl::Debugger_skipStackFrames,
+    &InspectorBackendDispatcherImpl::Debugger_setAsyncCallStackDepth,
+    &InspectorBackendDispatcherImpl::Debugger_enablePromiseTracker,
+    &InspectorBackendDispatcherImpl::Debugger_disablePromiseTracker,
+    &InspectorBackendDispatcherImpl::Debugger_getPromiseById,
+    &InspectorBackendDispatcherImpl::Debugger_getPromiseCensus,
+    &InspectorBackendDispatcherImpl::Debugger_getLongPendingPromises,
+    &InspectorBackendDispatcherImpl::Debugger_flushAsyncOperationEvents,
+    &InspectorBackendDispatcherImpl::Debugger_setAsyncOperationBreakpoint,
+    &InspectorBackendDispatcherImpl::Debugger_removeAsyncOperationBreakpoint,
+    &InspectorBackendDispatcherImpl::Debugger_searchInAllScripts,
+    &InspectorBackendDispatcherImpl::Debugger_cancelSearch,
+    &InspectorBackendDispatcherImpl::DOMDebugger_setDOMBreakpoint,
+    &InspectorBackendDispatcherImpl::DOMDebugger_removeDOMBreakpoint,
+    &InspectorBackendDispatcherImpl::DOMDebugger_setEventListenerBreakpoint,
+    &InspectorBackendDispatcherImpl::DOMDebugger_removeEventListenerBreakpoint,
+    &InspectorBackendDispatcherImpl::DOMDebugger_setInstrumentationBreakpoint,
+    &InspectorBackendDispatcherImpl::DOMDebugger_removeInstrumentationBreakpoint,
+    &InspectorBackendDispatcherImpl::DOMDebugger_setXHRBreakpoint,
+    &InspectorBackendDispatcherImpl::DOMDebugger_removeXHRBreakpoint,
+    &InspectorBackendDispatcherImpl::DOMDebugger_getEventListeners,
+    &InspectorBackendDispatcherImpl::Profiler_enable,
+    &InspectorBackendDispatcherImpl::Profiler_disable,
+    &InspectorBackendDispatcherImpl::Profiler_setSamplingInterval,
+    &InspectorBackendDispatcherImpl::Profiler_start,
+    &InspectorBackendDispatcherImpl::Profiler_stop,
+    &InspectorBackendDispatcherImpl::HeapProfiler_enable,
+    &InspectorBackendDispatcherImpl::HeapProfiler_disable,
+    &InspectorBackendDispatcherImpl::HeapProfiler_startTrackingHeapObjects,
+    &InspectorBackendDispatcherImpl::HeapProfiler_stopTrackingHeapObjects,
+    &InspectorBackendDispatcherImpl::HeapProfiler_takeHeapSnapshot,
+    &InspectorBackendDispatcherImpl::HeapProfiler_collectGarbage,
+    &InspectorBackendDispatcherImpl::HeapProfiler_getObjectByHeapObjectId,
+    &InspectorBackendDispatcherImpl::HeapProfiler_addInspectedHeapObject,
+    &InspectorBackendDispatcherImpl::HeapProfiler_getHeapObjectId,
+    &InspectorBackendDispatcherImpl::Worker_enable,
+    &InspectorBackendDispatcherImpl::Worker_disable,
+    &InspectorBackendDispatcherImpl::Worker_sendMessageToWorker,
+    &InspectorBackendDispatcherImpl::Worker_connectToWorker,
+    &InspectorBackendDispatcherImpl::Worker_disconnectFromWorker,
+    &InspectorBackendDispatcherImpl::Worker_setAutoconnectToWorkers,
+    &InspectorBackendDispatcherImpl::Input_dispatchTouchEvent,
+    &InspectorBackendDispatcherImpl::LayerTree_enable,
+    &InspectorBackendDispatcherImpl::LayerTree_disable,
+    &InspectorBackendDispatcherImpl::LayerTree_compositingReasons,
+    &InspectorBackendDispatcherImpl::LayerTree_makeSnapshot,
+    &InspectorBackendDispatcherImpl::LayerTree_loadSnapshot,
+    &InspectorBackendDispatcherImpl::LayerTree_releaseSnapshot,
+    &InspectorBackendDispatcherImpl::LayerTree_profileSnapshot,
+    &InspectorBackendDispatcherImpl::LayerTree_replaySnapshot,
+    &InspectorBackendDispatcherImpl::LayerTree_snapshotCommandLog,
+    &InspectorBackendDispatcherImpl::DeviceOrientation_setDeviceOrientationOverride,
+    &InspectorBackendDispatcherImpl::DeviceOrientation_clearDeviceOrientationOverride,
+    &InspectorBackendDispatcherImpl::Tracing_start,
+    &InspectorBackendDispatcherImpl::Tracing_end,
+    &InspectorBackendDispatcherImpl::Animation_enable,
+    &InspectorBackendDispatcherImpl::Animation_getAnimationPlayersForNode,
+    &InspectorBackendDispatcherImpl::Animation_getPlaybackRate,
+    &InspectorBackendDispatcherImpl::Animation_setPlaybackRate,
+    &InspectorBackendDispatcherImpl::Animation_setCurrentTime,
+    &InspectorBackendDispatcherImpl::Animation_setTiming,
+    &InspectorBackendDispatcherImpl::Accessibility_getAXNode,
+};
+
 void InspectorBackendDispatcherImpl::Inspector_enable(int callId, JSONObject*, JSONArray* protocolErrors)
 {
     if (!m_inspectorAgent)
@@ -1156,6 +1701,69 @@ void InspectorBackendDispatcherImpl::Memory_getDOMCounters(int callId, JSONObjec
     sendResponse(callId, error, result);
 }
 
+void InspectorBackendDispatcherImpl::Memory_startTrackingGC(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors)
+{
+    if (!m_memoryAgent)
+        protocolErrors->pushString("Memory handler is not available.");
+
+    RefPtr<JSONObject> paramsContainer = requestMessageObject->getObject("params");
+    JSONObject* paramsContainerPtr = paramsContainer.get();
+    bool historySize_valueFound = false;
+    int in_historySize = getInt(paramsContainerPtr, "historySize", &historySize_valueFound, protocolErrors);
+
+    if (protocolErrors->length()) {
+        reportProtocolError(callId, InvalidParams, String::format(InvalidParamsFormatString, commandName(kMemory_startTrackingGCCmd)), protocolErrors);
+        return;
+    }
+    ErrorString error;
+    m_memoryAgent->startTrackingGC(&error, historySize_valueFound ? &in_historySize : 0);
+
+    sendResponse(callId, error);
+}
+
+void InspectorBackendDispatcherImpl::Memory_stopTrackingGC(int callId, JSONObject*, JSONArray* protocolErrors)
+{
+    if (!m_memoryAgent)
+        protocolErrors->pushString("Memory handler is not available.");
+
+    if (protocolErrors->length()) {
+        reportProtocolError(callId, InvalidParams, String::format(InvalidParamsFormatString, commandName(kMemory_stopTrackingGCCmd)), protocolErrors);
+        return;
+    }
+    ErrorString error;
+    m_memoryAgent->stopTrackingGC(&error);
+
+    sendResponse(callId, error);
+}
+
+void InspectorBackendDispatcherImpl::Memory_getGCStatistics(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors)
+{
+    if (!m_memoryAgent)
+        protocolErrors->pushString("Memory handler is not available.");
+
+    RefPtr<JSONObject> paramsContainer = requestMessageObject->getObject("params");
+    JSONObject* paramsContainerPtr = paramsContainer.get();
+    bool includeEvents_valueFound = false;
+    bool in_includeEvents = getBoolean(paramsContainerPtr, "includeEvents", &includeEvents_valueFound, protocolErrors);
+
+    RefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCPauseSummary> > out_summaries;
+    RefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCEvent> > out_events;
+
+    if (protocolErrors->length()) {
+        reportProtocolError(callId, InvalidParams, String::format(InvalidParamsFormatString, commandName(kMemory_getGCStatisticsCmd)), protocolErrors);
+        return;
+    }
+    ErrorString error;
+    RefPtr<JSONObject> result = JSONObject::create();
+    m_memoryAgent->getGCStatistics(&error, includeEvents_valueFound ? &in_includeEvents : 0, out_summaries, out_events);
+    if (!error.length()) {
+        result->setValue("summaries", out_summaries);
+        if (out_events)
+            result->setValue("events", out_events);
+    }
+    sendResponse(callId, error, result);
+}
+
 void InspectorBackendDispatcherImpl::Page_enable(int callId, JSONObject*, JSONArray* protocolErrors)
 {
     if (!m_pageAgent)
@@ -1727,7 +2335,7 @@ void InspectorBackendDispatcherImpl::Runtime_evaluate(int callId, JSONObject* re
     bool generatePreview_valueFound = false;
     bool in_generatePreview = getBoolean(paramsContainerPtr, "generatePreview", &generatePreview_valueFound, protocolErrors);
 
-    RefPtr<TypeBuilder::Runtime::RemoteObject> out_result;
+    RefPtr<JSONValue> out_result;
     TypeBuilder::OptOutput<bool> out_wasThrown;
     RefPtr<TypeBuilder::Debugger::ExceptionDetails> out_exceptionDetails;
 
@@ -1766,7 +2374,7 @@ void InspectorBackendDispatcherImpl::Runtime_callFunctionOn(int callId, JSONObje
     bool generatePreview_valueFound = false;
     bool in_generatePreview = getBoolean(paramsContainerPtr, "generatePreview", &generatePreview_valueFound, protocolErrors);
 
-    RefPtr<TypeBuilder::Runtime::RemoteObject> out_result;
+    RefPtr<JSONValue> out_result;
     TypeBuilder::OptOutput<bool> out_wasThrown;
 
     if (protocolErrors->length()) {
@@ -1798,10 +2406,21 @@ void InspectorBackendDispatcherImpl::Runtime_getProperties(int callId, JSONObjec
     bool in_accessorPropertiesOnly = getBoolean(paramsContainerPtr, "accessorPropertiesOnly", &accessorPropertiesOnly_valueFound, protocolErrors);
     bool generatePreview_valueFound = false;
     bool in_generatePreview = getBoolean(paramsContainerPtr, "generatePreview", &generatePreview_valueFound, protocolErrors);
-
-    RefPtr<TypeBuilder::Array<TypeBuilder::Runtime::PropertyDescriptor> > out_result;
+    bool fromIndex_valueFound = false;
+    int in_fromIndex = getInt(paramsContainerPtr, "fromIndex", &fromIndex_valueFound, protocolErrors);
+    bool toIndex_valueFound = false;
+    int in_toIndex = getInt(paramsContainerPtr, "toIndex", &toIndex_valueFound, protocolErrors);
+    bool nonIndexedPropertiesOnly_valueFound = false;
+    bool in_nonIndexedPropertiesOnly = getBoolean(paramsContainerPtr, "nonIndexedPropertiesOnly", &nonIndexedPropertiesOnly_valueFound, protocolErrors);
+    bool maxProperties_valueFound = false;
+    int in_maxProperties = getInt(paramsContainerPtr, "maxProperties", &maxProperties_valueFound, protocolErrors);
+    bool continuationToken_valueFound = false;
+    String in_continuationToken = getString(paramsContainerPtr, "continuationToken", &continuationToken_valueFound, protocolErrors);
+
+    RefPtr<JSONValue> out_result;
     RefPtr<TypeBuilder::Array<TypeBuilder::Runtime::InternalPropertyDescriptor> > out_internalProperties;
     RefPtr<TypeBuilder::Debugger::ExceptionDetails> out_exceptionDetails;
+    TypeBuilder::OptOutput<String> out_continuationToken;
 
     if (protocolErrors->length()) {
         reportProtocolError(callId, InvalidParams, String::format(InvalidParamsFormatString, commandName(kRuntime_getPropertiesCmd)), protocolErrors);
@@ -1809,13 +2428,15 @@ void InspectorBackendDispatcherImpl::Runtime_getProperties(int callId, JSONObjec
     }
     ErrorString error;
     RefPtr<JSONObject> result = JSONObject::create();
-    m_runtimeAgent->getProperties(&error, in_objectId, ownProperties_valueFound ? &in_ownProperties : 0, accessorPropertiesOnly_valueFound ? &in_accessorPropertiesOnly : 0, generatePreview_valueFound ? &in_generatePreview : 0, out_result, out_internalProperties, out_exceptionDetails);
+    m_runtimeAgent->getProperties(&error, in_objectId, ownProperties_valueFound ? &in_ownProperties : 0, accessorPropertiesOnly_valueFound ? &in_accessorPropertiesOnly : 0, generatePreview_valueFound ? &in_generatePreview : 0, fromIndex_valueFound ? &in_fromIndex : 0, toIndex_valueFound ? &in_toIndex : 0, nonIndexedPropertiesOnly_valueFound ? &in_nonIndexedPropertiesOnly : 0, maxProperties_valueFound ? &in_maxProperties : 0, continuationToken_valueFound ? &in_continuationToken : 0, out_result, out_internalProperties, out_exceptionDetails, &out_continuationToken);
     if (!error.length()) {
         result->setValue("result", out_result);
         if (out_internalProperties)
             result->setValue("internalProperties", out_internalProperties);
         if (out_exceptionDetails)
             result->setValue("exceptionDetails", out_exceptionDetails);
+        if (out_continuationToken.isAssigned())
+            result->setString("continuationToken", out_continuationToken.getValue());
     }
     sendResponse(callId, error, result);
 }
@@ -4827,7 +5448,7 @@ void InspectorBackendDispatcherImpl::Debugger_evaluateOnCallFrame(int callId, JS
     bool generatePreview_valueFound = false;
     bool in_generatePreview = getBoolean(paramsContainerPtr, "generatePreview", &generatePreview_valueFound, protocolErrors);
 
-    RefPtr<TypeBuilder::Runtime::RemoteObject> out_result;
+    RefPtr<JSONValue> out_result;
     TypeBuilder::OptOutput<bool> out_wasThrown;
     RefPtr<TypeBuilder::Debugger::ExceptionDetails> out_exceptionDetails;
 
@@ -5036,13 +5657,15 @@ void InspectorBackendDispatcherImpl::Debugger_enablePromiseTracker(int callId, J
     JSONObject* paramsContainerPtr = paramsContainer.get();
     bool captureStacks_valueFound = false;
     bool in_captureStacks = getBoolean(paramsContainerPtr, "captureStacks", &captureStacks_valueFound, protocolErrors);
+    bool census_valueFound = false;
+    bool in_census = getBoolean(paramsContainerPtr, "census", &census_valueFound, protocolErrors);
 
     if (protocolErrors->length()) {
         reportProtocolError(callId, InvalidParams, String::format(InvalidParamsFormatString, commandName(kDebugger_enablePromiseTrackerCmd)), protocolErrors);
         return;
     }
     ErrorString error;
-    m_debuggerAgent->enablePromiseTracker(&error, captureStacks_valueFound ? &in_captureStacks : 0);
+    m_debuggerAgent->enablePromiseTracker(&error, captureStacks_valueFound ? &in_captureStacks : 0, census_valueFound ? &in_census : 0);
 
     sendResponse(callId, error);
 }
@@ -5088,6 +5711,52 @@ void InspectorBackendDispatcherImpl::Debugger_getPromiseById(int callId, JSONObj
     sendResponse(callId, error, result);
 }
 
+void InspectorBackendDispatcherImpl::Debugger_getPromiseCensus(int callId, JSONObject*, JSONArray* protocolErrors)
+{
+    if (!m_debuggerAgent)
+        protocolErrors->pushString("Debugger handler is not available.");
+
+    RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::PromiseCreationSite> > out_sites;
+
+    if (protocolErrors->length()) {
+        reportProtocolError(callId, InvalidParams, String::format(InvalidParamsFormatString, commandName(kDebugger_getPromiseCensusCmd)), protocolErrors);
+        return;
+    }
+    ErrorString error;
+    RefPtr<JSONObject> result = JSONObject::create();
+    m_debuggerAgent->getPromiseCensus(&error, out_sites);
+    if (!error.length()) {
+        result->setValue("sites", out_sites);
+    }
+    sendResponse(callId, error, result);
+}
+
+void InspectorBackendDispatcherImpl::Debugger_getLongPendingPromises(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors)
+{
+    if (!m_debuggerAgent)
+        protocolErrors->pushString("Debugger handler is not available.");
+
+    RefPtr<JSONObject> paramsContainer = requestMessageObject->getObject("params");
+    JSONObject* paramsContainerPtr = paramsContainer.get();
+    double in_minimumAge = getDouble(paramsContainerPtr, "minimumAge", 0, protocolErrors);
+    bool maxCount_valueFound = false;
+    int in_maxCount = getInt(paramsContainerPtr, "maxCount", &maxCount_valueFound, protocolErrors);
+
+    RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::PromiseDetails> > out_promises;
+
+    if (protocolErrors->length()) {
+        reportProtocolError(callId, InvalidParams, String::format(InvalidParamsFormatString, commandName(kDebugger_getLongPendingPromisesCmd)), protocolErrors);
+        return;
+    }
+    ErrorString error;
+    RefPtr<JSONObject> result = JSONObject::create();
+    m_debuggerAgent->getLongPendingPromises(&error, in_minimumAge, maxCount_valueFound ? &in_maxCount : 0, out_promises);
+    if (!error.length()) {
+        result->setValue("promises", out_promises);
+    }
+    sendResponse(callId, error, result);
+}
+
 void InspectorBackendDispatcherImpl::Debugger_flushAsyncOperationEvents(int callId, JSONObject*, JSONArray* protocolErrors)
 {
     if (!m_debuggerAgent)
@@ -5141,6 +5810,54 @@ void InspectorBackendDispatcherImpl::Debugger_removeAsyncOperationBreakpoint(int
     sendResponse(callId, error);
 }
 
+void InspectorBackendDispatcherImpl::Debugger_searchInAllScripts(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors)
+{
+    if (!m_debuggerAgent)
+        protocolErrors->pushString("Debugger handler is not available.");
+
+    RefPtr<JSONObject> paramsContainer = requestMessageObject->getObject("params");
+    JSONObject* paramsContainerPtr = paramsContainer.get();
+    String in_query = getString(paramsContainerPtr, "query", 0, protocolErrors);
+    bool caseSensitive_valueFound = false;
+    bool in_caseSensitive = getBoolean(paramsContainerPtr, "caseSensitive", &caseSensitive_valueFound, protocolErrors);
+    bool isRegex_valueFound = false;
+    bool in_isRegex = getBoolean(paramsContainerPtr, "isRegex", &isRegex_valueFound, protocolErrors);
+    bool urlPattern_valueFound = false;
+    String in_urlPattern = getString(paramsContainerPtr, "urlPattern", &urlPattern_valueFound, protocolErrors);
+
+    String out_searchId;
+
+    if (protocolErrors->length()) {
+        reportProtocolError(callId, InvalidParams, String::format(InvalidParamsFormatString, commandName(kDebugger_searchInAllScriptsCmd)), protocolErrors);
+        return;
+    }
+    ErrorString error;
+    RefPtr<JSONObject> result = JSONObject::create();
+    m_debuggerAgent->searchInAllScripts(&error, in_query, caseSensitive_valueFound ? &in_caseSensitive : 0, isRegex_valueFound ? &in_isRegex : 0, urlPattern_valueFound ? &in_urlPattern : 0, &out_searchId);
+    if (!error.length())
+        result->setString("searchId", out_searchId);
+    sendResponse(callId, error, result);
+}
+
+void InspectorBackendDispatcherImpl::Debugger_cancelSearch(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors)
+{
+    if (!m_debuggerAgent)
+        protocolErrors->pushString("Debugger handler is not available.");
+
+    RefPtr<JSONObject> paramsContainer = requestMessageObject->getObject("params");
+    JSONObject* paramsContainerPtr = paramsContainer.get();
+    String in_searchId = getString(paramsContainerPtr, "searchId", 0, protocolErrors);
+
+    if (protocolErrors->length()) {
+        reportProtocolError(callId, InvalidParams, String::format(InvalidParamsFormatString, commandName(kDebugger_cancelSearchCmd)), protocolErrors);
+        return;
+    }
+    ErrorString error;
+    m_debuggerAgent->cancelSearch(&error, in_searchId);
+
+    sendResponse(callId, error);
+}
+
 void InspectorBackendDispatcherImpl::DOMDebugger_setDOMBreakpoint(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors)
 {
     if (!m_domDebuggerAgent)
@@ -6170,12 +6887,44 @@ PassRefPtrWillBeRawPtr<InspectorBackendDispatcher> InspectorBackendDispatcher::c
 void InspectorBackendDispatcherImpl::dispatch(const String& message)
 {
     RefPtrWillBeRawPtr<InspectorBackendDispatcher> protect(this);
-    int callId = 0;
+    if (m_observer)
+        m_observer->willParseMessage(message);
     RefPtr<JSONValue> parsedMessage = parseJSON(message);
+    if (m_observer)
+        m_observer->didParseMessage();
     ASSERT(parsedMessage);
-    RefPtr<JSONObject> messageObject = parsedMessage->asObject();
-    ASSERT(messageObject);
+    // A message dispatched from a nested loop while a batch is paused is not
+    // part of that batch.
+    RefPtr<JSONArray> outerBatchResponses = m_batchResponses.release();
+
+    RefPtr<JSONArray> batch = parsedMessage->asArray();
+    if (batch) {
+        // A batch is answered with one array holding the responses that its
+        // commands send before the batch ends, in order. Later responses and
+        // notifications are sent on their own.
+        m_batchResponses = JSONArray::create();
+        for (size_t i = 0; i < batch->length(); ++i) {
+            RefPtr<JSONObject> messageObject = batch->get(i)->asObject();
+            if (messageObject)
+                dispatchCommand(messageObject.get());
+            else
+                reportProtocolError(0, InvalidRequest, "Batch entries must be objects");
+        }
+        RefPtr<JSONArray> responses = m_batchResponses.release();
+        if (m_inspectorFrontendChannel && responses->length())
+            m_inspectorFrontendChannel->sendProtocolResponses(responses.release());
+    } else {
+        RefPtr<JSONObject> messageObject = parsedMessage->asObject();
+        ASSERT(messageObject);
+        dispatchCommand(messageObject.get());
+    }
 
+    m_batchResponses = outerBatchResponses.release();
+}
+
+void InspectorBackendDispatcherImpl::dispatchCommand(JSONObject* messageObject)
+{
+    int callId = 0;
     RefPtr<JSONValue> callIdValue = messageObject->get("id");
     bool success = callIdValue->asNumber(&callId);
     ASSERT_UNUSED(success, success);
@@ -6185,14 +6934,26 @@ void InspectorBackendDispatcherImpl::dispatch(const String& message)
     success = methodValue && methodValue->asString(&method);
     ASSERT_UNUSED(success, success);
 
-    HashMap<String, CallHandler>::iterator it = m_dispatchMap.find(method);
-    if (it == m_dispatchMap.end()) {
+    MethodNames methodName;
+    if (!findCommand(method, &methodName)) {
         reportProtocolError(callId, MethodNotFound, "'" + method + "' wasn't found");
         return;
     }
 
     RefPtr<JSONArray> protocolErrors = JSONArray::create();
-    ((*this).*it->value)(callId, messageObject.get(), protocolErrors.get());
+    if (m_observer)
+        m_observer->willDispatchCommand(methodName, callId);
+    ((*this).*s_handlers[methodName])(callId, messageObject, protocolErrors.get());
+    if (m_observer)
+        m_observer->didDispatchCommand(methodName, callId);
+}
+
+void InspectorBackendDispatcherImpl::sendProtocolResponse(int callId, PassRefPtr<JSONObject> message)
+{
+    if (m_batchResponses)
+        m_batchResponses->pushObject(message);
+    else if (m_inspectorFrontendChannel)
+        m_inspectorFrontendChannel->sendProtocolResponse(callId, message);
 }
 
 void InspectorBackendDispatcherImpl::sendResponse(int callId, const ErrorString& invocationError, PassRefPtr<JSONValue> errorData, PassRefPtr<JSONObject> result)
@@ -6205,16 +6966,15 @@ void InspectorBackendDispatcherImpl::sendResponse(int callId, const ErrorString&
     RefPtr<JSONObject> responseMessage = JSONObject::create();
     responseMessage->setNumber("id", callId);
     responseMessage->setObject("result", result);
-    if (m_inspectorFrontendChannel)
-        m_inspectorFrontendChannel->sendProtocolResponse(callId, responseMessage.release());
+    sendProtocolResponse(callId, responseMessage.release());
 }
 
-void InspectorBackendDispatcher::reportProtocolError(int callId, CommonErrorCode code, const String& errorMessage) const
+void InspectorBackendDispatcher::reportProtocolError(int callId, CommonErrorCode code, const String& errorMessage)
 {
     reportProtocolError(callId, code, errorMessage, PassRefPtr<JSONValue>());
 }
 
-void InspectorBackendDispatcherImpl::reportProtocolError(int callId, CommonErrorCode code, const String& errorMessage, PassRefPtr<JSONValue> data) const
+void InspectorBackendDispatcherImpl::reportProtocolError(int callId, CommonErrorCode code, const String& errorMessage, PassRefPtr<JSONValue> data)
 {
     ASSERT(code >=0);
     ASSERT((unsigned)code < m_commonErrors.size());
@@ -6228,8 +6988,7 @@ void InspectorBackendDispatcherImpl::reportProtocolError(int callId, CommonError
     RefPtr<JSONObject> message = JSONObject::create();
     message->setObject("error", error);
     message->setNumber("id", callId);
-    if (m_inspectorFrontendChannel)
-        m_inspectorFrontendChannel->sendProtocolResponse(callId, message.release());
+    sendProtocolResponse(callId, message.release());
 }
 
 template<typename R, typename V, typename V0>
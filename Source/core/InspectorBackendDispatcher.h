@@ -63,6 +63,9 @@ public:
     class CORE_EXPORT MemoryCommandHandler {
     public:
         virtual void getDOMCounters(ErrorString*, int* out_documents, int* out_nodes, int* out_jsEventListeners) = 0;
+        virtual void startTrackingGC(ErrorString*, const int* in_historySize) = 0;
+        virtual void stopTrackingGC(ErrorString*) = 0;
+        virtual void getGCStatistics(ErrorString*, const bool* in_includeEvents, RefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCPauseSummary> >& out_summaries, RefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCEvent> >& opt_out_events) = 0;
 
     protected:
         virtual ~MemoryCommandHandler() { }
@@ -120,9 +123,9 @@ public:
 
     class CORE_EXPORT RuntimeCommandHandler {
     public:
-        virtual void evaluate(ErrorString*, const String& in_expression, const String* in_objectGroup, const bool* in_includeCommandLineAPI, const bool* in_doNotPauseOnExceptionsAndMuteConsole, const int* in_contextId, const bool* in_returnByValue, const bool* in_generatePreview, RefPtr<TypeBuilder::Runtime::RemoteObject>& out_result, TypeBuilder::OptOutput<bool>* opt_out_wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>& opt_out_exceptionDetails) = 0;
-        virtual void callFunctionOn(ErrorString*, const String& in_objectId, const String& in_functionDeclaration, const RefPtr<JSONArray>* in_arguments, const bool* in_doNotPauseOnExceptionsAndMuteConsole, const bool* in_returnByValue, const bool* in_generatePreview, RefPtr<TypeBuilder::Runtime::RemoteObject>& out_result, TypeBuilder::OptOutput<bool>* opt_out_wasThrown) = 0;
-        virtual void getProperties(ErrorString*, const String& in_objectId, const bool* in_ownProperties, const bool* in_accessorPropertiesOnly, const bool* in_generatePreview, RefPtr<TypeBuilder::Array<TypeBuilder::Runtime::PropertyDescriptor> >& out_result, RefPtr<TypeBuilder::Array<TypeBuilder::Runtime::InternalPropertyDescriptor> >& opt_out_internalProperties, RefPtr<TypeBuilder::Debugger::ExceptionDetails>& opt_out_exceptionDetails) = 0;
+        virtual void evaluate(ErrorString*, const String& in_expression, const String* in_objectGroup, const bool* in_includeCommandLineAPI, const bool* in_doNotPauseOnExceptionsAndMuteConsole, const int* in_contextId, const bool* in_returnByValue, const bool* in_generatePreview, RefPtr<JSONValue>& out_result, TypeBuilder::OptOutput<bool>* opt_out_wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>& opt_out_exceptionDetails) = 0;
+        virtual void callFunctionOn(ErrorString*, const String& in_objectId, const String& in_functionDeclaration, const RefPtr<JSONArray>* in_arguments, const bool* in_doNotPauseOnExceptionsAndMuteConsole, const bool* in_returnByValue, const bool* in_generatePreview, RefPtr<JSONValue>& out_result, TypeBuilder::OptOutput<bool>* opt_out_wasThrown) = 0;
+        virtual void getProperties(ErrorString*, const String& in_objectId, const bool* in_ownProperties, const bool* in_accessorPropertiesOnly, const bool* in_generatePreview, const int* in_fromIndex, const int* in_toIndex, const bool* in_nonIndexedPropertiesOnly, const int* in_maxProperties, const String* in_continuationToken, RefPtr<JSONValue>& out_result, RefPtr<TypeBuilder::Array<TypeBuilder::Runtime::InternalPropertyDescriptor> >& opt_out_internalProperties, RefPtr<TypeBuilder::Debugger::ExceptionDetails>& opt_out_exceptionDetails, TypeBuilder::OptOutput<String>* opt_out_continuationToken) = 0;
         virtual void releaseObject(ErrorString*, const String& in_objectId) = 0;
         virtual void releaseObjectGroup(ErrorString*, const String& in_objectGroup) = 0;
         virtual void run(ErrorString*) = 0;
@@ -421,7 +424,7 @@ public:
         virtual void getGeneratorObjectDetails(ErrorString*, const String& in_objectId, RefPtr<TypeBuilder::Debugger::GeneratorObjectDetails>& out_details) = 0;
         virtual void getCollectionEntries(ErrorString*, const String& in_objectId, RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::CollectionEntry> >& out_entries) = 0;
         virtual void setPauseOnExceptions(ErrorString*, const String& in_state) = 0;
-        virtual void evaluateOnCallFrame(ErrorString*, const String& in_callFrameId, const String& in_expression, const String* in_objectGroup, const bool* in_includeCommandLineAPI, const bool* in_doNotPauseOnExceptionsAndMuteConsole, const bool* in_returnByValue, const bool* in_generatePreview, RefPtr<TypeBuilder::Runtime::RemoteObject>& out_result, TypeBuilder::OptOutput<bool>* opt_out_wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>& opt_out_exceptionDetails) = 0;
+        virtual void evaluateOnCallFrame(ErrorString*, const String& in_callFrameId, const String& in_expression, const String* in_objectGroup, const bool* in_includeCommandLineAPI, const bool* in_doNotPauseOnExceptionsAndMuteConsole, const bool* in_returnByValue, const bool* in_generatePreview, RefPtr<JSONValue>& out_result, TypeBuilder::OptOutput<bool>* opt_out_wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>& opt_out_exceptionDetails) = 0;
         virtual void compileScript(ErrorString*, const String& in_expression, const String& in_sourceURL, bool in_persistScript, const int* in_executionContextId, TypeBuilder::OptOutput<TypeBuilder::Debugger::ScriptId>* opt_out_scriptId, RefPtr<TypeBuilder::Debugger::ExceptionDetails>& opt_out_exceptionDetails) = 0;
         virtual void runScript(ErrorString*, const String& in_scriptId, const int* in_executionContextId, const String* in_objectGroup, const bool* in_doNotPauseOnExceptionsAndMuteConsole, RefPtr<TypeBuilder::Runtime::RemoteObject>& out_result, RefPtr<TypeBuilder::Debugger::ExceptionDetails>& opt_out_exceptionDetails) = 0;
         virtual void setVariableValue(ErrorString*, int in_scopeNumber, const String& in_variableName, const RefPtr<JSONObject>& in_newValue, const String* in_callFrameId, const String* in_functionObjectId) = 0;
@@ -429,12 +432,16 @@ public:
         virtual void getBacktrace(ErrorString*, RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::CallFrame> >& out_callFrames, RefPtr<TypeBuilder::Debugger::StackTrace>& opt_out_asyncStackTrace) = 0;
         virtual void skipStackFrames(ErrorString*, const String* in_script, const bool* in_skipContentScripts) = 0;
         virtual void setAsyncCallStackDepth(ErrorString*, int in_maxDepth) = 0;
-        virtual void enablePromiseTracker(ErrorString*, const bool* in_captureStacks) = 0;
+        virtual void enablePromiseTracker(ErrorString*, const bool* in_captureStacks, const bool* in_census) = 0;
         virtual void disablePromiseTracker(ErrorString*) = 0;
         virtual void getPromiseById(ErrorString*, int in_promiseId, const String* in_objectGroup, RefPtr<TypeBuilder::Runtime::RemoteObject>& out_promise) = 0;
+        virtual void getPromiseCensus(ErrorString*, RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::PromiseCreationSite> >& out_sites) = 0;
+        virtual void getLongPendingPromises(ErrorString*, double in_minimumAge, const int* in_maxCount, RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::PromiseDetails> >& out_promises) = 0;
         virtual void flushAsyncOperationEvents(ErrorString*) = 0;
         virtual void setAsyncOperationBreakpoint(ErrorString*, int in_operationId) = 0;
         virtual void removeAsyncOperationBreakpoint(ErrorString*, int in_operationId) = 0;
+        virtual void searchInAllScripts(ErrorString*, const String& in_query, const bool* in_caseSensitive, const bool* in_isRegex, const String* in_urlPattern, String* out_searchId) = 0;
+        virtual void cancelSearch(ErrorString*, const String& in_searchId) = 0;
 
     protected:
         virtual ~DebuggerCommandHandler() { }
@@ -628,8 +635,9 @@ public:
         LastEntry,
     };
 
-    void reportProtocolError(int callId, CommonErrorCode, const String& errorMessage) const;
-    virtual void reportProtocolError(int callId, CommonErrorCode, const String& errorMessage, PassRefPtr<JSONValue> data) const = 0;
+    void reportProtocolError(int callId, CommonErrorCode, const String& errorMessage);
+    virtual void reportProtocolError(int callId, CommonErrorCode, const String& errorMessage, PassRefPtr<JSONValue> data) = 0;
+    // |message| is either a command or an array of commands.
     virtual void dispatch(const String& message) = 0;
     static bool getCommandName(const String& message, String* result);
 
@@ -637,6 +645,9 @@ public:
         kInspector_enableCmd,
         kInspector_disableCmd,
         kMemory_getDOMCountersCmd,
+        kMemory_startTrackingGCCmd,
+        kMemory_stopTrackingGCCmd,
+        kMemory_getGCStatisticsCmd,
         kPage_enableCmd,
         kPage_disableCmd,
         kPage_addScriptToEvaluateOnLoadCmd,
@@ -812,9 +823,13 @@ public:
         kDebugger_enablePromiseTrackerCmd,
         kDebugger_disablePromiseTrackerCmd,
         kDebugger_getPromiseByIdCmd,
+        kDebugger_getPromiseCensusCmd,
+        kDebugger_getLongPendingPromisesCmd,
         kDebugger_flushAsyncOperationEventsCmd,
         kDebugger_setAsyncOperationBreakpointCmd,
         kDebugger_removeAsyncOperationBreakpointCmd,
+        kDebugger_searchInAllScriptsCmd,
+        kDebugger_cancelSearchCmd,
         kDOMDebugger_setDOMBreakpointCmd,
         kDOMDebugger_removeDOMBreakpointCmd,
         kDOMDebugger_setEventListenerBreakpointCmd,
@@ -870,10 +885,30 @@ public:
     };
 
     static const char* commandName(MethodNames);
+    // Looks the command up in a perfect hash built by the generator, so
+    // dispatching neither allocates nor probes a table. Returns false for
+    // unknown commands.
+    static bool findCommand(const String& name, MethodNames*);
+
+    // Told about every message the dispatcher parses and every command it
+    // runs, so that an embedder can measure them.
+    class Observer {
+    public:
+        virtual ~Observer() { }
+        virtual void willParseMessage(const String& message) = 0;
+        virtual void didParseMessage() = 0;
+        virtual void willDispatchCommand(MethodNames, int callId) = 0;
+        virtual void didDispatchCommand(MethodNames, int callId) = 0;
+    };
+    virtual void setObserver(Observer*) = 0;
 
 private:
     static const char commandNames[];
     static const unsigned short commandNamesIndex[];
+    // Indexed by the hash of a command name from the default seed.
+    static const unsigned short methodNameHashSeeds[];
+    // Indexed by the hash of a command name from its seed.
+    static const unsigned short methodNameHashSlots[];
 };
 
 } // namespace blink
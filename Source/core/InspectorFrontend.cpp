@@ -75,6 +75,17 @@ void InspectorFrontend::Inspector::inspect(PassRefPtr<TypeBuilder::Runtime::Remo
         m_inspectorFrontendChannel->sendProtocolNotification(jsonMessage.release());
 }
 
+void InspectorFrontend::Memory::garbageCollected(PassRefPtr<TypeBuilder::Memory::GCEvent> event)
+{
+    RefPtr<JSONObject> jsonMessage = JSONObject::create();
+    jsonMessage->setString("method", "Memory.garbageCollected");
+    RefPtr<JSONObject> paramsObject = JSONObject::create();
+    paramsObject->setValue("event", event);
+    jsonMessage->setObject("params", paramsObject);
+    if (m_inspectorFrontendChannel)
+        m_inspectorFrontendChannel->sendProtocolNotification(jsonMessage.release());
+}
+
 void InspectorFrontend::Page::domContentEventFired(double timestamp)
 {
     RefPtr<JSONObject> jsonMessage = JSONObject::create();
@@ -891,6 +902,17 @@ void InspectorFrontend::Debugger::promiseUpdated(EventType::Enum eventType, Pass
         m_inspectorFrontendChannel->sendProtocolNotification(jsonMessage.release());
 }
 
+void InspectorFrontend::Debugger::promiseCensusUpdated(PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::PromiseCreationSite> > sites)
+{
+    RefPtr<JSONObject> jsonMessage = JSONObject::create();
+    jsonMessage->setString("method", "Debugger.promiseCensusUpdated");
+    RefPtr<JSONObject> paramsObject = JSONObject::create();
+    paramsObject->setValue("sites", sites);
+    jsonMessage->setObject("params", paramsObject);
+    if (m_inspectorFrontendChannel)
+        m_inspectorFrontendChannel->sendProtocolNotification(jsonMessage.release());
+}
+
 void InspectorFrontend::Debugger::asyncOperationStarted(PassRefPtr<TypeBuilder::Debugger::AsyncOperation> operation)
 {
     RefPtr<JSONObject> jsonMessage = JSONObject::create();
@@ -913,6 +935,30 @@ void InspectorFrontend::Debugger::asyncOperationCompleted(int id)
         m_inspectorFrontendChannel->sendProtocolNotification(jsonMessage.release());
 }
 
+void InspectorFrontend::Debugger::searchResultsFound(const String& searchId, PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::ScriptSearchResult> > results)
+{
+    RefPtr<JSONObject> jsonMessage = JSONObject::create();
+    jsonMessage->setString("method", "Debugger.searchResultsFound");
+    RefPtr<JSONObject> paramsObject = JSONObject::create();
+    paramsObject->setString("searchId", searchId);
+    paramsObject->setValue("results", results);
+    jsonMessage->setObject("params", paramsObject);
+    if (m_inspectorFrontendChannel)
+        m_inspectorFrontendChannel->sendProtocolNotification(jsonMessage.release());
+}
+
+void InspectorFrontend::Debugger::searchFinished(const String& searchId, bool cancelled)
+{
+    RefPtr<JSONObject> jsonMessage = JSONObject::create();
+    jsonMessage->setString("method", "Debugger.searchFinished");
+    RefPtr<JSONObject> paramsObject = JSONObject::create();
+    paramsObject->setString("searchId", searchId);
+    paramsObject->setBoolean("cancelled", cancelled);
+    jsonMessage->setObject("params", paramsObject);
+    if (m_inspectorFrontendChannel)
+        m_inspectorFrontendChannel->sendProtocolNotification(jsonMessage.release());
+}
+
 void InspectorFrontend::Profiler::consoleProfileStarted(const String& id, PassRefPtr<TypeBuilder::Debugger::Location> location, const String* const title)
 {
     RefPtr<JSONObject> jsonMessage = JSONObject::create();
@@ -38,6 +38,7 @@ public:
     public:
         static Memory* from(InspectorFrontend* frontend) { return &(frontend->m_memory) ;}
         Memory(InspectorFrontendChannel* inspectorFrontendChannel) : m_inspectorFrontendChannel(inspectorFrontendChannel) { }
+        void garbageCollected(PassRefPtr<TypeBuilder::Memory::GCEvent> event);
 
         void flush() { m_inspectorFrontendChannel->flush(); }
     private:
@@ -290,8 +291,11 @@ public:
         }; // struct EventType
 
         void promiseUpdated(EventType::Enum eventType, PassRefPtr<TypeBuilder::Debugger::PromiseDetails> promise);
+        void promiseCensusUpdated(PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::PromiseCreationSite> > sites);
         void asyncOperationStarted(PassRefPtr<TypeBuilder::Debugger::AsyncOperation> operation);
         void asyncOperationCompleted(int id);
+        void searchResultsFound(const String& searchId, PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::ScriptSearchResult> > results);
+        void searchFinished(const String& searchId, bool cancelled);
 
         void flush() { m_inspectorFrontendChannel->flush(); }
     private:
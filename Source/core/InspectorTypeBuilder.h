@@ -410,6 +410,402 @@ typedef String AXNodeId;
 
 CORE_EXPORT String getEnumConstantValue(int code);
 
+namespace Memory {
+/* Time spent in one phase of a garbage collection. */
+class GCScope : public JSONObjectBase {
+public:
+    enum {
+        NoFieldsSet = 0,
+        NameSet = 1 << 0,
+        DurationSet = 1 << 1,
+        AllFieldsSet = (NameSet | DurationSet)
+    };
+
+    template<int STATE>
+    class Builder {
+    private:
+        RefPtr<JSONObject> m_result;
+
+        template<int STEP> Builder<STATE | STEP>& castState()
+        {
+            return *reinterpret_cast<Builder<STATE | STEP>*>(this);
+        }
+
+        Builder(PassRefPtr</*GCScope*/JSONObject> ptr)
+        {
+            static_assert(STATE == NoFieldsSet, "builder should not be created in non-init state");
+            m_result = ptr;
+        }
+        friend class GCScope;
+    public:
+
+        Builder<STATE | NameSet>& setName(const String& value)
+        {
+            static_assert(!(STATE & NameSet), "property name should not be set yet");
+            m_result->setString("name", value);
+            return castState<NameSet>();
+        }
+
+        Builder<STATE | DurationSet>& setDuration(double value)
+        {
+            static_assert(!(STATE & DurationSet), "property duration should not be set yet");
+            m_result->setNumber("duration", value);
+            return castState<DurationSet>();
+        }
+
+        operator RefPtr<GCScope>& ()
+        {
+            static_assert(STATE == AllFieldsSet, "state should be AllFieldsSet");
+            static_assert(sizeof(GCScope) == sizeof(JSONObject), "GCScope should be the same size as JSONObject");
+            return *reinterpret_cast<RefPtr<GCScope>*>(&m_result);
+        }
+
+        PassRefPtr<GCScope> release()
+        {
+            return RefPtr<GCScope>(*this).release();
+        }
+    };
+
+    /*
+     * Synthetic constructor:
+     * RefPtr<GCScope> result = GCScope::create()
+     *     .setName(...)
+     *     .setDuration(...);
+     */
+    static Builder<NoFieldsSet> create()
+    {
+        return Builder<NoFieldsSet>(JSONObject::create());
+    }
+    typedef TypeBuilder::StructItemTraits ItemTraits;
+
+    void name(String* value)
+    {
+        JSONObjectBase::getString("name", value);
+    }
+
+    void duration(double* value)
+    {
+        JSONObjectBase::getNumber("duration", value);
+    }
+};
+
+/* Statistics of a completed garbage collection. */
+class GCEvent : public JSONObjectBase {
+public:
+    enum {
+        NoFieldsSet = 0,
+        IdSet = 1 << 0,
+        TypeSet = 1 << 1,
+        StartTimeSet = 1 << 2,
+        PauseTimeSet = 1 << 3,
+        PromotedBytesSet = 1 << 4,
+        SurvivedBytesSet = 1 << 5,
+        HeapSizeBeforeSet = 1 << 6,
+        HeapSizeAfterSet = 1 << 7,
+        ScopesSet = 1 << 8,
+        AllFieldsSet = (IdSet | TypeSet | StartTimeSet | PauseTimeSet | PromotedBytesSet | SurvivedBytesSet | HeapSizeBeforeSet | HeapSizeAfterSet | ScopesSet)
+    };
+
+    template<int STATE>
+    class Builder {
+    private:
+        RefPtr<JSONObject> m_result;
+
+        template<int STEP> Builder<STATE | STEP>& castState()
+        {
+            return *reinterpret_cast<Builder<STATE | STEP>*>(this);
+        }
+
+        Builder(PassRefPtr</*GCEvent*/JSONObject> ptr)
+        {
+            static_assert(STATE == NoFieldsSet, "builder should not be created in non-init state");
+            m_result = ptr;
+        }
+        friend class GCEvent;
+    public:
+
+        Builder<STATE | IdSet>& setId(int value)
+        {
+            static_assert(!(STATE & IdSet), "property id should not be set yet");
+            m_result->setNumber("id", value);
+            return castState<IdSet>();
+        }
+
+        Builder<STATE | TypeSet>& setType(const String& value)
+        {
+            static_assert(!(STATE & TypeSet), "property type should not be set yet");
+            m_result->setString("type", value);
+            return castState<TypeSet>();
+        }
+
+        Builder<STATE | StartTimeSet>& setStartTime(double value)
+        {
+            static_assert(!(STATE & StartTimeSet), "property startTime should not be set yet");
+            m_result->setNumber("startTime", value);
+            return castState<StartTimeSet>();
+        }
+
+        Builder<STATE | PauseTimeSet>& setPauseTime(double value)
+        {
+            static_assert(!(STATE & PauseTimeSet), "property pauseTime should not be set yet");
+            m_result->setNumber("pauseTime", value);
+            return castState<PauseTimeSet>();
+        }
+
+        Builder<STATE | PromotedBytesSet>& setPromotedBytes(double value)
+        {
+            static_assert(!(STATE & PromotedBytesSet), "property promotedBytes should not be set yet");
+            m_result->setNumber("promotedBytes", value);
+            return castState<PromotedBytesSet>();
+        }
+
+        Builder<STATE | SurvivedBytesSet>& setSurvivedBytes(double value)
+        {
+            static_assert(!(STATE & SurvivedBytesSet), "property survivedBytes should not be set yet");
+            m_result->setNumber("survivedBytes", value);
+            return castState<SurvivedBytesSet>();
+        }
+
+        Builder<STATE | HeapSizeBeforeSet>& setHeapSizeBefore(double value)
+        {
+            static_assert(!(STATE & HeapSizeBeforeSet), "property heapSizeBefore should not be set yet");
+            m_result->setNumber("heapSizeBefore", value);
+            return castState<HeapSizeBeforeSet>();
+        }
+
+        Builder<STATE | HeapSizeAfterSet>& setHeapSizeAfter(double value)
+        {
+            static_assert(!(STATE & HeapSizeAfterSet), "property heapSizeAfter should not be set yet");
+            m_result->setNumber("heapSizeAfter", value);
+            return castState<HeapSizeAfterSet>();
+        }
+
+        Builder<STATE | ScopesSet>& setScopes(PassRefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCScope> > value)
+        {
+            static_assert(!(STATE & ScopesSet), "property scopes should not be set yet");
+            m_result->setValue("scopes", value);
+            return castState<ScopesSet>();
+        }
+
+        operator RefPtr<GCEvent>& ()
+        {
+            static_assert(STATE == AllFieldsSet, "state should be AllFieldsSet");
+            static_assert(sizeof(GCEvent) == sizeof(JSONObject), "GCEvent should be the same size as JSONObject");
+            return *reinterpret_cast<RefPtr<GCEvent>*>(&m_result);
+        }
+
+        PassRefPtr<GCEvent> release()
+        {
+            return RefPtr<GCEvent>(*this).release();
+        }
+    };
+
+    /*
+     * Synthetic constructor:
+     * RefPtr<GCEvent> result = GCEvent::create()
+     *     .setId(...)
+     *     .setType(...)
+     *     .setStartTime(...)
+     *     .setPauseTime(...)
+     *     .setPromotedBytes(...)
+     *     .setSurvivedBytes(...)
+     *     .setHeapSizeBefore(...)
+     *     .setHeapSizeAfter(...)
+     *     .setScopes(...);
+     */
+    static Builder<NoFieldsSet> create()
+    {
+        return Builder<NoFieldsSet>(JSONObject::create());
+    }
+    typedef TypeBuilder::StructItemTraits ItemTraits;
+
+    void id(int* value)
+    {
+        JSONObjectBase::getNumber("id", value);
+    }
+
+    void type(String* value)
+    {
+        JSONObjectBase::getString("type", value);
+    }
+
+    void startTime(double* value)
+    {
+        JSONObjectBase::getNumber("startTime", value);
+    }
+
+    void pauseTime(double* value)
+    {
+        JSONObjectBase::getNumber("pauseTime", value);
+    }
+
+    void promotedBytes(double* value)
+    {
+        JSONObjectBase::getNumber("promotedBytes", value);
+    }
+
+    void survivedBytes(double* value)
+    {
+        JSONObjectBase::getNumber("survivedBytes", value);
+    }
+
+    void heapSizeBefore(double* value)
+    {
+        JSONObjectBase::getNumber("heapSizeBefore", value);
+    }
+
+    void heapSizeAfter(double* value)
+    {
+        JSONObjectBase::getNumber("heapSizeAfter", value);
+    }
+
+    void setReason(const String& value)
+    {
+        this->setString("reason", value);
+    }
+
+    void setIncremental(bool value)
+    {
+        this->setBoolean("incremental", value);
+    }
+};
+
+/* Pause time distribution of the garbage collections of one type retained in the history. */
+class GCPauseSummary : public JSONObjectBase {
+public:
+    enum {
+        NoFieldsSet = 0,
+        TypeSet = 1 << 0,
+        CountSet = 1 << 1,
+        TotalPauseTimeSet = 1 << 2,
+        MedianPauseTimeSet = 1 << 3,
+        P99PauseTimeSet = 1 << 4,
+        MaxPauseTimeSet = 1 << 5,
+        AllFieldsSet = (TypeSet | CountSet | TotalPauseTimeSet | MedianPauseTimeSet | P99PauseTimeSet | MaxPauseTimeSet)
+    };
+
+    template<int STATE>
+    class Builder {
+    private:
+        RefPtr<JSONObject> m_result;
+
+        template<int STEP> Builder<STATE | STEP>& castState()
+        {
+            return *reinterpret_cast<Builder<STATE | STEP>*>(this);
+        }
+
+        Builder(PassRefPtr</*GCPauseSummary*/JSONObject> ptr)
+        {
+            static_assert(STATE == NoFieldsSet, "builder should not be created in non-init state");
+            m_result = ptr;
+        }
+        friend class GCPauseSummary;
+    public:
+
+        Builder<STATE | TypeSet>& setType(const String& value)
+        {
+            static_assert(!(STATE & TypeSet), "property type should not be set yet");
+            m_result->setString("type", value);
+            return castState<TypeSet>();
+        }
+
+        Builder<STATE | CountSet>& setCount(int value)
+        {
+            static_assert(!(STATE & CountSet), "property count should not be set yet");
+            m_result->setNumber("count", value);
+            return castState<CountSet>();
+        }
+
+        Builder<STATE | TotalPauseTimeSet>& setTotalPauseTime(double value)
+        {
+            static_assert(!(STATE & TotalPauseTimeSet), "property totalPauseTime should not be set yet");
+            m_result->setNumber("totalPauseTime", value);
+            return castState<TotalPauseTimeSet>();
+        }
+
+        Builder<STATE | MedianPauseTimeSet>& setMedianPauseTime(double value)
+        {
+            static_assert(!(STATE & MedianPauseTimeSet), "property medianPauseTime should not be set yet");
+            m_result->setNumber("medianPauseTime", value);
+            return castState<MedianPauseTimeSet>();
+        }
+
+        Builder<STATE | P99PauseTimeSet>& setP99PauseTime(double value)
+        {
+            static_assert(!(STATE & P99PauseTimeSet), "property p99PauseTime should not be set yet");
+            m_result->setNumber("p99PauseTime", value);
+            return castState<P99PauseTimeSet>();
+        }
+
+        Builder<STATE | MaxPauseTimeSet>& setMaxPauseTime(double value)
+        {
+            static_assert(!(STATE & MaxPauseTimeSet), "property maxPauseTime should not be set yet");
+            m_result->setNumber("maxPauseTime", value);
+            return castState<MaxPauseTimeSet>();
+        }
+
+        operator RefPtr<GCPauseSummary>& ()
+        {
+            static_assert(STATE == AllFieldsSet, "state should be AllFieldsSet");
+            static_assert(sizeof(GCPauseSummary) == sizeof(JSONObject), "GCPauseSummary should be the same size as JSONObject");
+            return *reinterpret_cast<RefPtr<GCPauseSummary>*>(&m_result);
+        }
+
+        PassRefPtr<GCPauseSummary> release()
+        {
+            return RefPtr<GCPauseSummary>(*this).release();
+        }
+    };
+
+    /*
+     * Synthetic constructor:
+     * RefPtr<GCPauseSummary> result = GCPauseSummary::create()
+     *     .setType(...)
+     *     .setCount(...)
+     *     .setTotalPauseTime(...)
+     *     .setMedianPauseTime(...)
+     *     .setP99PauseTime(...)
+     *     .setMaxPauseTime(...);
+     */
+    static Builder<NoFieldsSet> create()
+    {
+        return Builder<NoFieldsSet>(JSONObject::create());
+    }
+    typedef TypeBuilder::StructItemTraits ItemTraits;
+
+    void type(String* value)
+    {
+        JSONObjectBase::getString("type", value);
+    }
+
+    void count(int* value)
+    {
+        JSONObjectBase::getNumber("count", value);
+    }
+
+    void totalPauseTime(double* value)
+    {
+        JSONObjectBase::getNumber("totalPauseTime", value);
+    }
+
+    void medianPauseTime(double* value)
+    {
+        JSONObjectBase::getNumber("medianPauseTime", value);
+    }
+
+    void p99PauseTime(double* value)
+    {
+        JSONObjectBase::getNumber("p99PauseTime", value);
+    }
+
+    void maxPauseTime(double* value)
+    {
+        JSONObjectBase::getNumber("maxPauseTime", value);
+    }
+};
+
+} // Memory
+
 namespace Page {
 /* Resource type as it was perceived by the rendering engine. */
 struct ResourceType {
@@ -8714,6 +9110,122 @@ public:
     }
 };
 
+/* Promise counts for one creation site, collected by the promise tracker in census mode. */
+class PromiseCreationSite : public JSONObjectBase {
+public:
+    enum {
+        NoFieldsSet = 0,
+        PendingSet = 1 << 0,
+        ResolvedSet = 1 << 1,
+        RejectedSet = 1 << 2,
+        CollectedSet = 1 << 3,
+        AllFieldsSet = (PendingSet | ResolvedSet | RejectedSet | CollectedSet)
+    };
+
+    template<int STATE>
+    class Builder {
+    private:
+        RefPtr<JSONObject> m_result;
+
+        template<int STEP> Builder<STATE | STEP>& castState()
+        {
+            return *reinterpret_cast<Builder<STATE | STEP>*>(this);
+        }
+
+        Builder(PassRefPtr</*PromiseCreationSite*/JSONObject> ptr)
+        {
+            static_assert(STATE == NoFieldsSet, "builder should not be created in non-init state");
+            m_result = ptr;
+        }
+        friend class PromiseCreationSite;
+    public:
+
+        Builder<STATE | PendingSet>& setPending(int value)
+        {
+            static_assert(!(STATE & PendingSet), "property pending should not be set yet");
+            m_result->setNumber("pending", value);
+            return castState<PendingSet>();
+        }
+
+        Builder<STATE | ResolvedSet>& setResolved(int value)
+        {
+            static_assert(!(STATE & ResolvedSet), "property resolved should not be set yet");
+            m_result->setNumber("resolved", value);
+            return castState<ResolvedSet>();
+        }
+
+        Builder<STATE | RejectedSet>& setRejected(int value)
+        {
+            static_assert(!(STATE & RejectedSet), "property rejected should not be set yet");
+            m_result->setNumber("rejected", value);
+            return castState<RejectedSet>();
+        }
+
+        Builder<STATE | CollectedSet>& setCollected(int value)
+        {
+            static_assert(!(STATE & CollectedSet), "property collected should not be set yet");
+            m_result->setNumber("collected", value);
+            return castState<CollectedSet>();
+        }
+
+        operator RefPtr<PromiseCreationSite>& ()
+        {
+            static_assert(STATE == AllFieldsSet, "state should be AllFieldsSet");
+            static_assert(sizeof(PromiseCreationSite) == sizeof(JSONObject), "PromiseCreationSite should be the same size as JSONObject");
+            return *reinterpret_cast<RefPtr<PromiseCreationSite>*>(&m_result);
+        }
+
+        PassRefPtr<PromiseCreationSite> release()
+        {
+            return RefPtr<PromiseCreationSite>(*this).release();
+        }
+    };
+
+    /*
+     * Synthetic constructor:
+     * RefPtr<PromiseCreationSite> result = PromiseCreationSite::create()
+     *     .setPending(...)
+     *     .setResolved(...)
+     *     .setRejected(...)
+     *     .setCollected(...);
+     */
+    static Builder<NoFieldsSet> create()
+    {
+        return Builder<NoFieldsSet>(JSONObject::create());
+    }
+    typedef TypeBuilder::StructItemTraits ItemTraits;
+
+    void pending(int* value)
+    {
+        JSONObjectBase::getNumber("pending", value);
+    }
+
+    void resolved(int* value)
+    {
+        JSONObjectBase::getNumber("resolved", value);
+    }
+
+    void rejected(int* value)
+    {
+        JSONObjectBase::getNumber("rejected", value);
+    }
+
+    void collected(int* value)
+    {
+        JSONObjectBase::getNumber("collected", value);
+    }
+
+    void setCallFrame(PassRefPtr<TypeBuilder::Console::CallFrame> value)
+    {
+        this->setValue("callFrame", value);
+    }
+
+    void setCreationStack(PassRefPtr<TypeBuilder::Array<TypeBuilder::Console::CallFrame> > value)
+    {
+        this->setValue("creationStack", value);
+    }
+};
+
 /* Information about the async operation. */
 class AsyncOperation : public JSONObjectBase {
 public:
@@ -8880,6 +9392,93 @@ public:
     }
 };
 
+/* Matches found in one script by searchInAllScripts. */
+class ScriptSearchResult : public JSONObjectBase {
+public:
+    enum {
+        NoFieldsSet = 0,
+        ScriptIdSet = 1 << 0,
+        UrlSet = 1 << 1,
+        MatchesSet = 1 << 2,
+        AllFieldsSet = (ScriptIdSet | UrlSet | MatchesSet)
+    };
+
+    template<int STATE>
+    class Builder {
+    private:
+        RefPtr<JSONObject> m_result;
+
+        template<int STEP> Builder<STATE | STEP>& castState()
+        {
+            return *reinterpret_cast<Builder<STATE | STEP>*>(this);
+        }
+
+        Builder(PassRefPtr</*ScriptSearchResult*/JSONObject> ptr)
+        {
+            static_assert(STATE == NoFieldsSet, "builder should not be created in non-init state");
+            m_result = ptr;
+        }
+        friend class ScriptSearchResult;
+    public:
+
+        Builder<STATE | ScriptIdSet>& setScriptId(const String& value)
+        {
+            static_assert(!(STATE & ScriptIdSet), "property scriptId should not be set yet");
+            m_result->setString("scriptId", value);
+            return castState<ScriptIdSet>();
+        }
+
+        Builder<STATE | UrlSet>& setUrl(const String& value)
+        {
+            static_assert(!(STATE & UrlSet), "property url should not be set yet");
+            m_result->setString("url", value);
+            return castState<UrlSet>();
+        }
+
+        Builder<STATE | MatchesSet>& setMatches(PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::SearchMatch> > value)
+        {
+            static_assert(!(STATE & MatchesSet), "property matches should not be set yet");
+            m_result->setValue("matches", value);
+            return castState<MatchesSet>();
+        }
+
+        operator RefPtr<ScriptSearchResult>& ()
+        {
+            static_assert(STATE == AllFieldsSet, "state should be AllFieldsSet");
+            static_assert(sizeof(ScriptSearchResult) == sizeof(JSONObject), "ScriptSearchResult should be the same size as JSONObject");
+            return *reinterpret_cast<RefPtr<ScriptSearchResult>*>(&m_result);
+        }
+
+        PassRefPtr<ScriptSearchResult> release()
+        {
+            return RefPtr<ScriptSearchResult>(*this).release();
+        }
+    };
+
+    /*
+     * Synthetic constructor:
+     * RefPtr<ScriptSearchResult> result = ScriptSearchResult::create()
+     *     .setScriptId(...)
+     *     .setUrl(...)
+     *     .setMatches(...);
+     */
+    static Builder<NoFieldsSet> create()
+    {
+        return Builder<NoFieldsSet>(JSONObject::create());
+    }
+    typedef TypeBuilder::StructItemTraits ItemTraits;
+
+    void scriptId(String* value)
+    {
+        JSONObjectBase::getString("scriptId", value);
+    }
+
+    void url(String* value)
+    {
+        JSONObjectBase::getString("url", value);
+    }
+};
+
 } // Debugger
 
 namespace DOMDebugger {
@@ -89,6 +89,8 @@
         'inspector/InspectorDebuggerAgent.cpp',
         'inspector/InspectorDebuggerAgent.h',
         'inspector/InspectorFrontendChannel.h',
+        'inspector/InspectorMemoryAgent.cpp',
+        'inspector/InspectorMemoryAgent.h',
         'inspector/InspectorRuntimeAgent.cpp',
         'inspector/InspectorRuntimeAgent.h',
         'inspector/InspectorState.cpp',
@@ -98,6 +100,8 @@
         'inspector/JSONParser.h',
         'inspector/JavaScriptCallFrame.cpp',
         'inspector/JavaScriptCallFrame.h',
+        'inspector/ObjectPreviewBuilder.cpp',
+        'inspector/ObjectPreviewBuilder.h',
         'inspector/PromiseTracker.cpp',
         'inspector/PromiseTracker.h',
         'inspector/ScriptArguments.cpp',
@@ -106,12 +110,16 @@
         'inspector/ScriptAsyncCallStack.h',
         'inspector/ScriptCallFrame.cpp',
         'inspector/ScriptCallFrame.h',
+        'inspector/ScriptCallFrameTable.cpp',
+        'inspector/ScriptCallFrameTable.h',
         'inspector/ScriptCallStack.cpp',
         'inspector/ScriptCallStack.h',
         'inspector/ScriptDebuggerBase.cpp',
         'inspector/ScriptDebuggerBase.h',
         'inspector/ScriptDebugListener.cpp',
         'inspector/ScriptDebugListener.h',
+        'inspector/ScriptSearchJob.cpp',
+        'inspector/ScriptSearchJob.h',
         'inspector/V8AsyncCallTracker.cpp',
         'inspector/V8AsyncCallTracker.h',
         'inspector/WorkerDebuggerAgent.cpp',
@@ -134,6 +142,8 @@
 
         '../bindings/core/v8/V8Debugger.cpp',
         '../bindings/core/v8/V8Debugger.h',
+        '../bindings/core/v8/V8JSONWriter.cpp',
+        '../bindings/core/v8/V8JSONWriter.h',
         '../bindings/core/v8/WorkerThreadDebugger.cpp',
         '../bindings/core/v8/WorkerThreadDebugger.h',
 
@@ -156,6 +166,7 @@
         # platform
         '../platform/JSONValues.cpp',
         '../platform/JSONValues.h',
+        '../platform/WebThread.cpp',
         '../platform/Decimal.cpp',
         '../platform/Decimal.h',
 
@@ -170,5 +181,31 @@
         '../bindings/core/v8/V8ScriptRunner.h',
       ],
     },
+    {
+      'target_name': 'webcore_v8inspector_unittests',
+      'type': 'executable',
+      'dependencies': [
+        'webcore_v8inspector',
+        '../chrome/testing/gtest.gyp:gtest',
+        '../chrome/v8/tools/gyp/v8.gyp:v8_libplatform',
+      ],
+      'include_dirs': [
+        '<@(webcore_include_dirs)',
+        '../chrome/v8', # for include/libplatform/libplatform.h
+      ],
+      'sources': [
+        'inspector/ContentSearchUtilsTest.cpp',
+        'inspector/InjectedScriptTest.cpp',
+        'inspector/InspectorBackendDispatcherTest.cpp',
+        'inspector/InspectorMemoryAgentTest.cpp',
+        'inspector/PromiseTrackerTest.cpp',
+        'inspector/ScriptCallFrameTableTest.cpp',
+        'inspector/ScriptSearchJobTest.cpp',
+        'testing/RunAllTests.cpp',
+
+        '../bindings/core/v8/ScriptRegexpTest.cpp',
+        '../bindings/core/v8/V8JSONWriterTest.cpp',
+      ],
+    },
   ],  # targets
 }
@@ -56,6 +56,12 @@ TYPES_WITH_OPEN_FIELD_LIST_SET = frozenset([
                                             # InspectorResourceAgent needs to update mime-type.
                                             "Network.Response"])
 
+# Command results that agents write straight from V8 as JSON text. Their
+# agent methods return a RefPtr<JSONValue> holding a JSONRawValue instead of
+# a TypeBuilder object.
+RAW_JSON_COMMAND_RETURN_SET = frozenset(["Runtime.evaluate.result", "Runtime.callFunctionOn.result", "Runtime.getProperties.result",
+                                         "Debugger.evaluateOnCallFrame.result"])
+
 cmdline_parser = optparse.OptionParser()
 cmdline_parser.add_option("--output_dir")
 
@@ -343,6 +349,39 @@ class RawTypes(object):
             return TypeModel.Array
 
 
+def method_name_hash(name, seed):
+    # FNV-1a; must match methodNameHash() in the generated dispatcher.
+    hash = seed
+    for c in name:
+        hash = ((hash ^ ord(c)) * 0x01000193) & 0xffffffff
+    return hash
+
+
+def build_method_name_hash(names):
+    # Hash and displace: the first hash of a name picks its bucket, and each
+    # bucket gets a seed that sends all of its names to free slots.
+    size = len(names)
+    buckets = [[] for i in range(size)]
+    for index, name in enumerate(names):
+        buckets[method_name_hash(name, 0x811c9dc5) % size].append(index)
+    seeds = [0] * size
+    slots = [None] * size
+    for bucket in sorted(range(size), key=lambda bucket: -len(buckets[bucket])):
+        if not buckets[bucket]:
+            continue
+        seed = 1
+        while True:
+            assert seed < 2 ** 16, "No seed found for the method name hash."
+            wanted = [method_name_hash(names[index], seed) % size for index in buckets[bucket]]
+            if len(set(wanted)) == len(wanted) and all(slots[slot] is None for slot in wanted):
+                break
+            seed += 1
+        seeds[bucket] = seed
+        for index, slot in zip(buckets[bucket], wanted):
+            slots[slot] = index
+    return seeds, slots
+
+
 def replace_right_shift(input_str):
     return input_str.replace(">>", "> >")
 
@@ -1606,6 +1645,7 @@ class Generator:
     backend_method_name_declaration_list = []
     backend_method_name_declaration_index_list = []
     backend_method_name_declaration_current_index = 0
+    backend_method_names = []
     method_handler_list = []
     frontend_method_list = []
 
@@ -1704,7 +1744,7 @@ class Generator:
         cmd_enum_name = "k%s_%sCmd" % (domain_name, json_command["name"])
 
         Generator.method_name_enum_list.append("        %s," % cmd_enum_name)
-        Generator.method_handler_list.append("            &InspectorBackendDispatcherImpl::%s_%s," % (domain_name, json_command_name))
+        Generator.method_handler_list.append("    &InspectorBackendDispatcherImpl::%s_%s," % (domain_name, json_command_name))
         Generator.backend_method_declaration_list.append("    void %s_%s(int callId, JSONObject* requestMessageObject, JSONArray* protocolErrors);" % (domain_name, json_command_name))
 
         backend_agent_interface_list = [] if "redirect" in json_command else Generator.backend_agent_interface_list
@@ -1825,6 +1865,15 @@ class Generator:
 
                     optional = bool(json_return.get("optional"))
 
+                    if "%s.%s.%s" % (domain_name, json_command_name, json_return_name) in RAW_JSON_COMMAND_RETURN_SET:
+                        assert not optional
+                        var_name = "out_%s" % json_return_name
+                        method_out_code += "    RefPtr<JSONValue> %s;\n" % var_name
+                        agent_call_param_list.append(var_name)
+                        backend_agent_interface_list.append(", RefPtr<JSONValue>& %s" % var_name)
+                        response_cook_list.append("        result->setValue(\"%s\", %s);\n" % (json_return_name, var_name))
+                        continue
+
                     return_type_binding = Generator.resolve_param_type_and_generate_ad_hoc(json_return, json_command_name, domain_name, ad_hoc_type_writer, agent_interface_name + "::")
 
                     raw_type = return_type_binding.reduce_to_raw_type()
@@ -1884,6 +1933,7 @@ class Generator:
         assert Generator.backend_method_name_declaration_current_index < 2 ** 16, "Number too large for unsigned short."
         Generator.backend_method_name_declaration_index_list.append("    %d," % Generator.backend_method_name_declaration_current_index)
         Generator.backend_method_name_declaration_current_index += len(declaration_command_name) - 1
+        Generator.backend_method_names.append("%s.%s" % (domain_name, json_command_name))
 
         backend_agent_interface_list.append(") = 0;\n")
 
@@ -2088,12 +2138,16 @@ backend_h_file.write(Templates.backend_h.substitute(None,
     agentInterfaces="".join(flatten_list(Generator.backend_agent_interface_list)),
     methodNamesEnumContent="\n".join(Generator.method_name_enum_list)))
 
+method_name_hash_seeds, method_name_hash_slots = build_method_name_hash(Generator.backend_method_names)
+
 backend_cpp_file.write(Templates.backend_cpp.substitute(None,
     constructorInit="\n".join(Generator.backend_constructor_init_list),
     setters="\n".join(Generator.backend_setters_list),
     fieldDeclarations="\n".join(Generator.backend_field_list),
     methodNameDeclarations="\n".join(Generator.backend_method_name_declaration_list),
     methodNameDeclarationsIndex="\n".join(Generator.backend_method_name_declaration_index_list),
+    methodNameHashSeeds="\n".join(["    %d," % seed for seed in method_name_hash_seeds]),
+    methodNameHashSlots="\n".join(["    %d," % slot for slot in method_name_hash_slots]),
     methods="\n".join(Generator.backend_method_implementation_list),
     methodDeclarations="\n".join(Generator.backend_method_declaration_list),
     messageHandlers="\n".join(Generator.method_handler_list)))
@@ -184,8 +184,9 @@ $virtualSetters
         LastEntry,
     };
 
-    void reportProtocolError(int callId, CommonErrorCode, const String& errorMessage) const;
-    virtual void reportProtocolError(int callId, CommonErrorCode, const String& errorMessage, PassRefPtr<JSONValue> data) const = 0;
+    void reportProtocolError(int callId, CommonErrorCode, const String& errorMessage);
+    virtual void reportProtocolError(int callId, CommonErrorCode, const String& errorMessage, PassRefPtr<JSONValue> data) = 0;
+    // |message| is either a command or an array of commands.
     virtual void dispatch(const String& message) = 0;
     static bool getCommandName(const String& message, String* result);
 
@@ -196,10 +197,30 @@ $methodNamesEnumContent
     };
 
     static const char* commandName(MethodNames);
+    // Looks the command up in a perfect hash built by the generator, so
+    // dispatching neither allocates nor probes a table. Returns false for
+    // unknown commands.
+    static bool findCommand(const String& name, MethodNames*);
+
+    // Told about every message the dispatcher parses and every command it
+    // runs, so that an embedder can measure them.
+    class Observer {
+    public:
+        virtual ~Observer() { }
+        virtual void willParseMessage(const String& message) = 0;
+        virtual void didParseMessage() = 0;
+        virtual void willDispatchCommand(MethodNames, int callId) = 0;
+        virtual void didDispatchCommand(MethodNames, int callId) = 0;
+    };
+    virtual void setObserver(Observer*) = 0;
 
 private:
     static const char commandNames[];
     static const unsigned short commandNamesIndex[];
+    // Indexed by the hash of a command name from the default seed.
+    static const unsigned short methodNameHashSeeds[];
+    // Indexed by the hash of a command name from its seed.
+    static const unsigned short methodNameHashSlots[];
 };
 
 } // namespace blink
@@ -235,19 +256,51 @@ const char* InspectorBackendDispatcher::commandName(MethodNames index) {
     return commandNames + commandNamesIndex[index];
 }
 
+const unsigned short InspectorBackendDispatcher::methodNameHashSeeds[] = {
+$methodNameHashSeeds
+};
+
+const unsigned short InspectorBackendDispatcher::methodNameHashSlots[] = {
+$methodNameHashSlots
+};
+
+// FNV-1a from |seed|, as computed by the generator. Command names are ASCII.
+static bool methodNameHash(const String& name, unsigned seed, unsigned* hash)
+{
+    for (unsigned i = 0; i < name.length(); ++i) {
+        UChar c = name[i];
+        if (c > 0x7f)
+            return false;
+        seed = (seed ^ c) * 0x01000193;
+    }
+    *hash = seed;
+    return true;
+}
+
+bool InspectorBackendDispatcher::findCommand(const String& name, MethodNames* result)
+{
+    static_assert(static_cast<int>(kMethodNamesEnumSize) == WTF_ARRAY_LENGTH(methodNameHashSeeds), "MethodNames enum should have the same number of elements as methodNameHashSeeds");
+    static_assert(static_cast<int>(kMethodNamesEnumSize) == WTF_ARRAY_LENGTH(methodNameHashSlots), "MethodNames enum should have the same number of elements as methodNameHashSlots");
+    // The first hash picks the seed of the second, which leads to the only
+    // command the name can be.
+    unsigned hash;
+    if (!methodNameHash(name, 0x811c9dc5, &hash))
+        return false;
+    methodNameHash(name, methodNameHashSeeds[hash % kMethodNamesEnumSize], &hash);
+    MethodNames candidate = static_cast<MethodNames>(methodNameHashSlots[hash % kMethodNamesEnumSize]);
+    if (name != commandName(candidate))
+        return false;
+    *result = candidate;
+    return true;
+}
+
 class InspectorBackendDispatcherImpl : public InspectorBackendDispatcher {
 public:
     InspectorBackendDispatcherImpl(InspectorFrontendChannel* inspectorFrontendChannel)
         : m_inspectorFrontendChannel(inspectorFrontendChannel)
 $constructorInit
+        , m_observer(nullptr)
     {
-        // Initialize dispatch map.
-        const CallHandler handlers[] = {
-  $messageHandlers
-        };
-        for (size_t i = 0; i < kMethodNamesEnumSize; ++i)
-            m_dispatchMap.add(commandName(static_cast<MethodNames>(i)), handlers[i]);
-
         // Initialize common errors.
         m_commonErrors.insert(ParseError, -32700);
         m_commonErrors.insert(InvalidRequest, -32600);
@@ -258,8 +311,9 @@ $constructorInit
     }
 
     virtual void clearFrontend() { m_inspectorFrontendChannel = 0; }
+    virtual void setObserver(Observer* observer) { m_observer = observer; }
     virtual void dispatch(const String& message);
-    virtual void reportProtocolError(int callId, CommonErrorCode, const String& errorMessage, PassRefPtr<JSONValue> data) const;
+    virtual void reportProtocolError(int callId, CommonErrorCode, const String& errorMessage, PassRefPtr<JSONValue> data);
     using InspectorBackendDispatcher::reportProtocolError;
 
     void sendResponse(int callId, const ErrorString& invocationError, PassRefPtr<JSONValue> errorData, PassRefPtr<JSONObject> result);
@@ -268,7 +322,9 @@ $constructorInit
 $setters
 private:
     using CallHandler = void (InspectorBackendDispatcherImpl::*)(int callId, JSONObject* messageObject, JSONArray* protocolErrors);
-    using DispatchMap = HashMap<String, CallHandler>;
+
+    void dispatchCommand(JSONObject* messageObject);
+    void sendProtocolResponse(int callId, PassRefPtr<JSONObject> message);
 
 $methodDeclarations
 
@@ -294,13 +350,21 @@ $fieldDeclarations
         sendResponse(callId, invocationError, RefPtr<JSONValue>(), JSONObject::create());
     }
     static const char InvalidParamsFormatString[];
+    // Indexed by MethodNames.
+    static const CallHandler s_handlers[];
 
-    DispatchMap m_dispatchMap;
     Vector<int> m_commonErrors;
+    // Responses of the batch being dispatched, sent together when it ends.
+    RefPtr<JSONArray> m_batchResponses;
+    Observer* m_observer;
 };
 
 const char InspectorBackendDispatcherImpl::InvalidParamsFormatString[] = "Some arguments of method '%s' can't be processed";
 
+const InspectorBackendDispatcherImpl::CallHandler InspectorBackendDispatcherImpl::s_handlers[] = {
+$messageHandlers
+};
+
 $methods
 
 PassRefPtrWillBeRawPtr<InspectorBackendDispatcher> InspectorBackendDispatcher::create(InspectorFrontendChannel* inspectorFrontendChannel)
@@ -312,12 +376,44 @@ PassRefPtrWillBeRawPtr<InspectorBackendDispatcher> InspectorBackendDispatcher::c
 void InspectorBackendDispatcherImpl::dispatch(const String& message)
 {
     RefPtrWillBeRawPtr<InspectorBackendDispatcher> protect(this);
-    int callId = 0;
+    if (m_observer)
+        m_observer->willParseMessage(message);
     RefPtr<JSONValue> parsedMessage = parseJSON(message);
+    if (m_observer)
+        m_observer->didParseMessage();
     ASSERT(parsedMessage);
-    RefPtr<JSONObject> messageObject = parsedMessage->asObject();
-    ASSERT(messageObject);
+    // A message dispatched from a nested loop while a batch is paused is not
+    // part of that batch.
+    RefPtr<JSONArray> outerBatchResponses = m_batchResponses.release();
+
+    RefPtr<JSONArray> batch = parsedMessage->asArray();
+    if (batch) {
+        // A batch is answered with one array holding the responses that its
+        // commands send before the batch ends, in order. Later responses and
+        // notifications are sent on their own.
+        m_batchResponses = JSONArray::create();
+        for (size_t i = 0; i < batch->length(); ++i) {
+            RefPtr<JSONObject> messageObject = batch->get(i)->asObject();
+            if (messageObject)
+                dispatchCommand(messageObject.get());
+            else
+                reportProtocolError(0, InvalidRequest, "Batch entries must be objects");
+        }
+        RefPtr<JSONArray> responses = m_batchResponses.release();
+        if (m_inspectorFrontendChannel && responses->length())
+            m_inspectorFrontendChannel->sendProtocolResponses(responses.release());
+    } else {
+        RefPtr<JSONObject> messageObject = parsedMessage->asObject();
+        ASSERT(messageObject);
+        dispatchCommand(messageObject.get());
+    }
 
+    m_batchResponses = outerBatchResponses.release();
+}
+
+void InspectorBackendDispatcherImpl::dispatchCommand(JSONObject* messageObject)
+{
+    int callId = 0;
     RefPtr<JSONValue> callIdValue = messageObject->get("id");
     bool success = callIdValue->asNumber(&callId);
     ASSERT_UNUSED(success, success);
@@ -327,14 +423,26 @@ void InspectorBackendDispatcherImpl::dispatch(const String& message)
     success = methodValue && methodValue->asString(&method);
     ASSERT_UNUSED(success, success);
 
-    HashMap<String, CallHandler>::iterator it = m_dispatchMap.find(method);
-    if (it == m_dispatchMap.end()) {
+    MethodNames methodName;
+    if (!findCommand(method, &methodName)) {
         reportProtocolError(callId, MethodNotFound, "'" + method + "' wasn't found");
         return;
     }
 
     RefPtr<JSONArray> protocolErrors = JSONArray::create();
-    ((*this).*it->value)(callId, messageObject.get(), protocolErrors.get());
+    if (m_observer)
+        m_observer->willDispatchCommand(methodName, callId);
+    ((*this).*s_handlers[methodName])(callId, messageObject, protocolErrors.get());
+    if (m_observer)
+        m_observer->didDispatchCommand(methodName, callId);
+}
+
+void InspectorBackendDispatcherImpl::sendProtocolResponse(int callId, PassRefPtr<JSONObject> message)
+{
+    if (m_batchResponses)
+        m_batchResponses->pushObject(message);
+    else if (m_inspectorFrontendChannel)
+        m_inspectorFrontendChannel->sendProtocolResponse(callId, message);
 }
 
 void InspectorBackendDispatcherImpl::sendResponse(int callId, const ErrorString& invocationError, PassRefPtr<JSONValue> errorData, PassRefPtr<JSONObject> result)
@@ -347,16 +455,15 @@ void InspectorBackendDispatcherImpl::sendResponse(int callId, const ErrorString&
     RefPtr<JSONObject> responseMessage = JSONObject::create();
     responseMessage->setNumber("id", callId);
     responseMessage->setObject("result", result);
-    if (m_inspectorFrontendChannel)
-        m_inspectorFrontendChannel->sendProtocolResponse(callId, responseMessage.release());
+    sendProtocolResponse(callId, responseMessage.release());
 }
 
-void InspectorBackendDispatcher::reportProtocolError(int callId, CommonErrorCode code, const String& errorMessage) const
+void InspectorBackendDispatcher::reportProtocolError(int callId, CommonErrorCode code, const String& errorMessage)
 {
     reportProtocolError(callId, code, errorMessage, PassRefPtr<JSONValue>());
 }
 
-void InspectorBackendDispatcherImpl::reportProtocolError(int callId, CommonErrorCode code, const String& errorMessage, PassRefPtr<JSONValue> data) const
+void InspectorBackendDispatcherImpl::reportProtocolError(int callId, CommonErrorCode code, const String& errorMessage, PassRefPtr<JSONValue> data)
 {
     ASSERT(code >=0);
     ASSERT((unsigned)code < m_commonErrors.size());
@@ -370,8 +477,7 @@ void InspectorBackendDispatcherImpl::reportProtocolError(int callId, CommonError
     RefPtr<JSONObject> message = JSONObject::create();
     message->setObject("error", error);
     message->setNumber("id", callId);
-    if (m_inspectorFrontendChannel)
-        m_inspectorFrontendChannel->sendProtocolResponse(callId, message.release());
+    sendProtocolResponse(callId, message.release());
 }
 
 template<typename R, typename V, typename V0>
@@ -31,8 +31,11 @@
 #include "core/inspector/ContentSearchUtils.h"
 
 #include "bindings/core/v8/ScriptRegexp.h"
+#include "bindings/core/v8/V8Binding.h"
 #include "wtf/Vector.h"
 #include "wtf/text/StringBuilder.h"
+#include <algorithm>
+#include <string.h>
 
 namespace blink {
 namespace ContentSearchUtils {
@@ -56,26 +59,125 @@ static String createSearchRegexSource(const String& text)
     return result.toString();
 }
 
-static Vector<pair<int, String> > getScriptRegexpMatchesByLines(const ScriptRegexp* regex, const String& text)
+unsigned LineEndings::lineForOffset(unsigned offset) const
 {
-    Vector<pair<int, String> > result;
-    if (text.isEmpty())
-        return result;
+    ASSERT(lineCount());
+    const unsigned* line = std::lower_bound(m_endings->begin(), m_endings->end(), offset);
+    return line == m_endings->end() ? lineCount() - 1 : line - m_endings->begin();
+}
+
+// Finds |query| in |text| starting at |start|. For 8-bit strings this looks
+// for the first query character with memchr, which the C library vectorizes,
+// and compares the rest with memcmp.
+static size_t findPlainText(const String& text, const String& query, unsigned start)
+{
+    if (!text.is8Bit() || !query.is8Bit() || query.isEmpty())
+        return text.find(query, start);
+
+    const LChar* characters = text.characters8();
+    const LChar* end = characters + text.length();
+    const LChar* pattern = query.characters8();
+    size_t patternLength = query.length();
+    const LChar* position = characters + start;
+    while (static_cast<size_t>(end - position) >= patternLength) {
+        position = static_cast<const LChar*>(memchr(position, pattern[0], end - position - patternLength + 1));
+        if (!position)
+            return kNotFound;
+        if (!memcmp(position + 1, pattern + 1, patternLength - 1))
+            return position - characters;
+        ++position;
+    }
+    return kNotFound;
+}
+
+// Returns the end of |line| excluding a trailing '\r'.
+static unsigned lineContentEnd(const String& text, const LineEndings& endings, unsigned line)
+{
+    unsigned end = endings.lineEnd(line);
+    if (end > endings.lineStart(line) && text[end - 1] == '\r')
+        --end;
+    return end;
+}
 
-    OwnPtr<Vector<unsigned> > endings(lineEndings(text));
-    unsigned size = endings->size();
+String lineContent(const String& text, const LineEndings& endings, unsigned line)
+{
+    unsigned start = endings.lineStart(line);
+    return text.substring(start, lineContentEnd(text, endings, line) - start);
+}
+
+// Finds the lines containing |query| with one pass over |text|: after a match
+// the search resumes at the start of the next line.
+static Vector<unsigned> findMatchingLines(const String& text, const LineEndings& endings, const String& query)
+{
+    Vector<unsigned> result;
     unsigned start = 0;
-    for (unsigned lineNumber = 0; lineNumber < size; ++lineNumber) {
-        unsigned lineEnd = endings->at(lineNumber);
-        String line = text.substring(start, lineEnd - start);
-        if (line.endsWith('\r'))
-            line = line.left(line.length() - 1);
+    while (start <= text.length()) {
+        size_t position = findPlainText(text, query, start);
+        if (position == kNotFound)
+            break;
+        unsigned line = endings.lineForOffset(position);
+        // Matches never span lines; if this one does, so does every later
+        // occurrence in the same line.
+        if (position + query.length() <= lineContentEnd(text, endings, line))
+            result.append(line);
+        start = endings.lineEnd(line) + 1;
+    }
+    return result;
+}
 
+// Runs |regex| over the whole of |text| at once rather than line by line;
+// matches crossing a line end are re-checked against their line alone. The
+// regexp must be multiline so that '^' and '$' still match at line bounds,
+// and global so that it can resume at a line start.
+static Vector<unsigned> findMatchingLinesWithRegex(const ScriptRegexp& regex, const String& text, const LineEndings& endings)
+{
+    Vector<unsigned> result;
+    v8::Isolate* isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope handleScope(isolate);
+    v8::Local<v8::String> subject = v8String(isolate, text);
+    unsigned start = 0;
+    while (start <= text.length()) {
         int matchLength;
-        if (regex->match(line, 0, &matchLength) != -1)
-            result.append(pair<int, String>(lineNumber, line));
+        int position = regex.matchInPlace(subject, start, &matchLength);
+        if (position == -1)
+            break;
+        unsigned line = endings.lineForOffset(position);
+        if (position + matchLength <= lineContentEnd(text, endings, line) || regex.match(lineContent(text, endings, line)) != -1)
+            result.append(line);
+        start = endings.lineEnd(line) + 1;
+    }
+    return result;
+}
+
+bool canSearchInPlainText(const String& query, bool caseSensitive, bool isRegex)
+{
+    return !isRegex && (caseSensitive || query.containsOnlyASCII());
+}
 
-        start = lineEnd + 1;
+Vector<unsigned> findMatchingLinesInPlainText(const String& text, const LineEndings& endings, const String& query, bool caseSensitive)
+{
+    ASSERT(canSearchInPlainText(query, caseSensitive, false));
+    if (text.isEmpty())
+        return Vector<unsigned>();
+    if (caseSensitive)
+        return findMatchingLines(text, endings, query);
+    // Lower-casing Latin-1 text keeps offsets, so matches in the folded copy
+    // map 1:1 onto |text|.
+    if (text.is8Bit()) {
+        String foldedText = text.lower();
+        if (foldedText.length() == text.length())
+            return findMatchingLines(foldedText, endings, query.lower());
+    }
+    Vector<unsigned> result;
+    unsigned start = 0;
+    while (start <= text.length()) {
+        size_t position = text.findIgnoringCase(query, start);
+        if (position == kNotFound)
+            break;
+        unsigned line = endings.lineForOffset(position);
+        if (position + query.length() <= lineContentEnd(text, endings, line))
+            result.append(line);
+        start = endings.lineEnd(line) + 1;
     }
     return result;
 }
@@ -88,21 +190,40 @@ static PassRefPtr<TypeBuilder::Debugger::SearchMatch> buildObjectForSearchMatch(
         .release();
 }
 
-PassOwnPtr<ScriptRegexp> createSearchRegex(const String& query, bool caseSensitive, bool isRegex)
+static PassOwnPtr<ScriptRegexp> createSearchRegex(const String& query, bool caseSensitive, bool isRegex, MultilineMode multilineMode, GlobalMode globalMode)
 {
     String regexSource = isRegex ? query : createSearchRegexSource(query);
-    return adoptPtr(new ScriptRegexp(regexSource, caseSensitive ? TextCaseSensitive : TextCaseInsensitive));
+    return adoptPtr(new ScriptRegexp(regexSource, caseSensitive ? TextCaseSensitive : TextCaseInsensitive, multilineMode, globalMode));
+}
+
+PassOwnPtr<ScriptRegexp> createSearchRegex(const String& query, bool caseSensitive, bool isRegex)
+{
+    return createSearchRegex(query, caseSensitive, isRegex, MultilineDisabled, GlobalDisabled);
 }
 
 PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::SearchMatch>> searchInTextByLines(const String& text, const String& query, const bool caseSensitive, const bool isRegex)
+{
+    return searchInTextByLines(text, *LineEndings::create(text), query, caseSensitive, isRegex);
+}
+
+PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::SearchMatch>> searchInTextByLines(const String& text, const LineEndings& endings, const String& query, const bool caseSensitive, const bool isRegex)
 {
     RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::SearchMatch>> result = TypeBuilder::Array<TypeBuilder::Debugger::SearchMatch>::create();
+    if (text.isEmpty())
+        return result;
 
-    OwnPtr<ScriptRegexp> regex = ContentSearchUtils::createSearchRegex(query, caseSensitive, isRegex);
-    Vector<pair<int, String> > matches = getScriptRegexpMatchesByLines(regex.get(), text);
+    Vector<unsigned> lines;
+    if (canSearchInPlainText(query, caseSensitive, isRegex)) {
+        lines = findMatchingLinesInPlainText(text, endings, query, caseSensitive);
+    } else {
+        OwnPtr<ScriptRegexp> regex = createSearchRegex(query, caseSensitive, isRegex, MultilineEnabled, GlobalEnabled);
+        if (!regex->isValid())
+            return result;
+        lines = findMatchingLinesWithRegex(*regex, text, endings);
+    }
 
-    for (const auto& match : matches)
-        result->addItem(buildObjectForSearchMatch(match.first, match.second));
+    for (unsigned line : lines)
+        result->addItem(buildObjectForSearchMatch(line, lineContent(text, endings, line)));
 
     return result;
 }
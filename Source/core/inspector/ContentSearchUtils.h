@@ -29,8 +29,11 @@
 #ifndef ContentSearchUtils_h
 #define ContentSearchUtils_h
 
+#include "core/CoreExport.h"
 #include "core/InspectorTypeBuilder.h"
 #include "wtf/PassOwnPtr.h"
+#include "wtf/ThreadSafeRefCounted.h"
+#include "wtf/Vector.h"
 #include "wtf/text/TextPosition.h"
 #include "wtf/text/WTFString.h"
 
@@ -45,8 +48,34 @@ enum MagicCommentType {
     CSSMagicComment
 };
 
+// Line end offsets of a text (see WTF::lineEndings), computed once and shared
+// by all searches of that text.
+class CORE_EXPORT LineEndings : public ThreadSafeRefCounted<LineEndings> {
+public:
+    static PassRefPtr<LineEndings> create(const String& text) { return adoptRef(new LineEndings(text)); }
+
+    unsigned lineCount() const { return m_endings->size(); }
+    unsigned lineStart(unsigned line) const { return line ? m_endings->at(line - 1) + 1 : 0; }
+    unsigned lineEnd(unsigned line) const { return m_endings->at(line); }
+    // Returns the line containing |offset|, in O(log lineCount()).
+    unsigned lineForOffset(unsigned offset) const;
+
+private:
+    explicit LineEndings(const String& text) : m_endings(lineEndings(text)) { }
+
+    OwnPtr<Vector<unsigned>> m_endings;
+};
+
 PassOwnPtr<ScriptRegexp> createSearchRegex(const String& query, bool caseSensitive, bool isRegex);
+
+// Plain-text search does not use V8 and may run on any thread; it handles
+// case-insensitive queries only if they are ASCII.
+bool canSearchInPlainText(const String& query, bool caseSensitive, bool isRegex);
+Vector<unsigned> findMatchingLinesInPlainText(const String& text, const LineEndings&, const String& query, bool caseSensitive);
+String lineContent(const String& text, const LineEndings&, unsigned line);
+
 PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::SearchMatch>> searchInTextByLines(const String& text, const String& query, const bool caseSensitive, const bool isRegex);
+PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::SearchMatch>> searchInTextByLines(const String& text, const LineEndings&, const String& query, const bool caseSensitive, const bool isRegex);
 
 String findSourceURL(const String& content, MagicCommentType, bool* deprecated = nullptr);
 String findSourceMapURL(const String& content, MagicCommentType, bool* deprecated = nullptr);
@@ -0,0 +1,78 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/inspector/ContentSearchUtils.h"
+
+#include "bindings/core/v8/ScriptRegexp.h"
+#include <gtest/gtest.h>
+
+namespace blink {
+namespace ContentSearchUtils {
+namespace {
+
+String search(const String& text, const String& query, bool caseSensitive, bool isRegex)
+{
+    return searchInTextByLines(text, query, caseSensitive, isRegex)->toJSONString();
+}
+
+TEST(ContentSearchUtilsTest, PlainText)
+{
+    String text("foo\r\nbar foo foo\n\nbarfoo");
+    RefPtr<LineEndings> endings = LineEndings::create(text);
+    Vector<unsigned> lines = findMatchingLinesInPlainText(text, *endings, "foo", true);
+    ASSERT_EQ(3u, lines.size());
+    EXPECT_EQ(0u, lines[0]);
+    EXPECT_EQ(1u, lines[1]);
+    EXPECT_EQ(3u, lines[2]);
+
+    lines = findMatchingLinesInPlainText(text, *endings, "BAR", false);
+    ASSERT_EQ(2u, lines.size());
+    EXPECT_EQ(1u, lines[0]);
+    EXPECT_EQ(3u, lines[1]);
+
+    // Matches do not span lines.
+    EXPECT_TRUE(findMatchingLinesInPlainText(text, *endings, "foo\r\nbar", true).isEmpty());
+}
+
+TEST(ContentSearchUtilsTest, LineContentExcludesCarriageReturn)
+{
+    EXPECT_EQ("[{\"lineNumber\":0,\"lineContent\":\"foo\"}]", search("foo\r\nbar", "foo", true, false));
+}
+
+TEST(ContentSearchUtilsTest, Regex)
+{
+    String text("abc\nbcd\nxbc");
+    EXPECT_EQ("[{\"lineNumber\":1,\"lineContent\":\"bcd\"}]", search(text, "^b", true, true));
+    EXPECT_EQ("[{\"lineNumber\":0,\"lineContent\":\"abc\"},{\"lineNumber\":2,\"lineContent\":\"xbc\"}]", search(text, "c$", true, true));
+    EXPECT_EQ("[{\"lineNumber\":1,\"lineContent\":\"bcd\"}]", search(text, "BCD", false, true));
+    EXPECT_EQ("[]", search(text, "(", true, true));
+}
+
+TEST(ContentSearchUtilsTest, RegexCrossingLineEnd)
+{
+    // "c\s+b" first matches across the end of line 0; only line 2 contains
+    // it on its own.
+    EXPECT_EQ("[{\"lineNumber\":2,\"lineContent\":\"c  b\"}]", search("abc\nbcd\nc  b", "c\\s+b", true, true));
+}
+
+TEST(ContentSearchUtilsTest, CaseInsensitiveNonASCII)
+{
+    String text = String::fromUTF8("x\nStra\xC3\x9F" "e\n\xC3\x84PFEL");
+    EXPECT_EQ(String::fromUTF8("[{\"lineNumber\":2,\"lineContent\":\"\xC3\x84PFEL\"}]"), search(text, String::fromUTF8("\xC3\xA4pfel"), false, false));
+}
+
+TEST(ContentSearchUtilsTest, SearchRegexIsNotGlobal)
+{
+    // createSearchRegex() is used for URL matching; repeated matches must
+    // not depend on the previous one.
+    OwnPtr<ScriptRegexp> regex = createSearchRegex("a.js", true, false);
+    EXPECT_EQ(4, regex->match("foo/a.js"));
+    EXPECT_EQ(4, regex->match("foo/a.js"));
+    EXPECT_EQ(-1, regex->match("foo/abjs"));
+}
+
+} // namespace
+} // namespace ContentSearchUtils
+} // namespace blink
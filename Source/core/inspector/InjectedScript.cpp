@@ -34,8 +34,10 @@
 #include "core/inspector/InjectedScript.h"
 
 #include "bindings/core/v8/ScriptFunctionCall.h"
+#include "bindings/core/v8/V8Binding.h"
 #include "core/inspector/InjectedScriptHost.h"
 #include "core/inspector/JSONParser.h"
+#include "core/inspector/ObjectPreviewBuilder.h"
 #include "platform/JSONValues.h"
 #include "wtf/text/WTFString.h"
 #include "wtf/text/StringBuilder.h"
@@ -53,38 +55,84 @@ namespace blink {
 
 InjectedScript::InjectedScript()
     : InjectedScriptBase("InjectedScript")
+    , m_host(nullptr)
 {
 }
 
-InjectedScript::InjectedScript(ScriptValue injectedScriptObject, InspectedStateAccessCheck accessCheck, PassRefPtr<InjectedScriptNative> injectedScriptNative)
+InjectedScript::InjectedScript(ScriptValue injectedScriptObject, InspectedStateAccessCheck accessCheck, PassRefPtr<InjectedScriptNative> injectedScriptNative, InjectedScriptHost* host)
     : InjectedScriptBase("InjectedScript", injectedScriptObject, accessCheck)
     , m_native(injectedScriptNative)
+    , m_host(host)
 {
 }
 
-void InjectedScript::evaluate(ErrorString* errorString, const String& expression, const String& objectGroup, bool includeCommandLineAPI, bool returnByValue, bool generatePreview, RefPtr<TypeBuilder::Runtime::RemoteObject>* result, TypeBuilder::OptOutput<bool>* wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>* exceptionDetails)
+// Previews are built natively rather than by InjectedScriptSource.js, which
+// would walk every property through Object.getOwnPropertyDescriptor. They are
+// added while the RemoteObjects at |remoteObjectDepth| are being written.
+class InjectedScript::PreviewWriterClient final : public V8JSONWriter::Client {
+public:
+    PreviewWriterClient(const InjectedScript* injectedScript, int remoteObjectDepth)
+        : m_injectedScript(injectedScript)
+        , m_remoteObjectDepth(remoteObjectDepth)
+    {
+    }
+
+    void willCloseObject(V8JSONWriter& writer, v8::Local<v8::Object> object, int depth) override
+    {
+        if (depth == m_remoteObjectDepth)
+            m_injectedScript->appendPreview(writer, object, *this);
+    }
+
+    // The object ids of one call only differ in their "id", so the JSON of
+    // the first one is parsed and the others are matched against its prefix.
+    bool boundIdForObjectId(const String& objectId, int* boundId)
+    {
+        if (!m_objectIdPrefix.isNull() && objectId.startsWith(m_objectIdPrefix) && objectId.endsWith('}')) {
+            bool ok = false;
+            *boundId = objectId.substring(m_objectIdPrefix.length(), objectId.length() - m_objectIdPrefix.length() - 1).toIntStrict(&ok);
+            return ok;
+        }
+        RefPtr<JSONValue> parsedObjectId = parseJSON(objectId);
+        RefPtr<JSONObject> parsedObject;
+        int injectedScriptId = 0;
+        if (!parsedObjectId || !parsedObjectId->asObject(&parsedObject) || !parsedObject->getNumber("id", boundId) || !parsedObject->getNumber("injectedScriptId", &injectedScriptId))
+            return false;
+        // Must match InjectedScript.prototype._bind.
+        m_objectIdPrefix = "{\"injectedScriptId\":" + String::number(injectedScriptId) + ",\"id\":";
+        return true;
+    }
+
+private:
+    const InjectedScript* m_injectedScript;
+    int m_remoteObjectDepth;
+    String m_objectIdPrefix;
+};
+
+void InjectedScript::evaluate(ErrorString* errorString, const String& expression, const String& objectGroup, bool includeCommandLineAPI, bool returnByValue, bool generatePreview, RefPtr<JSONValue>* result, TypeBuilder::OptOutput<bool>* wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>* exceptionDetails)
 {
     ScriptFunctionCall function(injectedScriptObject(), "evaluate");
     function.appendArgument(expression);
     function.appendArgument(objectGroup);
     function.appendArgument(includeCommandLineAPI);
     function.appendArgument(returnByValue);
-    function.appendArgument(generatePreview);
-    makeEvalCall(errorString, function, result, wasThrown, exceptionDetails);
+    function.appendArgument(false);
+    PreviewWriterClient previewClient(this, 0);
+    makeEvalCall(errorString, function, result, wasThrown, exceptionDetails, generatePreview ? &previewClient : nullptr);
 }
 
-void InjectedScript::callFunctionOn(ErrorString* errorString, const String& objectId, const String& expression, const String& arguments, bool returnByValue, bool generatePreview, RefPtr<TypeBuilder::Runtime::RemoteObject>* result, TypeBuilder::OptOutput<bool>* wasThrown)
+void InjectedScript::callFunctionOn(ErrorString* errorString, const String& objectId, const String& expression, const String& arguments, bool returnByValue, bool generatePreview, RefPtr<JSONValue>* result, TypeBuilder::OptOutput<bool>* wasThrown)
 {
     ScriptFunctionCall function(injectedScriptObject(), "callFunctionOn");
     function.appendArgument(objectId);
     function.appendArgument(expression);
     function.appendArgument(arguments);
     function.appendArgument(returnByValue);
-    function.appendArgument(generatePreview);
-    makeEvalCall(errorString, function, result, wasThrown);
+    function.appendArgument(false);
+    PreviewWriterClient previewClient(this, 0);
+    makeEvalCall(errorString, function, result, wasThrown, 0, generatePreview ? &previewClient : nullptr);
 }
 
-void InjectedScript::evaluateOnCallFrame(ErrorString* errorString, const ScriptValue& callFrames, const Vector<ScriptValue>& asyncCallStacks, const String& callFrameId, const String& expression, const String& objectGroup, bool includeCommandLineAPI, bool returnByValue, bool generatePreview, RefPtr<RemoteObject>* result, TypeBuilder::OptOutput<bool>* wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>* exceptionDetails)
+void InjectedScript::evaluateOnCallFrame(ErrorString* errorString, const ScriptValue& callFrames, const Vector<ScriptValue>& asyncCallStacks, const String& callFrameId, const String& expression, const String& objectGroup, bool includeCommandLineAPI, bool returnByValue, bool generatePreview, RefPtr<JSONValue>* result, TypeBuilder::OptOutput<bool>* wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>* exceptionDetails)
 {
     ScriptFunctionCall function(injectedScriptObject(), "evaluateOnCallFrame");
     function.appendArgument(callFrames);
@@ -95,8 +143,9 @@ void InjectedScript::evaluateOnCallFrame(ErrorString* errorString, const ScriptV
     function.appendArgument(objectGroup);
     function.appendArgument(includeCommandLineAPI);
     function.appendArgument(returnByValue);
-    function.appendArgument(generatePreview);
-    makeEvalCall(errorString, function, result, wasThrown, exceptionDetails);
+    function.appendArgument(false);
+    PreviewWriterClient previewClient(this, 0);
+    makeEvalCall(errorString, function, result, wasThrown, exceptionDetails, generatePreview ? &previewClient : nullptr);
 }
 
 void InjectedScript::restartFrame(ErrorString* errorString, const ScriptValue& callFrames, const String& callFrameId, RefPtr<JSONObject>* result)
@@ -211,26 +260,48 @@ void InjectedScript::getCollectionEntries(ErrorString* errorString, const String
     *result = Array<CollectionEntry>::runtimeCast(resultValue);
 }
 
-void InjectedScript::getProperties(ErrorString* errorString, const String& objectId, bool ownProperties, bool accessorPropertiesOnly, bool generatePreview, RefPtr<Array<PropertyDescriptor>>* properties, RefPtr<TypeBuilder::Debugger::ExceptionDetails>* exceptionDetails)
+void InjectedScript::getProperties(ErrorString* errorString, const String& objectId, bool ownProperties, bool accessorPropertiesOnly, bool generatePreview, const PropertyPage& page, RefPtr<JSONValue>* properties, RefPtr<TypeBuilder::Debugger::ExceptionDetails>* exceptionDetails, TypeBuilder::OptOutput<String>* continuationToken)
 {
     ScriptFunctionCall function(injectedScriptObject(), "getProperties");
     function.appendArgument(objectId);
     function.appendArgument(ownProperties);
     function.appendArgument(accessorPropertiesOnly);
-    function.appendArgument(generatePreview);
-
-    RefPtr<JSONValue> result;
-    makeCallWithExceptionDetails(function, &result, exceptionDetails);
+    function.appendArgument(false);
+    function.appendArgument(page.fromIndex);
+    function.appendArgument(page.toIndex);
+    function.appendArgument(page.nonIndexedPropertiesOnly);
+    function.appendArgument(page.maxProperties);
+    function.appendArgument(page.continuationToken);
+
+    ScriptState::Scope scope(injectedScriptObject().scriptState());
+    v8::Isolate* isolate = injectedScriptObject().isolate();
+    v8::Local<v8::Value> result = callWithExceptionDetails(function, exceptionDetails);
     if (*exceptionDetails) {
         // FIXME: make properties optional
-        *properties = Array<PropertyDescriptor>::create();
+        *properties = JSONArray::create();
         return;
     }
-    if (!result || result->type() != JSONValue::TypeArray) {
-        *errorString = "Internal error";
+    v8::Local<v8::Value> resultProperties;
+    if (result.IsEmpty() || !result->IsObject() || (resultProperties = result.As<v8::Object>()->Get(v8AtomicString(isolate, "properties"))).IsEmpty() || !resultProperties->IsArray()) {
+        if (!result.IsEmpty() && result->IsString())
+            *errorString = toCoreString(result.As<v8::String>());
+        else
+            *errorString = "Internal error";
+        return;
+    }
+
+    // The RemoteObjects in the descriptors are two levels down:
+    // [ { value: { ... } } ], which is where their previews are added.
+    PreviewWriterClient previewClient(this, 2);
+    V8JSONWriter writer(isolate, generatePreview ? &previewClient : nullptr);
+    *properties = writer.toRawValue(resultProperties);
+    if (!*properties) {
+        *errorString = String::format("Object has too long reference chain(must not be longer than %d)", JSONValue::maxDepth);
         return;
     }
-    *properties = Array<PropertyDescriptor>::runtimeCast(result);
+    v8::Local<v8::Value> nextToken = result.As<v8::Object>()->Get(v8AtomicString(isolate, "continuationToken"));
+    if (!nextToken.IsEmpty() && nextToken->IsString())
+        *continuationToken = toCoreString(nextToken.As<v8::String>());
 }
 
 void InjectedScript::getInternalProperties(ErrorString* errorString, const String& objectId, RefPtr<Array<InternalPropertyDescriptor>>* properties, RefPtr<TypeBuilder::Debugger::ExceptionDetails>* exceptionDetails)
@@ -287,13 +358,17 @@ PassRefPtr<TypeBuilder::Runtime::RemoteObject> InjectedScript::wrapObject(const
     wrapFunction.appendArgument(value);
     wrapFunction.appendArgument(groupName);
     wrapFunction.appendArgument(canAccessInspectedWindow());
-    wrapFunction.appendArgument(generatePreview);
+    wrapFunction.appendArgument(false);
     bool hadException = false;
     ScriptValue r = callFunctionWithEvalEnabled(wrapFunction, hadException);
     if (hadException)
         return nullptr;
-    RefPtr<JSONObject> rawResult = toJSONValue(r)->asObject();
-    return TypeBuilder::Runtime::RemoteObject::runtimeCast(rawResult);
+    ScriptState::Scope scope(injectedScriptObject().scriptState());
+    v8::Local<v8::Value> rawResult = r.v8Value();
+    if (rawResult.IsEmpty() || !rawResult->IsObject())
+        return nullptr;
+    PreviewWriterClient previewClient(this, 0);
+    return serializeRemoteObject(rawResult.As<v8::Object>(), generatePreview ? &previewClient : nullptr);
 }
 
 PassRefPtr<TypeBuilder::Runtime::RemoteObject> InjectedScript::wrapTable(const ScriptValue& table, const ScriptValue& columns) const
@@ -352,6 +427,32 @@ void InjectedScript::releaseObjectGroup(const String& objectGroup)
     }
 }
 
+void InjectedScript::appendPreview(V8JSONWriter& writer, v8::Local<v8::Object> remoteObject, PreviewWriterClient& client) const
+{
+    v8::Isolate* isolate = injectedScriptObject().isolate();
+    v8::Local<v8::Value> type = remoteObject->Get(v8AtomicString(isolate, "type"));
+    v8::Local<v8::Value> objectId = remoteObject->Get(v8AtomicString(isolate, "objectId"));
+    if (type.IsEmpty() || !type->IsString() || toCoreString(type.As<v8::String>()) != "object" || objectId.IsEmpty() || !objectId->IsString())
+        return;
+    if (remoteObject->HasRealNamedProperty(v8AtomicString(isolate, "preview")))
+        return;
+    String subtype = toCoreStringWithUndefinedOrNullCheck(remoteObject->Get(v8AtomicString(isolate, "subtype")));
+    if (subtype == "node")
+        return;
+    int boundId = 0;
+    if (!client.boundIdForObjectId(toCoreString(objectId.As<v8::String>()), &boundId))
+        return;
+
+    v8::Local<v8::Value> object = m_native->objectForId(boundId);
+    if (object.IsEmpty() || !object->IsObject())
+        return;
+    String description = toCoreStringWithUndefinedOrNullCheck(remoteObject->Get(v8AtomicString(isolate, "description")));
+    V8Debugger* debugger = m_host && m_host->hasDebugger() ? &m_host->debugger() : nullptr;
+    ObjectPreviewBuilder builder(isolate, debugger);
+    RefPtr<TypeBuilder::Runtime::ObjectPreview> preview = builder.build(object.As<v8::Object>(), subtype, description);
+    writer.appendMember("preview", preview.get());
+}
+
 void InjectedScript::setCustomObjectFormatterEnabled(bool enabled)
 {
     ASSERT(!isEmpty());
@@ -41,11 +41,30 @@
 
 namespace blink {
 
+class InjectedScriptHost;
+
 class InjectedScript final : public InjectedScriptBase {
 public:
     InjectedScript();
     virtual ~InjectedScript() { }
 
+    // Selects part of an object's properties for getProperties().
+    struct PropertyPage {
+        PropertyPage() : fromIndex(-1), toIndex(-1), nonIndexedPropertiesOnly(false), maxProperties(0) { }
+
+        // Array element range; -1 leaves that end open. Setting either end
+        // returns only the elements in the range.
+        int fromIndex;
+        int toIndex;
+        bool nonIndexedPropertiesOnly;
+        // 0 for no limit. A limited call also stops after a time budget.
+        int maxProperties;
+        String continuationToken;
+    };
+
+    // The results of evaluate(), callFunctionOn(), evaluateOnCallFrame() and
+    // getProperties() are JSONRawValues holding the RemoteObject or the
+    // PropertyDescriptor array, written straight from V8 for the response.
     void evaluate(
         ErrorString*,
         const String& expression,
@@ -53,7 +72,7 @@ public:
         bool includeCommandLineAPI,
         bool returnByValue,
         bool generatePreview,
-        RefPtr<TypeBuilder::Runtime::RemoteObject>* result,
+        RefPtr<JSONValue>* result,
         TypeBuilder::OptOutput<bool>* wasThrown,
         RefPtr<TypeBuilder::Debugger::ExceptionDetails>*);
     void callFunctionOn(
@@ -63,7 +82,7 @@ public:
         const String& arguments,
         bool returnByValue,
         bool generatePreview,
-        RefPtr<TypeBuilder::Runtime::RemoteObject>* result,
+        RefPtr<JSONValue>* result,
         TypeBuilder::OptOutput<bool>* wasThrown);
     void evaluateOnCallFrame(
         ErrorString*,
@@ -75,7 +94,7 @@ public:
         bool includeCommandLineAPI,
         bool returnByValue,
         bool generatePreview,
-        RefPtr<TypeBuilder::Runtime::RemoteObject>* result,
+        RefPtr<JSONValue>* result,
         TypeBuilder::OptOutput<bool>* wasThrown,
         RefPtr<TypeBuilder::Debugger::ExceptionDetails>*);
     void restartFrame(ErrorString*, const ScriptValue& callFrames, const String& callFrameId, RefPtr<JSONObject>* result);
@@ -84,7 +103,7 @@ public:
     void getFunctionDetails(ErrorString*, const String& functionId, RefPtr<TypeBuilder::Debugger::FunctionDetails>* result);
     void getGeneratorObjectDetails(ErrorString*, const String& functionId, RefPtr<TypeBuilder::Debugger::GeneratorObjectDetails>* result);
     void getCollectionEntries(ErrorString*, const String& objectId, RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::CollectionEntry> >* result);
-    void getProperties(ErrorString*, const String& objectId, bool ownProperties, bool accessorPropertiesOnly, bool generatePreview, RefPtr<TypeBuilder::Array<TypeBuilder::Runtime::PropertyDescriptor>>* result, RefPtr<TypeBuilder::Debugger::ExceptionDetails>*);
+    void getProperties(ErrorString*, const String& objectId, bool ownProperties, bool accessorPropertiesOnly, bool generatePreview, const PropertyPage&, RefPtr<JSONValue>* result, RefPtr<TypeBuilder::Debugger::ExceptionDetails>*, TypeBuilder::OptOutput<String>* continuationToken);
     void getInternalProperties(ErrorString*, const String& objectId, RefPtr<TypeBuilder::Array<TypeBuilder::Runtime::InternalPropertyDescriptor>>* result, RefPtr<TypeBuilder::Debugger::ExceptionDetails>*);
     void releaseObject(const String& objectId);
 
@@ -101,9 +120,14 @@ public:
 
 private:
     friend InjectedScript InjectedScriptManager::injectedScriptFor(ScriptState*);
-    InjectedScript(ScriptValue, InspectedStateAccessCheck, PassRefPtr<InjectedScriptNative>);
+    InjectedScript(ScriptValue, InspectedStateAccessCheck, PassRefPtr<InjectedScriptNative>, InjectedScriptHost*);
+
+    class PreviewWriterClient;
+    void appendPreview(V8JSONWriter&, v8::Local<v8::Object> remoteObject, PreviewWriterClient&) const;
 
     RefPtr<InjectedScriptNative> m_native;
+    // Owned by InjectedScriptManager, which outlives its injected scripts.
+    InjectedScriptHost* m_host;
 };
 
 } // namespace blink
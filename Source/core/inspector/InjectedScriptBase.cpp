@@ -177,53 +177,96 @@ void InjectedScriptBase::makeCall(ScriptFunctionCall& function, RefPtr<JSONValue
     }
 }
 
-void InjectedScriptBase::makeEvalCall(ErrorString* errorString, ScriptFunctionCall& function, RefPtr<TypeBuilder::Runtime::RemoteObject>* objectResult, TypeBuilder::OptOutput<bool>* wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>* exceptionDetails)
+void InjectedScriptBase::makeEvalCall(ErrorString* errorString, ScriptFunctionCall& function, RefPtr<JSONValue>* objectResult, TypeBuilder::OptOutput<bool>* wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>* exceptionDetails, V8JSONWriter::Client* writerClient)
 {
-    RefPtr<JSONValue> result;
-    makeCall(function, &result);
-    if (!result) {
+    if (isEmpty() || !canAccessInspectedWindow()) {
+        *errorString = "Internal error: result is not an Object";
+        return;
+    }
+
+    bool hadException = false;
+    ScriptValue resultValue = callFunctionWithEvalEnabled(function, hadException);
+    ASSERT(!hadException);
+    if (hadException) {
+        *errorString = "Exception while making a call.";
+        return;
+    }
+
+    ScriptState* scriptState = m_injectedScriptObject.scriptState();
+    ScriptState::Scope scope(scriptState);
+    v8::Isolate* isolate = scriptState->isolate();
+    v8::Local<v8::Value> result = resultValue.v8Value();
+    if (result.IsEmpty()) {
         *errorString = "Internal error: result value is empty";
         return;
     }
-    if (result->type() == JSONValue::TypeString) {
-        result->asString(errorString);
+    if (result->IsString()) {
+        *errorString = toCoreString(result.As<v8::String>());
         ASSERT(errorString->length());
         return;
     }
-    RefPtr<JSONObject> resultPair = result->asObject();
-    if (!resultPair) {
+    if (!result->IsObject()) {
         *errorString = "Internal error: result is not an Object";
         return;
     }
-    RefPtr<JSONObject> resultObj = resultPair->getObject("result");
-    bool wasThrownVal = false;
-    if (!resultObj || !resultPair->getBoolean("wasThrown", &wasThrownVal)) {
+    v8::Local<v8::Object> resultPair = result.As<v8::Object>();
+    v8::Local<v8::Value> resultObj = resultPair->Get(v8AtomicString(isolate, "result"));
+    v8::Local<v8::Value> wasThrownVal = resultPair->Get(v8AtomicString(isolate, "wasThrown"));
+    if (resultObj.IsEmpty() || !resultObj->IsObject() || wasThrownVal.IsEmpty() || !wasThrownVal->IsBoolean()) {
         *errorString = "Internal error: result is not a pair of value and wasThrown flag";
         return;
     }
-    if (wasThrownVal) {
-        RefPtr<JSONObject> objectExceptionDetails = resultPair->getObject("exceptionDetails");
-        if (objectExceptionDetails)
-            *exceptionDetails = toExceptionDetails(objectExceptionDetails.release());
+    if (wasThrownVal->BooleanValue()) {
+        v8::Local<v8::Value> objectExceptionDetails = resultPair->Get(v8AtomicString(isolate, "exceptionDetails"));
+        if (!objectExceptionDetails.IsEmpty() && objectExceptionDetails->IsObject()) {
+            RefPtr<JSONValue> exceptionDetailsValue = ScriptValue::v8ToJSONValue(objectExceptionDetails, isolate);
+            if (exceptionDetailsValue && exceptionDetailsValue->type() == JSONValue::TypeObject)
+                *exceptionDetails = toExceptionDetails(exceptionDetailsValue->asObject());
+        }
     }
-    *objectResult = TypeBuilder::Runtime::RemoteObject::runtimeCast(resultObj);
-    *wasThrown = wasThrownVal;
+    // Thrown values get no previews, as before previews were built natively.
+    V8JSONWriter writer(isolate, wasThrownVal->BooleanValue() ? nullptr : writerClient);
+    *objectResult = writer.toRawValue(resultObj);
+    if (!*objectResult) {
+        *errorString = String::format("Object has too long reference chain(must not be longer than %d)", JSONValue::maxDepth);
+        return;
+    }
+    *wasThrown = wasThrownVal->BooleanValue();
 }
 
 void InjectedScriptBase::makeCallWithExceptionDetails(ScriptFunctionCall& function, RefPtr<JSONValue>* result, RefPtr<TypeBuilder::Debugger::ExceptionDetails>* exceptionDetails)
 {
     ScriptState::Scope scope(injectedScriptObject().scriptState());
+    v8::Local<v8::Value> resultValue = callWithExceptionDetails(function, exceptionDetails);
+    if (resultValue.IsEmpty())
+        return;
+    *result = ScriptValue::v8ToJSONValue(resultValue, injectedScriptObject().isolate());
+    if (!*result)
+        *result = JSONString::create(String::format("Object has too long reference chain(must not be longer than %d)", JSONValue::maxDepth));
+}
+
+v8::Local<v8::Value> InjectedScriptBase::callWithExceptionDetails(ScriptFunctionCall& function, RefPtr<TypeBuilder::Debugger::ExceptionDetails>* exceptionDetails)
+{
     v8::TryCatch tryCatch;
     ScriptValue resultValue = function.callWithoutExceptionHandling();
     if (tryCatch.HasCaught()) {
         v8::Local<v8::Message> message = tryCatch.Message();
         String text = !message.IsEmpty() ? toCoreStringWithUndefinedOrNullCheck(message->Get()) : "Internal error";
         *exceptionDetails = TypeBuilder::Debugger::ExceptionDetails::create().setText(text);
-    } else {
-        *result = toJSONValue(resultValue);
-        if (!*result)
-            *result = JSONString::create(String::format("Object has too long reference chain(must not be longer than %d)", JSONValue::maxDepth));
+        return v8::Local<v8::Value>();
     }
+    return resultValue.v8Value();
+}
+
+// Converts |remoteObject| without building a JSONValue tree for its by-value
+// payload. Returns null if the object is nested too deep.
+PassRefPtr<TypeBuilder::Runtime::RemoteObject> InjectedScriptBase::serializeRemoteObject(v8::Local<v8::Object> remoteObject, V8JSONWriter::Client* writerClient) const
+{
+    V8JSONWriter writer(m_injectedScriptObject.isolate(), writerClient);
+    RefPtr<JSONValue> object = writer.toJSONValue(remoteObject, 0, "value");
+    if (!object)
+        return nullptr;
+    return RemoteObject::runtimeCast(object.release());
 }
 
 } // namespace blink
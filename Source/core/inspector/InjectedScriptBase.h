@@ -33,6 +33,7 @@
 
 #include "bindings/core/v8/ScriptState.h"
 #include "bindings/core/v8/ScriptValue.h"
+#include "bindings/core/v8/V8JSONWriter.h"
 #include "core/InspectorTypeBuilder.h"
 #include "wtf/Forward.h"
 
@@ -66,8 +67,14 @@ protected:
     const ScriptValue& injectedScriptObject() const;
     ScriptValue callFunctionWithEvalEnabled(ScriptFunctionCall&, bool& hadException) const;
     void makeCall(ScriptFunctionCall&, RefPtr<JSONValue>* result);
-    void makeEvalCall(ErrorString*, ScriptFunctionCall&, RefPtr<TypeBuilder::Runtime::RemoteObject>* result, TypeBuilder::OptOutput<bool>* wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>* = 0);
+    // The RemoteObject is written straight from V8 as JSON text and kept in a
+    // JSONRawValue; |writerClient| may add members to the objects written.
+    void makeEvalCall(ErrorString*, ScriptFunctionCall&, RefPtr<JSONValue>* result, TypeBuilder::OptOutput<bool>* wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>* = 0, V8JSONWriter::Client* writerClient = 0);
     void makeCallWithExceptionDetails(ScriptFunctionCall&, RefPtr<JSONValue>* result, RefPtr<TypeBuilder::Debugger::ExceptionDetails>*);
+    // Same as makeCallWithExceptionDetails(), but leaves the result in V8.
+    // Must be called inside a ScriptState::Scope of the injected script.
+    v8::Local<v8::Value> callWithExceptionDetails(ScriptFunctionCall&, RefPtr<TypeBuilder::Debugger::ExceptionDetails>*);
+    PassRefPtr<TypeBuilder::Runtime::RemoteObject> serializeRemoteObject(v8::Local<v8::Object>, V8JSONWriter::Client*) const;
 
 private:
     String m_name;
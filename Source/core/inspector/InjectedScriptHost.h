@@ -92,6 +92,8 @@ public:
     void unmonitorFunction(const String& scriptId, int lineNumber, int columnNumber);
 
     V8Debugger& debugger() { return *m_debugger; }
+    // False once the host has been disconnected.
+    bool hasDebugger() const { return m_debugger; }
     InjectedScriptHostClient* client() { return m_client.get(); }
 
     // FIXME: store this template in per isolate data
@@ -178,7 +178,7 @@ InjectedScript InjectedScriptManager::injectedScriptFor(ScriptState* inspectedSc
     int id = injectedScriptIdFor(inspectedScriptState);
     RefPtr<InjectedScriptNative> injectedScriptNative = adoptRef(new InjectedScriptNative(inspectedScriptState->isolate()));
     ScriptValue injectedScriptValue = createInjectedScript(injectedScriptSource(), inspectedScriptState, id, injectedScriptNative.get());
-    InjectedScript result(injectedScriptValue, m_inspectedStateAccessCheck, injectedScriptNative.release());
+    InjectedScript result(injectedScriptValue, m_inspectedStateAccessCheck, injectedScriptNative.release(), m_injectedScriptHost.get());
     if (m_customObjectFormatterEnabled)
         result.setCustomObjectFormatterEnabled(m_customObjectFormatterEnabled);
     m_idToInjectedScript.set(id, result);
@@ -274,6 +274,48 @@ InjectedScript.primitiveTypes = {
     __proto__: null
 }
 
+/**
+ * Time a paged getProperties call may spend before it returns a continuation token.
+ * @type {number}
+ * @const
+ */
+InjectedScript.GetPropertiesTimeBudgetMs = 50;
+
+/**
+ * The part of a property name a continuation token keeps to recognize it.
+ * @param {string} name
+ * @return {string}
+ */
+InjectedScript._continuationName = function(name)
+{
+    return name.substr(0, 64);
+}
+
+/**
+ * Lists the own elements of |object| in [fromIndex, toIndex) in the format of
+ * InjectedScriptHost.indexedDataProperties(), for array-like objects that it
+ * does not handle. All elements are reported as accessors, so that their
+ * descriptors are taken.
+ * @param {!Object} object
+ * @param {number} fromIndex
+ * @param {number} toIndex
+ * @param {number} maxCount
+ * @return {!Array.<*>}
+ */
+InjectedScript._ownIndexedProperties = function(object, fromIndex, toIndex, maxCount)
+{
+    var slice = [0];
+    var index = fromIndex;
+    for (var count = 0; index < toIndex && count < maxCount; ++index) {
+        if (!InjectedScriptHost.suppressWarningsAndCallFunction(Object.prototype.hasOwnProperty, object, ["" + index]))
+            continue;
+        push(slice, index, undefined, -1);
+        ++count;
+    }
+    slice[0] = index;
+    return slice;
+}
+
 InjectedScript.prototype = {
     /**
      * @param {*} object
@@ -435,9 +477,14 @@ InjectedScript.prototype = {
      * @param {boolean} ownProperties
      * @param {boolean} accessorPropertiesOnly
      * @param {boolean} generatePreview
-     * @return {!Array.<!RuntimeAgent.PropertyDescriptor>|boolean}
+     * @param {number} fromIndex
+     * @param {number} toIndex Negative for the end of the array.
+     * @param {boolean} nonIndexedPropertiesOnly
+     * @param {number} maxProperties Zero for no limit.
+     * @param {string} continuationToken
+     * @return {!{properties: !Array.<!RuntimeAgent.PropertyDescriptor>, continuationToken: (string|undefined)}|string|boolean}
      */
-    getProperties: function(objectId, ownProperties, accessorPropertiesOnly, generatePreview)
+    getProperties: function(objectId, ownProperties, accessorPropertiesOnly, generatePreview, fromIndex, toIndex, nonIndexedPropertiesOnly, maxProperties, continuationToken)
     {
         var parsedObjectId = this._parseObjectId(objectId);
         var object = this._objectForId(parsedObjectId);
@@ -446,25 +493,129 @@ InjectedScript.prototype = {
         if (!this._isDefined(object) || isSymbol(object))
             return false;
         object = /** @type {!Object} */ (object);
+
+        var isArray = InjectedScriptHost.subtype(object) === "array";
+        var rangeRequested = isArray && (fromIndex >= 0 || toIndex >= 0);
+        fromIndex = max(fromIndex, 0);
+        var length = 0;
+        if (isArray) {
+            try {
+                length = object.length >>> 0;
+            } catch (e) {
+            }
+        }
+
+        // Array elements are listed first, apart from the other properties,
+        // whose walk then leaves out the element names. Objects whose elements
+        // cannot be listed natively have all their names walked instead.
+        var skipElementNames = isArray && !accessorPropertiesOnly;
+
+        // The token is "i<next index>:<array length>" while walking array
+        // elements and "n<property names already visited>:<next name>" once
+        // past them, or "a<...>:<...>" if that walk includes element names.
+        // The length and the name tell whether the object changed in a way
+        // that would make the position point elsewhere.
+        var inElements = true;
+        var namedCursor = null;
+        if (continuationToken) {
+            var separator = continuationToken.indexOf(":");
+            var position = parseInt(continuationToken.substring(1, separator), 10);
+            var check = continuationToken.substr(separator + 1);
+            var kind = continuationToken[0];
+            if (separator < 0 || !isUInt32(position) || (kind !== "i" && kind !== "n" && kind !== "a"))
+                return "Invalid continuation token";
+            inElements = kind === "i";
+            if (inElements) {
+                if (check !== "" + length)
+                    return "Object changed since the continuation token was issued";
+                fromIndex = max(fromIndex, position);
+            } else {
+                namedCursor = { position: 0, skip: position, expectedName: check, mismatch: false, __proto__: null };
+                skipElementNames = skipElementNames && kind === "n";
+            }
+        }
+        if (!namedCursor)
+            namedCursor = { position: 0, skip: 0, expectedName: "", mismatch: false, __proto__: null };
+        var paged = maxProperties > 0 || !!continuationToken;
+        var limit = maxProperties > 0 ? maxProperties : Infinity;
+        var deadline = paged ? InjectedScriptHost.monotonicTime() + InjectedScript.GetPropertiesTimeBudgetMs : Infinity;
         var descriptors = [];
-        var iter = this._propertyDescriptors(object, ownProperties, accessorPropertiesOnly);
-        // Go over properties, wrap object values.
-        for (var descriptor of iter) {
+
+        /**
+         * @param {!Object} descriptor
+         */
+        function wrapAndPush(descriptor)
+        {
             if ("get" in descriptor)
-                descriptor.get = this._wrapObject(descriptor.get, objectGroupName);
+                descriptor.get = injectedScript._wrapObject(descriptor.get, objectGroupName);
             if ("set" in descriptor)
-                descriptor.set = this._wrapObject(descriptor.set, objectGroupName);
+                descriptor.set = injectedScript._wrapObject(descriptor.set, objectGroupName);
             if ("value" in descriptor)
-                descriptor.value = this._wrapObject(descriptor.value, objectGroupName, false, generatePreview);
+                descriptor.value = injectedScript._wrapObject(descriptor.value, objectGroupName, false, generatePreview);
             if (!("configurable" in descriptor))
                 descriptor.configurable = false;
             if (!("enumerable" in descriptor))
                 descriptor.enumerable = false;
             if ("symbol" in descriptor)
-                descriptor.symbol = this._wrapObject(descriptor.symbol, objectGroupName);
+                descriptor.symbol = injectedScript._wrapObject(descriptor.symbol, objectGroupName);
             push(descriptors, descriptor);
         }
-        return descriptors;
+
+        // Array, typed array and arguments elements are listed natively, a
+        // bounded slice at a time, instead of going through the descriptor
+        // generator.
+        if (skipElementNames && inElements && !nonIndexedPropertiesOnly) {
+            var end = toIndex >= 0 && toIndex < length ? toIndex : length;
+            var index = fromIndex;
+            while (index < end) {
+                var budget = max(deadline - InjectedScriptHost.monotonicTime(), 0);
+                var count = limit === Infinity ? end - index : limit - descriptors.length;
+                var slice = InjectedScriptHost.indexedDataProperties(object, index, end, count, budget);
+                if (!slice) {
+                    if (rangeRequested) {
+                        slice = InjectedScript._ownIndexedProperties(object, index, end, count);
+                    } else if (continuationToken) {
+                        return "Object changed since the continuation token was issued";
+                    } else {
+                        skipElementNames = false;
+                        break;
+                    }
+                }
+                index = slice[0];
+                for (var i = 1; i < slice.length; i += 3) {
+                    var name = "" + slice[i];
+                    var attributes = slice[i + 2];
+                    var descriptor;
+                    if (attributes < 0) {
+                        // Accessor element: take its descriptor without calling it.
+                        descriptor = nullifyObjectProto(InjectedScriptHost.suppressWarningsAndCallFunction(Object.getOwnPropertyDescriptor, Object, [object, name]));
+                        if (!descriptor)
+                            continue;
+                    } else {
+                        descriptor = { value: slice[i + 1], writable: !(attributes & 1), enumerable: !(attributes & 2), configurable: !(attributes & 4), __proto__: null };
+                    }
+                    descriptor.name = name;
+                    descriptor.isOwn = true;
+                    wrapAndPush(descriptor);
+                }
+                if (index < end && (descriptors.length >= limit || InjectedScriptHost.monotonicTime() >= deadline))
+                    return { properties: descriptors, continuationToken: "i" + index + ":" + length, __proto__: null };
+            }
+        }
+        // An index range selects one bucket of elements and nothing else.
+        if (rangeRequested && skipElementNames)
+            return { properties: descriptors, __proto__: null };
+
+        for (var descriptor of this._propertyDescriptors(object, ownProperties, accessorPropertiesOnly, undefined, skipElementNames, namedCursor)) {
+            // Each visited name yields at most one descriptor, so resuming
+            // at this one skips the names before it.
+            if (descriptors.length >= limit || (descriptors.length && !(descriptors.length % 64) && InjectedScriptHost.monotonicTime() >= deadline))
+                return { properties: descriptors, continuationToken: (skipElementNames ? "n" : "a") + (namedCursor.position - 1) + ":" + InjectedScript._continuationName(descriptor.name), __proto__: null };
+            wrapAndPush(descriptor);
+        }
+        if (namedCursor.mismatch)
+            return "Object changed since the continuation token was issued";
+        return { properties: descriptors, __proto__: null };
     },
 
     /**
@@ -564,11 +715,34 @@ InjectedScript.prototype = {
      * @param {boolean=} ownProperties
      * @param {boolean=} accessorPropertiesOnly
      * @param {?Array.<string>=} propertyNamesOnly
+     * @param {boolean=} skipElementNames Leave out the array index names of |object| itself.
+     * @param {?{position: number, skip: number, expectedName: string, mismatch: boolean}=} cursor Counts the property names visited, and skips the first |skip| of them.
      */
-    _propertyDescriptors: function*(object, ownProperties, accessorPropertiesOnly, propertyNamesOnly)
+    _propertyDescriptors: function*(object, ownProperties, accessorPropertiesOnly, propertyNamesOnly, skipElementNames, cursor)
     {
         var propertyProcessed = { __proto__: null };
 
+        /**
+         * Counts |name| in |cursor| and tells whether it is one of the names
+         * to skip, without building its descriptor. Checks that the first
+         * name not skipped is the one the cursor expects.
+         * @param {string} name
+         * @return {boolean}
+         */
+        function skipName(name)
+        {
+            if (!cursor)
+                return false;
+            var position = cursor.position++;
+            if (position < cursor.skip)
+                return true;
+            if (position === cursor.skip && cursor.skip && InjectedScript._continuationName(name) !== cursor.expectedName) {
+                cursor.mismatch = true;
+                return true;
+            }
+            return cursor.mismatch;
+        }
+
         /**
          * @param {?Object} o
          * @param {!Iterable.<string|symbol>|!Array.<string|symbol>} properties
@@ -578,10 +752,16 @@ InjectedScript.prototype = {
             for (var property of properties) {
                 if (propertyProcessed[property])
                     continue;
+                if (skipElementNames && o === object && typeof property === "string" && isUInt32(property))
+                    continue;
 
                 var name = property;
                 if (isSymbol(property))
                     name = /** @type {string} */ (injectedScript._describe(property));
+                if (skipName(name)) {
+                    propertyProcessed[property] = true;
+                    continue;
+                }
 
                 try {
                     propertyProcessed[property] = true;
@@ -659,8 +839,10 @@ InjectedScript.prototype = {
         for (var o = object; this._isDefined(o); o = o.__proto__) {
             if (skipGetOwnPropertyNames && o === object) {
                 // Avoid OOM crashes from getting all own property names of a large TypedArray.
-                for (var descriptor of process(o, arrayIndexNames(o.length)))
-                    yield descriptor;
+                if (!skipElementNames) {
+                    for (var descriptor of process(o, arrayIndexNames(o.length)))
+                        yield descriptor;
+                }
             } else {
                 // First call Object.keys() to enforce ordering of the property descriptors.
                 for (var descriptor of process(o, Object.keys(/** @type {!Object} */ (o))))
@@ -673,7 +855,7 @@ InjectedScript.prototype = {
                     yield descriptor;
             }
             if (ownProperties) {
-                if (object.__proto__ && !accessorPropertiesOnly)
+                if (object.__proto__ && !accessorPropertiesOnly && !skipName("__proto__"))
                     yield { name: "__proto__", value: object.__proto__, writable: true, configurable: true, enumerable: false, isOwn: true, __proto__: null };
                 break;
             }
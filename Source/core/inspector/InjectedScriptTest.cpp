@@ -0,0 +1,194 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/inspector/InjectedScript.h"
+
+#include "bindings/core/v8/ScriptState.h"
+#include "bindings/core/v8/ScriptValue.h"
+#include "bindings/core/v8/V8Binding.h"
+#include "core/inspector/InjectedScriptManager.h"
+#include "core/inspector/JSONParser.h"
+#include "platform/JSONValues.h"
+#include "wtf/text/StringBuilder.h"
+#include <gtest/gtest.h>
+
+namespace blink {
+namespace {
+
+const char kObjectChanged[] = "Object changed since the continuation token was issued";
+
+// InjectedScriptManager loads InjectedScriptSource.js relative to the current
+// directory, so these tests run from the top of the checkout.
+class InjectedScriptTest : public ::testing::Test {
+protected:
+    InjectedScriptTest()
+        : m_isolate(v8::Isolate::GetCurrent())
+        , m_context(v8::Context::New(m_isolate))
+        , m_contextScope(m_context)
+        , m_scriptState(ScriptState::create(m_context))
+        , m_manager(InjectedScriptManager::createForWorker())
+        , m_injectedScript(m_manager->injectedScriptFor(m_scriptState.get()))
+    {
+    }
+
+    ~InjectedScriptTest()
+    {
+        m_manager->disconnect();
+    }
+
+    String objectId(const char* source)
+    {
+        v8::Local<v8::Script> script = v8::Script::Compile(m_context, v8String(m_isolate, source)).ToLocalChecked();
+        ScriptValue value(m_scriptState.get(), script->Run(m_context));
+        RefPtr<TypeBuilder::Runtime::RemoteObject> remoteObject = m_injectedScript.wrapObject(value, "test");
+        String id;
+        remoteObject->openAccessors()->getString("objectId", &id);
+        return id;
+    }
+
+    void evaluate(const char* source)
+    {
+        v8::Script::Compile(m_context, v8String(m_isolate, source)).ToLocalChecked()->Run(m_context).ToLocalChecked();
+    }
+
+    // Appends the names of one page of own properties to |names|. Returns the
+    // error, if any, and sets |continuationToken| to the one returned, or to
+    // the null string.
+    String getPage(const String& objectId, const InjectedScript::PropertyPage& page, StringBuilder* names, String* continuationToken)
+    {
+        ErrorString error;
+        RefPtr<JSONValue> result;
+        RefPtr<TypeBuilder::Debugger::ExceptionDetails> exceptionDetails;
+        TypeBuilder::OptOutput<String> nextToken;
+        m_injectedScript.getProperties(&error, objectId, true, false, false, page, &result, &exceptionDetails, &nextToken);
+        *continuationToken = nextToken.isAssigned() ? nextToken.getValue() : String();
+        if (!error.isEmpty())
+            return error;
+        EXPECT_FALSE(exceptionDetails);
+        RefPtr<JSONArray> descriptors = parseJSON(result->toJSONString())->asArray();
+        for (size_t i = 0; i < descriptors->length(); ++i) {
+            String name;
+            EXPECT_TRUE(descriptors->get(i)->asObject()->getString("name", &name));
+            if (!names->isEmpty())
+                names->append(',');
+            names->append(name);
+        }
+        return String();
+    }
+
+    // Returns the own property names of the object, fetched |maxProperties|
+    // at a time.
+    String allNames(const String& objectId, int maxProperties)
+    {
+        InjectedScript::PropertyPage page;
+        page.maxProperties = maxProperties;
+        StringBuilder names;
+        for (int pages = 0; pages < 100; ++pages) {
+            String error = getPage(objectId, page, &names, &page.continuationToken);
+            EXPECT_EQ(String(), error);
+            if (!error.isNull() || page.continuationToken.isNull())
+                return names.toString();
+        }
+        ADD_FAILURE() << "getProperties kept returning continuation tokens";
+        return names.toString();
+    }
+
+    String range(const String& objectId, int fromIndex, int toIndex)
+    {
+        InjectedScript::PropertyPage page;
+        page.fromIndex = fromIndex;
+        page.toIndex = toIndex;
+        StringBuilder names;
+        String continuationToken;
+        EXPECT_EQ(String(), getPage(objectId, page, &names, &continuationToken));
+        EXPECT_TRUE(continuationToken.isNull());
+        return names.toString();
+    }
+
+    v8::Isolate* m_isolate;
+    v8::Local<v8::Context> m_context;
+    v8::Context::Scope m_contextScope;
+    RefPtr<ScriptState> m_scriptState;
+    OwnPtrWillBePersistent<InjectedScriptManager> m_manager;
+    InjectedScript m_injectedScript;
+};
+
+TEST_F(InjectedScriptTest, ArrayPagesCoverAllProperties)
+{
+    String id = objectId("var a = [0, 1, 2, 3, 4, 5, 6]; a.x = 1; a");
+    EXPECT_EQ("0,1,2,3,4,5,6,x,length,__proto__", allNames(id, 0));
+    EXPECT_EQ(allNames(id, 0), allNames(id, 3));
+    EXPECT_EQ(allNames(id, 0), allNames(id, 1));
+}
+
+TEST_F(InjectedScriptTest, ArgumentsPagesCoverAllProperties)
+{
+    String id = objectId("(function() { return arguments; })(0, 1, 2, 3, 4)");
+    String names = allNames(id, 0);
+    EXPECT_TRUE(names.startsWith("0,1,2,3,4,length,"));
+    EXPECT_EQ(names, allNames(id, 2));
+    EXPECT_EQ(names, allNames(id, 1));
+}
+
+TEST_F(InjectedScriptTest, PlainObjectPagesCoverAllProperties)
+{
+    String id = objectId("({a: 1, b: 2, c: 3, 0: 4})");
+    EXPECT_EQ("0,a,b,c,__proto__", allNames(id, 0));
+    EXPECT_EQ(allNames(id, 0), allNames(id, 2));
+}
+
+TEST_F(InjectedScriptTest, RangeSelectsElementsOnly)
+{
+    String arrayId = objectId("var a = [0, 1, 2, 3, 4, 5]; a.x = 1; a");
+    EXPECT_EQ("2,3,4", range(arrayId, 2, 5));
+    EXPECT_EQ("4,5", range(arrayId, 4, -1));
+    EXPECT_EQ("0,1", range(arrayId, -1, 2));
+
+    String argumentsId = objectId("(function() { return arguments; })(0, 1, 2, 3, 4, 5)");
+    EXPECT_EQ("2,3,4", range(argumentsId, 2, 5));
+
+    String typedArrayId = objectId("new Uint8Array(6)");
+    EXPECT_EQ("2,3,4", range(typedArrayId, 2, 5));
+}
+
+TEST_F(InjectedScriptTest, ChangedArrayInvalidatesElementToken)
+{
+    String id = objectId("var a = [0, 1, 2, 3, 4]; a");
+    InjectedScript::PropertyPage page;
+    page.maxProperties = 2;
+    StringBuilder names;
+    EXPECT_EQ(String(), getPage(id, page, &names, &page.continuationToken));
+    EXPECT_EQ("0,1", names.toString());
+    ASSERT_TRUE(page.continuationToken.startsWith("i"));
+
+    evaluate("a.push(5)");
+    EXPECT_EQ(kObjectChanged, getPage(id, page, &names, &page.continuationToken));
+}
+
+TEST_F(InjectedScriptTest, ChangedObjectInvalidatesNameToken)
+{
+    String id = objectId("var o = {a: 1, b: 2, c: 3}; o");
+    InjectedScript::PropertyPage page;
+    page.maxProperties = 1;
+    StringBuilder names;
+    EXPECT_EQ(String(), getPage(id, page, &names, &page.continuationToken));
+    EXPECT_EQ("a", names.toString());
+    ASSERT_FALSE(page.continuationToken.isNull());
+
+    evaluate("delete o.b");
+    EXPECT_EQ(kObjectChanged, getPage(id, page, &names, &page.continuationToken));
+}
+
+TEST_F(InjectedScriptTest, InvalidContinuationToken)
+{
+    String id = objectId("[1, 2, 3]");
+    InjectedScript::PropertyPage page;
+    page.continuationToken = "x1:3";
+    StringBuilder names;
+    EXPECT_EQ("Invalid continuation token", getPage(id, page, &names, &page.continuationToken));
+}
+
+} // namespace
+} // namespace blink
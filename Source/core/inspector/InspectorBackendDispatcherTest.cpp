@@ -0,0 +1,190 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/InspectorBackendDispatcher.h"
+
+#include "core/inspector/InspectorFrontendChannel.h"
+#include "platform/JSONValues.h"
+#include "wtf/text/StringBuilder.h"
+#include <gtest/gtest.h>
+
+namespace blink {
+namespace {
+
+// Responses are recorded as "id" for results and "id:code" for errors;
+// batches as their responses joined with commas.
+class TestChannel final : public InspectorFrontendChannel {
+public:
+    void sendProtocolResponse(int, PassRefPtr<JSONObject> message) override
+    {
+        m_messages.append(describe(message.get()));
+    }
+    void sendProtocolResponses(PassRefPtr<JSONArray> messages) override
+    {
+        StringBuilder batch;
+        batch.append('[');
+        for (size_t i = 0; i < messages->length(); ++i) {
+            if (i)
+                batch.append(',');
+            batch.append(describe(messages->get(i)->asObject().get()));
+        }
+        batch.append(']');
+        m_messages.append(batch.toString());
+    }
+    void sendProtocolNotification(PassRefPtr<JSONObject>) override { }
+    void flush() override { }
+
+    static String describe(JSONObject* message)
+    {
+        int id = -1;
+        message->getNumber("id", &id);
+        RefPtr<JSONObject> error = message->getObject("error");
+        if (!error)
+            return String::number(id);
+        int code = 0;
+        error->getNumber("code", &code);
+        return String::number(id) + ":" + String::number(code);
+    }
+
+    Vector<String> m_messages;
+};
+
+// stopTrackingGC dispatches |m_nestedMessage|, like a command that pauses and
+// runs a nested message loop.
+class TestMemoryHandler final : public InspectorBackendDispatcher::MemoryCommandHandler {
+public:
+    TestMemoryHandler() : m_dispatcher(nullptr) { }
+
+    void getDOMCounters(ErrorString*, int* documents, int* nodes, int* jsEventListeners) override
+    {
+        *documents = 1;
+        *nodes = 2;
+        *jsEventListeners = 3;
+    }
+    void startTrackingGC(ErrorString* error, const int* historySize) override
+    {
+        if (historySize && *historySize < 0)
+            *error = "historySize is out of range";
+    }
+    void stopTrackingGC(ErrorString*) override
+    {
+        if (!m_nestedMessage.isEmpty())
+            m_dispatcher->dispatch(m_nestedMessage);
+    }
+    void getGCStatistics(ErrorString*, const bool*, RefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCPauseSummary>>& summaries, RefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCEvent>>&) override
+    {
+        summaries = TypeBuilder::Array<TypeBuilder::Memory::GCPauseSummary>::create();
+    }
+
+    InspectorBackendDispatcher* m_dispatcher;
+    String m_nestedMessage;
+};
+
+class InspectorBackendDispatcherTest : public ::testing::Test {
+protected:
+    InspectorBackendDispatcherTest()
+        : m_dispatcher(InspectorBackendDispatcher::create(&m_channel))
+    {
+        m_dispatcher->registerAgent(&m_handler);
+        m_handler.m_dispatcher = m_dispatcher.get();
+    }
+
+    ~InspectorBackendDispatcherTest()
+    {
+        m_dispatcher->clearFrontend();
+    }
+
+    String messages() const
+    {
+        StringBuilder builder;
+        for (size_t i = 0; i < m_channel.m_messages.size(); ++i) {
+            if (i)
+                builder.append(' ');
+            builder.append(m_channel.m_messages[i]);
+        }
+        return builder.toString();
+    }
+
+    TestChannel m_channel;
+    TestMemoryHandler m_handler;
+    RefPtrWillBePersistent<InspectorBackendDispatcher> m_dispatcher;
+};
+
+TEST_F(InspectorBackendDispatcherTest, SingleCommandIsAnsweredOnItsOwn)
+{
+    m_dispatcher->dispatch("{\"id\":1,\"method\":\"Memory.getDOMCounters\"}");
+    m_dispatcher->dispatch("{\"id\":2,\"method\":\"Memory.noSuchCommand\"}");
+    EXPECT_EQ("1 2:-32601", messages());
+}
+
+TEST_F(InspectorBackendDispatcherTest, BatchIsAnsweredWithOneArray)
+{
+    m_dispatcher->dispatch(
+        "[{\"id\":1,\"method\":\"Memory.getDOMCounters\"},"
+        "{\"id\":2,\"method\":\"Memory.stopTrackingGC\"},"
+        "{\"id\":3,\"method\":\"Memory.getGCStatistics\"}]");
+    EXPECT_EQ("[1,2,3]", messages());
+}
+
+TEST_F(InspectorBackendDispatcherTest, ErrorsInsideBatchKeepTheirPlace)
+{
+    m_dispatcher->dispatch(
+        "[{\"id\":1,\"method\":\"Memory.noSuchCommand\"},"
+        "{\"id\":2,\"method\":\"Memory.startTrackingGC\",\"params\":{\"historySize\":\"many\"}},"
+        "{\"id\":3,\"method\":\"Memory.startTrackingGC\",\"params\":{\"historySize\":-1}},"
+        "1,"
+        "{\"id\":4,\"method\":\"Memory.getDOMCounters\"}]");
+    EXPECT_EQ("[1:-32601,2:-32602,3:-32000,0:-32600,4]", messages());
+}
+
+TEST_F(InspectorBackendDispatcherTest, NestedBatchIsAnsweredBeforeTheOuterOne)
+{
+    m_handler.m_nestedMessage =
+        "[{\"id\":10,\"method\":\"Memory.getDOMCounters\"},"
+        "{\"id\":11,\"method\":\"Memory.noSuchCommand\"}]";
+    m_dispatcher->dispatch(
+        "[{\"id\":1,\"method\":\"Memory.stopTrackingGC\"},"
+        "{\"id\":2,\"method\":\"Memory.getDOMCounters\"}]");
+    EXPECT_EQ("[10,11:-32601] [1,2]", messages());
+}
+
+TEST_F(InspectorBackendDispatcherTest, NestedCommandIsNotPartOfTheBatch)
+{
+    m_handler.m_nestedMessage = "{\"id\":10,\"method\":\"Memory.getDOMCounters\"}";
+    m_dispatcher->dispatch(
+        "[{\"id\":1,\"method\":\"Memory.stopTrackingGC\"},"
+        "{\"id\":2,\"method\":\"Memory.getDOMCounters\"}]");
+    EXPECT_EQ("10 [1,2]", messages());
+}
+
+TEST_F(InspectorBackendDispatcherTest, BatchWithoutResponsesSendsNothing)
+{
+    m_dispatcher->dispatch("[]");
+    EXPECT_EQ("", messages());
+}
+
+TEST(InspectorBackendDispatcherCommandTest, FindsEveryCommand)
+{
+    for (int i = 0; i < InspectorBackendDispatcher::kMethodNamesEnumSize; ++i) {
+        InspectorBackendDispatcher::MethodNames method = static_cast<InspectorBackendDispatcher::MethodNames>(i);
+        InspectorBackendDispatcher::MethodNames found;
+        ASSERT_TRUE(InspectorBackendDispatcher::findCommand(InspectorBackendDispatcher::commandName(method), &found)) << InspectorBackendDispatcher::commandName(method);
+        EXPECT_EQ(method, found);
+    }
+}
+
+TEST(InspectorBackendDispatcherCommandTest, RejectsUnknownCommands)
+{
+    InspectorBackendDispatcher::MethodNames found;
+    EXPECT_FALSE(InspectorBackendDispatcher::findCommand("", &found));
+    EXPECT_FALSE(InspectorBackendDispatcher::findCommand(String(), &found));
+    EXPECT_FALSE(InspectorBackendDispatcher::findCommand("Runtime.evaluat", &found));
+    EXPECT_FALSE(InspectorBackendDispatcher::findCommand("runtime.evaluate", &found));
+    const UChar nonASCII[] = { 'R', 'u', 'n', 't', 'i', 'm', 'e', '.', 0x00e9, 0 };
+    EXPECT_FALSE(InspectorBackendDispatcher::findCommand(String(nonASCII), &found));
+}
+
+} // namespace
+} // namespace blink
@@ -47,6 +47,7 @@
 #include "core/inspector/ScriptCallFrame.h"
 #include "core/inspector/ScriptCallStack.h"
 #include "core/inspector/V8AsyncCallTracker.h"
+#include "core/inspector/V8InspectorIsolateData.h"
 #include "platform/JSONValues.h"
 #include "wtf/text/StringBuilder.h"
 #include "wtf/text/WTFString.h"
@@ -60,6 +61,7 @@ using blink::TypeBuilder::Debugger::CollectionEntry;
 using blink::TypeBuilder::Debugger::ExceptionDetails;
 using blink::TypeBuilder::Debugger::FunctionDetails;
 using blink::TypeBuilder::Debugger::GeneratorObjectDetails;
+using blink::TypeBuilder::Debugger::PromiseCreationSite;
 using blink::TypeBuilder::Debugger::PromiseDetails;
 using blink::TypeBuilder::Debugger::ScriptId;
 using blink::TypeBuilder::Debugger::StackTrace;
@@ -74,6 +76,7 @@ static const char pauseOnExceptionsState[] = "pauseOnExceptionsState";
 static const char asyncCallStackDepth[] = "asyncCallStackDepth";
 static const char promiseTrackerEnabled[] = "promiseTrackerEnabled";
 static const char promiseTrackerCaptureStacks[] = "promiseTrackerCaptureStacks";
+static const char promiseTrackerCensus[] = "promiseTrackerCensus";
 
 // Breakpoint properties.
 static const char url[] = "url";
@@ -88,6 +91,7 @@ static const char skipAllPauses[] = "skipAllPauses";
 };
 
 static const int maxSkipStepFrameCount = 128;
+static const int defaultLongPendingPromisesCount = 100;
 
 const char InspectorDebuggerAgent::backtraceObjectGroup[] = "backtrace";
 
@@ -120,18 +124,18 @@ static ScriptCallFrame toScriptCallFrame(JavaScriptCallFrame* callFrame)
     return ScriptCallFrame(callFrame->functionName(), scriptId, callFrame->scriptName(), line, column);
 }
 
-static PassRefPtrWillBeRawPtr<ScriptCallStack> toScriptCallStack(JavaScriptCallFrame* callFrame)
+static PassRefPtrWillBeRawPtr<ScriptCallStack> toScriptCallStack(v8::Isolate* isolate, JavaScriptCallFrame* callFrame)
 {
     Vector<ScriptCallFrame> frames;
     for (; callFrame; callFrame = callFrame->caller())
         frames.append(toScriptCallFrame(callFrame));
-    return ScriptCallStack::create(frames);
+    return ScriptCallStack::create(V8InspectorIsolateData::from(isolate)->callFrameTable(), frames);
 }
 
-static PassRefPtrWillBeRawPtr<ScriptCallStack> toScriptCallStack(const ScriptValue& callFrames)
+static PassRefPtrWillBeRawPtr<ScriptCallStack> toScriptCallStack(v8::Isolate* isolate, const ScriptValue& callFrames)
 {
     RefPtrWillBeRawPtr<JavaScriptCallFrame> jsCallFrame = V8Debugger::toJavaScriptCallFrameUnsafe(callFrames);
-    return jsCallFrame ? toScriptCallStack(jsCallFrame.get()) : nullptr;
+    return jsCallFrame ? toScriptCallStack(isolate, jsCallFrame.get()) : nullptr;
 }
 
 InspectorDebuggerAgent::InspectorDebuggerAgent(InjectedScriptManager* injectedScriptManager, v8::Isolate* isolate)
@@ -160,17 +164,22 @@ InspectorDebuggerAgent::InspectorDebuggerAgent(InjectedScriptManager* injectedSc
     , m_pendingTraceAsyncOperationCompleted(false)
     , m_startingStepIntoAsync(false)
     , m_compiledScripts(isolate)
+    , m_lastSearchId(0)
+    , m_searchInspectorThread(nullptr)
+    , m_searchBackgroundThread(nullptr)
 {
     m_v8AsyncCallTracker = V8AsyncCallTracker::create(this);
 }
 
 InspectorDebuggerAgent::~InspectorDebuggerAgent()
 {
+    cancelAllSearches();
 }
 
 void InspectorDebuggerAgent::init()
 {
     m_promiseTracker = PromiseTracker::create(this, debugger().isolate());
+    m_promiseTracker->setInspectorThread(m_searchInspectorThread);
     // FIXME: make breakReason optional so that there was no need to init it with "other".
     clearBreakDetails();
     m_state->setLong(DebuggerAgentState::pauseOnExceptionsState, V8Debugger::DontPauseOnExceptions);
@@ -205,6 +214,7 @@ void InspectorDebuggerAgent::disable()
     m_state->setBoolean(DebuggerAgentState::promiseTrackerEnabled, false);
 
     stopListeningV8Debugger();
+    cancelAllSearches();
     clear();
 
     if (m_listener)
@@ -279,7 +289,7 @@ void InspectorDebuggerAgent::restore()
         m_skipContentScripts = m_state->getBoolean(DebuggerAgentState::skipContentScripts);
         m_skipAllPauses = m_state->getBoolean(DebuggerAgentState::skipAllPauses);
         internalSetAsyncCallStackDepth(m_state->getLong(DebuggerAgentState::asyncCallStackDepth));
-        promiseTracker().setEnabled(m_state->getBoolean(DebuggerAgentState::promiseTrackerEnabled), m_state->getBoolean(DebuggerAgentState::promiseTrackerCaptureStacks));
+        promiseTracker().setEnabled(m_state->getBoolean(DebuggerAgentState::promiseTrackerEnabled), m_state->getBoolean(DebuggerAgentState::promiseTrackerCaptureStacks), m_state->getBoolean(DebuggerAgentState::promiseTrackerCensus));
     }
 }
 
@@ -301,6 +311,14 @@ bool InspectorDebuggerAgent::isPaused()
     return debugger().isPaused();
 }
 
+void InspectorDebuggerAgent::setSearchThreads(WebThread* inspectorThread, WebThread* backgroundThread)
+{
+    m_searchInspectorThread = inspectorThread;
+    m_searchBackgroundThread = backgroundThread;
+    if (m_promiseTracker)
+        m_promiseTracker->setInspectorThread(inspectorThread);
+}
+
 static PassRefPtr<JSONObject> buildObjectForBreakpointCookie(const String& url, int lineNumber, int columnNumber, const String& condition, bool isRegex)
 {
     RefPtr<JSONObject> breakpointObject = JSONObject::create();
@@ -578,11 +596,81 @@ void InspectorDebuggerAgent::searchInContent(ErrorString* error, const String& s
 {
     ScriptsMap::iterator it = m_scripts.find(scriptId);
     if (it != m_scripts.end())
-        results = ContentSearchUtils::searchInTextByLines(it->value.source(), query, asBool(optionalCaseSensitive), asBool(optionalIsRegex));
+        results = ContentSearchUtils::searchInTextByLines(it->value.source(), *it->value.lineEndings(), query, asBool(optionalCaseSensitive), asBool(optionalIsRegex));
     else
         *error = "No script for id: " + scriptId;
 }
 
+void InspectorDebuggerAgent::searchInAllScripts(ErrorString* error, const String& query, const bool* const optionalCaseSensitive, const bool* const optionalIsRegex, const String* const optionalURLPattern, String* searchId)
+{
+    if (!checkEnabled(error))
+        return;
+
+    if (asBool(optionalIsRegex) && !ContentSearchUtils::createSearchRegex(query, asBool(optionalCaseSensitive), true)->isValid()) {
+        *error = "Invalid regular expression: " + query;
+        return;
+    }
+
+    if (!m_searchInspectorThread || !m_searchBackgroundThread) {
+        *error = "Search in all scripts is not supported";
+        return;
+    }
+
+    String id = String::number(m_lastSearchId + 1);
+    RefPtr<ScriptSearchJob> job = ScriptSearchJob::create(this, m_searchInspectorThread, m_searchBackgroundThread, id, query, asBool(optionalCaseSensitive), asBool(optionalIsRegex));
+    if (optionalURLPattern && !optionalURLPattern->isEmpty() && !job->setURLFilter(*optionalURLPattern)) {
+        *error = "Invalid URL pattern: " + *optionalURLPattern;
+        return;
+    }
+    ++m_lastSearchId;
+    *searchId = id;
+    for (auto& script : m_scripts) {
+        if (!script.value.isInternalScript())
+            job->addScript(script.key, script.value.sourceURL(), script.value.source(), script.value.cachedLineEndings());
+    }
+    m_searches.set(*searchId, job);
+    job->start();
+}
+
+void InspectorDebuggerAgent::cancelSearch(ErrorString* error, const String& searchId)
+{
+    RefPtr<ScriptSearchJob> job = m_searches.take(searchId);
+    if (!job) {
+        *error = "No search for id: " + searchId;
+        return;
+    }
+    job->cancel();
+    if (frontend())
+        frontend()->searchFinished(searchId, true);
+}
+
+void InspectorDebuggerAgent::cancelAllSearches()
+{
+    for (auto& search : m_searches)
+        search.value->cancel();
+    m_searches.clear();
+}
+
+void InspectorDebuggerAgent::didFindSearchResults(const String& searchId, PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::ScriptSearchResult>> results)
+{
+    if (frontend())
+        frontend()->searchResultsFound(searchId, results);
+}
+
+void InspectorDebuggerAgent::didFinishSearch(const String& searchId)
+{
+    m_searches.remove(searchId);
+    if (frontend())
+        frontend()->searchFinished(searchId, false);
+}
+
+void InspectorDebuggerAgent::didComputeLineEndings(const String& scriptId, const String& source, PassRefPtr<ContentSearchUtils::LineEndings> lineEndings)
+{
+    ScriptsMap::iterator it = m_scripts.find(scriptId);
+    if (it != m_scripts.end() && it->value.source().impl() == source.impl())
+        it->value.setLineEndings(lineEndings);
+}
+
 void InspectorDebuggerAgent::setScriptSource(ErrorString* error, RefPtr<TypeBuilder::Debugger::SetScriptSourceError>& errorData, const String& scriptId, const String& newContent, const bool* const preview, RefPtr<Array<CallFrame> >& newCallFrames, RefPtr<JSONObject>& result, RefPtr<StackTrace>& asyncStackTrace)
 {
     if (!checkEnabled(error))
@@ -850,7 +938,7 @@ void InspectorDebuggerAgent::setPauseOnExceptionsImpl(ErrorString* errorString,
         m_state->setLong(DebuggerAgentState::pauseOnExceptionsState, pauseState);
 }
 
-void InspectorDebuggerAgent::evaluateOnCallFrame(ErrorString* errorString, const String& callFrameId, const String& expression, const String* const objectGroup, const bool* const includeCommandLineAPI, const bool* const doNotPauseOnExceptionsAndMuteConsole, const bool* const returnByValue, const bool* generatePreview, RefPtr<RemoteObject>& result, TypeBuilder::OptOutput<bool>* wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>& exceptionDetails)
+void InspectorDebuggerAgent::evaluateOnCallFrame(ErrorString* errorString, const String& callFrameId, const String& expression, const String* const objectGroup, const bool* const includeCommandLineAPI, const bool* const doNotPauseOnExceptionsAndMuteConsole, const bool* const returnByValue, const bool* generatePreview, RefPtr<JSONValue>& result, TypeBuilder::OptOutput<bool>* wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>& exceptionDetails)
 {
     if (!isPaused() || m_currentCallStack.isEmpty()) {
         *errorString = "Attempt to access callframe when debugger is not on pause";
@@ -1033,13 +1121,14 @@ void InspectorDebuggerAgent::setAsyncCallStackDepth(ErrorString* errorString, in
     internalSetAsyncCallStackDepth(depth);
 }
 
-void InspectorDebuggerAgent::enablePromiseTracker(ErrorString* errorString, const bool* captureStacks)
+void InspectorDebuggerAgent::enablePromiseTracker(ErrorString* errorString, const bool* captureStacks, const bool* census)
 {
     if (!checkEnabled(errorString))
         return;
     m_state->setBoolean(DebuggerAgentState::promiseTrackerEnabled, true);
     m_state->setBoolean(DebuggerAgentState::promiseTrackerCaptureStacks, asBool(captureStacks));
-    promiseTracker().setEnabled(true, asBool(captureStacks));
+    m_state->setBoolean(DebuggerAgentState::promiseTrackerCensus, asBool(census));
+    promiseTracker().setEnabled(true, asBool(captureStacks), asBool(census));
 }
 
 void InspectorDebuggerAgent::disablePromiseTracker(ErrorString* errorString)
@@ -1047,7 +1136,7 @@ void InspectorDebuggerAgent::disablePromiseTracker(ErrorString* errorString)
     if (!checkEnabled(errorString))
         return;
     m_state->setBoolean(DebuggerAgentState::promiseTrackerEnabled, false);
-    promiseTracker().setEnabled(false, false);
+    promiseTracker().setEnabled(false, false, false);
 }
 
 void InspectorDebuggerAgent::getPromiseById(ErrorString* errorString, int promiseId, const String* objectGroup, RefPtr<RemoteObject>& promise)
@@ -1067,12 +1156,44 @@ void InspectorDebuggerAgent::getPromiseById(ErrorString* errorString, int promis
     promise = injectedScript.wrapObject(value, objectGroup ? *objectGroup : "");
 }
 
+void InspectorDebuggerAgent::getPromiseCensus(ErrorString* errorString, RefPtr<Array<PromiseCreationSite>>& sites)
+{
+    if (!checkEnabled(errorString))
+        return;
+    if (!promiseTracker().isCensusEnabled()) {
+        *errorString = "Promise census is disabled";
+        return;
+    }
+    sites = promiseTracker().census();
+}
+
+void InspectorDebuggerAgent::getLongPendingPromises(ErrorString* errorString, double minimumAge, const int* maxCount, RefPtr<Array<PromiseDetails>>& promises)
+{
+    if (!checkEnabled(errorString))
+        return;
+    if (!promiseTracker().isCensusEnabled()) {
+        *errorString = "Promise census is disabled";
+        return;
+    }
+    if (maxCount && *maxCount < 0) {
+        *errorString = "maxCount must not be negative";
+        return;
+    }
+    promises = promiseTracker().longPendingPromises(minimumAge, maxCount ? *maxCount : defaultLongPendingPromisesCount);
+}
+
 void InspectorDebuggerAgent::didUpdatePromise(InspectorFrontend::Debugger::EventType::Enum eventType, PassRefPtr<TypeBuilder::Debugger::PromiseDetails> promise)
 {
     if (frontend())
         frontend()->promiseUpdated(eventType, promise);
 }
 
+void InspectorDebuggerAgent::didUpdatePromiseCensus(PassRefPtr<Array<PromiseCreationSite>> sites)
+{
+    if (frontend())
+        frontend()->promiseCensusUpdated(sites);
+}
+
 int InspectorDebuggerAgent::traceAsyncOperationStarting(const String& description)
 {
     ScriptValue callFrames = debugger().currentCallFramesForAsyncStack();
@@ -1211,7 +1332,7 @@ void InspectorDebuggerAgent::flushAsyncOperationEvents(ErrorString*)
         RefPtr<AsyncOperation> operation;
         RefPtr<AsyncStackTrace> lastAsyncStackTrace;
         for (const auto& callStack : callStacks) {
-            RefPtrWillBeRawPtr<ScriptCallStack> scriptCallStack = toScriptCallStack(callStack->callFrames());
+            RefPtrWillBeRawPtr<ScriptCallStack> scriptCallStack = toScriptCallStack(debugger().isolate(), callStack->callFrames());
             if (!scriptCallStack)
                 break;
             if (!operation) {
@@ -1440,7 +1561,7 @@ PassRefPtrWillBeRawPtr<ScriptAsyncCallStack> InspectorDebuggerAgent::currentAsyn
         RefPtrWillBeRawPtr<JavaScriptCallFrame> callFrame = V8Debugger::toJavaScriptCallFrameUnsafe((*it)->callFrames());
         if (!callFrame)
             break;
-        result = ScriptAsyncCallStack::create((*it)->description(), toScriptCallStack(callFrame.get()), result.release());
+        result = ScriptAsyncCallStack::create((*it)->description(), toScriptCallStack(debugger().isolate(), callFrame.get()), result.release());
     }
     return result.release();
 }
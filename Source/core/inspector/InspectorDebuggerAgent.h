@@ -38,6 +38,7 @@
 #include "core/inspector/PromiseTracker.h"
 #include "core/inspector/ScriptBreakpoint.h"
 #include "core/inspector/ScriptDebugListener.h"
+#include "core/inspector/ScriptSearchJob.h"
 #include "wtf/Forward.h"
 #include "wtf/HashMap.h"
 #include "wtf/HashSet.h"
@@ -60,6 +61,7 @@ class ScriptRegexp;
 class ScriptSourceCode;
 class V8AsyncCallTracker;
 class V8Debugger;
+class WebThread;
 
 typedef String ErrorString;
 
@@ -67,7 +69,8 @@ class CORE_EXPORT InspectorDebuggerAgent
     : public InspectorBaseAgent<InspectorDebuggerAgent, InspectorFrontend::Debugger>
     , public ScriptDebugListener
     , public InspectorBackendDispatcher::DebuggerCommandHandler
-    , public PromiseTracker::Listener {
+    , public PromiseTracker::Listener
+    , public ScriptSearchJob::Client {
     WTF_MAKE_NONCOPYABLE(InspectorDebuggerAgent);
     WTF_MAKE_FAST_ALLOCATED_WILL_BE_REMOVED(InspectorDebuggerAgent);
 public:
@@ -89,6 +92,10 @@ public:
     void disable(ErrorString*) override final;
 
     bool isPaused();
+    // searchInAllScripts() is only available once these are set.
+    // |inspectorThread| is the thread the agent runs on; the promise census
+    // also posts its deferred reports there.
+    void setSearchThreads(WebThread* inspectorThread, WebThread* backgroundThread);
 
     // Part of the protocol.
     void enable(ErrorString*) override;
@@ -102,6 +109,8 @@ public:
     void getStepInPositions(ErrorString*, const String& callFrameId, RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::Location> >& positions) final;
     void getBacktrace(ErrorString*, RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::CallFrame> >&, RefPtr<TypeBuilder::Debugger::StackTrace>&) final;
     void searchInContent(ErrorString*, const String& scriptId, const String& query, const bool* optionalCaseSensitive, const bool* optionalIsRegex, RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::SearchMatch>>&) final;
+    void searchInAllScripts(ErrorString*, const String& query, const bool* optionalCaseSensitive, const bool* optionalIsRegex, const String* optionalURLPattern, String* searchId) final;
+    void cancelSearch(ErrorString*, const String& searchId) final;
     void setScriptSource(ErrorString*, RefPtr<TypeBuilder::Debugger::SetScriptSourceError>&, const String& scriptId, const String& newContent, const bool* preview, RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::CallFrame> >& newCallFrames, RefPtr<JSONObject>& result, RefPtr<TypeBuilder::Debugger::StackTrace>& asyncStackTrace) final;
     void restartFrame(ErrorString*, const String& callFrameId, RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::CallFrame> >& newCallFrames, RefPtr<JSONObject>& result, RefPtr<TypeBuilder::Debugger::StackTrace>& asyncStackTrace) final;
     void getScriptSource(ErrorString*, const String& scriptId, String* scriptSource) final;
@@ -123,7 +132,7 @@ public:
         const bool* doNotPauseOnExceptionsAndMuteConsole,
         const bool* returnByValue,
         const bool* generatePreview,
-        RefPtr<TypeBuilder::Runtime::RemoteObject>& result,
+        RefPtr<JSONValue>& result,
         TypeBuilder::OptOutput<bool>* wasThrown,
         RefPtr<TypeBuilder::Debugger::ExceptionDetails>&) final;
     void compileScript(ErrorString*, const String& expression, const String& sourceURL, bool persistScript, const int* executionContextId, TypeBuilder::OptOutput<TypeBuilder::Debugger::ScriptId>*, RefPtr<TypeBuilder::Debugger::ExceptionDetails>&) override;
@@ -131,9 +140,11 @@ public:
     void setVariableValue(ErrorString*, int in_scopeNumber, const String& in_variableName, const RefPtr<JSONObject>& in_newValue, const String* in_callFrame, const String* in_functionObjectId) final;
     void skipStackFrames(ErrorString*, const String* pattern, const bool* skipContentScripts) final;
     void setAsyncCallStackDepth(ErrorString*, int depth) final;
-    void enablePromiseTracker(ErrorString*, const bool* captureStacks) final;
+    void enablePromiseTracker(ErrorString*, const bool* captureStacks, const bool* census) final;
     void disablePromiseTracker(ErrorString*) final;
     void getPromiseById(ErrorString*, int promiseId, const String* objectGroup, RefPtr<TypeBuilder::Runtime::RemoteObject>& promise) final;
+    void getPromiseCensus(ErrorString*, RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::PromiseCreationSite>>& sites) final;
+    void getLongPendingPromises(ErrorString*, double minimumAge, const int* maxCount, RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::PromiseDetails>>& promises) final;
     void flushAsyncOperationEvents(ErrorString*) final;
     void setAsyncOperationBreakpoint(ErrorString*, int operationId) final;
     void removeAsyncOperationBreakpoint(ErrorString*, int operationId) final;
@@ -190,6 +201,12 @@ public:
 
     // PromiseTracker::Listener
     void didUpdatePromise(InspectorFrontend::Debugger::EventType::Enum, PassRefPtr<TypeBuilder::Debugger::PromiseDetails>) final;
+    void didUpdatePromiseCensus(PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::PromiseCreationSite>>) final;
+
+    // ScriptSearchJob::Client
+    void didFindSearchResults(const String& searchId, PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::ScriptSearchResult>>) final;
+    void didFinishSearch(const String& searchId) final;
+    void didComputeLineEndings(const String& scriptId, const String& source, PassRefPtr<ContentSearchUtils::LineEndings>) final;
 
 protected:
     InspectorDebuggerAgent(InjectedScriptManager*, v8::Isolate*);
@@ -239,6 +256,7 @@ private:
     void clearStepIntoAsync();
     bool assertPaused(ErrorString*);
     void clearBreakDetails();
+    void cancelAllSearches();
 
     String sourceMapURLForScript(const Script&, CompileResult);
 
@@ -304,6 +322,10 @@ private:
     bool m_startingStepIntoAsync;
     WillBeHeapVector<RawPtrWillBeMember<AsyncCallTrackingListener>> m_asyncCallTrackingListeners;
     V8GlobalValueMap<String, v8::Script, v8::kNotWeak> m_compiledScripts;
+    HashMap<String, RefPtr<ScriptSearchJob>> m_searches;
+    unsigned m_lastSearchId;
+    WebThread* m_searchInspectorThread;
+    WebThread* m_searchBackgroundThread;
 };
 
 } // namespace blink
@@ -35,6 +35,8 @@ class InspectorFrontendChannel {
 public:
     virtual ~InspectorFrontendChannel() { }
     virtual void sendProtocolResponse(int callId, PassRefPtr<JSONObject> message) = 0;
+    // Sends the responses to a batch of commands as one array message.
+    virtual void sendProtocolResponses(PassRefPtr<JSONArray> messages) = 0;
     virtual void sendProtocolNotification(PassRefPtr<JSONObject> message) = 0;
     virtual void flush() = 0;
 };
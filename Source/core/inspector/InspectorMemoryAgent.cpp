@@ -0,0 +1,218 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/inspector/InspectorMemoryAgent.h"
+
+#include "core/inspector/InspectorState.h"
+#include "public/platform/WebThread.h"
+#include "public/platform/WebTraceLocation.h"
+#include "wtf/Functional.h"
+#include "wtf/MathExtras.h"
+#include "wtf/Vector.h"
+#include <algorithm>
+#include <limits>
+
+namespace blink {
+
+namespace MemoryAgentState {
+static const char gcTrackingEnabled[] = "gcTrackingEnabled";
+static const char gcHistorySize[] = "gcHistorySize";
+};
+
+namespace {
+
+const int defaultGCHistorySize = 1000;
+const int maxGCHistorySize = 100000;
+
+const char* gcTypeName(v8::GCType type)
+{
+    return type == v8::kGCTypeScavenge ? "scavenge" : "mark-sweep";
+}
+
+// Nearest-rank percentile of an ascending list of pause times.
+double percentile(const Vector<double>& sortedPauses, double fraction)
+{
+    size_t rank = static_cast<size_t>(ceil(fraction * sortedPauses.size()));
+    return sortedPauses[rank ? rank - 1 : 0];
+}
+
+PassRefPtr<TypeBuilder::Memory::GCPauseSummary> buildPauseSummary(const char* type, Vector<double>& pauses)
+{
+    std::sort(pauses.begin(), pauses.end());
+    double total = 0;
+    for (double pause : pauses)
+        total += pause;
+    return TypeBuilder::Memory::GCPauseSummary::create()
+        .setType(type)
+        .setCount(pauses.size())
+        .setTotalPauseTime(total)
+        .setMedianPauseTime(pauses.isEmpty() ? 0 : percentile(pauses, 0.5))
+        .setP99PauseTime(pauses.isEmpty() ? 0 : percentile(pauses, 0.99))
+        .setMaxPauseTime(pauses.isEmpty() ? 0 : pauses.last())
+        .release();
+}
+
+} // namespace
+
+InspectorMemoryAgent::InspectorMemoryAgent(v8::Isolate* isolate, Client* client)
+    : InspectorBaseAgent<InspectorMemoryAgent, InspectorFrontend::Memory>("Memory")
+    , m_isolate(isolate)
+    , m_client(client)
+    , m_trackingGC(false)
+    , m_inspectorThread(nullptr)
+    , m_unreportedGCEvents(0)
+    , m_gcReportScheduled(false)
+    , m_weakPtrFactory(this)
+{
+}
+
+InspectorMemoryAgent::~InspectorMemoryAgent()
+{
+    m_client = nullptr;
+    stopTracking();
+}
+
+void InspectorMemoryAgent::getDOMCounters(ErrorString* errorString, int*, int*, int*)
+{
+    *errorString = "DOM counters are not available in this context";
+}
+
+void InspectorMemoryAgent::startTrackingGC(ErrorString* errorString, const int* historySize)
+{
+    int size = historySize ? *historySize : defaultGCHistorySize;
+    if (size <= 0 || size > maxGCHistorySize) {
+        *errorString = "historySize is out of range";
+        return;
+    }
+    startTracking(size);
+    m_state->setBoolean(MemoryAgentState::gcTrackingEnabled, true);
+    m_state->setLong(MemoryAgentState::gcHistorySize, size);
+}
+
+void InspectorMemoryAgent::stopTrackingGC(ErrorString*)
+{
+    stopTracking();
+    m_state->setBoolean(MemoryAgentState::gcTrackingEnabled, false);
+}
+
+void InspectorMemoryAgent::getGCStatistics(ErrorString*, const bool* includeEvents, RefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCPauseSummary>>& summaries, RefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCEvent>>& events)
+{
+    Vector<double> scavengePauses;
+    Vector<double> markSweepPauses;
+    size_t count = m_isolate->NumberOfGCEvents();
+    if (asBool(includeEvents))
+        events = TypeBuilder::Array<TypeBuilder::Memory::GCEvent>::create();
+    for (size_t i = 0; i < count; ++i) {
+        v8::GCEventStatistics statistics;
+        if (!m_isolate->GetGCEventStatistics(&statistics, i))
+            continue;
+        if (statistics.gc_type() == v8::kGCTypeScavenge)
+            scavengePauses.append(statistics.pause_duration());
+        else
+            markSweepPauses.append(statistics.pause_duration());
+        if (events)
+            events->addItem(buildGCEvent(i));
+    }
+    summaries = TypeBuilder::Array<TypeBuilder::Memory::GCPauseSummary>::create();
+    summaries->addItem(buildPauseSummary(gcTypeName(v8::kGCTypeScavenge), scavengePauses));
+    summaries->addItem(buildPauseSummary(gcTypeName(v8::kGCTypeMarkSweepCompact), markSweepPauses));
+}
+
+void InspectorMemoryAgent::disable(ErrorString*)
+{
+    stopTracking();
+    m_state->setBoolean(MemoryAgentState::gcTrackingEnabled, false);
+}
+
+void InspectorMemoryAgent::restore()
+{
+    if (m_state->getBoolean(MemoryAgentState::gcTrackingEnabled))
+        startTracking(m_state->getLong(MemoryAgentState::gcHistorySize, defaultGCHistorySize));
+}
+
+void InspectorMemoryAgent::onGCEvent(v8::Isolate* isolate, void* data)
+{
+    // Called from within the GC, so the reports are left to a posted task.
+    InspectorMemoryAgent* agent = static_cast<InspectorMemoryAgent*>(data);
+    ASSERT(agent->m_isolate == isolate);
+    ++agent->m_unreportedGCEvents;
+    if (!agent->m_inspectorThread || agent->m_gcReportScheduled)
+        return;
+    agent->m_gcReportScheduled = true;
+    agent->m_inspectorThread->postTask(BLINK_FROM_HERE, bind(&InspectorMemoryAgent::reportGCEvents, agent->m_weakPtrFactory.createWeakPtr()));
+}
+
+void InspectorMemoryAgent::reportGCEvents()
+{
+    m_gcReportScheduled = false;
+    size_t unreported = m_unreportedGCEvents;
+    m_unreportedGCEvents = 0;
+    if (!unreported || !m_trackingGC)
+        return;
+    if (m_client)
+        m_client->gcStatisticsChanged();
+    if (!frontend())
+        return;
+    // Older ones may have left the history already.
+    size_t count = m_isolate->NumberOfGCEvents();
+    for (size_t i = count - std::min(unreported, count); i < count; ++i)
+        frontend()->garbageCollected(buildGCEvent(i));
+}
+
+void InspectorMemoryAgent::startTracking(int historySize)
+{
+    m_isolate->SetGCHistorySize(historySize);
+    m_isolate->SetGCEventCallback(&InspectorMemoryAgent::onGCEvent, this);
+    m_trackingGC = true;
+    if (m_client)
+        m_client->gcStatisticsChanged();
+}
+
+void InspectorMemoryAgent::stopTracking()
+{
+    if (!m_trackingGC)
+        return;
+    m_isolate->SetGCEventCallback(nullptr);
+    m_isolate->SetGCHistorySize(0);
+    m_trackingGC = false;
+    m_unreportedGCEvents = 0;
+    if (m_client)
+        m_client->gcStatisticsChanged();
+}
+
+PassRefPtr<TypeBuilder::Memory::GCEvent> InspectorMemoryAgent::buildGCEvent(size_t index)
+{
+    v8::GCEventStatistics statistics;
+    m_isolate->GetGCEventStatistics(&statistics, index);
+
+    RefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCScope>> scopes = TypeBuilder::Array<TypeBuilder::Memory::GCScope>::create();
+    for (size_t i = 0; i < statistics.number_of_scopes(); ++i) {
+        if (!statistics.scope_duration(i))
+            continue;
+        scopes->addItem(TypeBuilder::Memory::GCScope::create()
+            .setName(statistics.scope_name(i))
+            .setDuration(statistics.scope_duration(i))
+            .release());
+    }
+
+    RefPtr<TypeBuilder::Memory::GCEvent> event = TypeBuilder::Memory::GCEvent::create()
+        .setId(static_cast<int>(std::min<size_t>(statistics.gc_id(), std::numeric_limits<int>::max())))
+        .setType(gcTypeName(statistics.gc_type()))
+        .setStartTime(statistics.start_time())
+        .setPauseTime(statistics.pause_duration())
+        .setPromotedBytes(statistics.promoted_bytes())
+        .setSurvivedBytes(statistics.survived_bytes())
+        .setHeapSizeBefore(statistics.heap_size_before())
+        .setHeapSizeAfter(statistics.heap_size_after())
+        .setScopes(scopes.release())
+        .release();
+    if (statistics.gc_reason())
+        event->setReason(statistics.gc_reason());
+    if (statistics.incremental())
+        event->setIncremental(true);
+    return event.release();
+}
+
+} // namespace blink
@@ -0,0 +1,80 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef InspectorMemoryAgent_h
+#define InspectorMemoryAgent_h
+
+#include "core/CoreExport.h"
+#include "core/InspectorFrontend.h"
+#include "core/inspector/InspectorBaseAgent.h"
+#include "wtf/Noncopyable.h"
+#include "wtf/PassOwnPtr.h"
+#include "wtf/WeakPtr.h"
+#include <v8.h>
+
+namespace blink {
+
+class WebThread;
+
+typedef String ErrorString;
+
+// Streams the GC history kept by V8's GCTracer (see v8::Isolate::SetGCHistorySize)
+// to the frontend and summarizes the recorded pauses on request.
+class CORE_EXPORT InspectorMemoryAgent final : public InspectorBaseAgent<InspectorMemoryAgent, InspectorFrontend::Memory>, public InspectorBackendDispatcher::MemoryCommandHandler {
+    WTF_MAKE_NONCOPYABLE(InspectorMemoryAgent);
+public:
+    class Client {
+    public:
+        virtual ~Client() { }
+        // Called whenever the result of getGCStatistics() may have changed:
+        // after recorded GCs and when tracking starts or stops. Called even
+        // without a frontend.
+        virtual void gcStatisticsChanged() = 0;
+    };
+
+    static PassOwnPtrWillBeRawPtr<InspectorMemoryAgent> create(v8::Isolate* isolate, Client* client = nullptr)
+    {
+        return adoptPtrWillBeNoop(new InspectorMemoryAgent(isolate, client));
+    }
+    ~InspectorMemoryAgent() override;
+
+    // Part of the protocol.
+    void getDOMCounters(ErrorString*, int* documents, int* nodes, int* jsEventListeners) override;
+    void startTrackingGC(ErrorString*, const int* historySize) override;
+    void stopTrackingGC(ErrorString*) override;
+    void getGCStatistics(ErrorString*, const bool* includeEvents, RefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCPauseSummary>>& summaries, RefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCEvent>>& events) override;
+
+    void disable(ErrorString*) override;
+    void restore() override;
+
+    bool isTrackingGC() const { return m_trackingGC; }
+    // GCs are reported to the client and the frontend from a task posted to
+    // |thread|, the thread the agent runs on, since the GC callback runs in
+    // the middle of the collection. Without one only getGCStatistics() sees
+    // them.
+    void setInspectorThread(WebThread* thread) { m_inspectorThread = thread; }
+    bool hasInspectorThread() const { return m_inspectorThread; }
+
+private:
+    InspectorMemoryAgent(v8::Isolate*, Client*);
+
+    static void onGCEvent(v8::Isolate*, void* data);
+    void reportGCEvents();
+    void startTracking(int historySize);
+    void stopTracking();
+    PassRefPtr<TypeBuilder::Memory::GCEvent> buildGCEvent(size_t index);
+
+    v8::Isolate* m_isolate;
+    Client* m_client;
+    bool m_trackingGC;
+    WebThread* m_inspectorThread;
+    // GCs recorded since the last report.
+    size_t m_unreportedGCEvents;
+    bool m_gcReportScheduled;
+    WeakPtrFactory<InspectorMemoryAgent> m_weakPtrFactory;
+};
+
+} // namespace blink
+
+#endif // !defined(InspectorMemoryAgent_h)
@@ -0,0 +1,167 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/inspector/InspectorMemoryAgent.h"
+
+#include "core/inspector/InspectorFrontendChannel.h"
+#include "core/inspector/InspectorState.h"
+#include "platform/JSONValues.h"
+#include "public/platform/WebThread.h"
+#include "wtf/OwnPtr.h"
+#include <gtest/gtest.h>
+
+namespace blink {
+namespace {
+
+class TestClient final : public InspectorMemoryAgent::Client {
+public:
+    TestClient() : m_changes(0) { }
+
+    void gcStatisticsChanged() override { ++m_changes; }
+
+    int m_changes;
+};
+
+class TestChannel final : public InspectorFrontendChannel {
+public:
+    TestChannel() : m_garbageCollected(0) { }
+
+    void sendProtocolResponse(int, PassRefPtr<JSONObject>) override { }
+    void sendProtocolResponses(PassRefPtr<JSONArray>) override { }
+    void sendProtocolNotification(PassRefPtr<JSONObject> message) override
+    {
+        String method;
+        if (message->getString("method", &method) && method == "Memory.garbageCollected")
+            ++m_garbageCollected;
+    }
+    void flush() override { }
+
+    int m_garbageCollected;
+};
+
+// Keeps the posted tasks until runTasks() is called.
+class TestThread final : public WebThread {
+public:
+    void postTask(const WebTraceLocation& location, Task* task) override { postDelayedTask(location, task, 0); }
+    void postDelayedTask(const WebTraceLocation&, Task* task, long long) override { m_tasks.append(adoptPtr(task)); }
+    bool isCurrentThread() const override { return true; }
+    WebScheduler* scheduler() const override { return nullptr; }
+
+    void runTasks()
+    {
+        Vector<OwnPtr<Task>> tasks;
+        tasks.swap(m_tasks);
+        for (const OwnPtr<Task>& task : tasks)
+            task->run();
+    }
+
+    Vector<OwnPtr<Task>> m_tasks;
+};
+
+class InspectorMemoryAgentTest : public ::testing::Test {
+protected:
+    InspectorMemoryAgentTest()
+        : m_isolate(v8::Isolate::GetCurrent())
+        , m_frontend(&m_channel)
+        , m_state(nullptr)
+        , m_agents(&m_state)
+    {
+        OwnPtrWillBeRawPtr<InspectorMemoryAgent> agent = InspectorMemoryAgent::create(m_isolate, &m_client);
+        m_agent = agent.get();
+        m_agents.append(agent.release());
+        m_agents.setFrontend(&m_frontend);
+
+        const char gcFlag[] = "--expose-gc";
+        v8::V8::SetFlagsFromString(gcFlag, sizeof(gcFlag) - 1);
+    }
+
+    ~InspectorMemoryAgentTest()
+    {
+        ErrorString error;
+        m_agent->disable(&error);
+        m_agents.clearFrontend();
+    }
+
+    void startTracking()
+    {
+        ErrorString error;
+        m_agent->startTrackingGC(&error, nullptr);
+        EXPECT_TRUE(error.isEmpty());
+        m_client.m_changes = 0;
+    }
+
+    void collectGarbage()
+    {
+        m_isolate->RequestGarbageCollectionForTesting(v8::Isolate::kFullGarbageCollection);
+    }
+
+    v8::Isolate* m_isolate;
+    TestClient m_client;
+    TestChannel m_channel;
+    TestThread m_thread;
+    InspectorFrontend m_frontend;
+    InspectorCompositeState m_state;
+    InspectorAgentRegistry m_agents;
+    InspectorMemoryAgent* m_agent;
+};
+
+TEST_F(InspectorMemoryAgentTest, GCIsReportedFromPostedTask)
+{
+    m_agent->setInspectorThread(&m_thread);
+    startTracking();
+    collectGarbage();
+    EXPECT_EQ(0, m_client.m_changes);
+    EXPECT_EQ(0, m_channel.m_garbageCollected);
+    ASSERT_EQ(1u, m_thread.m_tasks.size());
+
+    m_thread.runTasks();
+    EXPECT_EQ(1, m_client.m_changes);
+    EXPECT_EQ(1, m_channel.m_garbageCollected);
+}
+
+TEST_F(InspectorMemoryAgentTest, GCsBeforeTheReportShareOneTask)
+{
+    m_agent->setInspectorThread(&m_thread);
+    startTracking();
+    collectGarbage();
+    collectGarbage();
+    ASSERT_EQ(1u, m_thread.m_tasks.size());
+
+    m_thread.runTasks();
+    EXPECT_EQ(1, m_client.m_changes);
+    EXPECT_EQ(2, m_channel.m_garbageCollected);
+}
+
+TEST_F(InspectorMemoryAgentTest, NoReportAfterTrackingStops)
+{
+    m_agent->setInspectorThread(&m_thread);
+    startTracking();
+    collectGarbage();
+    ErrorString error;
+    m_agent->stopTrackingGC(&error);
+    m_client.m_changes = 0;
+
+    m_thread.runTasks();
+    EXPECT_EQ(0, m_client.m_changes);
+    EXPECT_EQ(0, m_channel.m_garbageCollected);
+}
+
+TEST_F(InspectorMemoryAgentTest, GCIsNotReportedWithoutThread)
+{
+    startTracking();
+    collectGarbage();
+    EXPECT_EQ(0, m_client.m_changes);
+    EXPECT_EQ(0, m_channel.m_garbageCollected);
+
+    ErrorString error;
+    RefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCPauseSummary>> summaries;
+    RefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCEvent>> events;
+    bool includeEvents = true;
+    m_agent->getGCStatistics(&error, &includeEvents, summaries, events);
+    EXPECT_EQ(1u, events->length());
+}
+
+} // namespace
+} // namespace blink
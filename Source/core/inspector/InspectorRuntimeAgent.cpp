@@ -103,7 +103,7 @@ DEFINE_TRACE(InspectorRuntimeAgent)
     InspectorBaseAgent::trace(visitor);
 }
 
-void InspectorRuntimeAgent::evaluate(ErrorString* errorString, const String& expression, const String* const objectGroup, const bool* const includeCommandLineAPI, const bool* const doNotPauseOnExceptionsAndMuteConsole, const int* executionContextId, const bool* const returnByValue, const bool* generatePreview, RefPtr<TypeBuilder::Runtime::RemoteObject>& result, TypeBuilder::OptOutput<bool>* wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>& exceptionDetails)
+void InspectorRuntimeAgent::evaluate(ErrorString* errorString, const String& expression, const String* const objectGroup, const bool* const includeCommandLineAPI, const bool* const doNotPauseOnExceptionsAndMuteConsole, const int* executionContextId, const bool* const returnByValue, const bool* generatePreview, RefPtr<JSONValue>& result, TypeBuilder::OptOutput<bool>* wasThrown, RefPtr<TypeBuilder::Debugger::ExceptionDetails>& exceptionDetails)
 {
     InjectedScript injectedScript = injectedScriptForEval(errorString, executionContextId);
     if (injectedScript.isEmpty())
@@ -113,7 +113,7 @@ void InspectorRuntimeAgent::evaluate(ErrorString* errorString, const String& exp
     injectedScript.evaluate(errorString, expression, objectGroup ? *objectGroup : "", asBool(includeCommandLineAPI), asBool(returnByValue), asBool(generatePreview), &result, wasThrown, &exceptionDetails);
 }
 
-void InspectorRuntimeAgent::callFunctionOn(ErrorString* errorString, const String& objectId, const String& expression, const RefPtr<JSONArray>* const optionalArguments, const bool* const doNotPauseOnExceptionsAndMuteConsole, const bool* const returnByValue, const bool* generatePreview, RefPtr<TypeBuilder::Runtime::RemoteObject>& result, TypeBuilder::OptOutput<bool>* wasThrown)
+void InspectorRuntimeAgent::callFunctionOn(ErrorString* errorString, const String& objectId, const String& expression, const RefPtr<JSONArray>* const optionalArguments, const bool* const doNotPauseOnExceptionsAndMuteConsole, const bool* const returnByValue, const bool* generatePreview, RefPtr<JSONValue>& result, TypeBuilder::OptOutput<bool>* wasThrown)
 {
     InjectedScript injectedScript = m_injectedScriptManager->injectedScriptForObjectId(objectId);
     if (injectedScript.isEmpty()) {
@@ -128,7 +128,7 @@ void InspectorRuntimeAgent::callFunctionOn(ErrorString* errorString, const Strin
     injectedScript.callFunctionOn(errorString, objectId, expression, arguments, asBool(returnByValue), asBool(generatePreview), &result, wasThrown);
 }
 
-void InspectorRuntimeAgent::getProperties(ErrorString* errorString, const String& objectId, const bool* ownProperties, const bool* accessorPropertiesOnly, const bool* generatePreview, RefPtr<TypeBuilder::Array<TypeBuilder::Runtime::PropertyDescriptor>>& result, RefPtr<TypeBuilder::Array<TypeBuilder::Runtime::InternalPropertyDescriptor>>& internalProperties, RefPtr<TypeBuilder::Debugger::ExceptionDetails>& exceptionDetails)
+void InspectorRuntimeAgent::getProperties(ErrorString* errorString, const String& objectId, const bool* ownProperties, const bool* accessorPropertiesOnly, const bool* generatePreview, const int* fromIndex, const int* toIndex, const bool* nonIndexedPropertiesOnly, const int* maxProperties, const String* continuationToken, RefPtr<JSONValue>& result, RefPtr<TypeBuilder::Array<TypeBuilder::Runtime::InternalPropertyDescriptor>>& internalProperties, RefPtr<TypeBuilder::Debugger::ExceptionDetails>& exceptionDetails, TypeBuilder::OptOutput<String>* continuationTokenOut)
 {
     InjectedScript injectedScript = m_injectedScriptManager->injectedScriptForObjectId(objectId);
     if (injectedScript.isEmpty()) {
@@ -138,9 +138,22 @@ void InspectorRuntimeAgent::getProperties(ErrorString* errorString, const String
 
     InjectedScriptCallScope callScope(this, true);
 
-    injectedScript.getProperties(errorString, objectId, asBool(ownProperties), asBool(accessorPropertiesOnly), asBool(generatePreview), &result, &exceptionDetails);
-
-    if (!exceptionDetails && !asBool(accessorPropertiesOnly))
+    if ((fromIndex && *fromIndex < 0) || (toIndex && *toIndex < 0) || (maxProperties && *maxProperties < 0)) {
+        *errorString = "Index range and property limit must not be negative";
+        return;
+    }
+    InjectedScript::PropertyPage page;
+    page.fromIndex = fromIndex ? *fromIndex : -1;
+    page.toIndex = toIndex ? *toIndex : -1;
+    page.nonIndexedPropertiesOnly = asBool(nonIndexedPropertiesOnly);
+    page.maxProperties = maxProperties ? *maxProperties : 0;
+    if (continuationToken)
+        page.continuationToken = *continuationToken;
+
+    injectedScript.getProperties(errorString, objectId, asBool(ownProperties), asBool(accessorPropertiesOnly), asBool(generatePreview), page, &result, &exceptionDetails, continuationTokenOut);
+
+    // Internal properties come with the first page and not with element ranges.
+    if (!exceptionDetails && !asBool(accessorPropertiesOnly) && page.continuationToken.isEmpty() && page.fromIndex < 0 && page.toIndex < 0)
         injectedScript.getInternalProperties(errorString, objectId, &internalProperties, &exceptionDetails);
 }
 
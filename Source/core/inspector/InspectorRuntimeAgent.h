@@ -71,7 +71,7 @@ public:
         const int* executionContextId,
         const bool* returnByValue,
         const bool* generatePreview,
-        RefPtr<TypeBuilder::Runtime::RemoteObject>& result,
+        RefPtr<JSONValue>& result,
         TypeBuilder::OptOutput<bool>* wasThrown,
         RefPtr<TypeBuilder::Debugger::ExceptionDetails>&) override final;
     void callFunctionOn(ErrorString*,
@@ -81,10 +81,10 @@ public:
                         const bool* doNotPauseOnExceptionsAndMuteConsole,
                         const bool* returnByValue,
                         const bool* generatePreview,
-                        RefPtr<TypeBuilder::Runtime::RemoteObject>& result,
+                        RefPtr<JSONValue>& result,
                         TypeBuilder::OptOutput<bool>* wasThrown) override final;
     void releaseObject(ErrorString*, const String& objectId) override final;
-    void getProperties(ErrorString*, const String& objectId, const bool* ownProperties, const bool* accessorPropertiesOnly, const bool* generatePreview, RefPtr<TypeBuilder::Array<TypeBuilder::Runtime::PropertyDescriptor>>& result, RefPtr<TypeBuilder::Array<TypeBuilder::Runtime::InternalPropertyDescriptor>>& internalProperties, RefPtr<TypeBuilder::Debugger::ExceptionDetails>&) override final;
+    void getProperties(ErrorString*, const String& objectId, const bool* ownProperties, const bool* accessorPropertiesOnly, const bool* generatePreview, const int* fromIndex, const int* toIndex, const bool* nonIndexedPropertiesOnly, const int* maxProperties, const String* continuationToken, RefPtr<JSONValue>& result, RefPtr<TypeBuilder::Array<TypeBuilder::Runtime::InternalPropertyDescriptor>>& internalProperties, RefPtr<TypeBuilder::Debugger::ExceptionDetails>&, TypeBuilder::OptOutput<String>* continuationTokenOut) override final;
     void releaseObjectGroup(ErrorString*, const String& objectGroup) override final;
     void run(ErrorString*) override;
     void isRunRequired(ErrorString*, bool* out_result) override;
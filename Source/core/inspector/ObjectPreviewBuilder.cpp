@@ -0,0 +1,530 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/inspector/ObjectPreviewBuilder.h"
+
+#include "bindings/core/v8/V8Binding.h"
+#include "bindings/core/v8/V8Debugger.h"
+#include "bindings/core/v8/inspector/V8InjectedScriptHost.h"
+#include "wtf/text/StringBuilder.h"
+#include "wtf/unicode/CharacterNames.h"
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+#include <v8-debug.h>
+
+namespace blink {
+
+using TypeBuilder::Runtime::EntryPreview;
+using TypeBuilder::Runtime::ObjectPreview;
+using TypeBuilder::Runtime::PropertyPreview;
+
+namespace {
+
+// Same limits as InjectedScript.RemoteObject.prototype._generatePreview.
+const int maxProperties = 5;
+const int maxIndexes = 100;
+const unsigned maxEntries = 5;
+const int maxStringLength = 100;
+// Elements of a sparse array are probed one index at a time; give up after
+// this many holes and report the preview as lossy.
+const uint32_t maxIndexesScanned = 10000;
+
+struct SubtypeName {
+    const char* name;
+    ObjectPreview::Subtype::Enum value;
+};
+
+const SubtypeName subtypeNames[] = {
+    { "array", ObjectPreview::Subtype::Array },
+    { "null", ObjectPreview::Subtype::Null },
+    { "node", ObjectPreview::Subtype::Node },
+    { "regexp", ObjectPreview::Subtype::Regexp },
+    { "date", ObjectPreview::Subtype::Date },
+    { "map", ObjectPreview::Subtype::Map },
+    { "set", ObjectPreview::Subtype::Set },
+    { "iterator", ObjectPreview::Subtype::Iterator },
+    { "generator", ObjectPreview::Subtype::Generator },
+    { "error", ObjectPreview::Subtype::Error },
+};
+
+bool previewSubtype(const char* subtype, ObjectPreview::Subtype::Enum* result)
+{
+    if (!subtype)
+        return false;
+    for (const SubtypeName& entry : subtypeNames) {
+        if (!strcmp(entry.name, subtype)) {
+            *result = entry.value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Generated enums share one value space, so ObjectPreview and PropertyPreview
+// subtypes convert into each other.
+bool propertySubtype(const char* subtype, PropertyPreview::Subtype::Enum* result)
+{
+    ObjectPreview::Subtype::Enum value;
+    if (!previewSubtype(subtype, &value))
+        return false;
+    *result = static_cast<PropertyPreview::Subtype::Enum>(value);
+    return true;
+}
+
+bool isSubtype(const char* subtype, const char* name)
+{
+    return subtype && !strcmp(subtype, name);
+}
+
+String abbreviate(const String& string, bool middle)
+{
+    if (string.length() <= static_cast<unsigned>(maxStringLength))
+        return string;
+    StringBuilder builder;
+    if (middle) {
+        unsigned leftHalf = maxStringLength >> 1;
+        unsigned rightHalf = maxStringLength - leftHalf - 1;
+        builder.append(string.left(leftHalf));
+        builder.append(horizontalEllipsisCharacter);
+        builder.append(string.right(rightHalf));
+    } else {
+        builder.append(string.left(maxStringLength));
+        builder.append(horizontalEllipsisCharacter);
+    }
+    return builder.toString();
+}
+
+// Like abbreviate(..., true), but only copies the kept characters out of V8 so
+// that previewing a huge string does not flatten it into a WTF::String.
+String abbreviate(v8::Local<v8::String> string, bool* truncated)
+{
+    int length = string->Length();
+    if (length <= maxStringLength)
+        return toCoreString(string);
+    *truncated = true;
+    int leftHalf = maxStringLength >> 1;
+    int rightHalf = maxStringLength - leftHalf - 1;
+    uint16_t buffer[maxStringLength];
+    StringBuilder builder;
+    string->Write(buffer, 0, leftHalf, v8::String::NO_NULL_TERMINATION);
+    builder.append(reinterpret_cast<const UChar*>(buffer), leftHalf);
+    builder.append(horizontalEllipsisCharacter);
+    string->Write(buffer, length - rightHalf, rightHalf, v8::String::NO_NULL_TERMINATION);
+    builder.append(reinterpret_cast<const UChar*>(buffer), rightHalf);
+    return builder.toString();
+}
+
+bool isIndexName(v8::Local<v8::Value> name)
+{
+    // GetOwnPropertyNames reports element keys as numbers.
+    return name->IsUint32();
+}
+
+} // namespace
+
+struct ObjectPreviewBuilder::PreviewState {
+    PreviewState()
+        : properties(TypeBuilder::Array<PropertyPreview>::create())
+        , propertiesLeft(maxProperties)
+        , indexesLeft(maxIndexes)
+        , lossless(true)
+        , overflow(false)
+    {
+    }
+
+    bool full() const { return propertiesLeft < 0 || indexesLeft < 0; }
+
+    void append(PassRefPtr<PropertyPreview> property, bool isIndex)
+    {
+        int& left = isIndex ? indexesLeft : propertiesLeft;
+        if (--left < 0) {
+            overflow = true;
+            lossless = false;
+            return;
+        }
+        properties->addItem(property);
+    }
+
+    RefPtr<TypeBuilder::Array<PropertyPreview>> properties;
+    int propertiesLeft;
+    int indexesLeft;
+    bool lossless;
+    bool overflow;
+};
+
+ObjectPreviewBuilder::ObjectPreviewBuilder(v8::Isolate* isolate, V8Debugger* debugger)
+    : m_isolate(isolate)
+    , m_context(isolate->GetCurrentContext())
+    , m_debugger(debugger)
+{
+}
+
+PassRefPtr<ObjectPreview> ObjectPreviewBuilder::build(v8::Local<v8::Object> object, const String& subtype, const String& description)
+{
+    const char* nativeSubtype = V8InjectedScriptHost::subtype(object);
+    // The JS side also calls array-like objects arrays.
+    if (!nativeSubtype && subtype == "array")
+        nativeSubtype = "array";
+    return buildPreview(object, nativeSubtype, description, false, nullptr);
+}
+
+PassRefPtr<ObjectPreview> ObjectPreviewBuilder::buildPreview(v8::Local<v8::Object> object, const char* subtype, const String& description, bool skipEntriesPreview, bool* lossless)
+{
+    PreviewState state;
+    RefPtr<TypeBuilder::Array<EntryPreview>> entries;
+    {
+        v8::TryCatch tryCatch;
+        bool indexed = object->IsArray() || object->IsTypedArray();
+        if (indexed)
+            appendIndexedProperties(object, state);
+        if (!state.full())
+            appendNamedProperties(object, subtype, indexed, state);
+        if (!state.full())
+            appendInternalProperties(object, subtype, state);
+        if (!state.full() && (isSubtype(subtype, "map") || isSubtype(subtype, "set") || isSubtype(subtype, "iterator")))
+            appendEntries(object, skipEntriesPreview, state, entries);
+        if (tryCatch.HasCaught())
+            state.lossless = false;
+    }
+
+    RefPtr<ObjectPreview> preview = ObjectPreview::create()
+        .setType(ObjectPreview::Type::Object)
+        .setLossless(state.lossless)
+        .setOverflow(state.overflow)
+        .setProperties(state.properties.release())
+        .release();
+    ObjectPreview::Subtype::Enum subtypeValue;
+    if (previewSubtype(subtype, &subtypeValue))
+        preview->setSubtype(subtypeValue);
+    preview->setDescription(description);
+    if (entries)
+        preview->setEntries(entries.release());
+    if (lossless && !state.lossless)
+        *lossless = false;
+    return preview.release();
+}
+
+// Mirrors the preview of a RemoteObject created for a Map or Set entry: objects
+// get a preview without nested entries, everything else an empty one.
+PassRefPtr<ObjectPreview> ObjectPreviewBuilder::buildValuePreview(v8::Local<v8::Value> value, bool* lossless)
+{
+    if (value->IsObject() && !value->IsFunction()) {
+        v8::Local<v8::Object> object = value.As<v8::Object>();
+        const char* subtype = V8InjectedScriptHost::subtype(object);
+        return buildPreview(object, subtype, describe(object, subtype), true, lossless);
+    }
+
+    ObjectPreview::Type::Enum type;
+    String description;
+    if (value->IsNull()) {
+        type = ObjectPreview::Type::Object;
+        description = "null";
+    } else if (value->IsFunction()) {
+        type = ObjectPreview::Type::Function;
+        description = describe(value.As<v8::Object>(), nullptr);
+    } else if (value->IsSymbol()) {
+        type = ObjectPreview::Type::Symbol;
+        description = primitiveDescription(value);
+    } else {
+        if (value->IsString())
+            type = ObjectPreview::Type::String;
+        else if (value->IsNumber())
+            type = ObjectPreview::Type::Number;
+        else if (value->IsBoolean())
+            type = ObjectPreview::Type::Boolean;
+        else
+            type = ObjectPreview::Type::Undefined;
+        description = primitiveDescription(value);
+    }
+
+    RefPtr<ObjectPreview> preview = ObjectPreview::create()
+        .setType(type)
+        .setLossless(true)
+        .setOverflow(false)
+        .setProperties(TypeBuilder::Array<PropertyPreview>::create())
+        .release();
+    if (value->IsNull())
+        preview->setSubtype(ObjectPreview::Subtype::Null);
+    preview->setDescription(description);
+    return preview.release();
+}
+
+void ObjectPreviewBuilder::appendIndexedProperties(v8::Local<v8::Object> object, PreviewState& state)
+{
+    if (object->IsTypedArray()) {
+        // Typed array elements are plain data; no need for descriptors.
+        size_t length = object.As<v8::TypedArray>()->Length();
+        for (uint32_t index = 0; index < length && !state.full(); ++index) {
+            v8::Local<v8::Value> value;
+            if (!object->Get(m_context, index).ToLocal(&value))
+                return;
+            appendValue(String::number(index), true, value, true, state);
+        }
+        return;
+    }
+
+    uint32_t length = object.As<v8::Array>()->Length();
+    uint32_t scanLength = std::min(length, maxIndexesScanned);
+    uint32_t index = 0;
+    for (; index < scanLength && !state.full(); ++index) {
+        if (!object->HasRealIndexedProperty(m_context, index).FromMaybe(false))
+            continue;
+        v8::Local<v8::String> name = v8String(m_isolate, String::number(index));
+        v8::Local<v8::Value> value;
+        if (!ownDataProperty(object, name, &value)) {
+            state.lossless = false;
+            continue;
+        }
+        appendValue(String::number(index), true, value, true, state);
+    }
+    if (index < length && !state.full())
+        state.lossless = false;
+}
+
+void ObjectPreviewBuilder::appendNamedProperties(v8::Local<v8::Object> object, const char* subtype, bool skipIndexes, PreviewState& state)
+{
+    bool isArray = isSubtype(subtype, "array");
+    bool isCollection = isSubtype(subtype, "map") || isSubtype(subtype, "set");
+    v8::Local<v8::Array> names;
+    if (!object->GetOwnPropertyNames(m_context).ToLocal(&names)) {
+        state.lossless = false;
+        return;
+    }
+
+    for (uint32_t i = 0; i < names->Length() && !state.full(); ++i) {
+        v8::Local<v8::Value> key;
+        if (!names->Get(m_context, i).ToLocal(&key))
+            return;
+        bool isIndex = isIndexName(key);
+        if (isIndex && skipIndexes)
+            continue;
+        v8::Local<v8::String> keyString;
+        if (!key->ToString(m_context).ToLocal(&keyString))
+            return;
+        String name = toCoreString(keyString);
+
+        // Same as the JS preview: skip these and stay lossless.
+        if (name == "__proto__" || (isArray && name == "length") || (isCollection && name == "size"))
+            continue;
+
+        v8::Local<v8::Value> value;
+        if (!ownDataProperty(object, keyString, &value)) {
+            // Never call getters; accessor properties make the preview lossy.
+            state.lossless = false;
+            continue;
+        }
+        appendValue(name, isIndex, value, isArray, state);
+    }
+
+    if (state.full() || !state.lossless)
+        return;
+
+    // Enumerable properties inherited from the prototype chain are never
+    // previewed, so their presence makes the preview lossy.
+    for (v8::Local<v8::Value> prototype = object->GetPrototype(); prototype->IsObject(); prototype = prototype.As<v8::Object>()->GetPrototype()) {
+        v8::Local<v8::Array> prototypeNames;
+        if (!prototype.As<v8::Object>()->GetOwnPropertyNames(m_context).ToLocal(&prototypeNames))
+            return;
+        for (uint32_t i = 0; i < prototypeNames->Length(); ++i) {
+            v8::Local<v8::Value> key;
+            v8::Local<v8::String> keyString;
+            if (!prototypeNames->Get(m_context, i).ToLocal(&key) || !key->ToString(m_context).ToLocal(&keyString))
+                return;
+            if (!object->HasOwnProperty(m_context, keyString).FromMaybe(false)) {
+                state.lossless = false;
+                return;
+            }
+        }
+    }
+}
+
+void ObjectPreviewBuilder::appendInternalProperties(v8::Local<v8::Object> object, const char* subtype, PreviewState& state)
+{
+    v8::Local<v8::Array> properties;
+    if (!v8::Debug::GetInternalProperties(m_isolate, object).ToLocal(&properties))
+        return;
+    bool isArray = isSubtype(subtype, "array");
+    for (uint32_t i = 0; i + 1 < properties->Length() && !state.full(); i += 2) {
+        v8::Local<v8::Value> name;
+        v8::Local<v8::Value> value;
+        if (!properties->Get(m_context, i).ToLocal(&name) || !properties->Get(m_context, i + 1).ToLocal(&value))
+            return;
+        appendValue(toString(name), false, value, isArray, state);
+    }
+}
+
+void ObjectPreviewBuilder::appendEntries(v8::Local<v8::Object> object, bool skipEntriesPreview, PreviewState& state, RefPtr<TypeBuilder::Array<EntryPreview>>& entries)
+{
+    if (!m_debugger || !m_debugger->enabled()) {
+        state.lossless = false;
+        return;
+    }
+    v8::Local<v8::Value> entriesValue = m_debugger->collectionEntries(object);
+    if (!entriesValue->IsArray())
+        return;
+    v8::Local<v8::Array> entriesArray = entriesValue.As<v8::Array>();
+    if (skipEntriesPreview) {
+        if (entriesArray->Length()) {
+            state.overflow = true;
+            state.lossless = false;
+        }
+        return;
+    }
+
+    v8::Local<v8::String> keyName = v8AtomicString(m_isolate, "key");
+    v8::Local<v8::String> valueName = v8AtomicString(m_isolate, "value");
+    entries = TypeBuilder::Array<EntryPreview>::create();
+    for (uint32_t i = 0; i < entriesArray->Length(); ++i) {
+        if (i >= maxEntries) {
+            state.overflow = true;
+            state.lossless = false;
+            break;
+        }
+        v8::Local<v8::Value> entryValue;
+        if (!entriesArray->Get(m_context, i).ToLocal(&entryValue) || !entryValue->IsObject())
+            continue;
+        v8::Local<v8::Object> entry = entryValue.As<v8::Object>();
+        v8::Local<v8::Value> value;
+        if (!entry->Get(m_context, valueName).ToLocal(&value))
+            continue;
+        RefPtr<EntryPreview> entryPreview = EntryPreview::create()
+            .setValue(buildValuePreview(value, &state.lossless))
+            .release();
+        v8::Local<v8::Value> key;
+        if (entry->HasOwnProperty(m_context, keyName).FromMaybe(false) && entry->Get(m_context, keyName).ToLocal(&key))
+            entryPreview->setKey(buildValuePreview(key, &state.lossless));
+        entries->addItem(entryPreview.release());
+    }
+}
+
+void ObjectPreviewBuilder::appendValue(const String& name, bool isIndex, v8::Local<v8::Value> value, bool ownerIsArray, PreviewState& state)
+{
+    // Never render functions in object preview, except for array elements.
+    if (value->IsFunction() && (!ownerIsArray || !isIndex)) {
+        state.lossless = false;
+        return;
+    }
+
+    RefPtr<PropertyPreview> property;
+    if (value->IsNull()) {
+        property = PropertyPreview::create()
+            .setName(name)
+            .setType(PropertyPreview::Type::Object)
+            .release();
+        property->setSubtype(PropertyPreview::Subtype::Null);
+        property->setValue("null");
+    } else if (value->IsString() || value->IsNumber() || value->IsBoolean() || value->IsUndefined()) {
+        PropertyPreview::Type::Enum type = PropertyPreview::Type::Undefined;
+        String description;
+        if (value->IsString()) {
+            type = PropertyPreview::Type::String;
+            bool truncated = false;
+            description = abbreviate(value.As<v8::String>(), &truncated);
+            if (truncated)
+                state.lossless = false;
+        } else {
+            if (value->IsNumber())
+                type = PropertyPreview::Type::Number;
+            else if (value->IsBoolean())
+                type = PropertyPreview::Type::Boolean;
+            description = primitiveDescription(value);
+        }
+        property = PropertyPreview::create()
+            .setName(name)
+            .setType(type)
+            .release();
+        property->setValue(description);
+    } else if (value->IsSymbol()) {
+        property = PropertyPreview::create()
+            .setName(name)
+            .setType(PropertyPreview::Type::Symbol)
+            .release();
+        property->setValue(abbreviate(primitiveDescription(value), false));
+        state.lossless = false;
+    } else {
+        v8::Local<v8::Object> object = value.As<v8::Object>();
+        const char* subtype = V8InjectedScriptHost::subtype(object);
+        bool isFunction = object->IsFunction();
+        property = PropertyPreview::create()
+            .setName(name)
+            .setType(isFunction ? PropertyPreview::Type::Function : PropertyPreview::Type::Object)
+            .release();
+        PropertyPreview::Subtype::Enum subtypeValue;
+        if (propertySubtype(subtype, &subtypeValue))
+            property->setSubtype(subtypeValue);
+        property->setValue(isFunction ? emptyString() : abbreviate(describe(object, subtype), isSubtype(subtype, "regexp")));
+        state.lossless = false;
+    }
+    state.append(property.release(), isIndex);
+}
+
+bool ObjectPreviewBuilder::ownDataProperty(v8::Local<v8::Object> object, v8::Local<v8::String> name, v8::Local<v8::Value>* result)
+{
+    v8::Local<v8::Value> descriptorValue;
+    if (!object->GetOwnPropertyDescriptor(m_context, name).ToLocal(&descriptorValue) || !descriptorValue->IsObject())
+        return false;
+    v8::Local<v8::Object> descriptor = descriptorValue.As<v8::Object>();
+    v8::Local<v8::String> valueName = v8AtomicString(m_isolate, "value");
+    if (!descriptor->HasOwnProperty(m_context, valueName).FromMaybe(false))
+        return false;
+    return descriptor->Get(m_context, valueName).ToLocal(result);
+}
+
+// Matches InjectedScript.prototype._describe, except that errors are described
+// by their own message only: reading |stack| would format the stack trace.
+String ObjectPreviewBuilder::describe(v8::Local<v8::Object> object, const char* subtype)
+{
+    if (isSubtype(subtype, "regexp") || isSubtype(subtype, "date"))
+        return toString(object);
+
+    String className = toCoreStringWithUndefinedOrNullCheck(V8InjectedScriptHost::internalConstructorName(m_isolate, object));
+    if (isSubtype(subtype, "array")) {
+        v8::Local<v8::Value> length;
+        if (object->IsArray())
+            length = v8::Integer::NewFromUnsigned(m_isolate, object.As<v8::Array>()->Length());
+        else if (object->IsTypedArray())
+            length = v8::Number::New(m_isolate, object.As<v8::TypedArray>()->Length());
+        else
+            ownDataProperty(object, v8AtomicString(m_isolate, "length"), &length);
+        if (!length.IsEmpty() && length->IsNumber())
+            return className + "[" + toString(length) + "]";
+        return className;
+    }
+
+    if (object->IsFunction())
+        return toString(object);
+
+    if (isSubtype(subtype, "error")) {
+        v8::Local<v8::Value> message;
+        if (ownDataProperty(object, v8AtomicString(m_isolate, "message"), &message) && message->IsString() && message.As<v8::String>()->Length())
+            return className + ": " + toCoreString(message.As<v8::String>());
+    }
+    return className;
+}
+
+String ObjectPreviewBuilder::primitiveDescription(v8::Local<v8::Value> value)
+{
+    if (value->IsNumber()) {
+        double number = value.As<v8::Number>()->Value();
+        if (!number && std::signbit(number))
+            return "-0";
+    }
+    if (value->IsSymbol()) {
+        v8::Local<v8::Value> name = value.As<v8::Symbol>()->Name();
+        return "Symbol(" + (name->IsString() ? toCoreString(name.As<v8::String>()) : emptyString()) + ")";
+    }
+    return toString(value);
+}
+
+String ObjectPreviewBuilder::toString(v8::Local<v8::Value> value)
+{
+    v8::Local<v8::String> string;
+    if (!value->ToString(m_context).ToLocal(&string))
+        return String();
+    return toCoreString(string);
+}
+
+} // namespace blink
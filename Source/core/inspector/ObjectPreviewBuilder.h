@@ -0,0 +1,57 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ObjectPreviewBuilder_h
+#define ObjectPreviewBuilder_h
+
+#include "core/InspectorTypeBuilder.h"
+#include "platform/heap/Handle.h"
+#include "wtf/Noncopyable.h"
+#include "wtf/text/WTFString.h"
+#include <v8.h>
+
+namespace blink {
+
+class V8Debugger;
+
+// Builds Runtime.ObjectPreview straight from the V8 API. It follows
+// InjectedScript.RemoteObject.prototype._generatePreview with the default
+// limits, and never calls getters or user code except toString of dates,
+// regexps and functions, like the JS version. Own properties are read with
+// GetOwnPropertyNames, which only lists enumerable string-keyed ones.
+class ObjectPreviewBuilder {
+    STACK_ALLOCATED();
+    WTF_MAKE_NONCOPYABLE(ObjectPreviewBuilder);
+public:
+    // Must be used inside the context of the previewed objects. |debugger|
+    // is used for Map and Set entries and may be null.
+    ObjectPreviewBuilder(v8::Isolate*, V8Debugger*);
+
+    // |subtype| and |description| are those of the RemoteObject being
+    // previewed, so that the preview agrees with it.
+    PassRefPtr<TypeBuilder::Runtime::ObjectPreview> build(v8::Local<v8::Object>, const String& subtype, const String& description);
+
+private:
+    struct PreviewState;
+
+    PassRefPtr<TypeBuilder::Runtime::ObjectPreview> buildPreview(v8::Local<v8::Object>, const char* subtype, const String& description, bool skipEntriesPreview, bool* lossless);
+    PassRefPtr<TypeBuilder::Runtime::ObjectPreview> buildValuePreview(v8::Local<v8::Value>, bool* lossless);
+    void appendIndexedProperties(v8::Local<v8::Object>, PreviewState&);
+    void appendNamedProperties(v8::Local<v8::Object>, const char* subtype, bool skipIndexes, PreviewState&);
+    void appendInternalProperties(v8::Local<v8::Object>, const char* subtype, PreviewState&);
+    void appendEntries(v8::Local<v8::Object>, bool skipEntriesPreview, PreviewState&, RefPtr<TypeBuilder::Array<TypeBuilder::Runtime::EntryPreview>>&);
+    void appendValue(const String& name, bool isIndex, v8::Local<v8::Value>, bool ownerIsArray, PreviewState&);
+    bool ownDataProperty(v8::Local<v8::Object>, v8::Local<v8::String> name, v8::Local<v8::Value>* result);
+    String describe(v8::Local<v8::Object>, const char* subtype);
+    String primitiveDescription(v8::Local<v8::Value>);
+    String toString(v8::Local<v8::Value>);
+
+    v8::Isolate* m_isolate;
+    v8::Local<v8::Context> m_context;
+    V8Debugger* m_debugger;
+};
+
+} // namespace blink
+
+#endif // ObjectPreviewBuilder_h
@@ -9,16 +9,32 @@
 #include "bindings/core/v8/ScriptState.h"
 #include "bindings/core/v8/ScriptValue.h"
 #include "core/inspector/ScriptAsyncCallStack.h"
+#include "public/platform/WebThread.h"
+#include "public/platform/WebTraceLocation.h"
 #include "wtf/CurrentTime.h"
+#include "wtf/Functional.h"
 #include "wtf/PassOwnPtr.h"
 #include "wtf/WeakPtr.h"
+#include <algorithm>
+#include <cmath>
 
 using blink::TypeBuilder::Array;
 using blink::TypeBuilder::Console::CallFrame;
+using blink::TypeBuilder::Debugger::PromiseCreationSite;
 using blink::TypeBuilder::Debugger::PromiseDetails;
 
 namespace blink {
 
+namespace {
+
+// Census updates are sent at most this often.
+const double censusIntervalSeconds = 1;
+// With stack capturing on, the census keeps the creation stack of the first
+// promise of every site and of every this many promises after it.
+const unsigned creationStackSamplingInterval = 1000;
+
+} // namespace
+
 class PromiseTracker::PromiseWeakCallbackData final {
     WTF_MAKE_NONCOPYABLE(PromiseWeakCallbackData);
 public:
@@ -28,14 +44,6 @@ public:
     {
     }
 
-    ~PromiseWeakCallbackData()
-    {
-        if (!m_tracker)
-            return;
-        RefPtr<PromiseDetails> promiseDetails = PromiseDetails::create().setId(m_id);
-        m_tracker->m_listener->didUpdatePromise(InspectorFrontend::Debugger::EventType::Gc, promiseDetails.release());
-    }
-
     WeakPtr<PromiseTracker> m_tracker;
     int m_id;
 };
@@ -54,7 +62,14 @@ void PromiseTracker::IdToPromiseMapTraits::DisposeCallbackData(WeakCallbackDataT
 
 void PromiseTracker::IdToPromiseMapTraits::DisposeWeak(const v8::WeakCallbackInfo<WeakCallbackDataType>& data)
 {
-    delete data.GetParameter();
+    // Unlike DisposeCallbackData(), this is only called when the promise was
+    // garbage collected, not when it was removed from the map. It runs as
+    // part of the GC, so the census is only updated here and reported from a
+    // posted task.
+    PromiseWeakCallbackData* callbackData = data.GetParameter();
+    if (callbackData->m_tracker)
+        callbackData->m_tracker->didCollectPromise(callbackData->m_id);
+    delete callbackData;
 }
 
 PromiseTracker::IdToPromiseMapTraits::MapType* PromiseTracker::IdToPromiseMapTraits::MapFromWeakCallbackInfo(const v8::WeakCallbackInfo<WeakCallbackDataType>& info)
@@ -71,6 +86,11 @@ PromiseTracker::PromiseTracker(Listener* listener, v8::Isolate* isolate)
     : m_circularSequentialId(0)
     , m_isEnabled(false)
     , m_captureStacks(false)
+    , m_census(false)
+    , m_censusChanged(false)
+    , m_censusReportScheduled(false)
+    , m_lastCensusTime(0)
+    , m_inspectorThread(nullptr)
     , m_listener(listener)
     , m_isolate(isolate)
     , m_weakPtrFactory(this)
@@ -90,12 +110,14 @@ DEFINE_TRACE(PromiseTracker)
 #endif
 }
 
-void PromiseTracker::setEnabled(bool enabled, bool captureStacks)
+void PromiseTracker::setEnabled(bool enabled, bool captureStacks, bool census)
 {
+    // Promises tracked in one mode mean nothing to the other.
+    if (!enabled || census != m_census)
+        clear();
     m_isEnabled = enabled;
     m_captureStacks = captureStacks;
-    if (!enabled)
-        clear();
+    m_census = census;
 }
 
 void PromiseTracker::clear()
@@ -103,6 +125,11 @@ void PromiseTracker::clear()
     v8::HandleScope scope(m_isolate);
     m_promiseToId.Reset(m_isolate, v8::NativeWeakMap::New(m_isolate));
     m_idToPromise.Clear();
+    m_creationSites.clear();
+    m_creationSiteIndex.clear();
+    m_pendingPromises.clear();
+    m_censusChanged = false;
+    m_lastCensusTime = 0;
 }
 
 int PromiseTracker::circularSequentialId()
@@ -134,6 +161,12 @@ void PromiseTracker::didReceiveV8PromiseEvent(ScriptState* scriptState, v8::Loca
     ASSERT(isEnabled());
     ASSERT(scriptState->contextIsValid());
 
+    if (m_census) {
+        ScriptState::Scope scope(scriptState);
+        didReceiveV8PromiseEventForCensus(promise, status);
+        return;
+    }
+
     bool isNewPromise = false;
     int id = promiseId(promise, &isNewPromise);
 
@@ -191,6 +224,177 @@ void PromiseTracker::didReceiveV8PromiseEvent(ScriptState* scriptState, v8::Loca
     m_listener->didUpdatePromise(eventType, promiseDetails.release());
 }
 
+void PromiseTracker::didReceiveV8PromiseEventForCensus(v8::Local<v8::Object> promise, int status)
+{
+    // Chaining events are ignored: the promise returned by then() has already
+    // been counted at its creation, and settling the parent is reported anyway.
+    v8::HandleScope scope(m_isolate);
+    v8::Local<v8::NativeWeakMap> map = v8::Local<v8::NativeWeakMap>::New(m_isolate, m_promiseToId);
+    v8::Local<v8::Value> value = map->Get(promise);
+    if (value->IsInt32()) {
+        if (!status)
+            return;
+        HashMap<int, PendingPromise>::iterator it = m_pendingPromises.find(value.As<v8::Int32>()->Value());
+        if (it == m_pendingPromises.end())
+            return;
+        CreationSite& site = m_creationSites[it->value.site];
+        --site.pending;
+        if (status > 0)
+            ++site.resolved;
+        else
+            ++site.rejected;
+        int id = it->key;
+        m_pendingPromises.remove(it);
+        m_idToPromise.Remove(id);
+        m_censusChanged = true;
+        reportCensusIfNeeded();
+        return;
+    }
+    // Promises created before the census started are not counted.
+    if (status)
+        return;
+
+    size_t siteIndex = creationSiteIndex();
+    CreationSite& site = m_creationSites[siteIndex];
+    if (m_captureStacks && !(site.created % creationStackSamplingInterval)) {
+        RefPtrWillBeRawPtr<ScriptCallStack> fullStack = createScriptCallStack(ScriptCallStack::maxCallStackSizeToCapture, true);
+        if (fullStack && fullStack->size())
+            site.creationStack = fullStack->buildInspectorArray();
+    }
+    ++site.created;
+    ++site.pending;
+
+    int id = circularSequentialId();
+    map->Set(promise, v8::Int32::New(m_isolate, id));
+    m_idToPromise.Set(id, promise);
+    PendingPromise pendingPromise = { siteIndex, currentTimeMS() };
+    m_pendingPromises.set(id, pendingPromise);
+    m_censusChanged = true;
+    reportCensusIfNeeded();
+}
+
+size_t PromiseTracker::creationSiteIndex()
+{
+    // Only the top frame's position is needed to find the site, so the
+    // frame is not converted unless the site is new.
+    CreationSiteKey key = { 0, 0, 0 };
+    v8::Local<v8::StackTrace> stackTrace = v8::StackTrace::CurrentStackTrace(m_isolate, 1, static_cast<v8::StackTrace::StackTraceOptions>(v8::StackTrace::kScriptId | v8::StackTrace::kColumnOffset));
+    if (!stackTrace.IsEmpty() && stackTrace->GetFrameCount()) {
+        v8::Local<v8::StackFrame> frame = stackTrace->GetFrame(0);
+        key.scriptId = frame->GetScriptId();
+        key.lineNumber = frame->GetLineNumber();
+        key.columnNumber = frame->GetColumn();
+    }
+    HashMap<CreationSiteKey, size_t, CreationSiteKeyHash, CreationSiteKeyTraits>::AddResult result = m_creationSiteIndex.add(key, m_creationSites.size());
+    if (result.isNewEntry) {
+        CreationSite site;
+        if (key.scriptId) {
+            RefPtrWillBeRawPtr<ScriptCallStack> stack = createScriptCallStack(1, true);
+            if (stack && stack->size())
+                site.callFrame = stack->at(0).buildInspectorObject();
+        }
+        site.created = 0;
+        site.pending = 0;
+        site.resolved = 0;
+        site.rejected = 0;
+        site.collected = 0;
+        m_creationSites.append(site);
+    }
+    return result.storedValue->value;
+}
+
+void PromiseTracker::didCollectPromise(int promiseId)
+{
+    if (!m_census) {
+        RefPtr<PromiseDetails> promiseDetails = PromiseDetails::create().setId(promiseId);
+        m_listener->didUpdatePromise(InspectorFrontend::Debugger::EventType::Gc, promiseDetails.release());
+        return;
+    }
+    HashMap<int, PendingPromise>::iterator it = m_pendingPromises.find(promiseId);
+    if (it == m_pendingPromises.end())
+        return;
+    CreationSite& site = m_creationSites[it->value.site];
+    --site.pending;
+    ++site.collected;
+    m_pendingPromises.remove(it);
+    m_censusChanged = true;
+    scheduleCensusReport();
+}
+
+void PromiseTracker::reportCensusIfNeeded()
+{
+    if (!m_censusChanged)
+        return;
+    double now = monotonicallyIncreasingTime();
+    if (now - m_lastCensusTime < censusIntervalSeconds) {
+        scheduleCensusReport();
+        return;
+    }
+    m_lastCensusTime = now;
+    m_censusChanged = false;
+    m_listener->didUpdatePromiseCensus(census());
+}
+
+void PromiseTracker::scheduleCensusReport()
+{
+    if (!m_inspectorThread || m_censusReportScheduled)
+        return;
+    double delay = std::max(m_lastCensusTime + censusIntervalSeconds - monotonicallyIncreasingTime(), 0.0);
+    m_censusReportScheduled = true;
+    m_inspectorThread->postDelayedTask(BLINK_FROM_HERE, bind(&PromiseTracker::reportScheduledCensus, m_weakPtrFactory.createWeakPtr()), static_cast<long long>(std::ceil(delay * 1000)));
+}
+
+void PromiseTracker::reportScheduledCensus()
+{
+    m_censusReportScheduled = false;
+    if (isCensusEnabled())
+        reportCensusIfNeeded();
+}
+
+PassRefPtr<Array<PromiseCreationSite>> PromiseTracker::census() const
+{
+    ASSERT(isCensusEnabled());
+    RefPtr<Array<PromiseCreationSite>> sites = Array<PromiseCreationSite>::create();
+    for (const CreationSite& site : m_creationSites) {
+        RefPtr<PromiseCreationSite> item = PromiseCreationSite::create()
+            .setPending(site.pending)
+            .setResolved(site.resolved)
+            .setRejected(site.rejected)
+            .setCollected(site.collected);
+        if (site.callFrame)
+            item->setCallFrame(site.callFrame);
+        if (site.creationStack)
+            item->setCreationStack(site.creationStack);
+        sites->addItem(item.release());
+    }
+    return sites.release();
+}
+
+PassRefPtr<Array<PromiseDetails>> PromiseTracker::longPendingPromises(double minimumAge, size_t maxCount) const
+{
+    ASSERT(isCensusEnabled());
+    double createdBefore = currentTimeMS() - minimumAge;
+    Vector<std::pair<double, int>> candidates;
+    for (const auto& entry : m_pendingPromises) {
+        if (entry.value.creationTime <= createdBefore)
+            candidates.append(std::make_pair(entry.value.creationTime, entry.key));
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    RefPtr<Array<PromiseDetails>> promises = Array<PromiseDetails>::create();
+    for (size_t i = 0; i < candidates.size() && i < maxCount; ++i) {
+        const PendingPromise& pendingPromise = m_pendingPromises.get(candidates[i].second);
+        RefPtr<PromiseDetails> promiseDetails = PromiseDetails::create().setId(candidates[i].second);
+        promiseDetails->setStatus(PromiseDetails::Status::Pending);
+        promiseDetails->setCreationTime(pendingPromise.creationTime);
+        const CreationSite& site = m_creationSites[pendingPromise.site];
+        if (site.callFrame)
+            promiseDetails->setCallFrame(site.callFrame);
+        promises->addItem(promiseDetails.release());
+    }
+    return promises.release();
+}
+
 ScriptValue PromiseTracker::promiseById(int promiseId)
 {
     ASSERT(isEnabled());
@@ -10,16 +10,20 @@
 #include "core/InspectorFrontend.h"
 #include "core/InspectorTypeBuilder.h"
 #include "platform/heap/Handle.h"
+#include "wtf/HashFunctions.h"
 #include "wtf/HashMap.h"
+#include "wtf/HashTraits.h"
 #include "wtf/Noncopyable.h"
 #include "wtf/RefPtr.h"
 #include "wtf/Vector.h"
+#include "wtf/text/StringHash.h"
 #include <v8.h>
 
 namespace blink {
 
 class ScriptState;
 class ScriptValue;
+class WebThread;
 
 class PromiseTracker final : public NoBaseWillBeGarbageCollectedFinalized<PromiseTracker> {
     WTF_MAKE_NONCOPYABLE(PromiseTracker);
@@ -28,6 +32,7 @@ public:
     public:
         virtual ~Listener() { }
         virtual void didUpdatePromise(InspectorFrontend::Debugger::EventType::Enum, PassRefPtr<TypeBuilder::Debugger::PromiseDetails>) = 0;
+        virtual void didUpdatePromiseCensus(PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::PromiseCreationSite>>) = 0;
     };
 
     static PassOwnPtrWillBeRawPtr<PromiseTracker> create(Listener* listener, v8::Isolate* isolate)
@@ -38,11 +43,25 @@ public:
     ~PromiseTracker();
 
     bool isEnabled() const { return m_isEnabled; }
-    void setEnabled(bool enabled, bool captureStacks);
+    bool isCensusEnabled() const { return m_isEnabled && m_census; }
+    // In census mode no per-promise updates are sent. Promises are counted by
+    // creation site instead, and the counts are reported at most once a
+    // second.
+    void setEnabled(bool enabled, bool captureStacks, bool census);
+    // Census updates that are throttled or caused by garbage collection are
+    // posted to |thread|, the thread the tracker runs on. Without one they
+    // wait for the next promise event.
+    void setInspectorThread(WebThread* thread) { m_inspectorThread = thread; }
     void clear();
     void didReceiveV8PromiseEvent(ScriptState*, v8::Local<v8::Object> promise, v8::Local<v8::Value> parentPromise, int status);
     ScriptValue promiseById(int promiseId);
 
+    // Census mode only.
+    PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::PromiseCreationSite>> census() const;
+    // Promises that have been pending for at least |minimumAge| milliseconds,
+    // oldest first.
+    PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::PromiseDetails>> longPendingPromises(double minimumAge, size_t maxCount) const;
+
     DECLARE_TRACE();
 
 private:
@@ -50,10 +69,74 @@ private:
 
     int circularSequentialId();
     int promiseId(v8::Local<v8::Object> promise, bool* isNewPromise);
+    void didReceiveV8PromiseEventForCensus(v8::Local<v8::Object> promise, int status);
+    size_t creationSiteIndex();
+    void didCollectPromise(int promiseId);
+    void reportCensusIfNeeded();
+    void scheduleCensusReport();
+    void reportScheduledCensus();
+
+    // The top frame of a creation stack. Promises created from native code
+    // share the site with no script, 0 being v8::UnboundScript::kNoScriptId.
+    struct CreationSiteKey {
+        int scriptId;
+        int lineNumber;
+        int columnNumber;
+
+        bool operator==(const CreationSiteKey& other) const
+        {
+            return scriptId == other.scriptId && lineNumber == other.lineNumber && columnNumber == other.columnNumber;
+        }
+    };
+
+    struct CreationSiteKeyHash {
+        static unsigned hash(const CreationSiteKey& key)
+        {
+            return WTF::pairIntHash(WTF::pairIntHash(key.scriptId, key.lineNumber), key.columnNumber);
+        }
+        static bool equal(const CreationSiteKey& a, const CreationSiteKey& b) { return a == b; }
+        static const bool safeToCompareToEmptyOrDeleted = true;
+    };
+
+    // Script ids are never negative.
+    struct CreationSiteKeyTraits : WTF::GenericHashTraits<CreationSiteKey> {
+        static const bool emptyValueIsZero = false;
+        static CreationSiteKey emptyValue()
+        {
+            CreationSiteKey key = { -1, 0, 0 };
+            return key;
+        }
+        static void constructDeletedValue(CreationSiteKey& slot, bool) { slot.scriptId = -2; }
+        static bool isDeletedValue(const CreationSiteKey& key) { return key.scriptId == -2; }
+    };
+
+    struct CreationSite {
+        RefPtr<TypeBuilder::Console::CallFrame> callFrame;
+        // Sampled, only if stacks are captured.
+        RefPtr<TypeBuilder::Array<TypeBuilder::Console::CallFrame>> creationStack;
+        unsigned created;
+        unsigned pending;
+        unsigned resolved;
+        unsigned rejected;
+        unsigned collected;
+    };
+
+    struct PendingPromise {
+        size_t site;
+        double creationTime;
+    };
 
     int m_circularSequentialId;
     bool m_isEnabled;
     bool m_captureStacks;
+    bool m_census;
+    bool m_censusChanged;
+    bool m_censusReportScheduled;
+    double m_lastCensusTime;
+    WebThread* m_inspectorThread;
+    Vector<CreationSite> m_creationSites;
+    HashMap<CreationSiteKey, size_t, CreationSiteKeyHash, CreationSiteKeyTraits> m_creationSiteIndex;
+    HashMap<int, PendingPromise> m_pendingPromises;
     RawPtrWillBeMember<Listener> m_listener;
 
     v8::Isolate* m_isolate;
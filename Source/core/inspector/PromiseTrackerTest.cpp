@@ -0,0 +1,170 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/inspector/PromiseTracker.h"
+
+#include "bindings/core/v8/ScriptState.h"
+#include "bindings/core/v8/V8Binding.h"
+#include "platform/JSONValues.h"
+#include "public/platform/WebThread.h"
+#include "wtf/OwnPtr.h"
+#include <gtest/gtest.h>
+
+using blink::TypeBuilder::Array;
+using blink::TypeBuilder::Debugger::PromiseCreationSite;
+using blink::TypeBuilder::Debugger::PromiseDetails;
+
+namespace blink {
+namespace {
+
+class TestListener final : public PromiseTracker::Listener {
+public:
+    TestListener() : m_censusUpdates(0) { }
+
+    void didUpdatePromise(InspectorFrontend::Debugger::EventType::Enum, PassRefPtr<PromiseDetails>) override { }
+    void didUpdatePromiseCensus(PassRefPtr<Array<PromiseCreationSite>>) override { ++m_censusUpdates; }
+
+    int m_censusUpdates;
+};
+
+// Keeps the posted tasks until runTasks() is called.
+class TestThread final : public WebThread {
+public:
+    void postTask(const WebTraceLocation& location, Task* task) override { postDelayedTask(location, task, 0); }
+    void postDelayedTask(const WebTraceLocation&, Task* task, long long delayMs) override
+    {
+        m_tasks.append(adoptPtr(task));
+        m_delays.append(delayMs);
+    }
+    bool isCurrentThread() const override { return true; }
+    WebScheduler* scheduler() const override { return nullptr; }
+
+    void runTasks()
+    {
+        Vector<OwnPtr<Task>> tasks;
+        tasks.swap(m_tasks);
+        m_delays.clear();
+        for (const OwnPtr<Task>& task : tasks)
+            task->run();
+    }
+
+    Vector<OwnPtr<Task>> m_tasks;
+    Vector<long long> m_delays;
+};
+
+// The promises are plain objects reported to the tracker through a native
+// track(promise, status) function, status being 0 for pending, 1 for
+// resolved and -1 for rejected, like the debugger's promise events.
+class PromiseTrackerTest : public ::testing::Test {
+protected:
+    PromiseTrackerTest()
+        : m_isolate(v8::Isolate::GetCurrent())
+        , m_context(v8::Context::New(m_isolate))
+        , m_contextScope(m_context)
+        , m_scriptState(ScriptState::create(m_context))
+        , m_tracker(PromiseTracker::create(&m_listener, m_isolate))
+    {
+        m_tracker->setEnabled(true, false, true);
+        v8::Local<v8::FunctionTemplate> track = v8::FunctionTemplate::New(m_isolate, trackCallback, v8::External::New(m_isolate, this));
+        m_context->Global()->Set(m_context, v8String(m_isolate, "track"), track->GetFunction(m_context).ToLocalChecked()).FromJust();
+    }
+
+    static void trackCallback(const v8::FunctionCallbackInfo<v8::Value>& info)
+    {
+        PromiseTrackerTest* test = static_cast<PromiseTrackerTest*>(info.Data().As<v8::External>()->Value());
+        test->m_tracker->didReceiveV8PromiseEvent(test->m_scriptState.get(), info[0].As<v8::Object>(), v8::Local<v8::Value>(), info[1].As<v8::Int32>()->Value());
+    }
+
+    void evaluate(const char* source)
+    {
+        v8::Local<v8::Script> script = v8::Script::Compile(m_context, v8String(m_isolate, source)).ToLocalChecked();
+        script->Run(m_context).ToLocalChecked();
+    }
+
+    PassRefPtr<JSONObject> site(size_t index)
+    {
+        return m_tracker->census()->asArray()->get(index)->asObject();
+    }
+
+    static int count(PassRefPtr<JSONObject> object, const char* name)
+    {
+        int value = -1;
+        object->getNumber(name, &value);
+        return value;
+    }
+
+    v8::Isolate* m_isolate;
+    v8::Local<v8::Context> m_context;
+    v8::Context::Scope m_contextScope;
+    RefPtr<ScriptState> m_scriptState;
+    TestListener m_listener;
+    OwnPtrWillBePersistent<PromiseTracker> m_tracker;
+};
+
+TEST_F(PromiseTrackerTest, CountsPromisesBySite)
+{
+    evaluate(
+        "var promises = [];\n"
+        "for (var i = 0; i < 3; ++i) { var p = {}; track(p, 0); promises.push(p); }\n"
+        "var q = {}; track(q, 0); promises.push(q);\n");
+    EXPECT_EQ(2u, m_tracker->census()->length());
+    EXPECT_EQ(3, count(site(0), "pending"));
+    EXPECT_EQ(1, count(site(1), "pending"));
+
+    int firstLine = -1;
+    int secondLine = -1;
+    EXPECT_TRUE(site(0)->getObject("callFrame")->getNumber("lineNumber", &firstLine));
+    EXPECT_TRUE(site(1)->getObject("callFrame")->getNumber("lineNumber", &secondLine));
+    EXPECT_EQ(firstLine + 1, secondLine);
+    EXPECT_EQ(4, m_listener.m_censusUpdates);
+}
+
+TEST_F(PromiseTrackerTest, CountsSettledPromises)
+{
+    evaluate(
+        "var promises = [];\n"
+        "for (var i = 0; i < 3; ++i) { var p = {}; track(p, 0); promises.push(p); }\n"
+        "track(promises[0], 1);\n"
+        "track(promises[1], -1);\n"
+        "track(promises[0], -1);\n");
+    EXPECT_EQ(1u, m_tracker->census()->length());
+    RefPtr<JSONObject> counts = site(0);
+    EXPECT_EQ(1, count(counts, "pending"));
+    EXPECT_EQ(1, count(counts, "resolved"));
+    EXPECT_EQ(1, count(counts, "rejected"));
+    EXPECT_EQ(0, count(counts, "collected"));
+}
+
+TEST_F(PromiseTrackerTest, IgnoresPromisesCreatedBeforeCensus)
+{
+    evaluate("var p = {}; track(p, 1);");
+    EXPECT_EQ(0u, m_tracker->census()->length());
+    EXPECT_EQ(0, m_listener.m_censusUpdates);
+}
+
+TEST_F(PromiseTrackerTest, CollectedPromisesAreReportedFromPostedTask)
+{
+    TestThread thread;
+    m_tracker->setInspectorThread(&thread);
+    evaluate("(function() { track({}, 0); })();");
+    EXPECT_EQ(1, m_listener.m_censusUpdates);
+    EXPECT_TRUE(thread.m_tasks.isEmpty());
+
+    const char gcFlag[] = "--expose-gc";
+    v8::V8::SetFlagsFromString(gcFlag, sizeof(gcFlag) - 1);
+    m_isolate->RequestGarbageCollectionForTesting(v8::Isolate::kFullGarbageCollection);
+    EXPECT_EQ(1, count(site(0), "collected"));
+    EXPECT_EQ(0, count(site(0), "pending"));
+    EXPECT_EQ(1, m_listener.m_censusUpdates);
+    ASSERT_EQ(1u, thread.m_tasks.size());
+    EXPECT_EQ(0, thread.m_delays[0]);
+
+    thread.runTasks();
+    EXPECT_EQ(2, m_listener.m_censusUpdates);
+    m_tracker->setInspectorThread(nullptr);
+}
+
+} // namespace
+} // namespace blink
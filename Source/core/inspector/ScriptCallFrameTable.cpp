@@ -0,0 +1,74 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/inspector/ScriptCallFrameTable.h"
+
+#include "wtf/PassOwnPtr.h"
+
+namespace blink {
+
+namespace {
+
+// Each new frame adds a node as well, so this bounds both.
+const size_t maxNodes = 64 * 1024;
+
+} // namespace
+
+ScriptCallFrameTable::ScriptCallFrameTable()
+{
+    m_frames.append(nullptr);
+    Node emptyStackNode = { emptyStack, 0 };
+    m_nodes.append(emptyStackNode);
+}
+
+bool ScriptCallFrameTable::isFull() const
+{
+    return m_nodes.size() >= maxNodes;
+}
+
+ScriptCallFrameTable::FrameKey ScriptCallFrameTable::frameKey(int scriptId, int lineNumber, int columnNumber, const String& functionName)
+{
+    return std::make_pair(std::make_pair(scriptId + 1, lineNumber), std::make_pair(columnNumber, functionName));
+}
+
+ScriptCallFrameTable::FrameId ScriptCallFrameTable::findFrame(int scriptId, int lineNumber, int columnNumber, const String& functionName) const
+{
+    return m_frameIds.get(frameKey(scriptId, lineNumber, columnNumber, functionName));
+}
+
+ScriptCallFrameTable::FrameId ScriptCallFrameTable::addFrame(int scriptId, const ScriptCallFrame& frame)
+{
+    HashMap<FrameKey, FrameId>::AddResult result = m_frameIds.add(frameKey(scriptId, frame.lineNumber(), frame.columnNumber(), frame.functionName()), m_frames.size());
+    if (result.isNewEntry)
+        m_frames.append(adoptPtr(new Frame(frame)));
+    return result.storedValue->value;
+}
+
+ScriptCallFrameTable::FrameId ScriptCallFrameTable::internFrame(const ScriptCallFrame& frame)
+{
+    return addFrame(frame.scriptId().toInt(), frame);
+}
+
+ScriptCallFrameTable::NodeId ScriptCallFrameTable::appendFrame(NodeId caller, FrameId frame)
+{
+    ASSERT(caller < m_nodes.size());
+    ASSERT(frame && frame < m_frames.size());
+    HashMap<std::pair<NodeId, FrameId>, NodeId>::AddResult result = m_nodeIds.add(std::make_pair(caller, frame), m_nodes.size());
+    if (result.isNewEntry) {
+        Node node = { caller, frame };
+        m_nodes.append(node);
+    }
+    return result.storedValue->value;
+}
+
+PassRefPtr<TypeBuilder::Console::CallFrame> ScriptCallFrameTable::buildInspectorObject(FrameId id)
+{
+    Frame& frame = *m_frames[id];
+    if (!frame.inspectorObject)
+        frame.inspectorObject = frame.frame.buildInspectorObject();
+    return frame.inspectorObject;
+}
+
+} // namespace blink
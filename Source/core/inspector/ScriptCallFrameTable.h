@@ -0,0 +1,88 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ScriptCallFrameTable_h
+#define ScriptCallFrameTable_h
+
+#include "core/CoreExport.h"
+#include "core/InspectorTypeBuilder.h"
+#include "core/inspector/ScriptCallFrame.h"
+#include "wtf/HashMap.h"
+#include "wtf/Noncopyable.h"
+#include "wtf/OwnPtr.h"
+#include "wtf/RefCounted.h"
+#include "wtf/Vector.h"
+#include "wtf/text/StringHash.h"
+
+namespace blink {
+
+// Interns the frames of captured call stacks. A frame that shows up in many
+// stacks is stored, and built into a protocol object, only once. Stacks are
+// nodes of a trie that grows from the outermost frame inwards, so stacks that
+// share their callers share storage as well.
+//
+// There is one table per isolate, see
+// V8InspectorIsolateData::callFrameTable(). It only grows; once it is full a
+// new one is started, and the stacks captured earlier keep their table alive.
+class CORE_EXPORT ScriptCallFrameTable : public RefCounted<ScriptCallFrameTable> {
+    WTF_MAKE_NONCOPYABLE(ScriptCallFrameTable);
+public:
+    typedef unsigned FrameId;
+    typedef unsigned NodeId;
+    static const NodeId emptyStack = 0;
+
+    static PassRefPtr<ScriptCallFrameTable> create()
+    {
+        return adoptRef(new ScriptCallFrameTable);
+    }
+
+    bool isFull() const;
+
+    // Returns 0 if the frame has not been interned yet.
+    FrameId findFrame(int scriptId, int lineNumber, int columnNumber, const String& functionName) const;
+    // |scriptId| is the numeric form of frame.scriptId().
+    FrameId addFrame(int scriptId, const ScriptCallFrame&);
+    FrameId internFrame(const ScriptCallFrame&);
+
+    // Returns the stack that has |frame| called from the top of |caller|.
+    NodeId appendFrame(NodeId caller, FrameId);
+
+    FrameId frameAt(NodeId node) const { return m_nodes[node].frame; }
+    NodeId callerOf(NodeId node) const { return m_nodes[node].caller; }
+
+    const ScriptCallFrame& frame(FrameId id) const { return m_frames[id]->frame; }
+    PassRefPtr<TypeBuilder::Console::CallFrame> buildInspectorObject(FrameId);
+
+private:
+    ScriptCallFrameTable();
+
+    struct Frame {
+        explicit Frame(const ScriptCallFrame& frame) : frame(frame) { }
+
+        ScriptCallFrame frame;
+        RefPtr<TypeBuilder::Console::CallFrame> inspectorObject;
+    };
+
+    struct Node {
+        NodeId caller;
+        FrameId frame;
+    };
+
+    // (scriptId + 1, lineNumber), (columnNumber, functionName). The script id
+    // is shifted so that no key is the empty value of the hash table.
+    typedef std::pair<std::pair<int, int>, std::pair<int, String>> FrameKey;
+    static FrameKey frameKey(int scriptId, int lineNumber, int columnNumber, const String& functionName);
+
+    // Owned one by one so that frame() references stay valid as the table
+    // grows. Index 0 is unused.
+    Vector<OwnPtr<Frame>> m_frames;
+    HashMap<FrameKey, FrameId> m_frameIds;
+    // Index 0 is the empty stack.
+    Vector<Node> m_nodes;
+    HashMap<std::pair<NodeId, FrameId>, NodeId> m_nodeIds;
+};
+
+} // namespace blink
+
+#endif // ScriptCallFrameTable_h
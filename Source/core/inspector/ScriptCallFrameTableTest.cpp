@@ -0,0 +1,114 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/inspector/ScriptCallFrameTable.h"
+
+#include "core/inspector/ScriptCallStack.h"
+#include "core/inspector/V8InspectorIsolateData.h"
+#include <gtest/gtest.h>
+
+namespace blink {
+namespace {
+
+ScriptCallFrame frame(const char* functionName, int scriptId, unsigned lineNumber)
+{
+    return ScriptCallFrame(functionName, String::number(scriptId), "test.js", lineNumber, 1);
+}
+
+// Innermost frame first, like ScriptCallStack::create().
+Vector<ScriptCallFrame> frames(const char* innermost, const char* outermost)
+{
+    Vector<ScriptCallFrame> result;
+    if (innermost)
+        result.append(frame(innermost, 1, 1));
+    result.append(frame("middle", 1, 2));
+    result.append(frame(outermost, 1, 3));
+    return result;
+}
+
+TEST(ScriptCallFrameTableTest, InternsEachFrameOnce)
+{
+    RefPtr<ScriptCallFrameTable> table = ScriptCallFrameTable::create();
+    ScriptCallFrameTable::FrameId id = table->internFrame(frame("f", 7, 10));
+    EXPECT_NE(0u, id);
+    EXPECT_EQ(id, table->internFrame(frame("f", 7, 10)));
+    EXPECT_EQ(id, table->findFrame(7, 10, 1, "f"));
+
+    // Any difference makes another frame.
+    EXPECT_NE(id, table->internFrame(frame("g", 7, 10)));
+    EXPECT_NE(id, table->internFrame(frame("f", 8, 10)));
+    EXPECT_NE(id, table->internFrame(frame("f", 7, 11)));
+    EXPECT_EQ(0u, table->findFrame(7, 10, 2, "f"));
+    EXPECT_EQ("f", table->frame(id).functionName());
+}
+
+TEST(ScriptCallFrameTableTest, StacksShareTheirCallers)
+{
+    RefPtr<ScriptCallFrameTable> table = ScriptCallFrameTable::create();
+    RefPtrWillBeRawPtr<ScriptCallStack> first = ScriptCallStack::create(table, frames("a", "main"));
+    RefPtrWillBeRawPtr<ScriptCallStack> second = ScriptCallStack::create(table, frames("b", "main"));
+    RefPtrWillBeRawPtr<ScriptCallStack> caller = ScriptCallStack::create(table, frames(nullptr, "main"));
+
+    // "middle" and "main" are stored once, so "b" adds a single node.
+    ScriptCallFrameTable::FrameId middle = table->findFrame(1, 2, 1, "middle");
+    ScriptCallFrameTable::FrameId main = table->findFrame(1, 3, 1, "main");
+    ScriptCallFrameTable::NodeId shared = table->appendFrame(table->appendFrame(ScriptCallFrameTable::emptyStack, main), middle);
+    ScriptCallFrameTable::NodeId a = table->appendFrame(shared, table->findFrame(1, 1, 1, "a"));
+    ScriptCallFrameTable::NodeId b = table->appendFrame(shared, table->findFrame(1, 1, 1, "b"));
+    EXPECT_NE(a, b);
+    EXPECT_EQ(shared, table->callerOf(a));
+    EXPECT_EQ(shared, table->callerOf(b));
+
+    ASSERT_EQ(3u, first->size());
+    EXPECT_EQ("a", first->at(0).functionName());
+    EXPECT_EQ("middle", first->at(1).functionName());
+    EXPECT_EQ("main", first->at(2).functionName());
+    ASSERT_EQ(3u, second->size());
+    EXPECT_EQ("b", second->at(0).functionName());
+    EXPECT_EQ(&first->at(2), &second->at(2));
+    ASSERT_EQ(2u, caller->size());
+    EXPECT_EQ(&first->at(1), &caller->at(0));
+}
+
+TEST(ScriptCallFrameTableTest, EmptyStack)
+{
+    RefPtrWillBeRawPtr<ScriptCallStack> stack = ScriptCallStack::create(ScriptCallFrameTable::create(), Vector<ScriptCallFrame>());
+    EXPECT_EQ(0u, stack->size());
+    EXPECT_EQ(0u, stack->buildInspectorArray()->length());
+}
+
+TEST(ScriptCallFrameTableTest, IsolateStartsNewTableWhenFull)
+{
+    V8InspectorIsolateData* data = V8InspectorIsolateData::from(v8::Isolate::GetCurrent());
+    RefPtr<ScriptCallFrameTable> table = data->callFrameTable();
+    EXPECT_EQ(table.get(), data->callFrameTable().get());
+
+    RefPtrWillBeRawPtr<ScriptCallStack> stack = ScriptCallStack::create(table, frames("a", "main"));
+    ScriptCallFrameTable::FrameId id = table->internFrame(frame("deep", 2, 1));
+    ScriptCallFrameTable::NodeId node = ScriptCallFrameTable::emptyStack;
+    size_t nodes = 0;
+    while (!table->isFull()) {
+        node = table->appendFrame(node, id);
+        ++nodes;
+    }
+    // 64K nodes in all, including the empty stack, the three of |stack| and
+    // any that earlier tests captured.
+    EXPECT_LE(nodes, 64u * 1024);
+    EXPECT_GT(nodes, 60u * 1024);
+
+    RefPtr<ScriptCallFrameTable> next = data->callFrameTable();
+    EXPECT_NE(table.get(), next.get());
+    EXPECT_FALSE(next->isFull());
+    EXPECT_EQ(0u, next->findFrame(2, 1, 1, "deep"));
+    EXPECT_EQ(next.get(), data->callFrameTable().get());
+
+    // Stacks captured before keep the full table alive.
+    table.clear();
+    ASSERT_EQ(3u, stack->size());
+    EXPECT_EQ("a", stack->at(0).functionName());
+}
+
+} // namespace
+} // namespace blink
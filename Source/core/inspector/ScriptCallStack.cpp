@@ -35,14 +35,26 @@
 
 namespace blink {
 
-PassRefPtrWillBeRawPtr<ScriptCallStack> ScriptCallStack::create(Vector<ScriptCallFrame>& frames)
+PassRefPtrWillBeRawPtr<ScriptCallStack> ScriptCallStack::create(PassRefPtr<ScriptCallFrameTable> table, ScriptCallFrameTable::NodeId top)
 {
-    return adoptRefWillBeNoop(new ScriptCallStack(frames));
+    return adoptRefWillBeNoop(new ScriptCallStack(table, top));
 }
 
-ScriptCallStack::ScriptCallStack(Vector<ScriptCallFrame>& frames)
+PassRefPtrWillBeRawPtr<ScriptCallStack> ScriptCallStack::create(PassRefPtr<ScriptCallFrameTable> table, const Vector<ScriptCallFrame>& frames)
 {
-    m_frames.swap(frames);
+    ScriptCallFrameTable::NodeId top = ScriptCallFrameTable::emptyStack;
+    for (size_t i = frames.size(); i; --i)
+        top = table->appendFrame(top, table->internFrame(frames[i - 1]));
+    return create(table, top);
+}
+
+ScriptCallStack::ScriptCallStack(PassRefPtr<ScriptCallFrameTable> table, ScriptCallFrameTable::NodeId top)
+    : m_table(table)
+    , m_top(top)
+    , m_size(0)
+{
+    for (ScriptCallFrameTable::NodeId node = m_top; node != ScriptCallFrameTable::emptyStack; node = m_table->callerOf(node))
+        ++m_size;
 }
 
 ScriptCallStack::~ScriptCallStack()
@@ -51,13 +63,16 @@ ScriptCallStack::~ScriptCallStack()
 
 const ScriptCallFrame &ScriptCallStack::at(size_t index) const
 {
-    ASSERT(m_frames.size() > index);
-    return m_frames[index];
+    ASSERT(m_size > index);
+    ScriptCallFrameTable::NodeId node = m_top;
+    for (; index; --index)
+        node = m_table->callerOf(node);
+    return m_table->frame(m_table->frameAt(node));
 }
 
 size_t ScriptCallStack::size() const
 {
-    return m_frames.size();
+    return m_size;
 }
 
 PassRefPtrWillBeRawPtr<ScriptAsyncCallStack> ScriptCallStack::asyncCallStack() const
@@ -73,8 +88,8 @@ void ScriptCallStack::setAsyncCallStack(PassRefPtrWillBeRawPtr<ScriptAsyncCallSt
 PassRefPtr<TypeBuilder::Array<TypeBuilder::Console::CallFrame> > ScriptCallStack::buildInspectorArray() const
 {
     RefPtr<TypeBuilder::Array<TypeBuilder::Console::CallFrame> > frames = TypeBuilder::Array<TypeBuilder::Console::CallFrame>::create();
-    for (size_t i = 0; i < m_frames.size(); i++)
-        frames->addItem(m_frames.at(i).buildInspectorObject());
+    for (ScriptCallFrameTable::NodeId node = m_top; node != ScriptCallFrameTable::emptyStack; node = m_table->callerOf(node))
+        frames->addItem(m_table->buildInspectorObject(m_table->frameAt(node)));
     return frames;
 }
 
@@ -34,6 +34,7 @@
 #include "core/CoreExport.h"
 #include "core/InspectorTypeBuilder.h"
 #include "core/inspector/ScriptCallFrame.h"
+#include "core/inspector/ScriptCallFrameTable.h"
 #include "platform/heap/Handle.h"
 #include "wtf/Forward.h"
 #include "wtf/RefCounted.h"
@@ -48,10 +49,14 @@ class CORE_EXPORT ScriptCallStack final : public RefCountedWillBeGarbageCollecte
 public:
     static const size_t maxCallStackSizeToCapture = 200;
 
-    static PassRefPtrWillBeRawPtr<ScriptCallStack> create(Vector<ScriptCallFrame>&);
+    // |top| is the innermost frame of the stack in |table|.
+    static PassRefPtrWillBeRawPtr<ScriptCallStack> create(PassRefPtr<ScriptCallFrameTable>, ScriptCallFrameTable::NodeId top);
+    // Frames are given innermost first.
+    static PassRefPtrWillBeRawPtr<ScriptCallStack> create(PassRefPtr<ScriptCallFrameTable>, const Vector<ScriptCallFrame>&);
 
     ~ScriptCallStack();
 
+    // Takes time linear in the index.
     const ScriptCallFrame &at(size_t) const;
     size_t size() const;
 
@@ -63,9 +68,11 @@ public:
     DECLARE_TRACE();
 
 private:
-    explicit ScriptCallStack(Vector<ScriptCallFrame>&);
+    ScriptCallStack(PassRefPtr<ScriptCallFrameTable>, ScriptCallFrameTable::NodeId top);
 
-    Vector<ScriptCallFrame> m_frames;
+    RefPtr<ScriptCallFrameTable> m_table;
+    ScriptCallFrameTable::NodeId m_top;
+    size_t m_size;
     RefPtrWillBeMember<ScriptAsyncCallStack> m_asyncCallStack;
 };
 
@@ -62,9 +62,17 @@ ScriptDebugListener::Script& ScriptDebugListener::Script::setSourceMappingURL(co
     return *this;
 }
 
+PassRefPtr<ContentSearchUtils::LineEndings> ScriptDebugListener::Script::lineEndings() const
+{
+    if (!m_lineEndings)
+        m_lineEndings = ContentSearchUtils::LineEndings::create(m_source);
+    return m_lineEndings;
+}
+
 ScriptDebugListener::Script& ScriptDebugListener::Script::setSource(const String& source)
 {
     m_source = source;
+    m_lineEndings = nullptr;
     return *this;
 }
 
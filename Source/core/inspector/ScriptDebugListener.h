@@ -32,6 +32,7 @@
 
 #include "bindings/core/v8/ScriptState.h"
 #include "core/CoreExport.h"
+#include "core/inspector/ContentSearchUtils.h"
 #include "wtf/Forward.h"
 #include "wtf/Vector.h"
 #include "wtf/text/WTFString.h"
@@ -54,6 +55,10 @@ public:
         String sourceURL() const;
         String sourceMappingURL() const { return m_sourceMappingURL; }
         String source() const { return m_source; }
+        // Computed on first use and kept until the source changes.
+        PassRefPtr<ContentSearchUtils::LineEndings> lineEndings() const;
+        // Null until lineEndings() or setLineEndings() is called.
+        PassRefPtr<ContentSearchUtils::LineEndings> cachedLineEndings() const { return m_lineEndings; }
         int startLine() const { return m_startLine; }
         int startColumn() const { return m_startColumn; }
         int endLine() const { return m_endLine; }
@@ -68,6 +73,8 @@ public:
         Script& setSourceURL(const String&);
         Script& setSourceMappingURL(const String&);
         Script& setSource(const String&);
+        // |lineEndings| must be those of the current source.
+        void setLineEndings(PassRefPtr<ContentSearchUtils::LineEndings> lineEndings) { m_lineEndings = lineEndings; }
         Script& setStartLine(int);
         Script& setStartColumn(int);
         Script& setEndLine(int);
@@ -80,6 +87,7 @@ public:
         String m_sourceURL;
         String m_sourceMappingURL;
         String m_source;
+        mutable RefPtr<ContentSearchUtils::LineEndings> m_lineEndings;
         int m_startLine;
         int m_startColumn;
         int m_endLine;
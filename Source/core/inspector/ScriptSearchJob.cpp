@@ -0,0 +1,254 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/inspector/ScriptSearchJob.h"
+
+#include "bindings/core/v8/ScriptRegexp.h"
+#include "public/platform/WebThread.h"
+#include "public/platform/WebTraceLocation.h"
+#include "wtf/Atomics.h"
+#include "wtf/CurrentTime.h"
+#include "wtf/Functional.h"
+#include "wtf/OwnPtr.h"
+
+namespace blink {
+
+namespace {
+
+// A worker batch is closed once it holds this many characters or scripts.
+const size_t maxBatchLength = 1024 * 1024;
+const size_t maxBatchScripts = 256;
+// Regex search runs on the inspector thread; yield to the message loop after
+// this long so that other protocol messages are not starved. Every slice
+// searches at least one script.
+const double regexSliceSeconds = 0.01;
+
+} // namespace
+
+// Deleted by didSearchPlainTextBatch(). Only |lines|, |lineContents| and
+// |lineEndings| are written on the background thread, and the inspector thread
+// reads them after the reply is posted.
+struct ScriptSearchJob::PlainTextBatch {
+    size_t begin;
+    size_t end;
+    String query;
+    Vector<Vector<unsigned>> lines;
+    Vector<Vector<String>> lineContents;
+    // The line endings computed for scripts that had none, or null.
+    Vector<RefPtr<ContentSearchUtils::LineEndings>> lineEndings;
+};
+
+ScriptSearchJob::ScriptSearchJob(Client* client, WebThread* inspectorThread, WebThread* backgroundThread, const String& searchId, const String& query, bool caseSensitive, bool isRegex)
+    : m_client(client)
+    , m_inspectorThread(inspectorThread)
+    , m_backgroundThread(backgroundThread)
+    , m_searchId(searchId)
+    , m_query(query)
+    , m_caseSensitive(caseSensitive)
+    , m_isRegex(isRegex)
+    , m_nextScript(0)
+    , m_pendingBatches(0)
+    , m_cancelled(0)
+{
+}
+
+ScriptSearchJob::~ScriptSearchJob()
+{
+}
+
+bool ScriptSearchJob::setURLFilter(const String& urlPattern)
+{
+    m_urlRegex = adoptPtr(new ScriptRegexp(urlPattern, TextCaseSensitive));
+    return m_urlRegex->isValid();
+}
+
+void ScriptSearchJob::addScript(const String& scriptId, const String& url, const String& source, PassRefPtr<ContentSearchUtils::LineEndings> lineEndings)
+{
+    ASSERT(!m_nextScript && !m_pendingBatches);
+    if (source.isEmpty())
+        return;
+    if (m_urlRegex && m_urlRegex->match(url) == -1)
+        return;
+    Script script;
+    script.scriptId = scriptId;
+    script.url = url;
+    script.source = source;
+    script.lineEndings = lineEndings;
+    m_scripts.append(script);
+}
+
+void ScriptSearchJob::start()
+{
+    m_urlRegex.clear();
+    if (!ContentSearchUtils::canSearchInPlainText(m_query, m_caseSensitive, m_isRegex)) {
+        scheduleRegexSlice();
+        return;
+    }
+
+    size_t begin = 0;
+    size_t batchLength = 0;
+    for (size_t i = 0; i < m_scripts.size(); ++i) {
+        batchLength += m_scripts[i].source.length();
+        if (batchLength >= maxBatchLength || i + 1 - begin >= maxBatchScripts) {
+            startPlainTextBatch(begin, i + 1);
+            begin = i + 1;
+            batchLength = 0;
+        }
+    }
+    if (begin < m_scripts.size())
+        startPlainTextBatch(begin, m_scripts.size());
+    if (!m_pendingBatches)
+        finish();
+}
+
+void ScriptSearchJob::cancel()
+{
+    m_client = nullptr;
+    releaseStore(&m_cancelled, 1);
+}
+
+bool ScriptSearchJob::isCancelled() const
+{
+    return acquireLoad(&m_cancelled);
+}
+
+void ScriptSearchJob::startPlainTextBatch(size_t begin, size_t end)
+{
+    PlainTextBatch* batch = new PlainTextBatch;
+    batch->begin = begin;
+    batch->end = end;
+    batch->query = m_query.isolatedCopy();
+
+    // Released in didSearchPlainTextBatch(), on the inspector thread, so that
+    // the job and its strings are never destroyed on the background thread.
+    ref();
+    ++m_pendingBatches;
+    m_backgroundThread->postTask(BLINK_FROM_HERE, bind(&ScriptSearchJob::runPlainTextBatch, this, batch));
+}
+
+void ScriptSearchJob::runPlainTextBatch(PlainTextBatch* batch)
+{
+    searchPlainTextBatch(batch);
+    m_inspectorThread->postTask(BLINK_FROM_HERE, bind(&ScriptSearchJob::didSearchPlainTextBatch, this, batch));
+}
+
+void ScriptSearchJob::searchPlainTextBatch(PlainTextBatch* batch) const
+{
+    for (size_t i = batch->begin; i < batch->end && !isCancelled(); ++i) {
+        const Script& script = m_scripts[i];
+        // The inspector thread keeps using the script's string, whose ref
+        // count is not atomic, so the search runs on a private copy. Copying
+        // only reads the characters.
+        String source = script.source.isolatedCopy();
+        RefPtr<ContentSearchUtils::LineEndings> lineEndings = script.lineEndings;
+        if (!lineEndings) {
+            lineEndings = ContentSearchUtils::LineEndings::create(source);
+            batch->lineEndings.append(lineEndings);
+        } else {
+            batch->lineEndings.append(nullptr);
+        }
+        Vector<unsigned> lines = ContentSearchUtils::findMatchingLinesInPlainText(source, *lineEndings, batch->query, m_caseSensitive);
+        Vector<String> lineContents;
+        lineContents.reserveInitialCapacity(lines.size());
+        for (unsigned line : lines)
+            lineContents.uncheckedAppend(ContentSearchUtils::lineContent(source, *lineEndings, line));
+        batch->lines.append(lines);
+        batch->lineContents.append(lineContents);
+    }
+}
+
+void ScriptSearchJob::didSearchPlainTextBatch(PlainTextBatch* batchPtr)
+{
+    OwnPtr<PlainTextBatch> batch = adoptPtr(batchPtr);
+    --m_pendingBatches;
+    for (size_t i = 0; i < batch->lineEndings.size(); ++i) {
+        if (!batch->lineEndings[i])
+            continue;
+        Script& script = m_scripts[batch->begin + i];
+        script.lineEndings = batch->lineEndings[i].release();
+        if (m_client)
+            m_client->didComputeLineEndings(script.scriptId, script.source, script.lineEndings);
+    }
+    if (!isCancelled()) {
+        RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::ScriptSearchResult>> results = TypeBuilder::Array<TypeBuilder::Debugger::ScriptSearchResult>::create();
+        bool found = false;
+        for (size_t i = 0; i < batch->lines.size(); ++i) {
+            if (batch->lines[i].isEmpty())
+                continue;
+            RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::SearchMatch>> matches = TypeBuilder::Array<TypeBuilder::Debugger::SearchMatch>::create();
+            for (size_t j = 0; j < batch->lines[i].size(); ++j) {
+                matches->addItem(TypeBuilder::Debugger::SearchMatch::create()
+                    .setLineNumber(batch->lines[i][j])
+                    .setLineContent(batch->lineContents[i][j])
+                    .release());
+            }
+            const Script& script = m_scripts[batch->begin + i];
+            results->addItem(TypeBuilder::Debugger::ScriptSearchResult::create()
+                .setScriptId(script.scriptId)
+                .setUrl(script.url)
+                .setMatches(matches.release())
+                .release());
+            found = true;
+        }
+        if (found && m_client)
+            m_client->didFindSearchResults(m_searchId, results.release());
+        if (!m_pendingBatches)
+            finish();
+    }
+    deref();
+}
+
+void ScriptSearchJob::scheduleRegexSlice()
+{
+    // Released in runRegexSlice().
+    ref();
+    m_inspectorThread->postTask(BLINK_FROM_HERE, bind(&ScriptSearchJob::runRegexSlice, this));
+}
+
+void ScriptSearchJob::runRegexSlice()
+{
+    if (!isCancelled()) {
+        RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::ScriptSearchResult>> results = TypeBuilder::Array<TypeBuilder::Debugger::ScriptSearchResult>::create();
+        bool found = false;
+        double deadline = monotonicallyIncreasingTime() + regexSliceSeconds;
+        size_t firstScript = m_nextScript;
+        while (m_nextScript < m_scripts.size()) {
+            if (m_nextScript > firstScript && monotonicallyIncreasingTime() >= deadline)
+                break;
+            Script& script = m_scripts[m_nextScript++];
+            if (!script.lineEndings) {
+                script.lineEndings = ContentSearchUtils::LineEndings::create(script.source);
+                if (m_client)
+                    m_client->didComputeLineEndings(script.scriptId, script.source, script.lineEndings);
+            }
+            RefPtr<TypeBuilder::Array<TypeBuilder::Debugger::SearchMatch>> matches = ContentSearchUtils::searchInTextByLines(script.source, *script.lineEndings, m_query, m_caseSensitive, m_isRegex);
+            if (!matches->length())
+                continue;
+            results->addItem(TypeBuilder::Debugger::ScriptSearchResult::create()
+                .setScriptId(script.scriptId)
+                .setUrl(script.url)
+                .setMatches(matches.release())
+                .release());
+            found = true;
+        }
+        if (found && m_client)
+            m_client->didFindSearchResults(m_searchId, results.release());
+        if (m_nextScript < m_scripts.size())
+            scheduleRegexSlice();
+        else
+            finish();
+    }
+    deref();
+}
+
+void ScriptSearchJob::finish()
+{
+    if (Client* client = m_client) {
+        m_client = nullptr;
+        client->didFinishSearch(m_searchId);
+    }
+}
+
+} // namespace blink
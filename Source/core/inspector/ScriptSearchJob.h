@@ -0,0 +1,97 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ScriptSearchJob_h
+#define ScriptSearchJob_h
+
+#include "core/CoreExport.h"
+#include "core/InspectorTypeBuilder.h"
+#include "core/inspector/ContentSearchUtils.h"
+#include "wtf/Noncopyable.h"
+#include "wtf/OwnPtr.h"
+#include "wtf/PassRefPtr.h"
+#include "wtf/ThreadSafeRefCounted.h"
+#include "wtf/Vector.h"
+#include "wtf/text/WTFString.h"
+
+namespace blink {
+
+class ScriptRegexp;
+class WebThread;
+
+// Searches a snapshot of scripts without blocking the inspector thread for the
+// whole search. Plain-text queries are split into batches that run on the
+// background thread; regex queries need V8 and run in short slices posted to
+// the inspector thread. Results are reported per batch as they come in.
+class CORE_EXPORT ScriptSearchJob : public ThreadSafeRefCounted<ScriptSearchJob> {
+    WTF_MAKE_NONCOPYABLE(ScriptSearchJob);
+public:
+    class Client {
+    public:
+        virtual ~Client() { }
+        virtual void didFindSearchResults(const String& searchId, PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::ScriptSearchResult>>) = 0;
+        virtual void didFinishSearch(const String& searchId) = 0;
+        // Line endings of |source|, for the client to keep if the script
+        // still has that source.
+        virtual void didComputeLineEndings(const String& scriptId, const String& source, PassRefPtr<ContentSearchUtils::LineEndings>) = 0;
+    };
+
+    // |inspectorThread| must be the current thread. |backgroundThread| may
+    // run several tasks at once.
+    static PassRefPtr<ScriptSearchJob> create(Client* client, WebThread* inspectorThread, WebThread* backgroundThread, const String& searchId, const String& query, bool caseSensitive, bool isRegex)
+    {
+        return adoptRef(new ScriptSearchJob(client, inspectorThread, backgroundThread, searchId, query, caseSensitive, isRegex));
+    }
+    ~ScriptSearchJob();
+
+    const String& searchId() const { return m_searchId; }
+
+    // Makes addScript() skip the scripts whose URL does not match
+    // |urlPattern|, a regular expression. Returns false if it is invalid.
+    bool setURLFilter(const String& urlPattern);
+    // Must be called before start(). Null line endings are computed when
+    // needed, on the background thread for plain-text queries.
+    void addScript(const String& scriptId, const String& url, const String& source, PassRefPtr<ContentSearchUtils::LineEndings>);
+    void start();
+    // Stops reporting to the client; work already running on the background
+    // thread bails out at the next script boundary.
+    void cancel();
+
+private:
+    struct Script {
+        String scriptId;
+        String url;
+        String source;
+        RefPtr<ContentSearchUtils::LineEndings> lineEndings;
+    };
+    struct PlainTextBatch;
+
+    ScriptSearchJob(Client*, WebThread* inspectorThread, WebThread* backgroundThread, const String& searchId, const String& query, bool caseSensitive, bool isRegex);
+
+    bool isCancelled() const;
+    void startPlainTextBatch(size_t begin, size_t end);
+    void runPlainTextBatch(PlainTextBatch*);
+    void searchPlainTextBatch(PlainTextBatch*) const;
+    void didSearchPlainTextBatch(PlainTextBatch*);
+    void scheduleRegexSlice();
+    void runRegexSlice();
+    void finish();
+
+    Client* m_client;
+    WebThread* m_inspectorThread;
+    WebThread* m_backgroundThread;
+    String m_searchId;
+    String m_query;
+    bool m_caseSensitive;
+    bool m_isRegex;
+    OwnPtr<ScriptRegexp> m_urlRegex;
+    Vector<Script> m_scripts;
+    size_t m_nextScript;
+    size_t m_pendingBatches;
+    volatile int m_cancelled;
+};
+
+} // namespace blink
+
+#endif // !defined(ScriptSearchJob_h)
@@ -0,0 +1,188 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/inspector/ScriptSearchJob.h"
+
+#include "public/platform/WebThread.h"
+#include "wtf/OwnPtr.h"
+#include <gtest/gtest.h>
+
+namespace blink {
+namespace {
+
+class TestClient final : public ScriptSearchJob::Client {
+public:
+    TestClient() : m_finished(0), m_lineEndings(0) { }
+
+    void didFindSearchResults(const String& searchId, PassRefPtr<TypeBuilder::Array<TypeBuilder::Debugger::ScriptSearchResult>> results) override
+    {
+        EXPECT_EQ("1", searchId);
+        m_results.append(results->toJSONString());
+        m_resultCounts.append(results->length());
+    }
+    void didFinishSearch(const String& searchId) override
+    {
+        EXPECT_EQ("1", searchId);
+        ++m_finished;
+    }
+    void didComputeLineEndings(const String&, const String&, PassRefPtr<ContentSearchUtils::LineEndings>) override { ++m_lineEndings; }
+
+    Vector<String> m_results;
+    Vector<unsigned> m_resultCounts;
+    int m_finished;
+    int m_lineEndings;
+};
+
+// Keeps the posted tasks until runTasks() is called.
+class TestThread final : public WebThread {
+public:
+    void postTask(const WebTraceLocation& location, Task* task) override { postDelayedTask(location, task, 0); }
+    void postDelayedTask(const WebTraceLocation&, Task* task, long long) override { m_tasks.append(adoptPtr(task)); }
+    bool isCurrentThread() const override { return true; }
+    WebScheduler* scheduler() const override { return nullptr; }
+
+    size_t runTasks()
+    {
+        Vector<OwnPtr<Task>> tasks;
+        tasks.swap(m_tasks);
+        for (const OwnPtr<Task>& task : tasks)
+            task->run();
+        return tasks.size();
+    }
+
+    Vector<OwnPtr<Task>> m_tasks;
+};
+
+class ScriptSearchJobTest : public ::testing::Test {
+protected:
+    PassRefPtr<ScriptSearchJob> createJob(const String& query, bool isRegex)
+    {
+        return ScriptSearchJob::create(&m_client, &m_inspectorThread, &m_backgroundThread, "1", query, false, isRegex);
+    }
+
+    static void addScripts(ScriptSearchJob* job, size_t count, const String& source)
+    {
+        for (size_t i = 0; i < count; ++i)
+            job->addScript(String::number(i), "script" + String::number(i) + ".js", source, nullptr);
+    }
+
+    TestClient m_client;
+    TestThread m_inspectorThread;
+    TestThread m_backgroundThread;
+};
+
+TEST_F(ScriptSearchJobTest, PlainTextResultsArrivePerBatch)
+{
+    RefPtr<ScriptSearchJob> job = createJob("bar", false);
+    addScripts(job.get(), 300, "foo\nbar");
+    job->start();
+    EXPECT_TRUE(m_inspectorThread.m_tasks.isEmpty());
+    EXPECT_EQ(2u, m_backgroundThread.runTasks());
+    EXPECT_TRUE(m_client.m_results.isEmpty());
+
+    ASSERT_EQ(2u, m_inspectorThread.m_tasks.size());
+    m_inspectorThread.m_tasks[0]->run();
+    ASSERT_EQ(1u, m_client.m_resultCounts.size());
+    EXPECT_EQ(256u, m_client.m_resultCounts[0]);
+    EXPECT_EQ(0, m_client.m_finished);
+
+    m_inspectorThread.m_tasks[1]->run();
+    ASSERT_EQ(2u, m_client.m_resultCounts.size());
+    EXPECT_EQ(44u, m_client.m_resultCounts[1]);
+    EXPECT_EQ(1, m_client.m_finished);
+    EXPECT_EQ(300, m_client.m_lineEndings);
+}
+
+TEST_F(ScriptSearchJobTest, PlainTextBatchesWithoutMatchesReportNothing)
+{
+    RefPtr<ScriptSearchJob> job = createJob("baz", false);
+    addScripts(job.get(), 3, "foo\nbar");
+    job->start();
+    m_backgroundThread.runTasks();
+    m_inspectorThread.runTasks();
+    EXPECT_TRUE(m_client.m_results.isEmpty());
+    EXPECT_EQ(1, m_client.m_finished);
+}
+
+// The test clock moves on by a minute per call, so every slice runs out of
+// time after its first script.
+TEST_F(ScriptSearchJobTest, RegexSearchRunsInSlices)
+{
+    RefPtr<ScriptSearchJob> job = createJob("b.r", true);
+    addScripts(job.get(), 3, "foo\nbar");
+    job->start();
+    EXPECT_TRUE(m_backgroundThread.m_tasks.isEmpty());
+    for (size_t i = 1; i <= 3; ++i) {
+        EXPECT_EQ(0, m_client.m_finished);
+        EXPECT_EQ(1u, m_inspectorThread.runTasks());
+        EXPECT_EQ(i, m_client.m_results.size());
+    }
+    EXPECT_EQ(1, m_client.m_finished);
+    EXPECT_TRUE(m_inspectorThread.m_tasks.isEmpty());
+    EXPECT_EQ(3, m_client.m_lineEndings);
+}
+
+TEST_F(ScriptSearchJobTest, CancelledPlainTextSearchReportsNothing)
+{
+    RefPtr<ScriptSearchJob> job = createJob("bar", false);
+    addScripts(job.get(), 3, "foo\nbar");
+    job->start();
+    job->cancel();
+    m_backgroundThread.runTasks();
+    m_inspectorThread.runTasks();
+    EXPECT_TRUE(m_client.m_results.isEmpty());
+    EXPECT_EQ(0, m_client.m_finished);
+}
+
+TEST_F(ScriptSearchJobTest, CancelledRegexSearchStopsSlicing)
+{
+    RefPtr<ScriptSearchJob> job = createJob("b.r", true);
+    addScripts(job.get(), 3, "foo\nbar");
+    job->start();
+    m_inspectorThread.runTasks();
+    EXPECT_EQ(1u, m_client.m_results.size());
+
+    job->cancel();
+    EXPECT_EQ(1u, m_inspectorThread.runTasks());
+    EXPECT_TRUE(m_inspectorThread.m_tasks.isEmpty());
+    EXPECT_EQ(1u, m_client.m_results.size());
+    EXPECT_EQ(0, m_client.m_finished);
+}
+
+TEST_F(ScriptSearchJobTest, URLFilterSkipsScripts)
+{
+    RefPtr<ScriptSearchJob> job = createJob("bar", false);
+    EXPECT_TRUE(job->setURLFilter("^lib/"));
+    job->addScript("1", "lib/a.js", "bar", nullptr);
+    job->addScript("2", "app/b.js", "bar", nullptr);
+    job->addScript("3", "lib/c.js", "bar", nullptr);
+    job->start();
+    m_backgroundThread.runTasks();
+    m_inspectorThread.runTasks();
+    ASSERT_EQ(1u, m_client.m_resultCounts.size());
+    EXPECT_EQ(2u, m_client.m_resultCounts[0]);
+    EXPECT_NE(kNotFound, m_client.m_results[0].find("lib/a.js"));
+    EXPECT_NE(kNotFound, m_client.m_results[0].find("lib/c.js"));
+    EXPECT_EQ(kNotFound, m_client.m_results[0].find("app/b.js"));
+    EXPECT_EQ(1, m_client.m_finished);
+}
+
+TEST_F(ScriptSearchJobTest, InvalidURLFilter)
+{
+    RefPtr<ScriptSearchJob> job = createJob("bar", false);
+    EXPECT_FALSE(job->setURLFilter("("));
+}
+
+TEST_F(ScriptSearchJobTest, NoScriptsFinishesRightAway)
+{
+    RefPtr<ScriptSearchJob> job = createJob("bar", false);
+    job->addScript("1", "empty.js", "", nullptr);
+    job->start();
+    EXPECT_TRUE(m_backgroundThread.m_tasks.isEmpty());
+    EXPECT_EQ(1, m_client.m_finished);
+}
+
+} // namespace
+} // namespace blink
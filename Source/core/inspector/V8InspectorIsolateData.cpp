@@ -35,4 +35,11 @@ v8::Local<v8::Context> V8InspectorIsolateData::ensureScriptRegexpContext()
     return m_scriptRegexpScriptState->context();
 }
 
+PassRefPtr<ScriptCallFrameTable> V8InspectorIsolateData::callFrameTable()
+{
+    if (!m_callFrameTable || m_callFrameTable->isFull())
+        m_callFrameTable = ScriptCallFrameTable::create();
+    return m_callFrameTable;
+}
+
 } // namespace blink
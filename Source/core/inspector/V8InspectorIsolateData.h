@@ -5,7 +5,9 @@
 #ifndef V8InspectorIsolateData_h
 #define V8InspectorIsolateData_h
 
+#include "core/inspector/ScriptCallFrameTable.h"
 #include "wtf/Noncopyable.h"
+#include "wtf/PassRefPtr.h"
 #include "wtf/RefPtr.h"
 #include <v8.h>
 
@@ -19,6 +21,8 @@ public:
     static V8InspectorIsolateData* from(v8::Isolate*);
 
     v8::Local<v8::Context> ensureScriptRegexpContext();
+    // Where captured call stacks intern their frames.
+    PassRefPtr<ScriptCallFrameTable> callFrameTable();
 
 private:
     explicit V8InspectorIsolateData(v8::Isolate*);
@@ -26,6 +30,7 @@ private:
 
     v8::Isolate* m_isolate;
     RefPtr<ScriptState> m_scriptRegexpScriptState;
+    RefPtr<ScriptCallFrameTable> m_callFrameTable;
 };
 
 } // namespace blink
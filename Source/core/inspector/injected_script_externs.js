@@ -47,6 +47,21 @@ InjectedScriptHostClass.prototype.isHTMLAllCollection = function(obj) {}
  */
 InjectedScriptHostClass.prototype.isTypedArray = function(obj) {}
 
+/**
+ * @param {!Object} obj
+ * @param {number} fromIndex
+ * @param {number} toIndex
+ * @param {number} maxCount
+ * @param {number} timeBudgetMs
+ * @return {?Array.<*>}
+ */
+InjectedScriptHostClass.prototype.indexedDataProperties = function(obj, fromIndex, toIndex, maxCount, timeBudgetMs) {}
+
+/**
+ * @return {number}
+ */
+InjectedScriptHostClass.prototype.monotonicTime = function() {}
+
 /**
  * @param {*} obj
  * @return {string}
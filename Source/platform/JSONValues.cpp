@@ -88,6 +88,20 @@ void writeIndent(int depth, StringBuilder* output)
 
 } // anonymous namespace
 
+void doubleQuoteStringForJSON(const String& str, StringBuilder* dst)
+{
+    doubleQuoteString(str, dst);
+}
+
+void writeNumberForJSON(double value, StringBuilder* output)
+{
+    if (!std::isfinite(value)) {
+        output->append(nullString, 4);
+        return;
+    }
+    output->append(Decimal::fromDouble(value).toString());
+}
+
 bool JSONValue::asBoolean(bool*) const
 {
     return false;
@@ -239,11 +253,7 @@ void JSONBasicValue::writeJSON(StringBuilder* output) const
         else
             output->append(falseString, 5);
     } else if (type() == TypeNumber) {
-        if (!std::isfinite(m_doubleValue)) {
-            output->append(nullString, 4);
-            return;
-        }
-        output->append(Decimal::fromDouble(m_doubleValue).toString());
+        writeNumberForJSON(m_doubleValue, output);
     }
 }
 
@@ -259,6 +269,11 @@ void JSONString::writeJSON(StringBuilder* output) const
     doubleQuoteString(m_stringValue, output);
 }
 
+void JSONRawValue::writeJSON(StringBuilder* output) const
+{
+    output->append(m_json);
+}
+
 JSONObjectBase::~JSONObjectBase()
 {
 }
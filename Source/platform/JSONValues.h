@@ -74,6 +74,10 @@ namespace blink {
 class JSONArray;
 class JSONObject;
 
+// Helpers for code that writes protocol JSON without building JSONValues.
+PLATFORM_EXPORT void doubleQuoteStringForJSON(const String&, StringBuilder*);
+PLATFORM_EXPORT void writeNumberForJSON(double, StringBuilder*);
+
 class PLATFORM_EXPORT JSONValue : public RefCounted<JSONValue> {
 public:
     static const int maxDepth = 1000;
@@ -92,7 +96,9 @@ public:
         TypeNumber,
         TypeString,
         TypeObject,
-        TypeArray
+        TypeArray,
+        // JSON text of any type, see JSONRawValue.
+        TypeRaw
     } Type;
 
     Type type() const { return m_type; }
@@ -189,6 +195,24 @@ private:
     String m_stringValue;
 };
 
+// JSON text that was serialized elsewhere and is written out as it is. The
+// text is opaque: its type is TypeRaw whatever value it holds, and
+// asObject(), asArray() and the other getters fail.
+class PLATFORM_EXPORT JSONRawValue : public JSONValue {
+public:
+    static PassRefPtr<JSONRawValue> create(const String& json)
+    {
+        return adoptRef(new JSONRawValue(json));
+    }
+
+    virtual void writeJSON(StringBuilder* output) const override;
+
+private:
+    explicit JSONRawValue(const String& json) : JSONValue(TypeRaw), m_json(json) { }
+
+    String m_json;
+};
+
 class PLATFORM_EXPORT JSONObjectBase : public JSONValue {
 private:
     typedef HashMap<String, RefPtr<JSONValue>> Dictionary;
@@ -0,0 +1,43 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "public/platform/WebThread.h"
+
+#include "public/platform/WebTraceLocation.h"
+#include "wtf/OwnPtr.h"
+
+namespace blink {
+
+namespace {
+
+class FunctionTask : public WebThread::Task {
+public:
+    explicit FunctionTask(PassOwnPtr<Function<void()>> function)
+        : m_function(function)
+    {
+    }
+
+    void run() override
+    {
+        (*m_function)();
+    }
+
+private:
+    OwnPtr<Function<void()>> m_function;
+};
+
+} // namespace
+
+void WebThread::postTask(const WebTraceLocation& location, PassOwnPtr<Function<void()>> function)
+{
+    postTask(location, new FunctionTask(function));
+}
+
+void WebThread::postDelayedTask(const WebTraceLocation& location, PassOwnPtr<Function<void()>> function, long long delayMs)
+{
+    postDelayedTask(location, new FunctionTask(function), delayMs);
+}
+
+} // namespace blink
@@ -0,0 +1,113 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/CodeCache.h"
+
+#include "base/files/file_util.h"
+#include "base/hash.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace v8inspector {
+
+namespace {
+
+const uint32_t kMagic = 0x43433856;  // "V8CC"
+
+struct EntryHeader {
+    uint32_t magic;
+    uint32_t version_tag;
+    uint32_t payload_length;
+    uint32_t payload_hash;
+};
+
+}
+
+CodeCache::CodeCache(const base::FilePath& directory)
+    : directory_(directory),
+      version_tag_(v8::ScriptCompiler::CachedDataVersionTag()) {
+    if (!base::CreateDirectory(directory_))
+        fprintf(stderr, "Code cache: cannot create %s\n", directory_.value().c_str());
+}
+
+CodeCache::~CodeCache() {
+}
+
+// static
+std::string CodeCache::KeyFor(const char* source, size_t length) {
+    unsigned char hash[base::kSHA1Length];
+    base::SHA1HashBytes(reinterpret_cast<const unsigned char*>(source), length, hash);
+    return base::HexEncode(hash, sizeof(hash));
+}
+
+v8::ScriptCompiler::CachedData* CodeCache::Lookup(const std::string& key) {
+    std::string contents;
+    if (!base::ReadFileToString(PathFor(key), &contents)) {
+        ++statistics_.misses;
+        return NULL;
+    }
+    EntryHeader header;
+    if (contents.size() < sizeof(header)) {
+        Reject(key);
+        return NULL;
+    }
+    memcpy(&header, contents.data(), sizeof(header));
+    const char* payload = contents.data() + sizeof(header);
+    size_t payload_length = contents.size() - sizeof(header);
+    // Entries of other builds have other names, so a tag that does not match
+    // the name is corruption like any other.
+    if (header.magic != kMagic
+        || header.version_tag != version_tag_
+        || header.payload_length != payload_length
+        || header.payload_hash != base::Hash(payload, payload_length)) {
+        Reject(key);
+        return NULL;
+    }
+    uint8_t* data = new uint8_t[payload_length];
+    memcpy(data, payload, payload_length);
+    return new v8::ScriptCompiler::CachedData(data, static_cast<int>(payload_length), v8::ScriptCompiler::CachedData::BufferOwned);
+}
+
+void CodeCache::DidConsume(const std::string& key, const v8::ScriptCompiler::CachedData& data) {
+    if (data.rejected)
+        Reject(key);
+    else
+        ++statistics_.hits;
+}
+
+void CodeCache::Store(const std::string& key, const v8::ScriptCompiler::CachedData& data) {
+    EntryHeader header;
+    header.magic = kMagic;
+    header.version_tag = version_tag_;
+    header.payload_length = data.length;
+    header.payload_hash = base::Hash(reinterpret_cast<const char*>(data.data), data.length);
+    std::string contents(reinterpret_cast<const char*>(&header), sizeof(header));
+    contents.append(reinterpret_cast<const char*>(data.data), data.length);
+
+    // Write to a temporary file first so that a concurrently starting process
+    // never sees a partially written entry.
+    base::FilePath path = PathFor(key);
+    base::FilePath temp_path = path.AddExtension(FILE_PATH_LITERAL("tmp"));
+    if (base::WriteFile(temp_path, contents.data(), contents.size()) != static_cast<int>(contents.size())
+        || !base::ReplaceFile(temp_path, path, NULL)) {
+        base::DeleteFile(temp_path, false);
+        return;
+    }
+    ++statistics_.stored;
+}
+
+base::FilePath CodeCache::PathFor(const std::string& key) const {
+    return directory_.AppendASCII(key + "-" + base::HexEncode(&version_tag_, sizeof(version_tag_)) + ".v8cache");
+}
+
+void CodeCache::Reject(const std::string& key) {
+    ++statistics_.rejected;
+    base::DeleteFile(PathFor(key), false);
+}
+
+}  // namespace v8inspector
@@ -0,0 +1,57 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CODE_CACHE_H_
+#define CODE_CACHE_H_
+
+#include "base/files/file_path.h"
+#include <include/v8.h>
+#include <string>
+
+namespace v8inspector {
+
+// On-disk store for the code cache V8 produces with kProduceCodeCache, so that
+// scripts loaded by the shell do not have to be recompiled on every start.
+//
+// Entries are named after a SHA-1 of the script source and V8's
+// CachedDataVersionTag (V8 version and flags), so that builds sharing a
+// directory keep separate entries. Each entry also carries the tag and a
+// payload checksum; entries that do not match are rejected and removed, as
+// are entries V8 itself refuses to consume.
+class CodeCache {
+public:
+    struct Statistics {
+        Statistics() : hits(0), misses(0), rejected(0), stored(0) {}
+        int hits;
+        int misses;
+        int rejected;
+        int stored;
+    };
+
+    explicit CodeCache(const base::FilePath& directory);
+    ~CodeCache();
+
+    static std::string KeyFor(const char* source, size_t length);
+
+    // Returns the cached data stored for |key| (owned by the caller), or NULL
+    // if there is no usable entry.
+    v8::ScriptCompiler::CachedData* Lookup(const std::string& key);
+    // Records the outcome of compiling with data returned by Lookup.
+    void DidConsume(const std::string& key, const v8::ScriptCompiler::CachedData& data);
+    void Store(const std::string& key, const v8::ScriptCompiler::CachedData& data);
+
+    const Statistics& statistics() const { return statistics_; }
+
+private:
+    base::FilePath PathFor(const std::string& key) const;
+    void Reject(const std::string& key);
+
+    base::FilePath directory_;
+    uint32_t version_tag_;
+    Statistics statistics_;
+};
+
+}  // namespace v8inspector
+
+#endif // CODE_CACHE_H_
@@ -0,0 +1,155 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/CodeCache.h"
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/scoped_ptr.h"
+#include <gtest/gtest.h>
+
+namespace v8inspector {
+namespace {
+
+const char kSource[] = "function f() { return 1; }";
+const uint8_t kData[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+class CodeCacheTest : public ::testing::Test {
+protected:
+    CodeCacheTest()
+    {
+        EXPECT_TRUE(temp_dir_.CreateUniqueTempDir());
+        cache_.reset(new CodeCache(temp_dir_.path()));
+        key_ = CodeCache::KeyFor(kSource, sizeof(kSource) - 1);
+    }
+
+    void Store()
+    {
+        v8::ScriptCompiler::CachedData data(kData, sizeof(kData));
+        cache_->Store(key_, data);
+    }
+
+    // The one entry in the cache directory.
+    base::FilePath EntryPath()
+    {
+        base::FileEnumerator files(temp_dir_.path(), false, base::FileEnumerator::FILES);
+        base::FilePath path = files.Next();
+        EXPECT_FALSE(path.empty());
+        EXPECT_TRUE(files.Next().empty());
+        return path;
+    }
+
+    int EntryCount()
+    {
+        base::FileEnumerator files(temp_dir_.path(), false, base::FileEnumerator::FILES);
+        int count = 0;
+        while (!files.Next().empty())
+            ++count;
+        return count;
+    }
+
+    void ExpectStatistics(int hits, int misses, int rejected, int stored)
+    {
+        const CodeCache::Statistics& statistics = cache_->statistics();
+        EXPECT_EQ(hits, statistics.hits);
+        EXPECT_EQ(misses, statistics.misses);
+        EXPECT_EQ(rejected, statistics.rejected);
+        EXPECT_EQ(stored, statistics.stored);
+    }
+
+    base::ScopedTempDir temp_dir_;
+    scoped_ptr<CodeCache> cache_;
+    std::string key_;
+};
+
+TEST_F(CodeCacheTest, KeyDependsOnSource)
+{
+    EXPECT_EQ(key_, CodeCache::KeyFor(kSource, sizeof(kSource) - 1));
+    EXPECT_NE(key_, CodeCache::KeyFor(kSource, sizeof(kSource) - 2));
+}
+
+TEST_F(CodeCacheTest, MissThenStoreThenHit)
+{
+    EXPECT_FALSE(cache_->Lookup(key_));
+    ExpectStatistics(0, 1, 0, 0);
+
+    Store();
+    ExpectStatistics(0, 1, 0, 1);
+    EXPECT_EQ(1, EntryCount());
+
+    scoped_ptr<v8::ScriptCompiler::CachedData> data(cache_->Lookup(key_));
+    ASSERT_TRUE(data);
+    ASSERT_EQ(static_cast<int>(sizeof(kData)), data->length);
+    EXPECT_EQ(0, memcmp(kData, data->data, sizeof(kData)));
+    cache_->DidConsume(key_, *data);
+    ExpectStatistics(1, 1, 0, 1);
+}
+
+TEST_F(CodeCacheTest, EntryRejectedByV8IsRemoved)
+{
+    Store();
+    scoped_ptr<v8::ScriptCompiler::CachedData> data(cache_->Lookup(key_));
+    ASSERT_TRUE(data);
+    data->rejected = true;
+    cache_->DidConsume(key_, *data);
+    ExpectStatistics(0, 0, 1, 1);
+    EXPECT_EQ(0, EntryCount());
+
+    EXPECT_FALSE(cache_->Lookup(key_));
+    ExpectStatistics(0, 1, 1, 1);
+}
+
+TEST_F(CodeCacheTest, CorruptedPayloadIsRejected)
+{
+    Store();
+    base::FilePath path = EntryPath();
+    std::string contents;
+    ASSERT_TRUE(base::ReadFileToString(path, &contents));
+    contents[contents.size() - 1] ^= 1;
+    ASSERT_EQ(static_cast<int>(contents.size()), base::WriteFile(path, contents.data(), contents.size()));
+
+    EXPECT_FALSE(cache_->Lookup(key_));
+    ExpectStatistics(0, 0, 1, 1);
+    EXPECT_EQ(0, EntryCount());
+}
+
+TEST_F(CodeCacheTest, TagNotMatchingTheNameIsRejected)
+{
+    Store();
+    base::FilePath path = EntryPath();
+    std::string contents;
+    ASSERT_TRUE(base::ReadFileToString(path, &contents));
+    // The version tag follows the magic number.
+    contents[4] ^= 1;
+    ASSERT_EQ(static_cast<int>(contents.size()), base::WriteFile(path, contents.data(), contents.size()));
+
+    EXPECT_FALSE(cache_->Lookup(key_));
+    ExpectStatistics(0, 0, 1, 1);
+    EXPECT_EQ(0, EntryCount());
+}
+
+TEST_F(CodeCacheTest, TruncatedEntryIsRejected)
+{
+    Store();
+    base::FilePath path = EntryPath();
+    ASSERT_EQ(3, base::WriteFile(path, "abc", 3));
+
+    EXPECT_FALSE(cache_->Lookup(key_));
+    ExpectStatistics(0, 0, 1, 1);
+    EXPECT_EQ(0, EntryCount());
+}
+
+TEST_F(CodeCacheTest, StoreReplacesEntry)
+{
+    Store();
+    Store();
+    ExpectStatistics(0, 0, 0, 2);
+    EXPECT_EQ(1, EntryCount());
+}
+
+}  // namespace
+}  // namespace v8inspector
@@ -0,0 +1,91 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/IdleGCScheduler.h"
+
+#include "base/bind.h"
+
+namespace v8inspector {
+
+namespace {
+
+// How long the loop has to stay free of tasks before it is considered idle.
+const int kQuietPeriodMs = 50;
+
+// Length of the idle slices handed to V8. Once the loop has been idle for a
+// while, slices grow so that V8 can finish a full mark-compact in one go; this
+// bounds the extra latency of a request that arrives during a slice.
+const int kShortIdleSliceMs = 10;
+const int kLongIdleSliceMs = 50;
+const int kLongIdleThresholdMs = 1000;
+
+}
+
+IdleGCScheduler::IdleGCScheduler(Heap* heap)
+    : heap_(heap),
+      message_loop_(base::MessageLoop::current()),
+      idle_heap_size_(heap->UsedHeapSize()),
+      active_(false),
+      idle_task_pending_(false),
+      in_idle_task_(false),
+      weak_factory_(this) {
+    message_loop_->AddTaskObserver(this);
+}
+
+IdleGCScheduler::~IdleGCScheduler() {
+    message_loop_->RemoveTaskObserver(this);
+}
+
+void IdleGCScheduler::DidProcessTask(const base::PendingTask& pending_task) {
+    if (in_idle_task_) {
+        in_idle_task_ = false;
+        return;
+    }
+    if (!active_) {
+        // Tasks that ran no JavaScript left V8 nothing to do.
+        if (heap_->UsedHeapSize() == idle_heap_size_)
+            return;
+        active_ = true;
+    }
+    last_task_end_ = base::TimeTicks::Now();
+    if (!idle_task_pending_)
+        ScheduleIdleTask(base::TimeDelta::FromMilliseconds(kQuietPeriodMs));
+}
+
+void IdleGCScheduler::ScheduleIdleTask(base::TimeDelta delay) {
+    idle_task_pending_ = true;
+    message_loop_->task_runner()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&IdleGCScheduler::RunIdleTask, weak_factory_.GetWeakPtr()),
+        delay);
+}
+
+void IdleGCScheduler::RunIdleTask() {
+    idle_task_pending_ = false;
+    in_idle_task_ = true;
+    // In a nested loop (e.g. paused on a breakpoint) collecting would only get
+    // in the way. The task that runs the loop schedules again once it returns.
+    if (message_loop_->IsNested())
+        return;
+
+    base::TimeDelta quiet = base::TimeTicks::Now() - last_task_end_;
+    base::TimeDelta quiet_period = base::TimeDelta::FromMilliseconds(kQuietPeriodMs);
+    // Tasks ran since this one was posted.
+    if (quiet < quiet_period) {
+        ScheduleIdleTask(quiet_period - quiet);
+        return;
+    }
+
+    int slice_ms = quiet.InMilliseconds() > kLongIdleThresholdMs ? kLongIdleSliceMs : kShortIdleSliceMs;
+    if (!heap_->IdleNotification(base::TimeDelta::FromMilliseconds(slice_ms))) {
+        ScheduleIdleTask(base::TimeDelta());
+        return;
+    }
+    active_ = false;
+    idle_heap_size_ = heap_->UsedHeapSize();
+}
+
+}  // namespace v8inspector
@@ -0,0 +1,61 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IDLE_GC_SCHEDULER_H_
+#define IDLE_GC_SCHEDULER_H_
+
+#include "base/memory/weak_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/time/time.h"
+
+namespace v8inspector {
+
+// Watches the tasks run by the current message loop and, once a task that ran
+// JavaScript is followed by a short quiet period, hands V8 bounded idle slices
+// through Isolate::IdleNotificationDeadline. This lets incremental marking
+// steps, scavenges and finalizations happen between inspector requests
+// instead of interrupting them. Idle slices stop once V8 reports it has
+// nothing left to do, and only resume after a task that changed the heap;
+// other tasks, and nested loops such as a pause on a breakpoint, post
+// nothing.
+class IdleGCScheduler : public base::MessageLoop::TaskObserver {
+public:
+    // The isolate as the scheduler sees it, so that tests can stand in for it.
+    class Heap {
+    public:
+        virtual ~Heap() {}
+        // Changes whenever JavaScript ran.
+        virtual size_t UsedHeapSize() = 0;
+        // Gives V8 |slice| of idle time. Returns true if V8 is done.
+        virtual bool IdleNotification(base::TimeDelta slice) = 0;
+    };
+
+    // |heap| must outlive this object.
+    explicit IdleGCScheduler(Heap* heap);
+    ~IdleGCScheduler() override;
+
+private:
+    // base::MessageLoop::TaskObserver implementation.
+    void WillProcessTask(const base::PendingTask& pending_task) override {}
+    void DidProcessTask(const base::PendingTask& pending_task) override;
+
+    void ScheduleIdleTask(base::TimeDelta delay);
+    void RunIdleTask();
+
+    Heap* heap_;
+    base::MessageLoop* message_loop_;
+    base::TimeTicks last_task_end_;
+    // Used heap size when V8 last reported it was done.
+    size_t idle_heap_size_;
+    // Whether V8 wants idle time, that is whether JavaScript ran since it
+    // last reported it was done.
+    bool active_;
+    bool idle_task_pending_;
+    bool in_idle_task_;
+    base::WeakPtrFactory<IdleGCScheduler> weak_factory_;
+};
+
+}  // namespace v8inspector
+
+#endif // IDLE_GC_SCHEDULER_H_
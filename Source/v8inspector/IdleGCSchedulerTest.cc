@@ -0,0 +1,134 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/IdleGCScheduler.h"
+
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include <gtest/gtest.h>
+
+namespace v8inspector {
+namespace {
+
+// Reports done after |slices_until_done| slices.
+class TestHeap : public IdleGCScheduler::Heap {
+public:
+    TestHeap()
+        : used_heap_size_(1000)
+        , slices_until_done_(3)
+        , slices_(0)
+        , slices_in_nested_loop_(0)
+    {
+    }
+
+    size_t UsedHeapSize() override { return used_heap_size_; }
+    bool IdleNotification(base::TimeDelta slice) override
+    {
+        EXPECT_GT(slice, base::TimeDelta());
+        ++slices_;
+        if (base::MessageLoop::current()->IsNested())
+            ++slices_in_nested_loop_;
+        return --slices_until_done_ <= 0;
+    }
+
+    // What a task that runs JavaScript does to the heap.
+    void RunJavaScript(int slices_until_done)
+    {
+        used_heap_size_ += 100;
+        slices_until_done_ = slices_until_done;
+    }
+
+    size_t used_heap_size_;
+    int slices_until_done_;
+    int slices_;
+    int slices_in_nested_loop_;
+};
+
+void DoNothing()
+{
+}
+
+void RunJavaScript(TestHeap* heap, int slices_until_done)
+{
+    heap->RunJavaScript(slices_until_done);
+}
+
+void RunNestedLoopFor(base::TimeDelta duration)
+{
+    base::MessageLoop::ScopedNestableTaskAllower allow(base::MessageLoop::current());
+    base::RunLoop run_loop;
+    base::MessageLoop::current()->task_runner()->PostDelayedTask(FROM_HERE, run_loop.QuitClosure(), duration);
+    run_loop.Run();
+}
+
+class IdleGCSchedulerTest : public ::testing::Test {
+protected:
+    IdleGCSchedulerTest()
+        : scheduler_(&heap_)
+    {
+    }
+
+    void Post(const base::Closure& task)
+    {
+        message_loop_.task_runner()->PostTask(FROM_HERE, task);
+    }
+
+    // Long enough for the quiet period and every slice the test heap wants.
+    void RunFor(int milliseconds)
+    {
+        base::RunLoop run_loop;
+        message_loop_.task_runner()->PostDelayedTask(FROM_HERE, run_loop.QuitClosure(), base::TimeDelta::FromMilliseconds(milliseconds));
+        run_loop.Run();
+    }
+
+    base::MessageLoop message_loop_;
+    TestHeap heap_;
+    IdleGCScheduler scheduler_;
+};
+
+TEST_F(IdleGCSchedulerTest, TasksWithoutJavaScriptGetNoSlices)
+{
+    Post(base::Bind(&DoNothing));
+    Post(base::Bind(&DoNothing));
+    RunFor(200);
+    EXPECT_EQ(0, heap_.slices_);
+}
+
+TEST_F(IdleGCSchedulerTest, SlicesStopWhenV8IsDone)
+{
+    Post(base::Bind(&RunJavaScript, &heap_, 3));
+    RunFor(200);
+    EXPECT_EQ(3, heap_.slices_);
+
+    // Neither time nor tasks that leave the heap alone bring them back.
+    Post(base::Bind(&DoNothing));
+    RunFor(200);
+    EXPECT_EQ(3, heap_.slices_);
+}
+
+TEST_F(IdleGCSchedulerTest, JavaScriptBringsSlicesBack)
+{
+    Post(base::Bind(&RunJavaScript, &heap_, 1));
+    RunFor(200);
+    EXPECT_EQ(1, heap_.slices_);
+
+    Post(base::Bind(&RunJavaScript, &heap_, 2));
+    RunFor(200);
+    EXPECT_EQ(3, heap_.slices_);
+}
+
+TEST_F(IdleGCSchedulerTest, NestedLoopGetsNoSlices)
+{
+    Post(base::Bind(&RunJavaScript, &heap_, 1));
+    Post(base::Bind(&RunNestedLoopFor, base::TimeDelta::FromMilliseconds(200)));
+    RunFor(400);
+    EXPECT_EQ(0, heap_.slices_in_nested_loop_);
+    EXPECT_EQ(1, heap_.slices_);
+}
+
+} // namespace
+} // namespace v8inspector
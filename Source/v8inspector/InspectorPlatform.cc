@@ -0,0 +1,85 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/InspectorPlatform.h"
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/single_thread_task_runner.h"
+#include "base/time/time.h"
+#include "v8inspector/WorkStealingThreadPool.h"
+
+namespace v8inspector {
+
+namespace {
+
+void RunTask(v8::Task* task) {
+    task->Run();
+}
+
+void PostTask(base::SingleThreadTaskRunner* task_runner, v8::Task* task) {
+    task_runner->PostTask(FROM_HERE, base::Bind(&RunTask, base::Owned(task)));
+}
+
+}
+
+InspectorPlatform::IsolateData::IsolateData() {
+}
+
+InspectorPlatform::IsolateData::~IsolateData() {
+}
+
+InspectorPlatform::InspectorPlatform()
+    : background_pool_(new WorkStealingThreadPool(0)) {
+}
+
+InspectorPlatform::~InspectorPlatform() {
+    while (!isolates_.empty())
+        UnregisterIsolate(isolates_.begin()->first);
+}
+
+void InspectorPlatform::RegisterIsolate(v8::Isolate* isolate, scoped_refptr<base::SingleThreadTaskRunner> task_runner) {
+    base::AutoLock lock(lock_);
+    IsolateData& data = isolates_[isolate];
+    data.task_runner = task_runner;
+    for (size_t i = 0; i < data.early_tasks.size(); ++i)
+        PostTask(task_runner.get(), data.early_tasks[i]);
+    data.early_tasks.clear();
+}
+
+void InspectorPlatform::UnregisterIsolate(v8::Isolate* isolate) {
+    base::AutoLock lock(lock_);
+    std::map<v8::Isolate*, IsolateData>::iterator it = isolates_.find(isolate);
+    if (it == isolates_.end())
+        return;
+    for (size_t i = 0; i < it->second.early_tasks.size(); ++i)
+        delete it->second.early_tasks[i];
+    isolates_.erase(it);
+}
+
+void InspectorPlatform::CallOnBackgroundThread(v8::Task* task, ExpectedRuntime expected_runtime) {
+    base::Closure closure = base::Bind(&RunTask, base::Owned(task));
+    if (expected_runtime == kLongRunningTask)
+        background_pool_->PostLongRunningTask(closure);
+    else
+        background_pool_->PostTask(closure);
+}
+
+void InspectorPlatform::CallOnForegroundThread(v8::Isolate* isolate, v8::Task* task) {
+    base::AutoLock lock(lock_);
+    IsolateData& data = isolates_[isolate];
+    if (!data.task_runner) {
+        data.early_tasks.push_back(task);
+        return;
+    }
+    PostTask(data.task_runner.get(), task);
+}
+
+double InspectorPlatform::MonotonicallyIncreasingTime() {
+    return base::TimeTicks::Now().ToInternalValue() / static_cast<double>(base::Time::kMicrosecondsPerSecond);
+}
+
+}  // namespace v8inspector
@@ -0,0 +1,65 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef INSPECTOR_PLATFORM_H_
+#define INSPECTOR_PLATFORM_H_
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include <include/v8-platform.h>
+#include <map>
+#include <vector>
+
+namespace base {
+class SingleThreadTaskRunner;
+}
+
+namespace v8inspector {
+
+class WorkStealingThreadPool;
+
+// v8::Platform that runs foreground tasks on the base::MessageLoop of their
+// isolate, next to inspector and script tasks, instead of queueing them for a
+// PumpMessageLoop() call that nobody makes. Background tasks go to a
+// WorkStealingThreadPool sized to the machine.
+class InspectorPlatform : public v8::Platform {
+public:
+    InspectorPlatform();
+    ~InspectorPlatform() override;
+
+    // Foreground tasks for |isolate| run on |task_runner| from now on. Tasks
+    // posted before are held back until then.
+    void RegisterIsolate(v8::Isolate*, scoped_refptr<base::SingleThreadTaskRunner> task_runner);
+    // Drops the tasks |isolate| still has queued here.
+    void UnregisterIsolate(v8::Isolate*);
+
+    WorkStealingThreadPool* background_pool() const { return background_pool_.get(); }
+
+    // v8::Platform implementation.
+    void CallOnBackgroundThread(v8::Task*, ExpectedRuntime) override;
+    void CallOnForegroundThread(v8::Isolate*, v8::Task*) override;
+    double MonotonicallyIncreasingTime() override;
+
+private:
+    struct IsolateData {
+        IsolateData();
+        ~IsolateData();
+
+        scoped_refptr<base::SingleThreadTaskRunner> task_runner;
+        // Tasks posted before the isolate was registered.
+        std::vector<v8::Task*> early_tasks;
+    };
+
+    scoped_ptr<WorkStealingThreadPool> background_pool_;
+    base::Lock lock_;
+    std::map<v8::Isolate*, IsolateData> isolates_;
+
+    DISALLOW_COPY_AND_ASSIGN(InspectorPlatform);
+};
+
+}  // namespace v8inspector
+
+#endif // INSPECTOR_PLATFORM_H_
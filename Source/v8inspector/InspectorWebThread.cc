@@ -0,0 +1,89 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/InspectorWebThread.h"
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/location.h"
+#include "base/single_thread_task_runner.h"
+#include "base/time/time.h"
+#include "public/platform/WebTraceLocation.h"
+#include "v8inspector/WorkStealingThreadPool.h"
+
+namespace v8inspector {
+
+namespace {
+
+void RunTask(blink::WebThread::Task* task) {
+    task->run();
+}
+
+void PostToPool(WorkStealingThreadPool* pool, const base::Closure& task) {
+    pool->PostTask(task);
+}
+
+tracked_objects::Location ToLocation(const blink::WebTraceLocation& location) {
+    return tracked_objects::Location(location.functionName(), location.fileName(), 0, nullptr);
+}
+
+}
+
+TaskRunnerWebThread::TaskRunnerWebThread(scoped_refptr<base::SingleThreadTaskRunner> task_runner)
+    : task_runner_(task_runner) {
+}
+
+TaskRunnerWebThread::~TaskRunnerWebThread() {
+}
+
+void TaskRunnerWebThread::postTask(const blink::WebTraceLocation& location, Task* task) {
+    task_runner_->PostTask(ToLocation(location), base::Bind(&RunTask, base::Owned(task)));
+}
+
+void TaskRunnerWebThread::postDelayedTask(const blink::WebTraceLocation& location, Task* task, long long delay_ms) {
+    task_runner_->PostDelayedTask(ToLocation(location), base::Bind(&RunTask, base::Owned(task)),
+        base::TimeDelta::FromMilliseconds(delay_ms));
+}
+
+bool TaskRunnerWebThread::isCurrentThread() const {
+    return task_runner_->BelongsToCurrentThread();
+}
+
+blink::WebScheduler* TaskRunnerWebThread::scheduler() const {
+    return nullptr;
+}
+
+ThreadPoolWebThread::ThreadPoolWebThread(WorkStealingThreadPool* pool, scoped_refptr<base::SingleThreadTaskRunner> timer_task_runner)
+    : pool_(pool)
+    , timer_task_runner_(timer_task_runner) {
+}
+
+ThreadPoolWebThread::~ThreadPoolWebThread() {
+}
+
+void ThreadPoolWebThread::postTask(const blink::WebTraceLocation&, Task* task) {
+    pool_->PostTask(base::Bind(&RunTask, base::Owned(task)));
+}
+
+void ThreadPoolWebThread::postDelayedTask(const blink::WebTraceLocation& location, Task* task, long long delay_ms) {
+    if (delay_ms <= 0) {
+        postTask(location, task);
+        return;
+    }
+    timer_task_runner_->PostDelayedTask(ToLocation(location),
+        base::Bind(&PostToPool, base::Unretained(pool_), base::Bind(&RunTask, base::Owned(task))),
+        base::TimeDelta::FromMilliseconds(delay_ms));
+}
+
+bool ThreadPoolWebThread::isCurrentThread() const {
+    return pool_->IsWorkerThread();
+}
+
+blink::WebScheduler* ThreadPoolWebThread::scheduler() const {
+    return nullptr;
+}
+
+}  // namespace v8inspector
@@ -0,0 +1,63 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef INSPECTOR_WEB_THREAD_H_
+#define INSPECTOR_WEB_THREAD_H_
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "public/platform/WebThread.h"
+
+namespace base {
+class SingleThreadTaskRunner;
+}
+
+namespace v8inspector {
+
+class WorkStealingThreadPool;
+
+// blink::WebThread that runs its tasks on a base::SingleThreadTaskRunner, for
+// handing the inspector's message loop to Blink code.
+class TaskRunnerWebThread : public blink::WebThread {
+public:
+    explicit TaskRunnerWebThread(scoped_refptr<base::SingleThreadTaskRunner>);
+    ~TaskRunnerWebThread() override;
+
+    // blink::WebThread implementation.
+    void postTask(const blink::WebTraceLocation&, Task*) override;
+    void postDelayedTask(const blink::WebTraceLocation&, Task*, long long delay_ms) override;
+    bool isCurrentThread() const override;
+    blink::WebScheduler* scheduler() const override;
+
+private:
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
+
+    DISALLOW_COPY_AND_ASSIGN(TaskRunnerWebThread);
+};
+
+// blink::WebThread that runs its tasks on a WorkStealingThreadPool, so that
+// several of them may run at once. The pool has no timers, so delayed tasks
+// wait on |timer_task_runner| and then go to the pool. Any of the pool's
+// workers counts as the current thread.
+class ThreadPoolWebThread : public blink::WebThread {
+public:
+    ThreadPoolWebThread(WorkStealingThreadPool*, scoped_refptr<base::SingleThreadTaskRunner> timer_task_runner);
+    ~ThreadPoolWebThread() override;
+
+    // blink::WebThread implementation.
+    void postTask(const blink::WebTraceLocation&, Task*) override;
+    void postDelayedTask(const blink::WebTraceLocation&, Task*, long long delay_ms) override;
+    bool isCurrentThread() const override;
+    blink::WebScheduler* scheduler() const override;
+
+private:
+    WorkStealingThreadPool* pool_;
+    scoped_refptr<base::SingleThreadTaskRunner> timer_task_runner_;
+
+    DISALLOW_COPY_AND_ASSIGN(ThreadPoolWebThread);
+};
+
+}  // namespace v8inspector
+
+#endif // INSPECTOR_WEB_THREAD_H_
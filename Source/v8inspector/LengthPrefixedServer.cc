@@ -0,0 +1,199 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/LengthPrefixedServer.h"
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/socket/server_socket.h"
+#include "net/socket/stream_socket.h"
+#include <string.h>
+
+namespace v8inspector {
+
+namespace {
+
+const size_t kLengthPrefixSize = 4;
+const int kReadBufferSize = 64 * 1024;
+// Same limit as the send buffer of devtools WebSocket connections.
+const uint32 kMaxMessageSize = 256 * 1024 * 1024;
+
+} // namespace
+
+LengthPrefixedServer::LengthPrefixedServer(scoped_ptr<net::ServerSocket> server_socket, Delegate* delegate)
+    : server_socket_(server_socket.Pass())
+    , delegate_(delegate)
+    , connection_id_(0)
+    , last_connection_id_(0)
+    , read_buffer_(new net::IOBuffer(kReadBufferSize))
+    , weak_factory_(this)
+{
+    DCHECK(server_socket_);
+    // Accept asynchronously, in case the delegate is not ready for callbacks
+    // yet.
+    base::MessageLoopProxy::current()->PostTask(
+        FROM_HERE,
+        base::Bind(&LengthPrefixedServer::DoAcceptLoop, weak_factory_.GetWeakPtr()));
+}
+
+LengthPrefixedServer::~LengthPrefixedServer()
+{
+}
+
+void LengthPrefixedServer::Send(int connection_id, const std::string& data)
+{
+    if (connection_id != connection_id_ || !socket_)
+        return;
+    DCHECK_LE(data.size(), kMaxMessageSize);
+    uint32 length = static_cast<uint32>(data.size());
+    scoped_refptr<net::IOBuffer> frame = new net::IOBuffer(kLengthPrefixSize + length);
+    char* p = frame->data();
+    p[0] = static_cast<char>(length >> 24);
+    p[1] = static_cast<char>(length >> 16);
+    p[2] = static_cast<char>(length >> 8);
+    p[3] = static_cast<char>(length);
+    memcpy(p + kLengthPrefixSize, data.data(), length);
+    pending_output_.push_back(new net::DrainableIOBuffer(frame.get(), kLengthPrefixSize + length));
+    if (!write_buffer_)
+        DoWriteLoop();
+}
+
+void LengthPrefixedServer::Close(int connection_id)
+{
+    if (connection_id != connection_id_ || !socket_)
+        return;
+    connection_id_ = 0;
+    pending_input_.clear();
+    pending_output_.clear();
+    write_buffer_ = nullptr;
+    // The call stack might be in a callback of the socket, so destroy it in
+    // the next run loop like net::HttpServer does.
+    base::MessageLoopProxy::current()->DeleteSoon(FROM_HERE, socket_.release());
+    delegate_->OnFramedClose(connection_id);
+    DoAcceptLoop();
+}
+
+void LengthPrefixedServer::DoAcceptLoop()
+{
+    if (socket_)
+        return;
+    int rv = server_socket_->Accept(&accepted_socket_,
+        base::Bind(&LengthPrefixedServer::OnAcceptCompleted, weak_factory_.GetWeakPtr()));
+    if (rv == net::ERR_IO_PENDING)
+        return;
+    HandleAcceptResult(rv);
+}
+
+void LengthPrefixedServer::OnAcceptCompleted(int rv)
+{
+    HandleAcceptResult(rv);
+}
+
+int LengthPrefixedServer::HandleAcceptResult(int rv)
+{
+    if (rv < 0) {
+        LOG(ERROR) << "Accept error: rv=" << rv;
+        return rv;
+    }
+    socket_ = accepted_socket_.Pass();
+    connection_id_ = ++last_connection_id_;
+    int connection_id = connection_id_;
+    delegate_->OnFramedConnect(connection_id);
+    if (connection_id_ == connection_id)
+        DoReadLoop();
+    return net::OK;
+}
+
+void LengthPrefixedServer::DoReadLoop()
+{
+    int rv;
+    do {
+        rv = socket_->Read(read_buffer_.get(), kReadBufferSize,
+            base::Bind(&LengthPrefixedServer::OnReadCompleted, weak_factory_.GetWeakPtr(), connection_id_));
+        if (rv == net::ERR_IO_PENDING)
+            return;
+        rv = HandleReadResult(rv);
+    } while (rv == net::OK);
+}
+
+void LengthPrefixedServer::OnReadCompleted(int connection_id, int rv)
+{
+    if (connection_id != connection_id_) // Closed meanwhile.
+        return;
+    if (HandleReadResult(rv) == net::OK)
+        DoReadLoop();
+}
+
+int LengthPrefixedServer::HandleReadResult(int rv)
+{
+    int connection_id = connection_id_;
+    if (rv <= 0) {
+        Close(connection_id);
+        return rv == 0 ? net::ERR_CONNECTION_CLOSED : rv;
+    }
+    pending_input_.append(read_buffer_->data(), rv);
+
+    size_t offset = 0;
+    while (pending_input_.size() - offset >= kLengthPrefixSize) {
+        const unsigned char* prefix = reinterpret_cast<const unsigned char*>(pending_input_.data() + offset);
+        uint32 length = (prefix[0] << 24) | (prefix[1] << 16) | (prefix[2] << 8) | prefix[3];
+        if (length > kMaxMessageSize) {
+            Close(connection_id);
+            return net::ERR_MSG_TOO_BIG;
+        }
+        if (pending_input_.size() - offset - kLengthPrefixSize < length)
+            break;
+        std::string message = pending_input_.substr(offset + kLengthPrefixSize, length);
+        delegate_->OnFramedMessage(connection_id, &message);
+        if (connection_id != connection_id_)
+            return net::ERR_CONNECTION_CLOSED;
+        offset += kLengthPrefixSize + length;
+    }
+    pending_input_.erase(0, offset);
+    return net::OK;
+}
+
+void LengthPrefixedServer::DoWriteLoop()
+{
+    int rv = net::OK;
+    while (rv == net::OK && (write_buffer_ || !pending_output_.empty())) {
+        if (!write_buffer_) {
+            write_buffer_ = pending_output_.front();
+            pending_output_.pop_front();
+        }
+        rv = socket_->Write(write_buffer_.get(), write_buffer_->BytesRemaining(),
+            base::Bind(&LengthPrefixedServer::OnWriteCompleted, weak_factory_.GetWeakPtr(), connection_id_));
+        if (rv == net::ERR_IO_PENDING)
+            return;
+        rv = HandleWriteResult(rv);
+    }
+}
+
+void LengthPrefixedServer::OnWriteCompleted(int connection_id, int rv)
+{
+    if (connection_id != connection_id_) // Closed meanwhile.
+        return;
+    if (HandleWriteResult(rv) == net::OK)
+        DoWriteLoop();
+}
+
+int LengthPrefixedServer::HandleWriteResult(int rv)
+{
+    if (rv < 0) {
+        Close(connection_id_);
+        return rv;
+    }
+    write_buffer_->DidConsume(rv);
+    if (!write_buffer_->BytesRemaining())
+        write_buffer_ = nullptr;
+    return net::OK;
+}
+
+} // namespace v8inspector
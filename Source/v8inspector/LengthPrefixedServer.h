@@ -0,0 +1,84 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef LENGTH_PREFIXED_SERVER_H_
+#define LENGTH_PREFIXED_SERVER_H_
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include <deque>
+#include <string>
+
+namespace net {
+class DrainableIOBuffer;
+class IOBuffer;
+class ServerSocket;
+class StreamSocket;
+}
+
+namespace v8inspector {
+
+// Serves one connection at a time from |server_socket| with the cheapest
+// possible framing: every message is a 32-bit big-endian length followed by
+// that many bytes. There is no handshake; a connection is usable as soon as
+// it is accepted. The next connection is accepted once the current one
+// closes. Must be used on an IO thread.
+class LengthPrefixedServer {
+public:
+    class Delegate {
+    public:
+        virtual ~Delegate() { }
+        virtual void OnFramedConnect(int connection_id) = 0;
+        // The delegate may take the contents of |data|.
+        virtual void OnFramedMessage(int connection_id, std::string* data) = 0;
+        virtual void OnFramedClose(int connection_id) = 0;
+    };
+
+    LengthPrefixedServer(scoped_ptr<net::ServerSocket>, Delegate*);
+    ~LengthPrefixedServer();
+
+    void Send(int connection_id, const std::string& data);
+    void Close(int connection_id);
+
+private:
+    // Like net::HttpServer, the Handle*Result methods return net::OK to
+    // continue the loop and an error otherwise.
+    void DoAcceptLoop();
+    void OnAcceptCompleted(int rv);
+    int HandleAcceptResult(int rv);
+
+    void DoReadLoop();
+    void OnReadCompleted(int connection_id, int rv);
+    int HandleReadResult(int rv);
+
+    void DoWriteLoop();
+    void OnWriteCompleted(int connection_id, int rv);
+    int HandleWriteResult(int rv);
+
+    scoped_ptr<net::ServerSocket> server_socket_;
+    Delegate* delegate_;
+
+    scoped_ptr<net::StreamSocket> accepted_socket_;
+    scoped_ptr<net::StreamSocket> socket_;
+    int connection_id_;
+    int last_connection_id_;
+
+    scoped_refptr<net::IOBuffer> read_buffer_;
+    // Bytes read but not yet delivered as a whole message.
+    std::string pending_input_;
+
+    // Framed messages waiting for |write_buffer_| to be written.
+    std::deque<scoped_refptr<net::DrainableIOBuffer>> pending_output_;
+    scoped_refptr<net::DrainableIOBuffer> write_buffer_;
+
+    base::WeakPtrFactory<LengthPrefixedServer> weak_factory_;
+
+    DISALLOW_COPY_AND_ASSIGN(LengthPrefixedServer);
+};
+
+}  // namespace v8inspector
+
+#endif // LENGTH_PREFIXED_SERVER_H_
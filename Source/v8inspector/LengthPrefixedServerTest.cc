@@ -0,0 +1,241 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/LengthPrefixedServer.h"
+
+#include "base/callback_helpers.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/log/net_log.h"
+#include "net/socket/server_socket.h"
+#include "net/socket/stream_socket.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vector>
+
+namespace v8inspector {
+namespace {
+
+// Reads what the test feeds it with DidRead() and writes into |written_|.
+class TestStreamSocket : public net::StreamSocket {
+public:
+    TestStreamSocket()
+        : read_buf_len_(0)
+    {
+    }
+
+    // net::StreamSocket implementation.
+    int Connect(const net::CompletionCallback&) override { return net::ERR_NOT_IMPLEMENTED; }
+    void Disconnect() override { }
+    bool IsConnected() const override { return true; }
+    bool IsConnectedAndIdle() const override { return true; }
+    int GetPeerAddress(net::IPEndPoint*) const override { return net::ERR_NOT_IMPLEMENTED; }
+    int GetLocalAddress(net::IPEndPoint*) const override { return net::ERR_NOT_IMPLEMENTED; }
+    const net::BoundNetLog& NetLog() const override { return net_log_; }
+    void SetSubresourceSpeculation() override { }
+    void SetOmniboxSpeculation() override { }
+    bool WasEverUsed() const override { return true; }
+    bool UsingTCPFastOpen() const override { return false; }
+    bool WasNpnNegotiated() const override { return false; }
+    net::NextProto GetNegotiatedProtocol() const override { return net::kProtoUnknown; }
+    bool GetSSLInfo(net::SSLInfo*) override { return false; }
+    void GetConnectionAttempts(net::ConnectionAttempts* out) const override { out->clear(); }
+    void ClearConnectionAttempts() override { }
+    void AddConnectionAttempts(const net::ConnectionAttempts&) override { }
+
+    // net::Socket implementation.
+    int Read(net::IOBuffer* buf, int buf_len, const net::CompletionCallback& callback) override
+    {
+        if (pending_read_data_.empty()) {
+            read_buf_ = buf;
+            read_buf_len_ = buf_len;
+            read_callback_ = callback;
+            return net::ERR_IO_PENDING;
+        }
+        int read_len = std::min(static_cast<int>(pending_read_data_.size()), buf_len);
+        memcpy(buf->data(), pending_read_data_.data(), read_len);
+        pending_read_data_.erase(0, read_len);
+        return read_len;
+    }
+    int Write(net::IOBuffer* buf, int buf_len, const net::CompletionCallback&) override
+    {
+        written_.append(buf->data(), buf_len);
+        return buf_len;
+    }
+    int SetReceiveBufferSize(int32) override { return net::ERR_NOT_IMPLEMENTED; }
+    int SetSendBufferSize(int32) override { return net::ERR_NOT_IMPLEMENTED; }
+
+    // Completes the pending read with |data|, or keeps it for the next one.
+    void DidRead(const std::string& data)
+    {
+        pending_read_data_.append(data);
+        if (!read_buf_.get())
+            return;
+        int read_len = Read(read_buf_.get(), read_buf_len_, net::CompletionCallback());
+        read_buf_ = nullptr;
+        base::ResetAndReturn(&read_callback_).Run(read_len);
+    }
+
+    // Completes the pending read with the end of the stream.
+    void DidClose()
+    {
+        ASSERT_TRUE(read_buf_.get());
+        read_buf_ = nullptr;
+        base::ResetAndReturn(&read_callback_).Run(0);
+    }
+
+    std::string written_;
+
+private:
+    scoped_refptr<net::IOBuffer> read_buf_;
+    int read_buf_len_;
+    net::CompletionCallback read_callback_;
+    std::string pending_read_data_;
+    net::BoundNetLog net_log_;
+};
+
+// Hands out |socket_| on the first accept; later ones never complete.
+class TestServerSocket : public net::ServerSocket {
+public:
+    explicit TestServerSocket(net::StreamSocket* socket)
+        : socket_(socket)
+    {
+    }
+
+    int Listen(const net::IPEndPoint&, int) override { return net::ERR_NOT_IMPLEMENTED; }
+    int GetLocalAddress(net::IPEndPoint*) const override { return net::ERR_NOT_IMPLEMENTED; }
+    int Accept(scoped_ptr<net::StreamSocket>* socket, const net::CompletionCallback&) override
+    {
+        if (!socket_)
+            return net::ERR_IO_PENDING;
+        *socket = socket_.Pass();
+        return net::OK;
+    }
+
+private:
+    scoped_ptr<net::StreamSocket> socket_;
+};
+
+class LengthPrefixedServerTest : public ::testing::Test, public LengthPrefixedServer::Delegate {
+protected:
+    LengthPrefixedServerTest()
+        : socket_(new TestStreamSocket)
+        , server_(scoped_ptr<net::ServerSocket>(new TestServerSocket(socket_)), this)
+        , connection_id_(0)
+        , closed_(false)
+    {
+        base::RunLoop().RunUntilIdle();
+    }
+
+    // LengthPrefixedServer::Delegate implementation.
+    void OnFramedConnect(int connection_id) override { connection_id_ = connection_id; }
+    void OnFramedMessage(int connection_id, std::string* data) override
+    {
+        EXPECT_EQ(connection_id_, connection_id);
+        messages_.push_back(std::string());
+        messages_.back().swap(*data);
+    }
+    void OnFramedClose(int connection_id) override
+    {
+        EXPECT_EQ(connection_id_, connection_id);
+        closed_ = true;
+        // The server deletes the socket soon.
+        socket_ = nullptr;
+    }
+
+    static std::string Frame(const std::string& payload)
+    {
+        uint32 length = static_cast<uint32>(payload.size());
+        std::string frame;
+        frame.push_back(static_cast<char>(length >> 24));
+        frame.push_back(static_cast<char>(length >> 16));
+        frame.push_back(static_cast<char>(length >> 8));
+        frame.push_back(static_cast<char>(length));
+        return frame + payload;
+    }
+
+    base::MessageLoopForIO message_loop_;
+    TestStreamSocket* socket_;
+    LengthPrefixedServer server_;
+    int connection_id_;
+    std::vector<std::string> messages_;
+    bool closed_;
+};
+
+TEST_F(LengthPrefixedServerTest, ConnectsWithoutHandshake)
+{
+    EXPECT_NE(0, connection_id_);
+    EXPECT_FALSE(closed_);
+}
+
+TEST_F(LengthPrefixedServerTest, FrameSplitAcrossReads)
+{
+    std::string frame = Frame("hello");
+    socket_->DidRead(frame.substr(0, 2));
+    socket_->DidRead(frame.substr(2, 4));
+    EXPECT_TRUE(messages_.empty());
+    socket_->DidRead(frame.substr(6));
+    ASSERT_EQ(1u, messages_.size());
+    EXPECT_EQ("hello", messages_[0]);
+}
+
+TEST_F(LengthPrefixedServerTest, SeveralFramesInOneRead)
+{
+    std::string second = Frame("second");
+    socket_->DidRead(Frame("first") + Frame("") + second.substr(0, 7));
+    ASSERT_EQ(2u, messages_.size());
+    EXPECT_EQ("first", messages_[0]);
+    EXPECT_EQ("", messages_[1]);
+
+    socket_->DidRead(second.substr(7) + Frame("third"));
+    ASSERT_EQ(4u, messages_.size());
+    EXPECT_EQ("second", messages_[2]);
+    EXPECT_EQ("third", messages_[3]);
+    EXPECT_FALSE(closed_);
+}
+
+TEST_F(LengthPrefixedServerTest, OversizedLengthClosesConnection)
+{
+    // 256 MB and one byte; the payload never has to arrive.
+    socket_->DidRead(Frame("before") + std::string("\x10\x00\x00\x01", 4));
+    ASSERT_EQ(1u, messages_.size());
+    EXPECT_EQ("before", messages_[0]);
+    EXPECT_TRUE(closed_);
+    base::RunLoop().RunUntilIdle();
+}
+
+TEST_F(LengthPrefixedServerTest, LargestLengthWaitsForPayload)
+{
+    socket_->DidRead(std::string("\x10\x00\x00\x00", 4) + "partial");
+    EXPECT_TRUE(messages_.empty());
+    EXPECT_FALSE(closed_);
+}
+
+TEST_F(LengthPrefixedServerTest, EndOfStreamClosesConnection)
+{
+    socket_->DidRead(std::string("\x00\x00", 2));
+    socket_->DidClose();
+    EXPECT_TRUE(messages_.empty());
+    EXPECT_TRUE(closed_);
+    base::RunLoop().RunUntilIdle();
+}
+
+TEST_F(LengthPrefixedServerTest, SendPrefixesLength)
+{
+    server_.Send(connection_id_, "abc");
+    server_.Send(connection_id_, "");
+    EXPECT_EQ(Frame("abc") + Frame(""), socket_->written_);
+
+    // Messages for an earlier connection are dropped.
+    server_.Send(connection_id_ + 1, "stale");
+    EXPECT_EQ(Frame("abc") + Frame(""), socket_->written_);
+}
+
+} // namespace
+} // namespace v8inspector
@@ -0,0 +1,62 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/MappedScriptSource.h"
+
+#include "base/files/file_path.h"
+
+namespace v8inspector {
+
+namespace {
+
+// Smaller sources are cheaper to copy than to keep a mapping alive for.
+const size_t kMinExternalLength = 64 * 1024;
+
+}
+
+// static
+scoped_ptr<MappedScriptSource> MappedScriptSource::Create(const base::FilePath& path) {
+    scoped_ptr<MappedScriptSource> source(new MappedScriptSource());
+    if (!source->file_.Initialize(path) || !source->file_.length())
+        return scoped_ptr<MappedScriptSource>();
+    return source.Pass();
+}
+
+MappedScriptSource::MappedScriptSource() {
+}
+
+MappedScriptSource::~MappedScriptSource() {
+}
+
+// static
+v8::Local<v8::String> MappedScriptSource::ToV8String(v8::Isolate* isolate, scoped_ptr<MappedScriptSource> source) {
+    if (source->length() >= kMinExternalLength && source->IsASCII()) {
+        v8::Local<v8::String> result;
+        if (v8::String::NewExternalOneByte(isolate, source.get()).ToLocal(&result)) {
+            ignore_result(source.release());
+            return result;
+        }
+    }
+    return v8::String::NewFromUtf8(isolate, source->data(), v8::String::kNormalString, static_cast<int>(source->length()));
+}
+
+const char* MappedScriptSource::data() const {
+    return reinterpret_cast<const char*>(file_.data());
+}
+
+size_t MappedScriptSource::length() const {
+    return file_.length();
+}
+
+bool MappedScriptSource::IsASCII() const {
+    const uint8* data = file_.data();
+    uint8 bits = 0;
+    for (size_t i = 0; i < file_.length(); ++i)
+        bits |= data[i];
+    return !(bits & 0x80);
+}
+
+}  // namespace v8inspector
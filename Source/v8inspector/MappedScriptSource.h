@@ -0,0 +1,48 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MAPPED_SCRIPT_SOURCE_H_
+#define MAPPED_SCRIPT_SOURCE_H_
+
+#include "base/files/memory_mapped_file.h"
+#include "base/memory/scoped_ptr.h"
+#include <include/v8.h>
+
+namespace base {
+class FilePath;
+}
+
+namespace v8inspector {
+
+// A memory-mapped script file. Large ASCII sources are handed to V8 as
+// external one-byte strings backed directly by the mapping, so they live
+// outside the V8 heap and are shared through the page cache; V8 releases the
+// mapping when the string dies. Everything else is copied into the heap
+// straight from the mapping.
+class MappedScriptSource : public v8::String::ExternalOneByteStringResource {
+public:
+    // Returns NULL if |path| cannot be mapped (e.g. it is empty).
+    static scoped_ptr<MappedScriptSource> Create(const base::FilePath& path);
+    ~MappedScriptSource() override;
+
+    // Creates the V8 string for the mapped source. Ownership of |source|
+    // passes to V8 if it ends up backing an external string.
+    static v8::Local<v8::String> ToV8String(v8::Isolate*, scoped_ptr<MappedScriptSource> source);
+
+    // v8::String::ExternalOneByteStringResource implementation.
+    const char* data() const override;
+    size_t length() const override;
+
+private:
+    MappedScriptSource();
+    bool IsASCII() const;
+
+    base::MemoryMappedFile file_;
+
+    DISALLOW_COPY_AND_ASSIGN(MappedScriptSource);
+};
+
+}  // namespace v8inspector
+
+#endif // MAPPED_SCRIPT_SOURCE_H_
@@ -0,0 +1,59 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/OffThreadResponder.h"
+
+#include "base/json/json_reader.h"
+#include "base/strings/stringprintf.h"
+#include "base/values.h"
+
+namespace v8inspector {
+
+OffThreadResponder::OffThreadResponder()
+{
+}
+
+OffThreadResponder::~OffThreadResponder()
+{
+}
+
+void OffThreadResponder::Publish(const std::string& method, const std::string& result)
+{
+    base::AutoLock lock(lock_);
+    results_[method] = result;
+}
+
+void OffThreadResponder::Withdraw(const std::string& method)
+{
+    base::AutoLock lock(lock_);
+    results_.erase(method);
+}
+
+bool OffThreadResponder::TryRespond(const std::string& message, std::string* response)
+{
+    // A command without parameters is an id and a method name; anything longer
+    // is left to the JS thread without being parsed here.
+    if (message.size() > kMaxCommandLength)
+        return false;
+    scoped_ptr<base::Value> value = base::JSONReader::Read(message);
+    base::DictionaryValue* command;
+    std::string method;
+    int id;
+    if (!value || !value->GetAsDictionary(&command) || !command->GetString("method", &method) || !command->GetInteger("id", &id))
+        return false;
+    base::DictionaryValue* params;
+    if (command->GetDictionary("params", &params) && !params->empty())
+        return false;
+
+    base::AutoLock lock(lock_);
+    std::map<std::string, std::string>::const_iterator it = results_.find(method);
+    if (it == results_.end())
+        return false;
+    *response = base::StringPrintf("{\"id\":%d,\"result\":%s}", id, it->second.c_str());
+    return true;
+}
+
+}  // namespace v8inspector
@@ -0,0 +1,46 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef OFF_THREAD_RESPONDER_H_
+#define OFF_THREAD_RESPONDER_H_
+
+#include "base/basictypes.h"
+#include "base/synchronization/lock.h"
+#include <map>
+#include <string>
+
+namespace v8inspector {
+
+// Answers protocol commands on the IO thread from results the JS thread
+// published in advance, so that they get through while JavaScript runs.
+// Only commands without parameters are answered, and only those whose result
+// the JS thread republishes whenever the underlying state changes; everything
+// else goes to the JS thread as usual.
+class OffThreadResponder {
+public:
+    OffThreadResponder();
+    ~OffThreadResponder();
+
+    // Called on the JS thread. |result| is the serialized result object of
+    // |method|.
+    void Publish(const std::string& method, const std::string& result);
+    void Withdraw(const std::string& method);
+
+    // Called on the IO thread. Returns true and the response to send if
+    // |message| is a command with a published result. Messages longer than
+    // |kMaxCommandLength| are never parsed.
+    bool TryRespond(const std::string& message, std::string* response);
+
+    static const size_t kMaxCommandLength = 256;
+
+private:
+    base::Lock lock_;
+    std::map<std::string, std::string> results_;
+
+    DISALLOW_COPY_AND_ASSIGN(OffThreadResponder);
+};
+
+}  // namespace v8inspector
+
+#endif // OFF_THREAD_RESPONDER_H_
@@ -0,0 +1,74 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/OffThreadResponder.h"
+
+#include <gtest/gtest.h>
+
+namespace v8inspector {
+namespace {
+
+class OffThreadResponderTest : public ::testing::Test {
+protected:
+    OffThreadResponderTest()
+    {
+        responder_.Publish("Runtime.isRunRequired", "{\"result\":true}");
+    }
+
+    // Returns the response, or "-" if the message is left to the JS thread.
+    std::string Respond(const std::string& message)
+    {
+        std::string response;
+        if (!responder_.TryRespond(message, &response))
+            return "-";
+        return response;
+    }
+
+    OffThreadResponder responder_;
+};
+
+TEST_F(OffThreadResponderTest, AnswersPublishedCommand)
+{
+    EXPECT_EQ("{\"id\":7,\"result\":{\"result\":true}}", Respond("{\"id\":7,\"method\":\"Runtime.isRunRequired\"}"));
+    EXPECT_EQ("{\"id\":8,\"result\":{\"result\":true}}", Respond("{\"method\":\"Runtime.isRunRequired\",\"id\":8,\"params\":{}}"));
+}
+
+TEST_F(OffThreadResponderTest, FollowsPublishAndWithdraw)
+{
+    responder_.Publish("Runtime.isRunRequired", "{\"result\":false}");
+    EXPECT_EQ("{\"id\":1,\"result\":{\"result\":false}}", Respond("{\"id\":1,\"method\":\"Runtime.isRunRequired\"}"));
+    responder_.Withdraw("Runtime.isRunRequired");
+    EXPECT_EQ("-", Respond("{\"id\":1,\"method\":\"Runtime.isRunRequired\"}"));
+}
+
+TEST_F(OffThreadResponderTest, LeavesOtherMessagesToJSThread)
+{
+    // Parameters, a missing or non-integer id, and no method at all.
+    EXPECT_EQ("-", Respond("{\"id\":1,\"method\":\"Runtime.isRunRequired\",\"params\":{\"x\":1}}"));
+    EXPECT_EQ("-", Respond("{\"method\":\"Runtime.isRunRequired\"}"));
+    EXPECT_EQ("-", Respond("{\"id\":\"1\",\"method\":\"Runtime.isRunRequired\"}"));
+    EXPECT_EQ("-", Respond("{\"id\":1}"));
+    EXPECT_EQ("-", Respond("[{\"id\":1,\"method\":\"Runtime.isRunRequired\"}]"));
+    EXPECT_EQ("-", Respond("{\"id\":1,\"method\":\"Runtime.isRunRequired\""));
+}
+
+TEST_F(OffThreadResponderTest, MatchesWholeMethodNames)
+{
+    EXPECT_EQ("-", Respond("{\"id\":1,\"method\":\"Runtime.isRunRequiredSoon\"}"));
+    EXPECT_EQ("-", Respond("{\"id\":1,\"method\":\"Runtime.evaluate\",\"params\":{\"expression\":\"Runtime.isRunRequired\"}}"));
+}
+
+TEST_F(OffThreadResponderTest, LeavesLongMessagesUnparsed)
+{
+    std::string padded = "{\"id\":1,\"method\":\"Runtime.isRunRequired\"}";
+    padded.append(OffThreadResponder::kMaxCommandLength - padded.size(), ' ');
+    EXPECT_NE("-", Respond(padded));
+    padded.append(" ");
+    EXPECT_EQ("-", Respond(padded));
+}
+
+}  // namespace
+}  // namespace v8inspector
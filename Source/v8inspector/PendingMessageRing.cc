@@ -0,0 +1,82 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/PendingMessageRing.h"
+
+namespace v8inspector {
+
+static_assert(!(PendingMessageRing::kCapacity & (PendingMessageRing::kCapacity - 1)), "capacity must be a power of two");
+
+PendingMessageRing::PendingMessageRing()
+    : slots_(new Slot[kCapacity])
+    , enqueue_position_(0)
+    , dequeue_position_(0)
+{
+    for (size_t i = 0; i < kCapacity; ++i)
+        base::subtle::NoBarrier_Store(&slots_[i].sequence, i);
+}
+
+PendingMessageRing::~PendingMessageRing()
+{
+}
+
+bool PendingMessageRing::TryPush(std::string* message, base::TimeTicks arrival)
+{
+    base::subtle::AtomicWord position;
+    if (!Claim(&position))
+        return false;
+    Slot* slot = &slots_[position & kMask];
+    slot->message.swap(*message);
+    slot->arrival = arrival;
+    Commit(position);
+    return true;
+}
+
+bool PendingMessageRing::Claim(base::subtle::AtomicWord* claimed)
+{
+    base::subtle::AtomicWord position = base::subtle::NoBarrier_Load(&enqueue_position_);
+    while (true) {
+        Slot* slot = &slots_[position & kMask];
+        base::subtle::AtomicWord sequence = base::subtle::Acquire_Load(&slot->sequence);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (!difference) {
+            // The slot is free for this position; claim it.
+            base::subtle::AtomicWord previous = base::subtle::NoBarrier_CompareAndSwap(&enqueue_position_, position, position + 1);
+            if (previous == position) {
+                *claimed = position;
+                return true;
+            }
+            position = previous;
+        } else if (difference < 0) {
+            // The consumer has not handed back the slot from the last round.
+            return false;
+        } else {
+            // Another producer claimed the position first.
+            position = base::subtle::NoBarrier_Load(&enqueue_position_);
+        }
+    }
+}
+
+void PendingMessageRing::Commit(base::subtle::AtomicWord position)
+{
+    base::subtle::Release_Store(&slots_[position & kMask].sequence, position + 1);
+}
+
+bool PendingMessageRing::TryPop(std::string* message, base::TimeTicks* arrival)
+{
+    Slot* slot = &slots_[dequeue_position_ & kMask];
+    base::subtle::AtomicWord sequence = base::subtle::Acquire_Load(&slot->sequence);
+    if (sequence != static_cast<base::subtle::AtomicWord>(dequeue_position_ + 1))
+        return false;
+    message->clear();
+    message->swap(slot->message);
+    *arrival = slot->arrival;
+    base::subtle::Release_Store(&slot->sequence, dequeue_position_ + kCapacity);
+    ++dequeue_position_;
+    return true;
+}
+
+}  // namespace v8inspector
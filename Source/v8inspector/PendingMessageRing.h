@@ -0,0 +1,64 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PENDING_MESSAGE_RING_H_
+#define PENDING_MESSAGE_RING_H_
+
+#include "base/atomicops.h"
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
+#include <string>
+
+namespace v8inspector {
+
+// Bounded lock-free queue of protocol messages with many producers and a
+// single consumer. Every slot carries a sequence number that tells whose turn
+// it is: producers claim a slot by advancing the enqueue position and publish
+// it by bumping the sequence, and the consumer hands it back the same way.
+// Messages are swapped in and out of the slots, so strings are not copied and
+// the ring allocates nothing after construction.
+class PendingMessageRing {
+public:
+    static const size_t kCapacity = 1024;
+
+    PendingMessageRing();
+    ~PendingMessageRing();
+
+    // May be called on any thread. Takes the contents of |message| and returns
+    // true, unless the ring is full.
+    bool TryPush(std::string* message, base::TimeTicks arrival);
+
+    // Called on the consumer thread only. Returns false if the ring is empty,
+    // or if the oldest message is still being written by its producer.
+    bool TryPop(std::string* message, base::TimeTicks* arrival);
+
+private:
+    friend class PendingMessageRingTest;
+
+    // TryPush in two steps: Claim reserves the slot for the next position,
+    // Commit hands the filled slot to the consumer. The consumer cannot get
+    // past a claimed slot until it is committed.
+    bool Claim(base::subtle::AtomicWord* position);
+    void Commit(base::subtle::AtomicWord position);
+
+    struct Slot {
+        base::subtle::AtomicWord sequence;
+        std::string message;
+        base::TimeTicks arrival;
+    };
+
+    static const size_t kMask = kCapacity - 1;
+
+    scoped_ptr<Slot[]> slots_;
+    base::subtle::AtomicWord enqueue_position_;
+    // Only touched by the consumer.
+    size_t dequeue_position_;
+
+    DISALLOW_COPY_AND_ASSIGN(PendingMessageRing);
+};
+
+}  // namespace v8inspector
+
+#endif // PENDING_MESSAGE_RING_H_
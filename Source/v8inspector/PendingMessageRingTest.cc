@@ -0,0 +1,193 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/PendingMessageRing.h"
+
+#include "base/atomicops.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/threading/platform_thread.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace v8inspector {
+
+class PendingMessageRingTest : public ::testing::Test {
+protected:
+    // Pushes "<producer>:<index>" for every index, retrying while the ring is
+    // full like the IO thread does with its overflow messages.
+    class Producer : public base::PlatformThread::Delegate {
+    public:
+        Producer(PendingMessageRing* ring, int producer, int messages, base::subtle::Atomic32* full)
+            : ring_(ring)
+            , producer_(producer)
+            , messages_(messages)
+            , full_(full)
+        {
+        }
+
+        void ThreadMain() override
+        {
+            for (int i = 0; i < messages_; ++i) {
+                std::string message = base::IntToString(producer_) + ":" + base::IntToString(i);
+                while (!ring_->TryPush(&message, base::TimeTicks())) {
+                    base::subtle::Release_Store(full_, 1);
+                    base::PlatformThread::YieldCurrentThread();
+                }
+            }
+        }
+
+    private:
+        PendingMessageRing* ring_;
+        int producer_;
+        int messages_;
+        base::subtle::Atomic32* full_;
+    };
+
+    bool Push(const std::string& message, int64 arrival = 0)
+    {
+        std::string copy = message;
+        return ring_.TryPush(&copy, base::TimeTicks::FromInternalValue(arrival));
+    }
+
+    // Returns the popped message, or "-" if there was none to pop.
+    std::string Pop(int64* arrival = nullptr)
+    {
+        std::string message;
+        base::TimeTicks ticks;
+        if (!ring_.TryPop(&message, &ticks))
+            return "-";
+        if (arrival)
+            *arrival = ticks.ToInternalValue();
+        return message;
+    }
+
+    // A producer that claimed a slot and did not fill it yet.
+    base::subtle::AtomicWord Claim()
+    {
+        base::subtle::AtomicWord position = -1;
+        EXPECT_TRUE(ring_.Claim(&position));
+        return position;
+    }
+
+    void FillAndCommit(base::subtle::AtomicWord position, const std::string& message)
+    {
+        ring_.slots_[position & PendingMessageRing::kMask].message = message;
+        ring_.Commit(position);
+    }
+
+    PendingMessageRing ring_;
+};
+
+namespace {
+
+const int kCapacity = PendingMessageRing::kCapacity;
+
+TEST_F(PendingMessageRingTest, EmptyRingPopsNothing)
+{
+    EXPECT_EQ("-", Pop());
+}
+
+TEST_F(PendingMessageRingTest, KeepsOrderAcrossWraparound)
+{
+    // Chunks that do not divide the capacity, so pushes and pops wrap at
+    // every slot position.
+    const int kChunk = 700;
+    int pushed = 0;
+    int popped = 0;
+    while (popped < 3 * kCapacity) {
+        for (int i = 0; i < kChunk; ++i, ++pushed)
+            ASSERT_TRUE(Push(base::IntToString(pushed), pushed));
+        for (int i = 0; i < kChunk; ++i, ++popped) {
+            int64 arrival = -1;
+            ASSERT_EQ(base::IntToString(popped), Pop(&arrival));
+            EXPECT_EQ(popped, arrival);
+        }
+    }
+    EXPECT_EQ("-", Pop());
+}
+
+TEST_F(PendingMessageRingTest, FullRingRejectsPushAndKeepsMessage)
+{
+    for (int i = 0; i < kCapacity; ++i)
+        ASSERT_TRUE(Push(base::IntToString(i)));
+    std::string rejected = "rejected";
+    EXPECT_FALSE(ring_.TryPush(&rejected, base::TimeTicks()));
+    EXPECT_EQ("rejected", rejected);
+
+    EXPECT_EQ("0", Pop());
+    EXPECT_TRUE(ring_.TryPush(&rejected, base::TimeTicks()));
+    EXPECT_FALSE(Push("again"));
+    for (int i = 1; i < kCapacity; ++i)
+        ASSERT_EQ(base::IntToString(i), Pop());
+    EXPECT_EQ("rejected", Pop());
+    EXPECT_EQ("-", Pop());
+}
+
+TEST_F(PendingMessageRingTest, ClaimedSlotHoldsBackLaterMessages)
+{
+    ASSERT_TRUE(Push("a"));
+    base::subtle::AtomicWord position = Claim();
+    ASSERT_TRUE(Push("c"));
+
+    EXPECT_EQ("a", Pop());
+    // What DispatchPendingMessages spins on: a message is counted, but its
+    // slot is not committed yet.
+    EXPECT_EQ("-", Pop());
+    EXPECT_EQ("-", Pop());
+
+    FillAndCommit(position, "b");
+    EXPECT_EQ("b", Pop());
+    EXPECT_EQ("c", Pop());
+    EXPECT_EQ("-", Pop());
+}
+
+TEST_F(PendingMessageRingTest, ManyProducersKeepTheirOrder)
+{
+    const int kProducers = 4;
+    const int kMessages = 3 * kCapacity;
+    base::subtle::Atomic32 full = 0;
+    std::vector<Producer*> producers;
+    std::vector<base::PlatformThreadHandle> threads(kProducers);
+    for (int i = 0; i < kProducers; ++i) {
+        producers.push_back(new Producer(&ring_, i, kMessages, &full));
+        ASSERT_TRUE(base::PlatformThread::Create(0, producers[i], &threads[i]));
+    }
+
+    // Let the producers fill the ring first, so they all go through the
+    // retry path.
+    while (!base::subtle::Acquire_Load(&full))
+        base::PlatformThread::YieldCurrentThread();
+
+    // Consumes like DispatchPendingMessages: a message that is known to be
+    // coming may still be in a claimed slot, so spin until it is committed.
+    std::vector<int> next(kProducers, 0);
+    std::string message;
+    base::TimeTicks arrival;
+    for (int received = 0; received < kProducers * kMessages; ++received) {
+        while (!ring_.TryPop(&message, &arrival))
+            base::PlatformThread::YieldCurrentThread();
+        // Keeps consuming after a failure, or the producers would never finish.
+        size_t colon = message.find(':');
+        int producer;
+        int index;
+        if (colon == std::string::npos || !base::StringToInt(message.substr(0, colon), &producer) || !base::StringToInt(message.substr(colon + 1), &index) || producer < 0 || producer >= kProducers) {
+            ADD_FAILURE() << "unexpected message " << message;
+            continue;
+        }
+        EXPECT_EQ(next[producer], index) << "producer " << producer;
+        next[producer] = index + 1;
+    }
+
+    for (int i = 0; i < kProducers; ++i) {
+        base::PlatformThread::Join(threads[i]);
+        delete producers[i];
+        EXPECT_EQ(kMessages, next[i]);
+    }
+    EXPECT_FALSE(ring_.TryPop(&message, &arrival));
+}
+
+} // namespace
+} // namespace v8inspector
@@ -0,0 +1,337 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/ProtocolStatistics.h"
+
+#include "base/json/json_writer.h"
+#include "base/trace_event/trace_event.h"
+#include "base/values.h"
+#include <algorithm>
+
+using blink::InspectorBackendDispatcher;
+
+namespace v8inspector {
+
+const char ProtocolStatistics::kTraceCategory[] = TRACE_DISABLED_BY_DEFAULT("devtools.protocol");
+
+ProtocolStatistics::LatencyHistogram::LatencyHistogram()
+    : count_(0)
+    , total_microseconds_(0)
+    , max_microseconds_(0)
+{
+    std::fill(buckets_, buckets_ + kBucketCount, 0);
+}
+
+void ProtocolStatistics::LatencyHistogram::Add(base::TimeDelta latency)
+{
+    int64 microseconds = std::max<int64>(latency.InMicroseconds(), 0);
+    // Bucket i holds [2^(i-1), 2^i) microseconds, bucket 0 less than one.
+    int bucket = 0;
+    while (bucket < kBucketCount - 1 && microseconds >= (static_cast<int64>(1) << bucket))
+        ++bucket;
+    ++buckets_[bucket];
+    ++count_;
+    total_microseconds_ += microseconds;
+    max_microseconds_ = std::max(max_microseconds_, microseconds);
+}
+
+void ProtocolStatistics::LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+    for (int i = 0; i < kBucketCount; ++i)
+        buckets_[i] += other.buckets_[i];
+    count_ += other.count_;
+    total_microseconds_ += other.total_microseconds_;
+    max_microseconds_ = std::max(max_microseconds_, other.max_microseconds_);
+}
+
+int64 ProtocolStatistics::LatencyHistogram::Percentile(double fraction) const
+{
+    int64 seen = 0;
+    for (int i = 0; i < kBucketCount - 1; ++i) {
+        seen += buckets_[i];
+        if (seen >= fraction * count_)
+            return std::min(static_cast<int64>(1) << i, max_microseconds_);
+    }
+    return max_microseconds_;
+}
+
+scoped_ptr<base::DictionaryValue> ProtocolStatistics::LatencyHistogram::ToValue() const
+{
+    scoped_ptr<base::DictionaryValue> value(new base::DictionaryValue());
+    value->SetDouble("count", count_);
+    value->SetDouble("totalMicroseconds", total_microseconds_);
+    value->SetDouble("maxMicroseconds", max_microseconds_);
+    if (!count_)
+        return value.Pass();
+    value->SetDouble("p50Microseconds", Percentile(0.5));
+    value->SetDouble("p99Microseconds", Percentile(0.99));
+    // Pairs of the bucket's upper bound and count, for the non-empty ones.
+    scoped_ptr<base::ListValue> buckets(new base::ListValue());
+    for (int i = 0; i < kBucketCount; ++i) {
+        if (!buckets_[i])
+            continue;
+        scoped_ptr<base::ListValue> bucket(new base::ListValue());
+        bucket->AppendDouble(i == kBucketCount - 1 ? max_microseconds_ : static_cast<int64>(1) << i);
+        bucket->AppendDouble(buckets_[i]);
+        buckets->Append(bucket.Pass());
+    }
+    value->Set("buckets", buckets.Pass());
+    return value.Pass();
+}
+
+ProtocolStatistics::CommandStatistics::CommandStatistics()
+    : commands(0)
+    , request_bytes(0)
+    , response_bytes(0)
+{
+}
+
+ProtocolStatistics::ProtocolStatistics()
+    : messages_received_(0)
+    , bytes_received_(0)
+    , messages_sent_(0)
+    , bytes_sent_(0)
+    , notifications_(0)
+    , off_thread_responses_(0)
+    , commands_(InspectorBackendDispatcher::kMethodNamesEnumSize)
+    , commands_dispatched_(0)
+{
+}
+
+ProtocolStatistics::~ProtocolStatistics()
+{
+}
+
+void ProtocolStatistics::RecordMessageReceived(size_t bytes)
+{
+    base::AutoLock lock(lock_);
+    ++messages_received_;
+    bytes_received_ += bytes;
+}
+
+void ProtocolStatistics::RecordOffThreadResponse()
+{
+    base::AutoLock lock(lock_);
+    ++off_thread_responses_;
+}
+
+void ProtocolStatistics::RecordMessageSent(size_t bytes, base::TimeDelta send_time)
+{
+    base::AutoLock lock(lock_);
+    ++messages_sent_;
+    bytes_sent_ += bytes;
+    send_time_.Add(send_time);
+}
+
+void ProtocolStatistics::RecordDeflateStats(const net::WebSocketEncoder::DeflateStats& connection)
+{
+    base::AutoLock lock(lock_);
+    open_connection_deflate_ = connection;
+}
+
+void ProtocolStatistics::RecordClosedConnectionDeflateStats(const net::WebSocketEncoder::DeflateStats& connection)
+{
+    base::AutoLock lock(lock_);
+    AddDeflateStats(connection, &closed_connections_deflate_);
+    open_connection_deflate_ = net::WebSocketEncoder::DeflateStats();
+}
+
+void ProtocolStatistics::WillDispatchMessage(size_t bytes)
+{
+    MessageFrame frame;
+    frame.bytes = bytes;
+    message_stack_.push_back(frame);
+}
+
+void ProtocolStatistics::DidDispatchMessage()
+{
+    if (message_stack_.empty())
+        return;
+    const MessageFrame& frame = message_stack_.back();
+    if (!frame.methods.empty()) {
+        base::AutoLock lock(lock_);
+        // The commands of a batch get an equal share of it.
+        size_t share = frame.bytes / frame.methods.size();
+        for (size_t i = 0; i < frame.methods.size(); ++i)
+            commands_[frame.methods[i]].request_bytes += share;
+    }
+    message_stack_.pop_back();
+}
+
+void ProtocolStatistics::RecordQueueTime(base::TimeDelta queue_time)
+{
+    base::AutoLock lock(lock_);
+    queue_time_.Add(queue_time);
+}
+
+void ProtocolStatistics::RecordSerialization(OutgoingMessageType type, int call_id, size_t bytes, base::TimeDelta serialize_time)
+{
+    base::AutoLock lock(lock_);
+    serialize_time_.Add(serialize_time);
+    if (type == Notification)
+        ++notifications_;
+    if (type == BatchResponses && !message_stack_.empty()) {
+        // The batch is answered as a whole, so its commands are not waiting
+        // for responses of their own any more.
+        const std::vector<int>& call_ids = message_stack_.back().call_ids;
+        for (size_t i = 0; i < call_ids.size(); ++i)
+            pending_responses_.erase(call_ids[i]);
+    }
+    if (type != Response)
+        return;
+    std::map<int, PendingResponse>::iterator it = pending_responses_.find(call_id);
+    if (it == pending_responses_.end())
+        return;
+    CommandStatistics& command = commands_[it->second.method];
+    command.response_bytes += bytes;
+    command.serialize.Add(serialize_time);
+    pending_responses_.erase(it);
+}
+
+void ProtocolStatistics::DidDisconnect()
+{
+    base::AutoLock lock(lock_);
+    pending_responses_.clear();
+    dispatch_order_.clear();
+}
+
+void ProtocolStatistics::willParseMessage(const WTF::String& message)
+{
+    TRACE_EVENT_BEGIN1(kTraceCategory, "ProtocolParse", "length", message.length());
+    parse_start_ = base::TimeTicks::Now();
+}
+
+void ProtocolStatistics::didParseMessage()
+{
+    base::TimeDelta parse_time = base::TimeTicks::Now() - parse_start_;
+    TRACE_EVENT_END0(kTraceCategory, "ProtocolParse");
+    base::AutoLock lock(lock_);
+    parse_time_.Add(parse_time);
+}
+
+void ProtocolStatistics::willDispatchCommand(InspectorBackendDispatcher::MethodNames method, int callId)
+{
+    TRACE_EVENT_BEGIN2(kTraceCategory, "ProtocolCommand", "method", InspectorBackendDispatcher::commandName(method), "id", callId);
+    CommandFrame frame;
+    frame.method = method;
+    frame.start = base::TimeTicks::Now();
+    command_stack_.push_back(frame);
+    if (!message_stack_.empty()) {
+        message_stack_.back().methods.push_back(method);
+        message_stack_.back().call_ids.push_back(callId);
+    }
+    base::AutoLock lock(lock_);
+    ++commands_[method].commands;
+    PendingResponse pending;
+    pending.method = method;
+    pending.sequence = commands_dispatched_++;
+    pending_responses_[callId] = pending;
+    dispatch_order_.push_back(std::make_pair(callId, pending.sequence));
+    if (dispatch_order_.size() <= kMaxPendingResponses)
+        return;
+    // The frontend picks the call ids, so only the dispatch order tells the
+    // oldest command. Its id may since have been answered or reused.
+    std::pair<int, int64> oldest = dispatch_order_.front();
+    dispatch_order_.pop_front();
+    std::map<int, PendingResponse>::iterator it = pending_responses_.find(oldest.first);
+    if (it != pending_responses_.end() && it->second.sequence == oldest.second)
+        pending_responses_.erase(it);
+}
+
+void ProtocolStatistics::didDispatchCommand(InspectorBackendDispatcher::MethodNames method, int callId)
+{
+    TRACE_EVENT_END0(kTraceCategory, "ProtocolCommand");
+    if (command_stack_.empty())
+        return;
+    CommandFrame frame = command_stack_.back();
+    command_stack_.pop_back();
+    ASSERT(frame.method == method);
+    base::AutoLock lock(lock_);
+    commands_[frame.method].execute.Add(base::TimeTicks::Now() - frame.start);
+}
+
+// static
+void ProtocolStatistics::AddCommandStatistics(const CommandStatistics& command, base::DictionaryValue* value)
+{
+    value->SetDouble("commands", command.commands);
+    value->SetDouble("requestBytes", command.request_bytes);
+    value->SetDouble("responseBytes", command.response_bytes);
+    value->Set("execute", command.execute.ToValue());
+    value->Set("serialize", command.serialize.ToValue());
+}
+
+void ProtocolStatistics::AddDeflateStats(const net::WebSocketEncoder::DeflateStats& stats, net::WebSocketEncoder::DeflateStats* total)
+{
+    total->messages += stats.messages;
+    total->deflated_messages += stats.deflated_messages;
+    total->input_bytes += stats.input_bytes;
+    total->output_bytes += stats.output_bytes;
+    total->cpu_time += stats.cpu_time;
+}
+
+scoped_ptr<base::DictionaryValue> ProtocolStatistics::ToValue() const
+{
+    scoped_ptr<base::DictionaryValue> value(new base::DictionaryValue());
+    base::AutoLock lock(lock_);
+    value->SetDouble("messagesReceived", messages_received_);
+    value->SetDouble("bytesReceived", bytes_received_);
+    value->SetDouble("messagesSent", messages_sent_);
+    value->SetDouble("bytesSent", bytes_sent_);
+    value->SetDouble("notifications", notifications_);
+    value->SetDouble("offThreadResponses", off_thread_responses_);
+    value->Set("queueTime", queue_time_.ToValue());
+    value->Set("parseTime", parse_time_.ToValue());
+    value->Set("serializeTime", serialize_time_.ToValue());
+    value->Set("sendTime", send_time_.ToValue());
+
+    net::WebSocketEncoder::DeflateStats deflate = closed_connections_deflate_;
+    AddDeflateStats(open_connection_deflate_, &deflate);
+    scoped_ptr<base::DictionaryValue> deflate_value(new base::DictionaryValue());
+    deflate_value->SetDouble("messages", deflate.messages);
+    deflate_value->SetDouble("deflatedMessages", deflate.deflated_messages);
+    deflate_value->SetDouble("inputBytes", deflate.input_bytes);
+    deflate_value->SetDouble("outputBytes", deflate.output_bytes);
+    deflate_value->SetDouble("cpuTimeMicroseconds", deflate.cpu_time.InMicroseconds());
+    value->Set("deflate", deflate_value.Pass());
+
+    scoped_ptr<base::DictionaryValue> methods(new base::DictionaryValue());
+    std::map<std::string, CommandStatistics> domains;
+    for (size_t i = 0; i < commands_.size(); ++i) {
+        const CommandStatistics& command = commands_[i];
+        if (!command.commands)
+            continue;
+        std::string name = InspectorBackendDispatcher::commandName(static_cast<InspectorBackendDispatcher::MethodNames>(i));
+        scoped_ptr<base::DictionaryValue> method(new base::DictionaryValue());
+        AddCommandStatistics(command, method.get());
+        methods->SetWithoutPathExpansion(name, method.Pass());
+
+        CommandStatistics& domain = domains[name.substr(0, name.find('.'))];
+        domain.commands += command.commands;
+        domain.request_bytes += command.request_bytes;
+        domain.response_bytes += command.response_bytes;
+        domain.execute.Merge(command.execute);
+        domain.serialize.Merge(command.serialize);
+    }
+    value->Set("methods", methods.Pass());
+
+    scoped_ptr<base::DictionaryValue> domain_values(new base::DictionaryValue());
+    for (std::map<std::string, CommandStatistics>::const_iterator it = domains.begin(); it != domains.end(); ++it) {
+        scoped_ptr<base::DictionaryValue> domain(new base::DictionaryValue());
+        AddCommandStatistics(it->second, domain.get());
+        domain_values->SetWithoutPathExpansion(it->first, domain.Pass());
+    }
+    value->Set("domains", domain_values.Pass());
+    return value.Pass();
+}
+
+std::string ProtocolStatistics::ToJSON() const
+{
+    std::string json;
+    base::JSONWriter::Write(*ToValue(), &json);
+    return json;
+}
+
+}  // namespace v8inspector
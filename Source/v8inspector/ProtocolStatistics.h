@@ -0,0 +1,173 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PROTOCOL_STATISTICS_H_
+#define PROTOCOL_STATISTICS_H_
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "core/InspectorBackendDispatcher.h"
+#include "net/server/web_socket_encoder.h"
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace v8inspector {
+
+// Counts and times the protocol traffic of RemoteDebuggingServer: bytes and
+// messages in and out, the time messages wait for the JavaScript thread, and
+// how long they take to parse, execute, serialize and send, per command and
+// per domain. The same stages show up as trace events in kTraceCategory.
+//
+// The dispatcher reports parsing and commands through the Observer interface
+// on the JavaScript thread; the server reports the rest from whichever thread
+// it happens on. A command's execute time includes any pause it runs into,
+// and the commands nested in that pause are also counted on their own.
+class ProtocolStatistics : public blink::InspectorBackendDispatcher::Observer {
+public:
+    static const char kTraceCategory[];
+
+    enum OutgoingMessageType {
+        Response,
+        // The responses of a batch, which are not attributed to commands.
+        BatchResponses,
+        Notification,
+    };
+
+    ProtocolStatistics();
+    ~ProtocolStatistics() override;
+
+    // Called on the IO thread.
+    void RecordMessageReceived(size_t bytes);
+    void RecordOffThreadResponse();
+    void RecordMessageSent(size_t bytes, base::TimeDelta send_time);
+    // Takes the deflate totals of the open WebSocket connection so far, and
+    // its final totals when it closes.
+    void RecordDeflateStats(const net::WebSocketEncoder::DeflateStats& connection);
+    void RecordClosedConnectionDeflateStats(const net::WebSocketEncoder::DeflateStats& connection);
+
+    // Called on the JavaScript thread. The commands dispatched between these
+    // calls share |bytes| as their request size.
+    void WillDispatchMessage(size_t bytes);
+    void DidDispatchMessage();
+    void RecordQueueTime(base::TimeDelta);
+    // |call_id| is only used for responses.
+    void RecordSerialization(OutgoingMessageType, int call_id, size_t bytes, base::TimeDelta);
+    // Forgets the commands that were not answered before the frontend went
+    // away. The next frontend numbers its commands from the start again.
+    void DidDisconnect();
+
+    // blink::InspectorBackendDispatcher::Observer implementation.
+    void willParseMessage(const WTF::String& message) override;
+    void didParseMessage() override;
+    void willDispatchCommand(blink::InspectorBackendDispatcher::MethodNames, int callId) override;
+    void didDispatchCommand(blink::InspectorBackendDispatcher::MethodNames, int callId) override;
+
+    // May be called on any thread.
+    scoped_ptr<base::DictionaryValue> ToValue() const;
+    std::string ToJSON() const;
+
+private:
+    friend class ProtocolStatisticsTest;
+
+    // Latencies in microseconds, in power of two buckets.
+    class LatencyHistogram {
+    public:
+        LatencyHistogram();
+
+        void Add(base::TimeDelta);
+        void Merge(const LatencyHistogram&);
+        scoped_ptr<base::DictionaryValue> ToValue() const;
+
+    private:
+        // The last bucket takes everything from 2^22 microseconds, about four
+        // seconds, on.
+        static const int kBucketCount = 24;
+
+        // Upper bound of the bucket holding the |fraction| of the samples.
+        int64 Percentile(double fraction) const;
+
+        int64 count_;
+        int64 total_microseconds_;
+        int64 max_microseconds_;
+        int64 buckets_[kBucketCount];
+    };
+
+    struct CommandStatistics {
+        CommandStatistics();
+
+        int64 commands;
+        int64 request_bytes;
+        int64 response_bytes;
+        LatencyHistogram execute;
+        LatencyHistogram serialize;
+    };
+
+    struct CommandFrame {
+        blink::InspectorBackendDispatcher::MethodNames method;
+        base::TimeTicks start;
+    };
+
+    struct PendingResponse {
+        blink::InspectorBackendDispatcher::MethodNames method;
+        // Which dispatch this is, as the frontend may reuse call ids.
+        int64 sequence;
+    };
+
+    struct MessageFrame {
+        size_t bytes;
+        std::vector<blink::InspectorBackendDispatcher::MethodNames> methods;
+        std::vector<int> call_ids;
+    };
+
+    // Commands whose responses have not shown up after this many later ones
+    // are given up on, so that commands the backend never answers do not
+    // pile up.
+    static const size_t kMaxPendingResponses = 1000;
+
+    static void AddCommandStatistics(const CommandStatistics&, base::DictionaryValue*);
+    static void AddDeflateStats(const net::WebSocketEncoder::DeflateStats&, net::WebSocketEncoder::DeflateStats*);
+
+    mutable base::Lock lock_;
+
+    int64 messages_received_;
+    int64 bytes_received_;
+    int64 messages_sent_;
+    int64 bytes_sent_;
+    int64 notifications_;
+    int64 off_thread_responses_;
+    LatencyHistogram queue_time_;
+    LatencyHistogram parse_time_;
+    LatencyHistogram serialize_time_;
+    LatencyHistogram send_time_;
+    net::WebSocketEncoder::DeflateStats closed_connections_deflate_;
+    net::WebSocketEncoder::DeflateStats open_connection_deflate_;
+    // Indexed by MethodNames.
+    std::vector<CommandStatistics> commands_;
+
+    // Only used on the JavaScript thread. Commands and messages nest when a
+    // command pauses and the frontend keeps sending.
+    base::TimeTicks parse_start_;
+    std::vector<CommandFrame> command_stack_;
+    std::vector<MessageFrame> message_stack_;
+    // Commands dispatched and not answered yet, by call id.
+    std::map<int, PendingResponse> pending_responses_;
+    // The call ids and sequence numbers of the last kMaxPendingResponses
+    // commands, oldest first, whether answered or not.
+    std::deque<std::pair<int, int64> > dispatch_order_;
+    int64 commands_dispatched_;
+
+    DISALLOW_COPY_AND_ASSIGN(ProtocolStatistics);
+};
+
+}  // namespace v8inspector
+
+#endif // PROTOCOL_STATISTICS_H_
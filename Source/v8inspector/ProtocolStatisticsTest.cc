@@ -0,0 +1,245 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/ProtocolStatistics.h"
+
+#include "base/values.h"
+#include <gtest/gtest.h>
+
+using blink::InspectorBackendDispatcher;
+
+namespace v8inspector {
+
+class ProtocolStatisticsTest : public ::testing::Test {
+protected:
+    static const int kMaxPendingResponses = ProtocolStatistics::kMaxPendingResponses;
+
+    void Dispatch(InspectorBackendDispatcher::MethodNames method, int call_id)
+    {
+        statistics_.willDispatchCommand(method, call_id);
+        statistics_.didDispatchCommand(method, call_id);
+    }
+
+    void Respond(int call_id, size_t bytes)
+    {
+        statistics_.RecordSerialization(ProtocolStatistics::Response, call_id, bytes, base::TimeDelta::FromMicroseconds(5));
+    }
+
+    // The value of |key| in the statistics of |method|, or -1 if it has none.
+    double Method(InspectorBackendDispatcher::MethodNames method, const char* key)
+    {
+        scoped_ptr<base::DictionaryValue> value = statistics_.ToValue();
+        base::DictionaryValue* methods = nullptr;
+        base::DictionaryValue* statistics = nullptr;
+        double result = -1;
+        if (value->GetDictionary("methods", &methods) && methods->GetDictionaryWithoutPathExpansion(InspectorBackendDispatcher::commandName(method), &statistics))
+            statistics->GetDouble(key, &result);
+        return result;
+    }
+
+    // The value of the dotted |path| in the queue time histogram.
+    double QueueTime(const char* path)
+    {
+        scoped_ptr<base::DictionaryValue> value = statistics_.ToValue();
+        double result = -1;
+        value->GetDouble(std::string("queueTime.") + path, &result);
+        return result;
+    }
+
+    void AddQueueTime(int64 microseconds, int times)
+    {
+        for (int i = 0; i < times; ++i)
+            statistics_.RecordQueueTime(base::TimeDelta::FromMicroseconds(microseconds));
+    }
+
+    ProtocolStatistics statistics_;
+};
+
+namespace {
+
+const InspectorBackendDispatcher::MethodNames kEvaluate = InspectorBackendDispatcher::kRuntime_evaluateCmd;
+const InspectorBackendDispatcher::MethodNames kPause = InspectorBackendDispatcher::kDebugger_pauseCmd;
+const InspectorBackendDispatcher::MethodNames kResume = InspectorBackendDispatcher::kDebugger_resumeCmd;
+
+TEST_F(ProtocolStatisticsTest, EmptyHistogram)
+{
+    EXPECT_EQ(0, QueueTime("count"));
+    EXPECT_EQ(0, QueueTime("maxMicroseconds"));
+    EXPECT_EQ(-1, QueueTime("p50Microseconds"));
+}
+
+TEST_F(ProtocolStatisticsTest, HistogramPercentiles)
+{
+    // 3 falls in [2, 4) and 1000 in [512, 1024).
+    AddQueueTime(3, 98);
+    AddQueueTime(1000, 2);
+    EXPECT_EQ(100, QueueTime("count"));
+    EXPECT_EQ(98 * 3 + 2 * 1000, QueueTime("totalMicroseconds"));
+    EXPECT_EQ(1000, QueueTime("maxMicroseconds"));
+    EXPECT_EQ(4, QueueTime("p50Microseconds"));
+    // The bucket's upper bound is capped at the largest sample.
+    EXPECT_EQ(1000, QueueTime("p99Microseconds"));
+
+    scoped_ptr<base::DictionaryValue> value = statistics_.ToValue();
+    base::ListValue* buckets = nullptr;
+    ASSERT_TRUE(value->GetList("queueTime.buckets", &buckets));
+    ASSERT_EQ(2u, buckets->GetSize());
+    base::ListValue* bucket = nullptr;
+    double bound = 0;
+    double count = 0;
+    ASSERT_TRUE(buckets->GetList(0, &bucket));
+    EXPECT_TRUE(bucket->GetDouble(0, &bound));
+    EXPECT_TRUE(bucket->GetDouble(1, &count));
+    EXPECT_EQ(4, bound);
+    EXPECT_EQ(98, count);
+    ASSERT_TRUE(buckets->GetList(1, &bucket));
+    EXPECT_TRUE(bucket->GetDouble(0, &bound));
+    EXPECT_TRUE(bucket->GetDouble(1, &count));
+    EXPECT_EQ(1024, bound);
+    EXPECT_EQ(2, count);
+}
+
+TEST_F(ProtocolStatisticsTest, HistogramEdges)
+{
+    AddQueueTime(0, 1);
+    EXPECT_EQ(0, QueueTime("p50Microseconds"));
+    EXPECT_EQ(0, QueueTime("p99Microseconds"));
+
+    // Everything from 2^22 microseconds on shares the last bucket, which
+    // reports the largest sample.
+    AddQueueTime(10 * 1000 * 1000, 1);
+    AddQueueTime(20 * 1000 * 1000, 2);
+    EXPECT_EQ(20 * 1000 * 1000, QueueTime("p50Microseconds"));
+    EXPECT_EQ(20 * 1000 * 1000, QueueTime("p99Microseconds"));
+}
+
+TEST_F(ProtocolStatisticsTest, BatchSharesRequestBytes)
+{
+    statistics_.WillDispatchMessage(90);
+    Dispatch(kEvaluate, 1);
+    Dispatch(kPause, 2);
+    Dispatch(kPause, 3);
+    statistics_.DidDispatchMessage();
+    EXPECT_EQ(1, Method(kEvaluate, "commands"));
+    EXPECT_EQ(30, Method(kEvaluate, "requestBytes"));
+    EXPECT_EQ(2, Method(kPause, "commands"));
+    EXPECT_EQ(60, Method(kPause, "requestBytes"));
+}
+
+TEST_F(ProtocolStatisticsTest, BatchResponsesAreNotAttributed)
+{
+    statistics_.WillDispatchMessage(20);
+    Dispatch(kEvaluate, 1);
+    Dispatch(kEvaluate, 2);
+    statistics_.RecordSerialization(ProtocolStatistics::BatchResponses, 0, 500, base::TimeDelta());
+    statistics_.DidDispatchMessage();
+
+    // Nor are later responses that reuse the batch's call ids.
+    Respond(1, 100);
+    EXPECT_EQ(0, Method(kEvaluate, "responseBytes"));
+}
+
+TEST_F(ProtocolStatisticsTest, NestedMessagesAndCommands)
+{
+    // Debugger.pause runs into a pause, during which the frontend evaluates
+    // and resumes.
+    statistics_.WillDispatchMessage(100);
+    statistics_.willDispatchCommand(kPause, 1);
+    statistics_.WillDispatchMessage(40);
+    Dispatch(kEvaluate, 2);
+    statistics_.DidDispatchMessage();
+    Respond(2, 300);
+    statistics_.WillDispatchMessage(10);
+    Dispatch(kResume, 3);
+    statistics_.DidDispatchMessage();
+    statistics_.didDispatchCommand(kPause, 1);
+    statistics_.DidDispatchMessage();
+    Respond(1, 20);
+    Respond(3, 5);
+
+    EXPECT_EQ(100, Method(kPause, "requestBytes"));
+    EXPECT_EQ(20, Method(kPause, "responseBytes"));
+    EXPECT_EQ(40, Method(kEvaluate, "requestBytes"));
+    EXPECT_EQ(300, Method(kEvaluate, "responseBytes"));
+    EXPECT_EQ(10, Method(kResume, "requestBytes"));
+    EXPECT_EQ(5, Method(kResume, "responseBytes"));
+
+    scoped_ptr<base::DictionaryValue> value = statistics_.ToValue();
+    double executed = 0;
+    EXPECT_TRUE(value->GetDouble("domains.Debugger.execute.count", &executed));
+    EXPECT_EQ(2, executed);
+    EXPECT_TRUE(value->GetDouble("domains.Runtime.execute.count", &executed));
+    EXPECT_EQ(1, executed);
+}
+
+TEST_F(ProtocolStatisticsTest, EachResponseCountsOnce)
+{
+    Dispatch(kEvaluate, 7);
+    Respond(7, 100);
+    Respond(7, 100);
+    Respond(8, 100);
+    EXPECT_EQ(100, Method(kEvaluate, "responseBytes"));
+    EXPECT_EQ(1, Method(kEvaluate, "serialize.count"));
+}
+
+TEST_F(ProtocolStatisticsTest, ReusedCallIdGoesToLatestCommand)
+{
+    Dispatch(kEvaluate, 5);
+    Dispatch(kPause, 5);
+    Respond(5, 100);
+    EXPECT_EQ(0, Method(kEvaluate, "responseBytes"));
+    EXPECT_EQ(100, Method(kPause, "responseBytes"));
+}
+
+TEST_F(ProtocolStatisticsTest, OldestUnansweredCommandIsEvicted)
+{
+    // Ids that do not grow: the first command has the largest one.
+    Dispatch(kPause, 1000000);
+    for (int i = 0; i < kMaxPendingResponses; ++i)
+        Dispatch(kEvaluate, i);
+    Respond(1000000, 100);
+    Respond(0, 10);
+    Respond(kMaxPendingResponses - 1, 10);
+    EXPECT_EQ(0, Method(kPause, "responseBytes"));
+    EXPECT_EQ(20, Method(kEvaluate, "responseBytes"));
+}
+
+TEST_F(ProtocolStatisticsTest, EvictionSkipsAnsweredAndReusedIds)
+{
+    // Answered commands still count towards the bound, but evicting them
+    // later must not drop a newer command that reuses the id.
+    Dispatch(kEvaluate, 1);
+    Respond(1, 10);
+    for (int i = 0; i < kMaxPendingResponses - 2; ++i)
+        Dispatch(kEvaluate, 100 + i);
+    Dispatch(kPause, 1);
+    // Pushes the first dispatch of id 1 out.
+    Dispatch(kEvaluate, 2);
+    Respond(1, 100);
+    EXPECT_EQ(100, Method(kPause, "responseBytes"));
+
+    // The answered command was the one given up on, so the next oldest is
+    // still pending.
+    Respond(100, 10);
+    EXPECT_EQ(20, Method(kEvaluate, "responseBytes"));
+}
+
+TEST_F(ProtocolStatisticsTest, DisconnectForgetsPendingCommands)
+{
+    Dispatch(kEvaluate, 1);
+    statistics_.DidDisconnect();
+    Respond(1, 100);
+    EXPECT_EQ(0, Method(kEvaluate, "responseBytes"));
+
+    // The next frontend starts from scratch, bound included.
+    for (int i = 0; i < kMaxPendingResponses; ++i)
+        Dispatch(kEvaluate, i);
+    Respond(0, 10);
+    EXPECT_EQ(10, Method(kEvaluate, "responseBytes"));
+}
+
+} // namespace
+} // namespace v8inspector
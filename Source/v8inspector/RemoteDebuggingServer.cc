@@ -6,13 +6,18 @@
 
 #include "v8inspector/RemoteDebuggingServer.h"
 
+#include "base/memory/ref_counted_memory.h"
 #include "base/message_loop/message_loop.h"
 #include "base/run_loop.h"
+#include "base/threading/platform_thread.h"
 #include "base/threading/thread.h"
+#include "base/trace_event/trace_event.h"
 #include "base/bind.h"
 #include "net/base/net_errors.h"
 #include "net/server/http_server.h"
-#include "net/socket/tcp_server_socket.h"
+#include "net/server/http_server_request_info.h"
+#include "net/socket/server_socket.h"
+#include "v8inspector/OffThreadResponder.h"
 #include "v8inspector/V8Inspector.h"
 #include "wtf/text/StringUTF8Adaptor.h"
 #include <string>
@@ -24,6 +29,10 @@ namespace v8inspector {
 
 namespace {
 
+const char kProtocolStatisticsPath[] = "/json/protocol-statistics";
+const char kStartTracingPath[] = "/json/protocol-trace/start";
+const char kStopTracingPath[] = "/json/protocol-trace/stop";
+
 std::string wtfToStdString(const String& string)
 {
     StringUTF8Adaptor utf8(string);
@@ -37,10 +46,28 @@ std::string wtfToStdString(const String& string)
 // added back pressure on the TraceComplete message protocol - crbug.com/456845.
 static const int32 kSendBufferSizeForDevTools = 256 * 1024 * 1024;  // 256Mb
 
+class RemoteDebuggingServer::InterruptTask : public V8Debugger::Task {
+public:
+    explicit InterruptTask(RemoteDebuggingServer* server) : server_(server) {}
+    void run() override { server_->DispatchPendingMessagesFromInterrupt(); }
+
+private:
+    RemoteDebuggingServer* server_;
+};
+
 // net::HttpServer::Delegate implementation -------------------------------------------------------------
 // All methods in the delegate are only called on handler thread.
 void RemoteDebuggingServer::OnHttpRequest(int connection_id, const net::HttpServerRequestInfo& request) {
-    fprintf(stderr, "RemoteDebuggingServer::OnHttpRequest 1\n");
+    if (transport_.log_messages)
+        fprintf(stderr, "RemoteDebuggingServer::OnHttpRequest %s\n", request.path.c_str());
+    if (request.path == kProtocolStatisticsPath)
+        SendStatistics(connection_id);
+    else if (request.path == kStartTracingPath)
+        StartTracing(connection_id);
+    else if (request.path == kStopTracingPath)
+        StopTracing(connection_id);
+    else
+        http_server_->Send404(connection_id);
 }
 
 void RemoteDebuggingServer::OnWebSocketRequest(int connection_id, const net::HttpServerRequestInfo& request) {
@@ -48,47 +75,244 @@ void RemoteDebuggingServer::OnWebSocketRequest(int connection_id, const net::Htt
     http_server_->AcceptWebSocket(connection_id, request);
     ASSERT(connection_id_ == -1);
     connection_id_ = connection_id;
-    fprintf(stderr, "RemoteDebuggingServer::OnWebSocketRequest accepted.\n");
+    if (transport_.log_messages)
+        fprintf(stderr, "RemoteDebuggingServer::OnWebSocketRequest accepted.\n");
     main_thread_loop_->task_runner()->PostTask(
         FROM_HERE,
         base::Bind(&RemoteDebuggingServer::HandleConnect,
                    base::Unretained(this), connection_id));
 }
 
-void RemoteDebuggingServer::OnWebSocketMessage(int connection_id, const std::string& data) {
-    main_thread_loop_->task_runner()->PostTask(
-        FROM_HERE,
-        base::Bind(&RemoteDebuggingServer::HandleMessageFromClient,
-                   base::Unretained(this), connection_id, data));
+void RemoteDebuggingServer::OnWebSocketMessage(int connection_id, std::string* data) {
+    statistics_.RecordMessageReceived(data->size());
+    // Only this thread adds messages, so the count can only go down after the check.
+    bool in_flight = base::subtle::Acquire_Load(&messages_in_flight_) > 0;
+    std::string response;
+    if (!in_flight && inspector_->offThreadResponder()->TryRespond(*data, &response)) {
+        statistics_.RecordOffThreadResponse();
+        sendMessageToClient(response);
+        return;
+    }
+    QueueMessageFromClient(data);
+}
+
+void RemoteDebuggingServer::OnWebSocketDeflateStats(int connection_id, const net::WebSocketEncoder::DeflateStats& stats) {
+    statistics_.RecordClosedConnectionDeflateStats(stats);
 }
 
 void RemoteDebuggingServer::OnClose(int connection_id) {
     connection_id_ = -1;
-    fprintf(stderr, "RemoteDebuggingServer::OnClose\n");
+    if (transport_.log_messages)
+        fprintf(stderr, "RemoteDebuggingServer::OnClose\n");
     main_thread_loop_->task_runner()->PostTask(
         FROM_HERE,
         base::Bind(&RemoteDebuggingServer::HandleDisconnect,
                    base::Unretained(this), connection_id));
 }
 
+// LengthPrefixedServer::Delegate implementation ---------------------------------------------------------
+// Called on handler thread. Connections need no handshake, so they go to the inspector right away.
+void RemoteDebuggingServer::OnFramedConnect(int connection_id) {
+    ASSERT(connection_id_ == -1);
+    connection_id_ = connection_id;
+    if (transport_.log_messages)
+        fprintf(stderr, "RemoteDebuggingServer::OnFramedConnect accepted.\n");
+    main_thread_loop_->task_runner()->PostTask(
+        FROM_HERE,
+        base::Bind(&RemoteDebuggingServer::HandleConnect,
+                   base::Unretained(this), connection_id));
+}
+
+void RemoteDebuggingServer::OnFramedMessage(int connection_id, std::string* data) {
+    OnWebSocketMessage(connection_id, data);
+}
+
+void RemoteDebuggingServer::OnFramedClose(int connection_id) {
+    OnClose(connection_id);
+}
+
+void RemoteDebuggingServer::SendStatistics(int connection_id)
+{
+    net::WebSocketEncoder::DeflateStats stats;
+    if (!framed_server_ && connection_id_ != -1 && http_server_->GetWebSocketDeflateStats(connection_id_, &stats))
+        statistics_.RecordDeflateStats(stats);
+    http_server_->Send200(connection_id, statistics_.ToJSON(), "application/json; charset=UTF-8");
+}
+
+void RemoteDebuggingServer::StartTracing(int connection_id)
+{
+    if (tracing_) {
+        http_server_->Send500(connection_id, "Protocol tracing is already running");
+        return;
+    }
+    tracing_ = true;
+    base::trace_event::TraceLog::GetInstance()->SetEnabled(
+        base::trace_event::CategoryFilter(ProtocolStatistics::kTraceCategory),
+        base::trace_event::TraceLog::RECORDING_MODE,
+        base::trace_event::TraceOptions());
+    http_server_->Send200(connection_id, "{}", "application/json; charset=UTF-8");
+}
+
+void RemoteDebuggingServer::StopTracing(int connection_id)
+{
+    if (!tracing_) {
+        http_server_->Send500(connection_id, "Protocol tracing is not running");
+        return;
+    }
+    tracing_ = false;
+    base::trace_event::TraceLog::GetInstance()->SetDisabled();
+    trace_events_.clear();
+    base::trace_event::TraceLog::GetInstance()->Flush(
+        base::Bind(&RemoteDebuggingServer::OnTraceDataCollected,
+                   base::Unretained(this), connection_id));
+}
+
+void RemoteDebuggingServer::OnTraceDataCollected(int connection_id, const scoped_refptr<base::RefCountedString>& events, bool has_more_events)
+{
+    if (!events->data().empty()) {
+        if (!trace_events_.empty())
+            trace_events_ += ",";
+        trace_events_ += events->data();
+    }
+    if (has_more_events)
+        return;
+    http_server_->Send200(connection_id, "{\"traceEvents\":[" + trace_events_ + "]}", "application/json; charset=UTF-8");
+    trace_events_.clear();
+}
+
+void RemoteDebuggingServer::QueueMessageFromClient(std::string* data)
+{
+    base::subtle::Barrier_AtomicIncrement(&messages_in_flight_, 1);
+    base::TimeTicks arrival = base::TimeTicks::Now();
+    // Messages must not overtake the ones still waiting for room.
+    if (overflow_messages_.empty() && PushMessage(data, arrival))
+        return;
+    overflow_messages_.push_back(std::make_pair(std::string(), arrival));
+    overflow_messages_.back().first.swap(*data);
+    PushOverflowMessages();
+}
+
+void RemoteDebuggingServer::PushOverflowMessages()
+{
+    while (!overflow_messages_.empty()) {
+        std::pair<std::string, base::TimeTicks>& front = overflow_messages_.front();
+        if (!PushMessage(&front.first, front.second)) {
+            // The ring is full, so the main thread has messages to dispatch
+            // and will see the flag once it is done with them. Check again
+            // after setting it in case it was done before.
+            base::subtle::NoBarrier_Store(&overflowed_, 1);
+            base::subtle::MemoryBarrier();
+            if (!PushMessage(&front.first, front.second))
+                return;
+        }
+        overflow_messages_.pop_front();
+    }
+}
+
+bool RemoteDebuggingServer::PushMessage(std::string* message, base::TimeTicks arrival)
+{
+    if (!pending_messages_.TryPush(message, arrival))
+        return false;
+    if (base::subtle::Barrier_AtomicIncrement(&queued_messages_, 1) != 1)
+        return true;
+    main_thread_loop_->task_runner()->PostTask(
+        FROM_HERE,
+        base::Bind(&RemoteDebuggingServer::DispatchPendingMessages,
+                   base::Unretained(this)));
+    // Gets the message through while a long script keeps the loop busy.
+    if (!base::subtle::NoBarrier_CompareAndSwap(&interrupt_requested_, 0, 1))
+        inspector_->interruptAndRun(adoptPtr(new InterruptTask(this)));
+    return true;
+}
+
 // Actual implementation. These methods are called on the main (JavaScript) thread.
 void RemoteDebuggingServer::HandleConnect(int connection_id)
 {
-    fprintf(stderr, "RemoteDebuggingServer::HandleConnect\n");
+    if (transport_.log_messages)
+        fprintf(stderr, "RemoteDebuggingServer::HandleConnect\n");
     inspector_->connectFrontend(this);
+    frontend_connected_ = true;
+}
+
+void RemoteDebuggingServer::DispatchPendingMessages()
+{
+    ++dispatch_depth_;
+    std::string message;
+    while (base::subtle::Acquire_Load(&queued_messages_) > 0) {
+        base::TimeTicks arrival;
+        if (!pending_messages_.TryPop(&message, &arrival)) {
+            // A producer claimed the oldest slot and is still filling it.
+            base::PlatformThread::YieldCurrentThread();
+            continue;
+        }
+        // The message may pause in a nested loop, which only gets later
+        // messages if they schedule a task of their own, that is if the count
+        // drops to zero before.
+        base::subtle::Barrier_AtomicIncrement(&queued_messages_, -1);
+        statistics_.RecordQueueTime(base::TimeTicks::Now() - arrival);
+        HandleMessageFromClient(message);
+        ++answered_messages_;
+    }
+    --dispatch_depth_;
+    if (base::subtle::Acquire_Load(&overflowed_)) {
+        base::subtle::NoBarrier_Store(&overflowed_, 0);
+        io_thread_->message_loop()->task_runner()->PostTask(
+            FROM_HERE,
+            base::Bind(&RemoteDebuggingServer::PushOverflowMessages,
+                       base::Unretained(this)));
+    }
+    FlushOutgoingMessages();
 }
 
-void RemoteDebuggingServer::HandleMessageFromClient(int connection_id, const std::string& data)
+void RemoteDebuggingServer::DispatchPendingMessagesFromInterrupt()
 {
-    fprintf(stderr, "RemoteDebuggingServer::HandleMessageFromClient %s\n", data.substr(0, 100).data());
+    base::subtle::Release_Store(&interrupt_requested_, 0);
+    // Leave the messages to the message loop task if the interrupt hit in the
+    // middle of a command or before the connection reached this thread.
+    if (!frontend_connected_ || inspector_->isDispatchingMessage())
+        return;
+    DispatchPendingMessages();
+}
+
+void RemoteDebuggingServer::FlushOutgoingMessages()
+{
+    if (outgoing_messages_.empty() && !answered_messages_)
+        return;
+    std::vector<std::string> messages;
+    messages.swap(outgoing_messages_);
+    // The messages stay in flight until the IO thread sent their responses.
+    io_thread_->message_loop()->task_runner()->PostTask(
+        FROM_HERE,
+        base::Bind(&RemoteDebuggingServer::sendMessagesToClient,
+                   base::Unretained(this), messages, answered_messages_));
+    answered_messages_ = 0;
+}
+
+// Covers a command that pauses, whose nested message loop would otherwise
+// hold back the output until it resumes.
+void RemoteDebuggingServer::FlushOutgoingMessagesTask()
+{
+    flush_scheduled_ = false;
+    FlushOutgoingMessages();
+}
+
+void RemoteDebuggingServer::HandleMessageFromClient(const std::string& data)
+{
+    if (transport_.log_messages)
+        fprintf(stderr, "RemoteDebuggingServer::HandleMessageFromClient %s\n", data.substr(0, 100).data());
     String message = String::fromUTF8(data.data(), data.length());
+    statistics_.WillDispatchMessage(data.size());
     inspector_->dispatchMessageFromFrontend(message);
+    statistics_.DidDispatchMessage();
 }
 
 void RemoteDebuggingServer::HandleDisconnect(int connection_id)
 {
-    fprintf(stderr, "RemoteDebuggingServer::HandleDisconnect\n");
+    if (transport_.log_messages)
+        fprintf(stderr, "RemoteDebuggingServer::HandleDisconnect\n");
+    frontend_connected_ = false;
     inspector_->disconnectFrontend();
+    statistics_.DidDisconnect();
 }
 
 // InspectorFrontendChannel implementation.
@@ -96,20 +320,42 @@ void RemoteDebuggingServer::sendProtocolResponse(int callId, PassRefPtr<JSONObje
 {
 //    printf("ChannelImpl::sendProtocolResponse \n");
 //    printf("ChannelImpl::sendProtocolResponse callId = %d message = %s\n", callId, message->toPrettyJSONString().utf8().data());
-    serializeAndSend(message);
+    serializeAndSend(message, ProtocolStatistics::Response, callId);
+}
+
+void RemoteDebuggingServer::sendProtocolResponses(PassRefPtr<JSONArray> messages)
+{
+    serializeAndSend(messages, ProtocolStatistics::BatchResponses, 0);
 }
 
 void RemoteDebuggingServer::sendProtocolNotification(PassRefPtr<JSONObject> message)
 {
 //    printf("ChannelImpl::sendProtocolNotification \n");
 //    printf("ChannelImpl::sendProtocolNotification message = %s\n", message->toPrettyJSONString().utf8().data());
-    serializeAndSend(message);
+    serializeAndSend(message, ProtocolStatistics::Notification, 0);
 }
 
-void RemoteDebuggingServer::serializeAndSend(PassRefPtr<blink::JSONObject> message)
+void RemoteDebuggingServer::serializeAndSend(PassRefPtr<blink::JSONValue> message, ProtocolStatistics::OutgoingMessageType type, int callId)
 {
-    String responseString = message->toJSONString();
-    std::string response = wtfToStdString(responseString);
+    base::TimeTicks start = base::TimeTicks::Now();
+    std::string response;
+    {
+        TRACE_EVENT0(ProtocolStatistics::kTraceCategory, "ProtocolSerialize");
+        response = wtfToStdString(message->toJSONString());
+    }
+    statistics_.RecordSerialization(type, callId, response.size(), base::TimeTicks::Now() - start);
+
+    if (dispatch_depth_) {
+        outgoing_messages_.push_back(response);
+        if (!flush_scheduled_) {
+            flush_scheduled_ = true;
+            main_thread_loop_->task_runner()->PostTask(
+                FROM_HERE,
+                base::Bind(&RemoteDebuggingServer::FlushOutgoingMessagesTask,
+                           base::Unretained(this)));
+        }
+        return;
+    }
 
     io_thread_->message_loop()->task_runner()->PostTask(
         FROM_HERE,
@@ -121,20 +367,47 @@ void RemoteDebuggingServer::serializeAndSend(PassRefPtr<blink::JSONObject> messa
 // Send methods. Called on the IO thread.
 void RemoteDebuggingServer::sendMessageToClient(const std::string& message)
 {
-    fprintf(stderr, "RemoteDebuggingServer::sendMessageToClient %s\n", message.substr(0, 100).data());
+    if (transport_.log_messages)
+        fprintf(stderr, "RemoteDebuggingServer::sendMessageToClient %s\n", message.substr(0, 100).data());
     if (connection_id_ == -1) {
-        printf("RemoteDebuggingServer::sendMessageToClient failed, connection closed \n");
+        if (transport_.log_messages)
+            fprintf(stderr, "RemoteDebuggingServer::sendMessageToClient failed, connection closed\n");
         return;
     }
-    http_server_->SendOverWebSocket(connection_id_, message);
+    TRACE_EVENT1(ProtocolStatistics::kTraceCategory, "ProtocolSend", "bytes", message.size());
+    base::TimeTicks start = base::TimeTicks::Now();
+    if (framed_server_)
+        framed_server_->Send(connection_id_, message);
+    else
+        http_server_->SendOverWebSocket(connection_id_, message);
+    statistics_.RecordMessageSent(message.size(), base::TimeTicks::Now() - start);
+}
+
+void RemoteDebuggingServer::sendMessagesToClient(const std::vector<std::string>& messages, int answered_messages)
+{
+    for (size_t i = 0; i < messages.size(); ++i)
+        sendMessageToClient(messages[i]);
+    if (answered_messages)
+        base::subtle::Barrier_AtomicIncrement(&messages_in_flight_, -answered_messages);
 }
 
-RemoteDebuggingServer::RemoteDebuggingServer(V8Inspector* inspector)
+RemoteDebuggingServer::RemoteDebuggingServer(V8Inspector* inspector, const RemoteDebuggingTransport& transport)
     : inspector_(inspector)
     , io_thread_(nullptr)
     , main_thread_loop_(base::MessageLoop::current())
+    , transport_(transport)
     , connection_id_(-1)
+    , frontend_connected_(false)
+    , dispatch_depth_(0)
+    , answered_messages_(0)
+    , flush_scheduled_(false)
+    , queued_messages_(0)
+    , messages_in_flight_(0)
+    , interrupt_requested_(0)
+    , overflowed_(0)
+    , tracing_(false)
 {
+    inspector_->setProtocolObserver(&statistics_);
     io_thread_.reset(new base::Thread("IO/Handler Thread"));
     base::Thread::Options options;
     options.message_loop_type = base::MessageLoop::TYPE_IO;
@@ -149,23 +422,23 @@ RemoteDebuggingServer::RemoteDebuggingServer(V8Inspector* inspector)
 
 RemoteDebuggingServer::~RemoteDebuggingServer()
 {
+    inspector_->setProtocolObserver(nullptr);
 }
 
 void RemoteDebuggingServer::StartServerOnHandlerThread()
 {
-    scoped_ptr<net::ServerSocket> server_socket(
-        new net::TCPServerSocket(nullptr, net::NetLog::Source()));
-    if (server_socket->ListenWithAddressAndPort("127.0.0.1", 2015, 10) != net::OK) {
-        fprintf(stderr, "RemoteDebuggingServer::StartServerOnHandlerThread FAILED to start listen socket\n");
+    scoped_ptr<net::ServerSocket> server_socket = transport_.CreateServerSocket();
+    if (!server_socket) {
+        fprintf(stderr, "RemoteDebuggingServer::StartServerOnHandlerThread FAILED to start listen socket on %s\n", transport_.Describe().c_str());
         return;
     }
-    scoped_ptr<net::IPEndPoint> ip_address(new net::IPEndPoint);
-    http_server_.reset(new net::HttpServer(server_socket.Pass(), this));
-    if (http_server_->GetLocalAddress(ip_address.get()) != net::OK) {
-        fprintf(stderr, "RemoteDebuggingServer::StartServerOnHandlerThread 4 failed to GetLocalAddress\n");
-        ip_address.reset();
+    if (transport_.framing == RemoteDebuggingTransport::LengthPrefixedFraming) {
+        framed_server_.reset(new LengthPrefixedServer(server_socket.Pass(), this));
+        fprintf(stderr, "RemoteDebuggingServer::StartServerOnHandlerThread Done, %s.\n", transport_.Describe().c_str());
+        return;
     }
-    fprintf(stderr, "RemoteDebuggingServer::StartServerOnHandlerThread Done.\n");
+    http_server_.reset(new net::HttpServer(server_socket.Pass(), this));
+    fprintf(stderr, "RemoteDebuggingServer::StartServerOnHandlerThread Done, %s.\n", transport_.Describe().c_str());
 }
 
 }  // namespace net
@@ -5,13 +5,25 @@
 #ifndef REMOTE_DEBUGGING_SERVER_H_
 #define REMOTE_DEBUGGING_SERVER_H_
 
+#include "base/atomicops.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
 #include "core/inspector/InspectorFrontendChannel.h"
 #include "net/server/http_server.h"
+#include "v8inspector/LengthPrefixedServer.h"
+#include "v8inspector/PendingMessageRing.h"
+#include "v8inspector/ProtocolStatistics.h"
+#include "v8inspector/RemoteDebuggingTransport.h"
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace base {
 class Thread;
 class MessageLoop;
+class RefCountedString;
 }
 
 namespace blink {
@@ -20,12 +32,22 @@ class V8Inspector;
 
 namespace v8inspector {
 
-class RemoteDebuggingServer : public net::HttpServer::Delegate, public blink::InspectorFrontendChannel {
+// Besides the WebSocket for the frontend, the HTTP server answers:
+//
+//   /json/protocol-statistics    ProtocolStatistics of the server so far,
+//                                with the WebSocket deflate totals.
+//   /json/protocol-trace/start   Starts recording ProtocolStatistics'
+//                                trace events.
+//   /json/protocol-trace/stop    Stops and returns them in the JSON trace
+//                                format.
+class RemoteDebuggingServer : public net::HttpServer::Delegate, public LengthPrefixedServer::Delegate, public blink::InspectorFrontendChannel {
 public:
-    explicit RemoteDebuggingServer(blink::V8Inspector*);
+    RemoteDebuggingServer(blink::V8Inspector*, const RemoteDebuggingTransport&);
     virtual ~RemoteDebuggingServer();
 
 private:
+    class InterruptTask;
+
     void StartServerOnHandlerThread();
 
     // net::HttpServer::Delegate implementation.
@@ -35,29 +57,99 @@ private:
     void OnWebSocketRequest(int connection_id,
                             const net::HttpServerRequestInfo& info) override;
     void OnWebSocketMessage(int connection_id,
-                            const std::string& data) override;
+                            std::string* data) override;
+    void OnWebSocketDeflateStats(int connection_id, const net::WebSocketEncoder::DeflateStats&) override;
     void OnClose(int connection_id) override;
 
+    // LengthPrefixedServer::Delegate implementation.
+    void OnFramedConnect(int connection_id) override;
+    void OnFramedMessage(int connection_id, std::string* data) override;
+    void OnFramedClose(int connection_id) override;
+
+    // Protocol trace requests. Called on the IO thread.
+    void SendStatistics(int connection_id);
+    void StartTracing(int connection_id);
+    void StopTracing(int connection_id);
+    void OnTraceDataCollected(int connection_id,
+                              const scoped_refptr<base::RefCountedString>& events,
+                              bool has_more_events);
+
+    // Queues a message for the JavaScript thread, taking the contents of
+    // |data|. Called on the IO thread.
+    void QueueMessageFromClient(std::string* data);
+    // Moves messages that did not fit into the ring over as far as they fit.
+    // Called on the IO thread.
+    void PushOverflowMessages();
+    bool PushMessage(std::string* message, base::TimeTicks arrival);
+
     // Protocol implementation.
     void HandleConnect(int connection_id);
-    void HandleMessageFromClient(int connection_id, const std::string& data);
+    void HandleMessageFromClient(const std::string& data);
     void HandleDisconnect(int connection_id);
+    void DispatchPendingMessages();
+    void DispatchPendingMessagesFromInterrupt();
+    void FlushOutgoingMessages();
+    void FlushOutgoingMessagesTask();
 
     // InspectorFrontendChannel implementation.
     void sendProtocolResponse(int callId, PassRefPtr<blink::JSONObject> message) override;
+    void sendProtocolResponses(PassRefPtr<blink::JSONArray> messages) override;
     void sendProtocolNotification(PassRefPtr<blink::JSONObject> message) override;
     void flush() override {}
 
-    void serializeAndSend(PassRefPtr<blink::JSONObject> message);
+    // |callId| is only used for responses.
+    void serializeAndSend(PassRefPtr<blink::JSONValue> message, ProtocolStatistics::OutgoingMessageType, int callId);
 
     // Send* methods. Called on the IO thread.
     void sendMessageToClient(const std::string& message);
+    // Also takes |answered_messages| out of flight once the messages are sent.
+    void sendMessagesToClient(const std::vector<std::string>& messages, int answered_messages);
 
     blink::V8Inspector* inspector_;
     scoped_ptr<base::Thread> io_thread_;
     base::MessageLoop* main_thread_loop_;
+    RemoteDebuggingTransport transport_;
+    // Only one of these exists, depending on transport_.framing.
     scoped_ptr<net::HttpServer> http_server_;
+    scoped_ptr<LengthPrefixedServer> framed_server_;
     int connection_id_;
+    // Whether HandleConnect() has run. Only used on the main thread.
+    bool frontend_connected_;
+    // Output of the messages being dispatched by DispatchPendingMessages(),
+    // handed to the IO thread in one task once the queue is drained. Only
+    // used on the main thread.
+    int dispatch_depth_;
+    std::vector<std::string> outgoing_messages_;
+    // Messages dispatched since the last flush. Their responses are in
+    // |outgoing_messages_| or were handed to the IO thread before.
+    int answered_messages_;
+    bool flush_scheduled_;
+
+    // Messages are handed to the main thread through this ring, drained both
+    // by a message loop task and by a V8 interrupt, whichever runs first.
+    PendingMessageRing pending_messages_;
+    // Messages pushed and not yet popped. The push that raises it from zero
+    // schedules the dispatch, so a burst of messages costs one task and at
+    // most one interrupt.
+    base::subtle::Atomic32 queued_messages_;
+    // Messages queued and not yet answered: dispatched and their responses
+    // sent by the IO thread. While there are any, the IO thread must not
+    // answer on its own or it could overtake them.
+    base::subtle::Atomic32 messages_in_flight_;
+    // At most one interrupt is outstanding; the next push after it ran may
+    // request another.
+    base::subtle::Atomic32 interrupt_requested_;
+    // Set by the IO thread when messages wait in |overflow_messages_|; the
+    // main thread then asks it to push them once it drained the ring.
+    base::subtle::Atomic32 overflowed_;
+    // Only used on the IO thread.
+    std::deque<std::pair<std::string, base::TimeTicks>> overflow_messages_;
+
+    ProtocolStatistics statistics_;
+    // Trace events collected by StopTracing() so far. Only used on the IO
+    // thread.
+    std::string trace_events_;
+    bool tracing_;
 };
 
 }  // namespace net
@@ -0,0 +1,190 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/RemoteDebuggingTransport.h"
+
+#include "base/bind.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_util.h"
+#include "net/socket/socket_libevent.h"
+#include "net/socket/tcp_server_socket.h"
+#include "net/socket/unix_domain_client_socket_posix.h"
+#include "net/socket/unix_domain_server_socket_posix.h"
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace v8inspector {
+
+namespace {
+
+const char kPortSwitch[] = "--remote-debugging-port=";
+const char kSocketSwitch[] = "--remote-debugging-socket=";
+const char kFdSwitch[] = "--remote-debugging-fd=";
+const char kRawSwitch[] = "--remote-debugging-raw";
+const char kLogMessagesSwitch[] = "--remote-debugging-log-messages";
+
+const uint16 kDefaultPort = 2015;
+const int kBacklog = 10;
+
+// Only processes of the same user may attach to the socket.
+bool IsSameUser(const net::UnixDomainServerSocket::Credentials& credentials)
+{
+    return credentials.user_id == geteuid();
+}
+
+// Hands out a connected socket once, as if it had been accepted. |fd| is the
+// descriptor of |socket|, which owns it.
+class InheritedServerSocket : public net::ServerSocket {
+public:
+    InheritedServerSocket(scoped_ptr<net::StreamSocket> socket, int fd)
+        : socket_(socket.Pass())
+        , fd_(fd)
+    {
+    }
+
+    int Listen(const net::IPEndPoint&, int) override { return net::ERR_NOT_IMPLEMENTED; }
+
+    // The address the inherited socket is bound to. Fails with
+    // ERR_ADDRESS_INVALID for Unix domain sockets, which have no IPEndPoint.
+    int GetLocalAddress(net::IPEndPoint* address) const override
+    {
+        net::SockaddrStorage storage;
+        if (getsockname(fd_, storage.addr, &storage.addr_len) < 0)
+            return net::MapSystemError(errno);
+        if (!address->FromSockAddr(storage.addr, storage.addr_len))
+            return net::ERR_ADDRESS_INVALID;
+        return net::OK;
+    }
+
+    int Accept(scoped_ptr<net::StreamSocket>* socket, const net::CompletionCallback&) override
+    {
+        if (!socket_)
+            return net::ERR_IO_PENDING;
+        *socket = socket_.Pass();
+        return net::OK;
+    }
+
+private:
+    scoped_ptr<net::StreamSocket> socket_;
+    int fd_;
+};
+
+bool StartsWith(const char* arg, const char* prefix)
+{
+    return !strncmp(arg, prefix, strlen(prefix));
+}
+
+} // namespace
+
+RemoteDebuggingTransport::RemoteDebuggingTransport()
+    : type(TCP)
+    , framing(WebSocketFraming)
+    , port(kDefaultPort)
+    , fd(-1)
+    , log_messages(false)
+{
+}
+
+bool RemoteDebuggingTransport::ParseSwitch(const char* arg, bool* error)
+{
+    *error = false;
+    if (StartsWith(arg, kPortSwitch)) {
+        unsigned value;
+        type = TCP;
+        if (!base::StringToUint(arg + strlen(kPortSwitch), &value) || !value || value > 0xFFFF)
+            *error = true;
+        else
+            port = static_cast<uint16>(value);
+        return true;
+    }
+    if (StartsWith(arg, kSocketSwitch)) {
+        type = UnixSocket;
+        socket_path = arg + strlen(kSocketSwitch);
+        *error = socket_path.empty() || socket_path == "@";
+        return true;
+    }
+    if (StartsWith(arg, kFdSwitch)) {
+        type = InheritedSocket;
+        if (!base::StringToInt(arg + strlen(kFdSwitch), &fd) || fd < 0)
+            *error = true;
+        return true;
+    }
+    if (!strcmp(arg, kRawSwitch)) {
+        framing = LengthPrefixedFraming;
+        return true;
+    }
+    if (!strcmp(arg, kLogMessagesSwitch)) {
+        log_messages = true;
+        return true;
+    }
+    return false;
+}
+
+// static
+bool RemoteDebuggingTransport::IsSwitch(const char* arg)
+{
+    RemoteDebuggingTransport transport;
+    bool error;
+    return transport.ParseSwitch(arg, &error);
+}
+
+scoped_ptr<net::ServerSocket> RemoteDebuggingTransport::CreateServerSocket() const
+{
+    switch (type) {
+    case TCP: {
+        scoped_ptr<net::ServerSocket> socket(new net::TCPServerSocket(nullptr, net::NetLog::Source()));
+        if (socket->ListenWithAddressAndPort("127.0.0.1", port, kBacklog) != net::OK)
+            return nullptr;
+        return socket.Pass();
+    }
+    case UnixSocket: {
+        bool abstractNamespace = socket_path[0] == '@';
+        scoped_ptr<net::ServerSocket> socket(new net::UnixDomainServerSocket(base::Bind(&IsSameUser), abstractNamespace));
+        std::string path = abstractNamespace ? socket_path.substr(1) : socket_path;
+        // A socket file left behind by an earlier run would fail the bind.
+        if (!abstractNamespace)
+            unlink(path.c_str());
+        if (socket->ListenWithAddressAndPort(path, 0, kBacklog) != net::OK)
+            return nullptr;
+        return socket.Pass();
+    }
+    case InheritedSocket: {
+        scoped_ptr<net::SocketLibevent> socket(new net::SocketLibevent);
+        if (socket->AdoptConnectedSocket(fd, net::SockaddrStorage()) != net::OK)
+            return nullptr;
+        scoped_ptr<net::StreamSocket> streamSocket(new net::UnixDomainClientSocket(socket.Pass()));
+        return scoped_ptr<net::ServerSocket>(new InheritedServerSocket(streamSocket.Pass(), fd));
+    }
+    }
+    NOTREACHED();
+    return nullptr;
+}
+
+std::string RemoteDebuggingTransport::Describe() const
+{
+    std::string description;
+    switch (type) {
+    case TCP:
+        description = base::StringPrintf("127.0.0.1:%d", port);
+        break;
+    case UnixSocket:
+        description = "unix:" + socket_path;
+        break;
+    case InheritedSocket:
+        description = base::StringPrintf("fd %d", fd);
+        break;
+    }
+    if (framing == LengthPrefixedFraming)
+        description += " (length-prefixed)";
+    return description;
+}
+
+} // namespace v8inspector
@@ -0,0 +1,68 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef REMOTE_DEBUGGING_TRANSPORT_H_
+#define REMOTE_DEBUGGING_TRANSPORT_H_
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include <string>
+
+namespace net {
+class ServerSocket;
+}
+
+namespace v8inspector {
+
+// Where RemoteDebuggingServer gets its frontend connection from, and how
+// messages are framed on it. Set up from command line switches:
+//
+//   --remote-debugging-port=<port>    TCP on 127.0.0.1 (the default, 2015).
+//   --remote-debugging-socket=<path>  Unix domain socket; a leading '@' names
+//                                     a socket in the abstract namespace.
+//   --remote-debugging-fd=<fd>        An already connected stream socket
+//                                     inherited from a supervisor, e.g. one
+//                                     end of a socketpair.
+//   --remote-debugging-raw            Skip HTTP and WebSocket: every message
+//                                     is a 32-bit big-endian length followed
+//                                     by that many bytes of UTF-8 JSON.
+//   --remote-debugging-log-messages   Log connections and the start of every
+//                                     message to stderr.
+struct RemoteDebuggingTransport {
+    enum Type {
+        TCP,
+        UnixSocket,
+        InheritedSocket,
+    };
+    enum Framing {
+        WebSocketFraming,
+        LengthPrefixedFraming,
+    };
+
+    RemoteDebuggingTransport();
+
+    // Applies |arg| if it is one of the switches above. Returns false if it is
+    // not; sets |*error| if it is but has an invalid value.
+    bool ParseSwitch(const char* arg, bool* error);
+    static bool IsSwitch(const char* arg);
+
+    // Creates the server socket to accept the frontend from, already
+    // listening. For an inherited socket, the first accept returns it and
+    // later ones never complete. Returns null on failure. Must be called on
+    // an IO thread.
+    scoped_ptr<net::ServerSocket> CreateServerSocket() const;
+
+    std::string Describe() const;
+
+    Type type;
+    Framing framing;
+    uint16 port;
+    std::string socket_path;
+    int fd;
+    bool log_messages;
+};
+
+}  // namespace v8inspector
+
+#endif // REMOTE_DEBUGGING_TRANSPORT_H_
@@ -0,0 +1,198 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/RemoteDebuggingTransport.h"
+
+#include "base/message_loop/message_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/net_errors.h"
+#include "net/socket/server_socket.h"
+#include "net/socket/stream_socket.h"
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace v8inspector {
+namespace {
+
+// Returns whether |arg| is a switch, and sets |*error| to whether its value
+// is invalid.
+bool Parse(RemoteDebuggingTransport* transport, const char* arg, bool* error)
+{
+    *error = true;
+    return transport->ParseSwitch(arg, error);
+}
+
+TEST(RemoteDebuggingTransportTest, Defaults)
+{
+    RemoteDebuggingTransport transport;
+    EXPECT_EQ(RemoteDebuggingTransport::TCP, transport.type);
+    EXPECT_EQ(RemoteDebuggingTransport::WebSocketFraming, transport.framing);
+    EXPECT_EQ(2015, transport.port);
+    EXPECT_FALSE(transport.log_messages);
+    EXPECT_EQ("127.0.0.1:2015", transport.Describe());
+}
+
+TEST(RemoteDebuggingTransportTest, Port)
+{
+    RemoteDebuggingTransport transport;
+    bool error;
+    EXPECT_TRUE(Parse(&transport, "--remote-debugging-port=9222", &error));
+    EXPECT_FALSE(error);
+    EXPECT_EQ(9222, transport.port);
+
+    const char* invalid[] = {
+        "--remote-debugging-port=",
+        "--remote-debugging-port=0",
+        "--remote-debugging-port=65536",
+        "--remote-debugging-port=-1",
+        "--remote-debugging-port=92x",
+    };
+    for (size_t i = 0; i < arraysize(invalid); ++i) {
+        EXPECT_TRUE(Parse(&transport, invalid[i], &error)) << invalid[i];
+        EXPECT_TRUE(error) << invalid[i];
+        EXPECT_EQ(9222, transport.port) << invalid[i];
+    }
+}
+
+TEST(RemoteDebuggingTransportTest, UnixSocket)
+{
+    RemoteDebuggingTransport transport;
+    bool error;
+    EXPECT_TRUE(Parse(&transport, "--remote-debugging-socket=/tmp/inspector", &error));
+    EXPECT_FALSE(error);
+    EXPECT_EQ(RemoteDebuggingTransport::UnixSocket, transport.type);
+    EXPECT_EQ("/tmp/inspector", transport.socket_path);
+    EXPECT_EQ("unix:/tmp/inspector", transport.Describe());
+
+    EXPECT_TRUE(Parse(&transport, "--remote-debugging-socket=@inspector", &error));
+    EXPECT_FALSE(error);
+    EXPECT_EQ("@inspector", transport.socket_path);
+
+    EXPECT_TRUE(Parse(&transport, "--remote-debugging-socket=", &error));
+    EXPECT_TRUE(error);
+    EXPECT_TRUE(Parse(&transport, "--remote-debugging-socket=@", &error));
+    EXPECT_TRUE(error);
+}
+
+TEST(RemoteDebuggingTransportTest, InheritedSocket)
+{
+    RemoteDebuggingTransport transport;
+    bool error;
+    EXPECT_TRUE(Parse(&transport, "--remote-debugging-fd=3", &error));
+    EXPECT_FALSE(error);
+    EXPECT_EQ(RemoteDebuggingTransport::InheritedSocket, transport.type);
+    EXPECT_EQ(3, transport.fd);
+    EXPECT_EQ("fd 3", transport.Describe());
+
+    EXPECT_TRUE(Parse(&transport, "--remote-debugging-fd=-1", &error));
+    EXPECT_TRUE(error);
+    EXPECT_TRUE(Parse(&transport, "--remote-debugging-fd=x", &error));
+    EXPECT_TRUE(error);
+}
+
+TEST(RemoteDebuggingTransportTest, Flags)
+{
+    RemoteDebuggingTransport transport;
+    bool error;
+    EXPECT_TRUE(Parse(&transport, "--remote-debugging-raw", &error));
+    EXPECT_FALSE(error);
+    EXPECT_EQ(RemoteDebuggingTransport::LengthPrefixedFraming, transport.framing);
+    EXPECT_EQ("127.0.0.1:2015 (length-prefixed)", transport.Describe());
+
+    EXPECT_TRUE(Parse(&transport, "--remote-debugging-log-messages", &error));
+    EXPECT_FALSE(error);
+    EXPECT_TRUE(transport.log_messages);
+}
+
+TEST(RemoteDebuggingTransportTest, OtherArguments)
+{
+    const char* others[] = {
+        "--remote-debugging-port",
+        "--remote-debugging-raw=1",
+        "--remote-debugging-log-messages2",
+        "--remote-debugging",
+        "-remote-debugging-port=9222",
+        "script.js",
+        "",
+    };
+    for (size_t i = 0; i < arraysize(others); ++i) {
+        RemoteDebuggingTransport transport;
+        bool error;
+        EXPECT_FALSE(Parse(&transport, others[i], &error)) << others[i];
+        EXPECT_FALSE(error) << others[i];
+        EXPECT_FALSE(RemoteDebuggingTransport::IsSwitch(others[i])) << others[i];
+    }
+    EXPECT_TRUE(RemoteDebuggingTransport::IsSwitch("--remote-debugging-port=9222"));
+    EXPECT_TRUE(RemoteDebuggingTransport::IsSwitch("--remote-debugging-port=0"));
+    EXPECT_TRUE(RemoteDebuggingTransport::IsSwitch("--remote-debugging-raw"));
+}
+
+// Returns the server socket for an inherited |fd|, which it takes over.
+scoped_ptr<net::ServerSocket> InheritSocket(int fd)
+{
+    RemoteDebuggingTransport transport;
+    bool error;
+    std::string arg = "--remote-debugging-fd=" + base::IntToString(fd);
+    EXPECT_TRUE(Parse(&transport, arg.c_str(), &error));
+    EXPECT_FALSE(error);
+    return transport.CreateServerSocket();
+}
+
+TEST(RemoteDebuggingTransportTest, InheritedTCPSocketHasLocalAddress)
+{
+    base::MessageLoopForIO message_loop;
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_LE(0, listener);
+    sockaddr_in address = sockaddr_in();
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    ASSERT_EQ(0, bind(listener, reinterpret_cast<sockaddr*>(&address), length));
+    ASSERT_EQ(0, listen(listener, 1));
+    ASSERT_EQ(0, getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length));
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_EQ(0, connect(client, reinterpret_cast<sockaddr*>(&address), length));
+    int accepted = accept(listener, nullptr, nullptr);
+    ASSERT_LE(0, accepted);
+
+    scoped_ptr<net::ServerSocket> server_socket = InheritSocket(accepted);
+    ASSERT_TRUE(server_socket);
+    net::IPEndPoint local;
+    ASSERT_EQ(net::OK, server_socket->GetLocalAddress(&local));
+    EXPECT_EQ("127.0.0.1", local.ToStringWithoutPort());
+    EXPECT_EQ(ntohs(address.sin_port), local.port());
+
+    // The first accept returns the inherited socket, later ones never
+    // complete.
+    scoped_ptr<net::StreamSocket> socket;
+    EXPECT_EQ(net::OK, server_socket->Accept(&socket, net::CompletionCallback()));
+    EXPECT_TRUE(socket);
+    EXPECT_EQ(net::ERR_IO_PENDING, server_socket->Accept(&socket, net::CompletionCallback()));
+    // Still known once the socket is handed out.
+    EXPECT_EQ(net::OK, server_socket->GetLocalAddress(&local));
+
+    close(client);
+    close(listener);
+}
+
+TEST(RemoteDebuggingTransportTest, InheritedUnixSocketHasNoLocalAddress)
+{
+    base::MessageLoopForIO message_loop;
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    scoped_ptr<net::ServerSocket> server_socket = InheritSocket(fds[0]);
+    ASSERT_TRUE(server_socket);
+    net::IPEndPoint local;
+    EXPECT_EQ(net::ERR_ADDRESS_INVALID, server_socket->GetLocalAddress(&local));
+    close(fds[1]);
+}
+
+} // namespace
+} // namespace v8inspector
@@ -0,0 +1,126 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/StreamedScript.h"
+
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/location.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/single_thread_task_runner.h"
+#include "base/thread_task_runner_handle.h"
+#include <algorithm>
+#include <include/v8-platform.h>
+#include <string.h>
+
+namespace v8inspector {
+
+namespace {
+
+// Chunks handed to V8, which takes ownership of each. V8 handles UTF-8
+// sequences split between chunks, so the size only trades the number of
+// copies against their length.
+const size_t kChunkSize = 64 * 1024;
+
+}
+
+class StreamedScript::MappedSourceStream : public v8::ScriptCompiler::ExternalSourceStream {
+public:
+    explicit MappedSourceStream(const MappedScriptSource* mapped) : mapped_(mapped), position_(0) {}
+
+    // Called on the background thread.
+    size_t GetMoreData(const uint8_t** src) override {
+        size_t length = std::min(kChunkSize, mapped_->length() - position_);
+        if (!length)
+            return 0;
+        uint8_t* chunk = new uint8_t[length];
+        memcpy(chunk, mapped_->data() + position_, length);
+        position_ += length;
+        *src = chunk;
+        return length;
+    }
+
+private:
+    const MappedScriptSource* mapped_;
+    size_t position_;
+};
+
+class StreamedScript::ParseTask : public v8::Task {
+public:
+    ParseTask(v8::ScriptCompiler::ScriptStreamingTask* task, StreamedScript* script)
+        : task_(task),
+          parsed_(&script->parsed_),
+          task_runner_(script->task_runner_),
+          script_(script->weak_factory_.GetWeakPtr()) {}
+
+    // |script_| is only dereferenced on the main thread, by DidParse(). The
+    // script cannot be destroyed before |parsed_| is signaled.
+    void Run() override {
+        task_->Run();
+        task_.reset();
+        parsed_->Signal();
+        task_runner_->PostTask(FROM_HERE, base::Bind(&StreamedScript::DidParse, script_));
+    }
+
+private:
+    scoped_ptr<v8::ScriptCompiler::ScriptStreamingTask> task_;
+    base::WaitableEvent* parsed_;
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
+    base::WeakPtr<StreamedScript> script_;
+};
+
+// static
+scoped_ptr<StreamedScript> StreamedScript::Start(v8::Isolate* isolate, v8::Platform* platform, const std::string& path) {
+    scoped_ptr<MappedScriptSource> mapped = MappedScriptSource::Create(base::FilePath(path));
+    if (!mapped)
+        return scoped_ptr<StreamedScript>();
+    scoped_ptr<StreamedScript> script(new StreamedScript(path, mapped.Pass()));
+    v8::ScriptCompiler::ScriptStreamingTask* task =
+        v8::ScriptCompiler::StartStreamingScript(isolate, &script->source_);
+    platform->CallOnBackgroundThread(new ParseTask(task, script.get()),
+                                     v8::Platform::kShortRunningTask);
+    return script.Pass();
+}
+
+StreamedScript::StreamedScript(const std::string& path, scoped_ptr<MappedScriptSource> mapped)
+    : path_(path),
+      mapped_(mapped.Pass()),
+      source_(new MappedSourceStream(mapped_.get()), v8::ScriptCompiler::StreamedSource::UTF8),
+      parsed_(true, false),
+      task_runner_(base::ThreadTaskRunnerHandle::Get()),
+      weak_factory_(this) {
+}
+
+StreamedScript::~StreamedScript() {
+    parsed_.Wait();
+}
+
+void StreamedScript::RunUntilParsed() {
+    // DidParse() is posted after |parsed_| is signaled, so it is still to
+    // come if parsing has not finished yet.
+    if (IsParsed())
+        return;
+    base::RunLoop run_loop;
+    quit_when_parsed_ = run_loop.QuitClosure();
+    base::MessageLoop::ScopedNestableTaskAllower allow(base::MessageLoop::current());
+    run_loop.Run();
+    quit_when_parsed_.Reset();
+}
+
+void StreamedScript::DidParse() {
+    if (!quit_when_parsed_.is_null())
+        quit_when_parsed_.Run();
+}
+
+v8::MaybeLocal<v8::Script> StreamedScript::Compile(v8::Local<v8::Context> context,
+                                                   const v8::ScriptOrigin& origin) {
+    parsed_.Wait();
+    v8::Local<v8::String> full_source = MappedScriptSource::ToV8String(context->GetIsolate(), mapped_.Pass());
+    return v8::ScriptCompiler::Compile(context, &source_, full_source, origin);
+}
+
+}  // namespace v8inspector
@@ -0,0 +1,82 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef STREAMED_SCRIPT_H_
+#define STREAMED_SCRIPT_H_
+
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/synchronization/waitable_event.h"
+#include "v8inspector/MappedScriptSource.h"
+#include <include/v8.h>
+#include <string>
+
+namespace base {
+class SingleThreadTaskRunner;
+}
+
+namespace v8 {
+class Platform;
+}
+
+namespace v8inspector {
+
+// A script file that is parsed on a v8::Platform background thread while the
+// main thread keeps running. The file is mapped once; the parser is fed
+// chunks of the mapping through an ExternalSourceStream, and the same mapping
+// becomes the source string of the compiled script, so the file is neither
+// read twice nor able to change between parsing and compiling.
+//
+// A streamed compile can neither consume nor produce cached data, so scripts
+// are not streamed when the code cache is enabled: a cache hit skips the
+// parse that streaming would overlap, and a miss has to compile on the main
+// thread to produce the entry.
+class StreamedScript {
+public:
+    // Maps |path| and starts parsing it. Must be called on a thread with a
+    // message loop, which is told when parsing has finished. Returns NULL if
+    // the file cannot be mapped, e.g. because it is empty.
+    static scoped_ptr<StreamedScript> Start(v8::Isolate*, v8::Platform*, const std::string& path);
+    // Blocks until the background task has finished.
+    ~StreamedScript();
+
+    const std::string& path() const { return path_; }
+    bool IsParsed() { return parsed_.IsSignaled(); }
+
+    // Runs the current message loop until parsing has finished, so that
+    // protocol messages and other tasks are handled in the meantime.
+    void RunUntilParsed();
+
+    // Compiles the script in |context|, waiting for parsing to finish if it
+    // has not yet. Can only be called once.
+    v8::MaybeLocal<v8::Script> Compile(v8::Local<v8::Context> context,
+                                       const v8::ScriptOrigin& origin);
+
+private:
+    class MappedSourceStream;
+    class ParseTask;
+
+    StreamedScript(const std::string& path, scoped_ptr<MappedScriptSource> mapped);
+
+    void DidParse();
+
+    std::string path_;
+    // Read by the parser on the background thread until |parsed_| is
+    // signaled.
+    scoped_ptr<MappedScriptSource> mapped_;
+    v8::ScriptCompiler::StreamedSource source_;
+    base::WaitableEvent parsed_;
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
+    // Quits the run loop of RunUntilParsed(), if it is running.
+    base::Closure quit_when_parsed_;
+    base::WeakPtrFactory<StreamedScript> weak_factory_;
+
+    DISALLOW_COPY_AND_ASSIGN(StreamedScript);
+};
+
+}  // namespace v8inspector
+
+#endif // STREAMED_SCRIPT_H_
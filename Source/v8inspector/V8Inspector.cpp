@@ -11,11 +11,14 @@
 #include "core/inspector/InjectedScriptHost.h"
 #include "core/inspector/InjectedScriptManager.h"
 #include "core/inspector/InspectorFrontendChannel.h"
+#include "core/inspector/InspectorMemoryAgent.h"
 #include "core/inspector/InspectorState.h"
 #include "core/inspector/InspectorStateClient.h"
 #include "core/inspector/WorkerDebuggerAgent.h"
 #include "core/inspector/WorkerRuntimeAgent.h"
+#include "v8inspector/OffThreadResponder.h"
 #include "wtf/PassOwnPtr.h"
+#include "wtf/TemporaryChange.h"
 
 namespace blink {
 
@@ -40,13 +43,16 @@ public:
 }
 
 V8Inspector::V8Inspector(v8::Isolate* isolate, PassOwnPtr<WorkerThreadDebugger::ClientMessageLoop> messageLoop)
-    : m_stateClient(adoptPtr(new StateClientImpl()))
+    : m_offThreadResponder(adoptPtr(new v8inspector::OffThreadResponder()))
+    , m_stateClient(adoptPtr(new StateClientImpl()))
     , m_state(adoptPtrWillBeNoop(new InspectorCompositeState(m_stateClient.get())))
     , m_injectedScriptManager(InjectedScriptManager::createForWorker())
     , m_workerThreadDebugger(WorkerThreadDebugger::create(isolate, messageLoop))
     , m_agents(m_state.get())
     , m_frontendChannel(nullptr)
+    , m_protocolObserver(nullptr)
     , m_paused(false)
+    , m_dispatchingMessage(false)
 {
     ScriptState* scriptState = ScriptState::current(isolate);
 
@@ -58,7 +64,15 @@ V8Inspector::V8Inspector(v8::Isolate* isolate, PassOwnPtr<WorkerThreadDebugger::
     m_workerDebuggerAgent = workerDebuggerAgent.get();
     m_agents.append(workerDebuggerAgent.release());
 
+    OwnPtrWillBeRawPtr<InspectorMemoryAgent> memoryAgent = InspectorMemoryAgent::create(isolate, this);
+    m_memoryAgent = memoryAgent.get();
+    m_agents.append(memoryAgent.release());
+
     m_injectedScriptManager->injectedScriptHost()->init(m_workerDebuggerAgent, nullptr, m_workerThreadDebugger->debugger(), adoptPtr(new InjectedScriptHostClientImpl()));
+
+    m_offThreadResponder->Publish("Debugger.canSetScriptSource", "{\"result\":true}");
+    publishRunRequired();
+    gcStatisticsChanged();
 }
 
 V8Inspector::~V8Inspector()
@@ -70,6 +84,13 @@ void V8Inspector::registerModuleAgent(PassOwnPtrWillBeRawPtr<InspectorAgent> age
     m_agents.append(agent);
 }
 
+void V8Inspector::setSearchThreads(WebThread* inspectorThread, WebThread* backgroundThread)
+{
+    m_workerDebuggerAgent->setSearchThreads(inspectorThread, backgroundThread);
+    m_memoryAgent->setInspectorThread(inspectorThread);
+    gcStatisticsChanged();
+}
+
 void V8Inspector::connectFrontend(InspectorFrontendChannel* channel)
 {
     ASSERT(!m_frontend);
@@ -77,8 +98,10 @@ void V8Inspector::connectFrontend(InspectorFrontendChannel* channel)
     m_frontendChannel = channel;
     m_frontend = adoptPtr(new InspectorFrontend(m_frontendChannel));
     m_backendDispatcher = InspectorBackendDispatcher::create(m_frontendChannel);
+    m_backendDispatcher->setObserver(m_protocolObserver);
     m_agents.registerInDispatcher(m_backendDispatcher.get());
     m_agents.setFrontend(m_frontend.get());
+    gcStatisticsChanged();
 }
 
 void V8Inspector::disconnectFrontend()
@@ -93,6 +116,7 @@ void V8Inspector::disconnectFrontend()
     m_agents.clearFrontend();
     m_frontend.clear();
     m_frontendChannel = nullptr;
+    gcStatisticsChanged();
 }
 
 void V8Inspector::restoreInspectorStateFromCookie(const String& inspectorCookie)
@@ -106,8 +130,10 @@ void V8Inspector::restoreInspectorStateFromCookie(const String& inspectorCookie)
 
 void V8Inspector::dispatchMessageFromFrontend(const String& message)
 {
-    if (m_backendDispatcher)
-        m_backendDispatcher->dispatch(message);
+    if (!m_backendDispatcher)
+        return;
+    TemporaryChange<bool> dispatching(m_dispatchingMessage, true);
+    m_backendDispatcher->dispatch(message);
 }
 
 void V8Inspector::dispose()
@@ -120,9 +146,23 @@ void V8Inspector::interruptAndDispatchInspectorCommands()
     m_workerDebuggerAgent->interruptAndDispatchInspectorCommands();
 }
 
+static void runInterruptTask(v8::Isolate*, void* data)
+{
+    OwnPtr<V8Debugger::Task> task = adoptPtr(static_cast<V8Debugger::Task*>(data));
+    task->run();
+}
+
+void V8Inspector::interruptAndRun(PassOwnPtr<V8Debugger::Task> task)
+{
+    // Not V8Debugger::interruptAndRun, which holds the tasks back until the
+    // Debugger domain is enabled.
+    m_workerThreadDebugger->debugger()->isolate()->RequestInterrupt(&runInterruptTask, task.leakPtr());
+}
+
 void V8Inspector::resumeStartup()
 {
     m_paused = false;
+    publishRunRequired();
 }
 
 bool V8Inspector::isRunRequired()
@@ -133,7 +173,44 @@ bool V8Inspector::isRunRequired()
 void V8Inspector::pauseOnStart()
 {
     m_paused = true;
+    publishRunRequired();
     printf("V8Inspector::pauseOnStart\n");
 }
 
+void V8Inspector::setProtocolObserver(InspectorBackendDispatcher::Observer* observer)
+{
+    m_protocolObserver = observer;
+    if (m_backendDispatcher)
+        m_backendDispatcher->setObserver(observer);
+}
+
+void V8Inspector::gcStatisticsChanged()
+{
+    // Only a connected frontend can ask, and only while tracking is enabled;
+    // anything else would build and serialize the statistics after every GC
+    // for nobody. Without an inspector thread the GCs are not reported, so a
+    // published answer would go stale.
+    if (!m_frontend || !m_memoryAgent->isTrackingGC() || !m_memoryAgent->hasInspectorThread()) {
+        m_offThreadResponder->Withdraw("Memory.getGCStatistics");
+        return;
+    }
+    ErrorString error;
+    RefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCPauseSummary>> summaries;
+    RefPtr<TypeBuilder::Array<TypeBuilder::Memory::GCEvent>> events;
+    m_memoryAgent->getGCStatistics(&error, nullptr, summaries, events);
+    if (!error.isEmpty()) {
+        m_offThreadResponder->Withdraw("Memory.getGCStatistics");
+        return;
+    }
+    RefPtr<JSONObject> result = JSONObject::create();
+    result->setValue("summaries", summaries);
+    CString json = result->toJSONString().utf8();
+    m_offThreadResponder->Publish("Memory.getGCStatistics", std::string(json.data(), json.length()));
+}
+
+void V8Inspector::publishRunRequired()
+{
+    m_offThreadResponder->Publish("Runtime.isRunRequired", m_paused ? "{\"result\":true}" : "{\"result\":false}");
+}
+
 } // namespace blink
@@ -6,25 +6,31 @@
 #define V8Inspector_h
 
 #include "bindings/core/v8/WorkerThreadDebugger.h"
+#include "core/InspectorBackendDispatcher.h"
 #include "core/inspector/InspectorBaseAgent.h"
+#include "core/inspector/InspectorMemoryAgent.h"
 #include "core/inspector/InspectorRuntimeAgent.h"
 #include "wtf/Forward.h"
 #include "wtf/Noncopyable.h"
 #include "wtf/OwnPtr.h"
 #include "wtf/RefPtr.h"
 
+namespace v8inspector {
+class OffThreadResponder;
+}
+
 namespace blink {
 
 class InjectedScriptManager;
-class InspectorBackendDispatcher;
 class InspectorFrontend;
 class InspectorFrontendChannel;
 class InspectorStateClient;
+class WebThread;
 class WorkerDebuggerAgent;
 class WorkerRuntimeAgent;
 class WorkerThreadDebugger;
 
-class V8Inspector : public InspectorRuntimeAgent::Client {
+class V8Inspector : public InspectorRuntimeAgent::Client, public InspectorMemoryAgent::Client {
     WTF_MAKE_NONCOPYABLE(V8Inspector);
 public:
     explicit V8Inspector(v8::Isolate*, PassOwnPtr<WorkerThreadDebugger::ClientMessageLoop>);
@@ -38,14 +44,41 @@ public:
     void dispatchMessageFromFrontend(const String&);
     void dispose();
     void interruptAndDispatchInspectorCommands();
+    // Threads for Debugger.searchInAllScripts; |inspectorThread| is the
+    // JavaScript thread, which also gets the GC reports of the Memory domain.
+    // Both must outlive this object.
+    void setSearchThreads(WebThread* inspectorThread, WebThread* backgroundThread);
+
+    // May be called on any thread. Runs |task| on the JavaScript thread as soon
+    // as the running script reaches an interrupt check, whether or not the
+    // Debugger domain is enabled.
+    void interruptAndRun(PassOwnPtr<V8Debugger::Task>);
+    // Whether a protocol command is being dispatched; commands must not be
+    // dispatched from an interrupt in the middle of another one.
+    bool isDispatchingMessage() const { return m_dispatchingMessage; }
+
+    // Results of parameterless commands that only depend on state this class
+    // keeps published, for the IO thread to answer while JavaScript is busy.
+    v8inspector::OffThreadResponder* offThreadResponder() const { return m_offThreadResponder.get(); }
 
     void pauseOnStart();
 
+    // Told about the messages and commands of this and every later frontend
+    // connection; |observer| must outlive them or be reset.
+    void setProtocolObserver(InspectorBackendDispatcher::Observer*);
+
 private:
     // InspectorRuntimeAgent::Client implementation.
     void resumeStartup() override;
     bool isRunRequired() override;
 
+    // InspectorMemoryAgent::Client implementation.
+    void gcStatisticsChanged() override;
+
+    void publishRunRequired();
+
+    // Declared first so that agents may still publish while being destroyed.
+    OwnPtr<v8inspector::OffThreadResponder> m_offThreadResponder;
     OwnPtr<InspectorStateClient> m_stateClient;
     OwnPtrWillBeMember<InspectorCompositeState> m_state;
     OwnPtrWillBeMember<InjectedScriptManager> m_injectedScriptManager;
@@ -56,7 +89,10 @@ private:
     RefPtrWillBeMember<InspectorBackendDispatcher> m_backendDispatcher;
     RawPtrWillBeMember<WorkerDebuggerAgent> m_workerDebuggerAgent;
     RawPtrWillBeMember<WorkerRuntimeAgent> m_workerRuntimeAgent;
+    RawPtrWillBeMember<InspectorMemoryAgent> m_memoryAgent;
+    InspectorBackendDispatcher::Observer* m_protocolObserver;
     bool m_paused;
+    bool m_dispatchingMessage;
 };
 
 }
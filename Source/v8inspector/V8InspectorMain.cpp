@@ -6,18 +6,27 @@
 
 #include "bindings/core/v8/ScriptState.h"
 #include "bindings/core/v8/WorkerThreadDebugger.h"
+#include "v8inspector/CodeCache.h"
+#include "v8inspector/IdleGCScheduler.h"
+#include "v8inspector/InspectorPlatform.h"
+#include "v8inspector/InspectorWebThread.h"
+#include "v8inspector/MappedScriptSource.h"
+#include "v8inspector/StreamedScript.h"
 #include "v8inspector/V8Inspector.h"
+#include "v8inspector/WorkStealingThreadPool.h"
 #include "v8inspector/RemoteDebuggingServer.h"
+#include "v8inspector/RemoteDebuggingTransport.h"
 #include "wtf/OwnPtr.h"
 
 #include <include/v8.h>
-#include <include/libplatform/libplatform.h>
 
 #include "base/message_loop/message_loop.h"
 #include "base/at_exit.h"
 #include "base/run_loop.h"
 #include "base/threading/thread.h"
 #include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_vector.h"
 
 #include <assert.h>
 #include <fcntl.h>
@@ -44,17 +53,30 @@ bool ExecuteString(v8::Isolate* isolate,
                    v8::Handle<v8::String> source,
                    v8::Handle<v8::Value> name,
                    bool print_result,
-                   bool report_exceptions);
+                   bool report_exceptions,
+                   const std::string& cache_key = std::string());
+bool ExecuteStreamedScript(v8::Isolate* isolate,
+                           StreamedScript* streamed_script,
+                           bool report_exceptions);
 void Print(const v8::FunctionCallbackInfo<v8::Value>& args);
 void Read(const v8::FunctionCallbackInfo<v8::Value>& args);
 void Load(const v8::FunctionCallbackInfo<v8::Value>& args);
 void Quit(const v8::FunctionCallbackInfo<v8::Value>& args);
 void Version(const v8::FunctionCallbackInfo<v8::Value>& args);
-v8::Handle<v8::String> ReadFile(v8::Isolate* isolate, const char* name);
+void CodeCacheStatistics(const v8::FunctionCallbackInfo<v8::Value>& args);
+v8::Handle<v8::String> ReadFile(v8::Isolate* isolate, const char* name,
+                                std::string* cache_key = NULL);
 void ReportException(v8::Isolate* isolate, v8::TryCatch* handler);
 
 
 static bool run_shell;
+static InspectorPlatform* platform;
+// Set by --code-cache-dir=<path>. Scripts are streamed only without it; see
+// StreamedScript.
+static CodeCache* code_cache;
+static const char kCodeCacheDirFlag[] = "--code-cache-dir=";
+// Prints the background pool's statistics at exit.
+static const char kBackgroundTaskStatsFlag[] = "--background-task-stats";
 
 namespace {
 
@@ -73,6 +95,25 @@ class DebuggerMessageLoopImpl : public WorkerThreadDebugger::ClientMessageLoop {
   base::MessageLoop* message_loop_;
 };
 
+// Hands IdleGCScheduler's slices to the isolate.
+class IsolateIdleHeap : public IdleGCScheduler::Heap {
+ public:
+  IsolateIdleHeap(v8::Isolate* isolate, InspectorPlatform* platform)
+      : isolate_(isolate), platform_(platform) {}
+  size_t UsedHeapSize() override {
+    v8::HeapStatistics statistics;
+    isolate_->GetHeapStatistics(&statistics);
+    return statistics.used_heap_size();
+  }
+  bool IdleNotification(base::TimeDelta slice) override {
+    double deadline = platform_->MonotonicallyIncreasingTime() + slice.InSecondsF();
+    return isolate_->IdleNotificationDeadline(deadline);
+  }
+ private:
+  v8::Isolate* isolate_;
+  InspectorPlatform* platform_;
+};
+
 class ShellArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
  public:
   void* Allocate(size_t length) override {
@@ -105,7 +146,7 @@ int main(int argc, char* argv[]) {
   base::MessageLoop message_loop;
 
   v8::V8::InitializeICU();
-  v8::Platform* platform = v8::platform::CreateDefaultPlatform();
+  platform = new InspectorPlatform();
   v8::V8::InitializePlatform(platform);
   v8::V8::Initialize();
   v8::V8::SetFlagsFromCommandLine(&argc, argv, true);
@@ -113,8 +154,35 @@ int main(int argc, char* argv[]) {
   v8::Isolate::CreateParams create_params;
   create_params.array_buffer_allocator = &array_buffer_allocator;
   v8::Isolate* isolate = v8::Isolate::New(create_params);
-
-  run_shell = (argc == 1);
+  platform->RegisterIsolate(isolate, message_loop.task_runner());
+  // Outlive the background pool, which may still be running search tasks
+  // that post back to the message loop.
+  TaskRunnerWebThread inspector_thread(message_loop.task_runner());
+  ThreadPoolWebThread search_thread(platform->background_pool(), message_loop.task_runner());
+
+  scoped_ptr<CodeCache> code_cache_owner;
+  bool print_background_task_stats = false;
+  RemoteDebuggingTransport transport;
+  int handled_switches = 0;
+  for (int i = 1; i < argc; i++) {
+    bool invalid_value;
+    if (strncmp(argv[i], kCodeCacheDirFlag, strlen(kCodeCacheDirFlag)) == 0) {
+      code_cache_owner.reset(new CodeCache(
+          base::FilePath(argv[i] + strlen(kCodeCacheDirFlag))));
+      ++handled_switches;
+    } else if (strcmp(argv[i], kBackgroundTaskStatsFlag) == 0) {
+      print_background_task_stats = true;
+      ++handled_switches;
+    } else if (transport.ParseSwitch(argv[i], &invalid_value)) {
+      if (invalid_value) {
+        fprintf(stderr, "Invalid value in %s\n", argv[i]);
+        return 1;
+      }
+      ++handled_switches;
+    }
+  }
+  run_shell = (argc == 1 + handled_switches);
+  code_cache = code_cache_owner.get();
 
   fprintf(stderr, "main 10\n");
   int result;
@@ -133,8 +201,12 @@ int main(int argc, char* argv[]) {
     // Must be in context when constructing V8Inspector.
     ScriptState::create(context);
     OwnPtr<V8Inspector> inspector = adoptPtr(new V8Inspector(isolate, adoptPtr(new DebuggerMessageLoopImpl())));
+    inspector->setSearchThreads(&inspector_thread, &search_thread);
     fprintf(stderr, "V8 inspector is running\n");
-    scoped_ptr<RemoteDebuggingServer> server(new RemoteDebuggingServer(inspector.get()));
+    scoped_ptr<RemoteDebuggingServer> server(new RemoteDebuggingServer(inspector.get(), transport));
+    // Give V8 the gaps between tasks for incremental marking and scavenges.
+    IsolateIdleHeap idle_heap(isolate, platform);
+    IdleGCScheduler idle_gc_scheduler(&idle_heap);
 
     message_loop.task_runner()->PostTask(
         FROM_HERE,
@@ -145,10 +217,34 @@ int main(int argc, char* argv[]) {
     run_loop.Run();
     fprintf(stderr, "Exited main loop\n");
   }
+  if (code_cache) {
+    const CodeCache::Statistics& stats = code_cache->statistics();
+    fprintf(stderr, "Code cache: %d hits, %d misses, %d rejected, %d stored\n",
+            stats.hits, stats.misses, stats.rejected, stats.stored);
+    code_cache = NULL;
+  }
+  platform->UnregisterIsolate(isolate);
   isolate->Dispose();
   v8::V8::Dispose();
   v8::V8::ShutdownPlatform();
+  if (print_background_task_stats) {
+    WorkStealingThreadPool::Statistics pool_stats =
+        platform->background_pool()->GetStatistics();
+    fprintf(stderr, "Background tasks: %d threads, %lld run (%lld stolen), "
+            "%lld long running, max queue depth %d, "
+            "mean wait %.3f ms, max wait %.3f ms\n",
+            platform->background_pool()->num_threads(),
+            static_cast<long long>(pool_stats.tasks_run),
+            static_cast<long long>(pool_stats.tasks_stolen),
+            static_cast<long long>(pool_stats.long_running_tasks_run),
+            pool_stats.max_queue_depth,
+            pool_stats.tasks_run + pool_stats.long_running_tasks_run ?
+                pool_stats.total_queue_time.InMillisecondsF() /
+                    (pool_stats.tasks_run + pool_stats.long_running_tasks_run) : 0,
+            pool_stats.max_queue_time.InMillisecondsF());
+  }
   delete platform;
+  platform = NULL;
   fprintf(stderr, "Deleted platform.\n");
   return result;
 }
@@ -180,6 +276,9 @@ v8::Handle<v8::Context> CreateShellContext(v8::Isolate* isolate) {
   // Bind the 'version' function
   global->Set(v8::String::NewFromUtf8(isolate, "version"),
               v8::FunctionTemplate::New(isolate, Version));
+  // Bind the 'codeCacheStatistics' function
+  global->Set(v8::String::NewFromUtf8(isolate, "codeCacheStatistics"),
+              v8::FunctionTemplate::New(isolate, CodeCacheStatistics));
 
   // Bind the 'quitWhenIdle' function
   global->Set(v8::String::NewFromUtf8(isolate, "quitWhenIdle"),
@@ -247,7 +346,23 @@ void Load(const v8::FunctionCallbackInfo<v8::Value>& args) {
           v8::String::NewFromUtf8(args.GetIsolate(), "Error loading file"));
       return;
     }
-    v8::Handle<v8::String> source = ReadFile(args.GetIsolate(), *file);
+    // load() returns only once the file has run, so the parse cannot overlap
+    // anything here but it still moves off the main thread.
+    scoped_ptr<StreamedScript> streamed_script;
+    if (!code_cache)
+      streamed_script = StreamedScript::Start(args.GetIsolate(), platform, *file);
+    if (streamed_script) {
+      if (!ExecuteStreamedScript(args.GetIsolate(), streamed_script.get(),
+                                 false)) {
+        args.GetIsolate()->ThrowException(v8::String::NewFromUtf8(
+            args.GetIsolate(), "Error executing file"));
+        return;
+      }
+      continue;
+    }
+    std::string cache_key;
+    v8::Handle<v8::String> source =
+        ReadFile(args.GetIsolate(), *file, &cache_key);
     if (source.IsEmpty()) {
       args.GetIsolate()->ThrowException(
            v8::String::NewFromUtf8(args.GetIsolate(), "Error loading file"));
@@ -257,7 +372,8 @@ void Load(const v8::FunctionCallbackInfo<v8::Value>& args) {
                        source,
                        v8::String::NewFromUtf8(args.GetIsolate(), *file),
                        false,
-                       false)) {
+                       false,
+                       cache_key)) {
       args.GetIsolate()->ThrowException(
           v8::String::NewFromUtf8(args.GetIsolate(), "Error executing file"));
       return;
@@ -284,8 +400,40 @@ void Version(const v8::FunctionCallbackInfo<v8::Value>& args) {
 }
 
 
-// Reads a file into a v8 string.
-v8::Handle<v8::String> ReadFile(v8::Isolate* isolate, const char* name) {
+// The callback that is invoked by v8 whenever the JavaScript
+// 'codeCacheStatistics' function is called.  Returns the code cache
+// counters, or undefined if no --code-cache-dir was given.
+void CodeCacheStatistics(const v8::FunctionCallbackInfo<v8::Value>& args) {
+  if (!code_cache) return;
+  v8::Isolate* isolate = args.GetIsolate();
+  const CodeCache::Statistics& stats = code_cache->statistics();
+  v8::Local<v8::Object> result = v8::Object::New(isolate);
+  result->Set(v8::String::NewFromUtf8(isolate, "hits"),
+              v8::Integer::New(isolate, stats.hits));
+  result->Set(v8::String::NewFromUtf8(isolate, "misses"),
+              v8::Integer::New(isolate, stats.misses));
+  result->Set(v8::String::NewFromUtf8(isolate, "rejected"),
+              v8::Integer::New(isolate, stats.rejected));
+  result->Set(v8::String::NewFromUtf8(isolate, "stored"),
+              v8::Integer::New(isolate, stats.stored));
+  args.GetReturnValue().Set(result);
+}
+
+
+// Reads a file into a v8 string. If the code cache is enabled and |cache_key|
+// is given, it receives the key of the file's contents.
+v8::Handle<v8::String> ReadFile(v8::Isolate* isolate, const char* name,
+                                std::string* cache_key) {
+  // Map the file so that large sources can stay outside the V8 heap, and
+  // fall back to reading it for files that cannot be mapped.
+  scoped_ptr<MappedScriptSource> mapped =
+      MappedScriptSource::Create(base::FilePath(name));
+  if (mapped) {
+    if (code_cache && cache_key)
+      *cache_key = CodeCache::KeyFor(mapped->data(), mapped->length());
+    return MappedScriptSource::ToV8String(isolate, mapped.Pass());
+  }
+
   FILE* file = fopen(name, "rb");
   if (file == NULL) return v8::Handle<v8::String>();
 
@@ -303,6 +451,8 @@ v8::Handle<v8::String> ReadFile(v8::Isolate* isolate, const char* name) {
     }
   }
   fclose(file);
+  if (code_cache && cache_key)
+    *cache_key = CodeCache::KeyFor(chars, size);
   v8::Handle<v8::String> result = v8::String::NewFromUtf8(
       isolate, chars, v8::String::kNormalString, static_cast<int>(size));
   delete[] chars;
@@ -310,12 +460,38 @@ v8::Handle<v8::String> ReadFile(v8::Isolate* isolate, const char* name) {
 }
 
 
+// Returns true if argv[i] names a script file for RunMain() to run.
+static bool IsScriptFileArgument(int argc, char* argv[], int i) {
+  const char* str = argv[i];
+  if (strncmp(str, "--", 2) == 0 || strcmp(str, "-f") == 0) return false;
+  if (strcmp(str, "-e") == 0 && i + 1 < argc) return false;
+  return i == 1 || strcmp(argv[i - 1], "-e") != 0;
+}
+
+
 // Process remaining command line arguments and execute files
 int RunMain(v8::Isolate* isolate, int argc, char* argv[]) {
+  // Without the code cache, which needs the whole source before compiling,
+  // all script files are parsed on background threads from the start, so
+  // that the parses overlap each other and the scripts that run first.
+  ScopedVector<StreamedScript> streamed_scripts;
+  streamed_scripts.resize(argc);
+  if (!code_cache) {
+    for (int i = 1; i < argc; i++) {
+      if (IsScriptFileArgument(argc, argv, i))
+        streamed_scripts[i] =
+            StreamedScript::Start(isolate, platform, argv[i]).release();
+    }
+  }
   for (int i = 1; i < argc; i++) {
     const char* str = argv[i];
     if (strcmp(str, "--shell") == 0) {
       run_shell = true;
+    } else if (strncmp(str, kCodeCacheDirFlag, strlen(kCodeCacheDirFlag)) == 0 ||
+               strcmp(str, kBackgroundTaskStatsFlag) == 0 ||
+               RemoteDebuggingTransport::IsSwitch(str)) {
+      // Handled in main().
+      continue;
     } else if (strcmp(str, "-f") == 0) {
       // Ignore any -f flags for compatibility with the other stand-
       // alone JavaScript engines.
@@ -331,14 +507,24 @@ int RunMain(v8::Isolate* isolate, int argc, char* argv[]) {
           v8::String::NewFromUtf8(isolate, argv[++i]);
       if (!ExecuteString(isolate, source, file_name, false, true)) return 1;
     } else {
-      // Use all other arguments as names of files to load and run.
+      // Use all other arguments as names of files to load and run. Files
+      // that could not be mapped for streaming are read instead.
+      if (streamed_scripts[i]) {
+        // Keep serving the remote debugger while the file is parsed.
+        streamed_scripts[i]->RunUntilParsed();
+        if (!ExecuteStreamedScript(isolate, streamed_scripts[i], true))
+          return 1;
+        continue;
+      }
       v8::Handle<v8::String> file_name = v8::String::NewFromUtf8(isolate, str);
-      v8::Handle<v8::String> source = ReadFile(isolate, str);
+      std::string cache_key;
+      v8::Handle<v8::String> source = ReadFile(isolate, str, &cache_key);
       if (source.IsEmpty()) {
         fprintf(stderr, "Error reading '%s'\n", str);
         continue;
       }
-      if (!ExecuteString(isolate, source, file_name, false, true)) return 1;
+      if (!ExecuteString(isolate, source, file_name, false, true, cache_key))
+        return 1;
     }
   }
   return 0;
@@ -369,16 +555,43 @@ void RunShell(v8::Handle<v8::Context> context) {
 }
 
 
+// Compiles a script, consuming the code cache entry for |cache_key| if there
+// is one and producing it otherwise.
+v8::Handle<v8::Script> CompileWithCodeCache(v8::Isolate* isolate,
+                                            v8::Handle<v8::String> source,
+                                            const v8::ScriptOrigin& origin,
+                                            const std::string& cache_key) {
+  v8::ScriptCompiler::CachedData* cached_data = code_cache->Lookup(cache_key);
+  v8::ScriptCompiler::CompileOptions options =
+      cached_data ? v8::ScriptCompiler::kConsumeCodeCache
+                  : v8::ScriptCompiler::kProduceCodeCache;
+  v8::ScriptCompiler::Source script_source(source, origin, cached_data);
+  v8::Handle<v8::Script> script =
+      v8::ScriptCompiler::Compile(isolate, &script_source, options);
+  if (script.IsEmpty()) return script;
+  if (cached_data) {
+    code_cache->DidConsume(cache_key, *script_source.GetCachedData());
+  } else if (script_source.GetCachedData()) {
+    code_cache->Store(cache_key, *script_source.GetCachedData());
+  }
+  return script;
+}
+
+
 // Executes a string within the current v8 context.
 bool ExecuteString(v8::Isolate* isolate,
                    v8::Handle<v8::String> source,
                    v8::Handle<v8::Value> name,
                    bool print_result,
-                   bool report_exceptions) {
+                   bool report_exceptions,
+                   const std::string& cache_key) {
   v8::HandleScope handle_scope(isolate);
   v8::TryCatch try_catch;
   v8::ScriptOrigin origin(name);
-  v8::Handle<v8::Script> script = v8::Script::Compile(source, &origin);
+  v8::Handle<v8::Script> script =
+      code_cache && !cache_key.empty()
+          ? CompileWithCodeCache(isolate, source, origin, cache_key)
+          : v8::Script::Compile(source, &origin);
   if (script.IsEmpty()) {
     // Print errors that happened during compilation.
     if (report_exceptions)
@@ -407,6 +620,28 @@ bool ExecuteString(v8::Isolate* isolate,
 }
 
 
+// Compiles and runs a script whose parse was started with
+// StreamedScript::Start(), waiting for the parse if it has not finished.
+bool ExecuteStreamedScript(v8::Isolate* isolate,
+                           StreamedScript* streamed_script,
+                           bool report_exceptions) {
+  v8::HandleScope handle_scope(isolate);
+  v8::TryCatch try_catch;
+  v8::ScriptOrigin origin(
+      v8::String::NewFromUtf8(isolate, streamed_script->path().c_str()));
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Script> script;
+  v8::Local<v8::Value> result;
+  if (!streamed_script->Compile(context, origin).ToLocal(&script) ||
+      !script->Run(context).ToLocal(&result)) {
+    if (report_exceptions)
+      ReportException(isolate, &try_catch);
+    return false;
+  }
+  return true;
+}
+
+
 void ReportException(v8::Isolate* isolate, v8::TryCatch* try_catch) {
   v8::HandleScope handle_scope(isolate);
   v8::String::Utf8Value exception(try_catch->Exception());
@@ -0,0 +1,283 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/WorkStealingThreadPool.h"
+
+#include "base/strings/stringprintf.h"
+#include "base/sys_info.h"
+#include <algorithm>
+
+namespace v8inspector {
+
+WorkStealingThreadPool::Statistics::Statistics()
+    : tasks_run(0),
+      tasks_stolen(0),
+      long_running_tasks_run(0),
+      queue_depth(0),
+      max_queue_depth(0) {
+}
+
+WorkStealingThreadPool::PendingTask::PendingTask() {
+}
+
+WorkStealingThreadPool::PendingTask::PendingTask(const base::Closure& task)
+    : task(task),
+      posted(base::TimeTicks::Now()) {
+}
+
+WorkStealingThreadPool::PendingTask::~PendingTask() {
+}
+
+// A short task worker and the deque it takes tasks from first.
+class WorkStealingThreadPool::Worker : public base::DelegateSimpleThread::Delegate {
+public:
+    Worker(WorkStealingThreadPool* pool, int index)
+        : pool_(pool),
+          thread_(this, base::StringPrintf("V8 Worker%d", index)) {
+    }
+
+    void Start() { thread_.Start(); }
+    void Join() { thread_.Join(); }
+
+    // base::DelegateSimpleThread::Delegate implementation.
+    void Run() override {
+        pool_->current_worker_.Set(this);
+        // Tasks still queued at shutdown are dropped.
+        while (!base::subtle::Acquire_Load(&pool_->shutting_down_)) {
+            PendingTask task;
+            if (pool_->TakeTask(this, &task)) {
+                pool_->RunTask(this, task, false);
+                continue;
+            }
+            if (!pool_->WaitForWork())
+                return;
+        }
+    }
+
+    // The owner takes the oldest task and thieves the newest, so that they
+    // rarely want the same end.
+    base::Lock lock;
+    std::deque<PendingTask> tasks;
+
+    // Only this worker writes the statistics, but GetStatistics() reads them
+    // on other threads, so both sides take the lock.
+    base::Lock statistics_lock;
+    Statistics statistics;
+
+private:
+    WorkStealingThreadPool* pool_;
+    base::DelegateSimpleThread thread_;
+
+    DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
+class WorkStealingThreadPool::LongRunningThread : public base::DelegateSimpleThread::Delegate {
+public:
+    LongRunningThread(WorkStealingThreadPool* pool, int index)
+        : pool_(pool),
+          thread_(this, base::StringPrintf("V8 LongRunningWorker%d", index)) {
+    }
+
+    void Start() { thread_.Start(); }
+    void Join() { thread_.Join(); }
+
+    // base::DelegateSimpleThread::Delegate implementation.
+    void Run() override {
+        PendingTask task;
+        while (pool_->TakeLongRunningTask(&task))
+            pool_->RunTask(nullptr, task, true);
+    }
+
+private:
+    WorkStealingThreadPool* pool_;
+    base::DelegateSimpleThread thread_;
+
+    DISALLOW_COPY_AND_ASSIGN(LongRunningThread);
+};
+
+WorkStealingThreadPool::WorkStealingThreadPool(int num_threads)
+    : next_worker_(0),
+      pending_tasks_(0),
+      max_pending_tasks_(0),
+      idle_workers_(0),
+      wake_up_(&sleep_lock_),
+      shutting_down_(0),
+      long_running_wake_up_(&long_running_lock_),
+      idle_long_running_threads_(0),
+      long_running_shutting_down_(false) {
+    if (num_threads <= 0)
+        num_threads = base::SysInfo::NumberOfProcessors();
+    num_threads = std::max(num_threads, 1);
+    for (int i = 0; i < num_threads; ++i)
+        workers_.push_back(new Worker(this, i));
+    for (size_t i = 0; i < workers_.size(); ++i)
+        workers_[i]->Start();
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        base::AutoLock lock(sleep_lock_);
+        base::subtle::Release_Store(&shutting_down_, 1);
+        wake_up_.Broadcast();
+    }
+    {
+        base::AutoLock lock(long_running_lock_);
+        long_running_shutting_down_ = true;
+        long_running_wake_up_.Broadcast();
+    }
+    for (size_t i = 0; i < workers_.size(); ++i)
+        workers_[i]->Join();
+    for (size_t i = 0; i < long_running_threads_.size(); ++i)
+        long_running_threads_[i]->Join();
+}
+
+void WorkStealingThreadPool::PostTask(const base::Closure& task) {
+    Worker* worker = WorkerForPost();
+    {
+        base::AutoLock lock(worker->lock);
+        worker->tasks.push_back(PendingTask(task));
+    }
+    base::subtle::Atomic32 pending = base::subtle::Barrier_AtomicIncrement(&pending_tasks_, 1);
+    base::subtle::Atomic32 max_pending = base::subtle::NoBarrier_Load(&max_pending_tasks_);
+    while (pending > max_pending) {
+        base::subtle::Atomic32 previous = base::subtle::NoBarrier_CompareAndSwap(&max_pending_tasks_, max_pending, pending);
+        if (previous == max_pending)
+            break;
+        max_pending = previous;
+    }
+    // Pairs with the check in WaitForWork(): either the waiter sees the task
+    // or this sees the waiter.
+    if (base::subtle::Acquire_Load(&idle_workers_)) {
+        base::AutoLock lock(sleep_lock_);
+        wake_up_.Signal();
+    }
+}
+
+void WorkStealingThreadPool::PostLongRunningTask(const base::Closure& task) {
+    base::AutoLock lock(long_running_lock_);
+    if (long_running_shutting_down_)
+        return;
+    long_running_tasks_.push_back(PendingTask(task));
+    if (long_running_tasks_.size() > static_cast<size_t>(idle_long_running_threads_)) {
+        LongRunningThread* thread = new LongRunningThread(this, static_cast<int>(long_running_threads_.size()));
+        long_running_threads_.push_back(thread);
+        thread->Start();
+        return;
+    }
+    long_running_wake_up_.Signal();
+}
+
+WorkStealingThreadPool::Statistics WorkStealingThreadPool::GetStatistics() {
+    Statistics result;
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        base::AutoLock lock(workers_[i]->statistics_lock);
+        const Statistics& statistics = workers_[i]->statistics;
+        result.tasks_run += statistics.tasks_run;
+        result.tasks_stolen += statistics.tasks_stolen;
+        result.total_queue_time += statistics.total_queue_time;
+        result.max_queue_time = std::max(result.max_queue_time, statistics.max_queue_time);
+    }
+    {
+        base::AutoLock lock(long_running_lock_);
+        result.long_running_tasks_run = long_running_statistics_.long_running_tasks_run;
+        result.total_queue_time += long_running_statistics_.total_queue_time;
+        result.max_queue_time = std::max(result.max_queue_time, long_running_statistics_.max_queue_time);
+    }
+    // Briefly negative while a task is taken before its post is counted.
+    result.queue_depth = std::max(base::subtle::Acquire_Load(&pending_tasks_), 0);
+    result.max_queue_depth = base::subtle::NoBarrier_Load(&max_pending_tasks_);
+    return result;
+}
+
+WorkStealingThreadPool::Worker* WorkStealingThreadPool::WorkerForPost() {
+    // Tasks posted by a task stay on its worker, where their data is warm.
+    if (Worker* worker = current_worker_.Get())
+        return worker;
+    base::subtle::Atomic32 next = base::subtle::NoBarrier_AtomicIncrement(&next_worker_, 1);
+    return workers_[static_cast<uint32>(next) % workers_.size()];
+}
+
+bool WorkStealingThreadPool::TakeTask(Worker* worker, PendingTask* task) {
+    {
+        base::AutoLock lock(worker->lock);
+        if (!worker->tasks.empty()) {
+            *task = worker->tasks.front();
+            worker->tasks.pop_front();
+            base::subtle::Barrier_AtomicIncrement(&pending_tasks_, -1);
+            return true;
+        }
+    }
+    if (!base::subtle::Acquire_Load(&pending_tasks_))
+        return false;
+    size_t start = std::find(workers_.begin(), workers_.end(), worker) - workers_.begin();
+    for (size_t i = 1; i < workers_.size(); ++i) {
+        Worker* victim = workers_[(start + i) % workers_.size()];
+        // A busy deque is skipped rather than waited for.
+        if (!victim->lock.Try())
+            continue;
+        bool stolen = !victim->tasks.empty();
+        if (stolen) {
+            *task = victim->tasks.back();
+            victim->tasks.pop_back();
+        }
+        victim->lock.Release();
+        if (stolen) {
+            base::subtle::Barrier_AtomicIncrement(&pending_tasks_, -1);
+            base::AutoLock lock(worker->statistics_lock);
+            ++worker->statistics.tasks_stolen;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingThreadPool::WaitForWork() {
+    base::AutoLock lock(sleep_lock_);
+    base::subtle::Barrier_AtomicIncrement(&idle_workers_, 1);
+    // A task may sit in a deque that was skipped while locked; the timeout
+    // makes sure it is picked up even if no more tasks are posted.
+    bool shutting_down = base::subtle::NoBarrier_Load(&shutting_down_);
+    if (!shutting_down && !base::subtle::Acquire_Load(&pending_tasks_))
+        wake_up_.Wait();
+    else if (!shutting_down)
+        wake_up_.TimedWait(base::TimeDelta::FromMilliseconds(1));
+    base::subtle::Barrier_AtomicIncrement(&idle_workers_, -1);
+    return !base::subtle::NoBarrier_Load(&shutting_down_);
+}
+
+void WorkStealingThreadPool::RunTask(Worker* worker, const PendingTask& task, bool long_running) {
+    base::TimeDelta queue_time = base::TimeTicks::Now() - task.posted;
+    task.task.Run();
+    if (long_running) {
+        base::AutoLock lock(long_running_lock_);
+        ++long_running_statistics_.long_running_tasks_run;
+        long_running_statistics_.total_queue_time += queue_time;
+        long_running_statistics_.max_queue_time = std::max(long_running_statistics_.max_queue_time, queue_time);
+        return;
+    }
+    base::AutoLock lock(worker->statistics_lock);
+    ++worker->statistics.tasks_run;
+    worker->statistics.total_queue_time += queue_time;
+    worker->statistics.max_queue_time = std::max(worker->statistics.max_queue_time, queue_time);
+}
+
+bool WorkStealingThreadPool::TakeLongRunningTask(PendingTask* task) {
+    base::AutoLock lock(long_running_lock_);
+    while (long_running_tasks_.empty()) {
+        if (long_running_shutting_down_)
+            return false;
+        ++idle_long_running_threads_;
+        long_running_wake_up_.Wait();
+        --idle_long_running_threads_;
+    }
+    if (long_running_shutting_down_)
+        return false;
+    *task = long_running_tasks_.front();
+    long_running_tasks_.pop_front();
+    return true;
+}
+
+}  // namespace v8inspector
@@ -0,0 +1,105 @@
+// Copyright (c) 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef WORK_STEALING_THREAD_POOL_H_
+#define WORK_STEALING_THREAD_POOL_H_
+
+#include "base/atomicops.h"
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/memory/scoped_vector.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/simple_thread.h"
+#include "base/threading/thread_local.h"
+#include "base/time/time.h"
+#include <deque>
+
+namespace v8inspector {
+
+// Thread pool for V8 background tasks. Every worker has its own task deque,
+// and idle workers steal from the others, so that short tasks posted at once
+// by concurrent sweeping, recompilation and streaming parses spread over all
+// cores without meeting on one queue lock. Long running tasks get threads of
+// their own, started on demand and reused, so they cannot hold up short ones.
+class WorkStealingThreadPool {
+public:
+    struct Statistics {
+        Statistics();
+
+        int64 tasks_run;
+        int64 tasks_stolen;
+        int64 long_running_tasks_run;
+        // Short tasks queued and not started yet.
+        int queue_depth;
+        int max_queue_depth;
+        // Time tasks spent queued before they started.
+        base::TimeDelta total_queue_time;
+        base::TimeDelta max_queue_time;
+    };
+
+    // |num_threads| short task workers are started right away; 0 means one
+    // per processor.
+    explicit WorkStealingThreadPool(int num_threads);
+    // Waits for running tasks to finish. Tasks that have not started are
+    // dropped.
+    ~WorkStealingThreadPool();
+
+    // May be called on any thread.
+    void PostTask(const base::Closure& task);
+    void PostLongRunningTask(const base::Closure& task);
+
+    // Whether the calling thread is one of the short task workers.
+    bool IsWorkerThread() { return current_worker_.Get(); }
+
+    Statistics GetStatistics();
+    int num_threads() const { return static_cast<int>(workers_.size()); }
+
+private:
+    struct PendingTask {
+        PendingTask();
+        PendingTask(const base::Closure& task);
+        ~PendingTask();
+
+        base::Closure task;
+        base::TimeTicks posted;
+    };
+    class Worker;
+    class LongRunningThread;
+
+    Worker* WorkerForPost();
+    bool TakeTask(Worker*, PendingTask*);
+    // Blocks until some deque may have a task. Returns false on shutdown.
+    bool WaitForWork();
+    void RunTask(Worker*, const PendingTask&, bool long_running);
+    // Blocks until a long running task is queued. Returns false on shutdown.
+    bool TakeLongRunningTask(PendingTask*);
+
+    ScopedVector<Worker> workers_;
+    base::ThreadLocalPointer<Worker> current_worker_;
+    base::subtle::Atomic32 next_worker_;
+    // Tasks in all deques, and workers waiting for one.
+    base::subtle::Atomic32 pending_tasks_;
+    base::subtle::Atomic32 max_pending_tasks_;
+    base::subtle::Atomic32 idle_workers_;
+
+    base::Lock sleep_lock_;
+    base::ConditionVariable wake_up_;
+    // Written under |sleep_lock_|, also read without it between tasks.
+    base::subtle::Atomic32 shutting_down_;
+
+    base::Lock long_running_lock_;
+    base::ConditionVariable long_running_wake_up_;
+    std::deque<PendingTask> long_running_tasks_;
+    ScopedVector<LongRunningThread> long_running_threads_;
+    int idle_long_running_threads_;
+    bool long_running_shutting_down_;
+    Statistics long_running_statistics_;
+
+    DISALLOW_COPY_AND_ASSIGN(WorkStealingThreadPool);
+};
+
+}  // namespace v8inspector
+
+#endif // WORK_STEALING_THREAD_POOL_H_
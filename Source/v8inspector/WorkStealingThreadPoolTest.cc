@@ -0,0 +1,134 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "v8inspector/WorkStealingThreadPool.h"
+
+#include "base/atomicops.h"
+#include "base/bind.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/platform_thread.h"
+#include <gtest/gtest.h>
+
+namespace v8inspector {
+namespace {
+
+// Counts down and signals |done| when the last task ran.
+class TaskCounter {
+public:
+    explicit TaskCounter(int tasks)
+        : remaining_(tasks)
+        , done_(true, false)
+    {
+    }
+
+    void Run()
+    {
+        if (!base::subtle::Barrier_AtomicIncrement(&remaining_, -1))
+            done_.Signal();
+    }
+
+    bool Wait() { return done_.TimedWait(base::TimeDelta::FromSeconds(10)); }
+
+private:
+    base::subtle::Atomic32 remaining_;
+    base::WaitableEvent done_;
+};
+
+void RunCounter(TaskCounter* counter)
+{
+    counter->Run();
+}
+
+// Posts |tasks| tasks to the current worker, then blocks it until they ran,
+// so every one of them has to be stolen.
+void PostAndBlock(WorkStealingThreadPool* pool, TaskCounter* counter, int tasks)
+{
+    for (int i = 0; i < tasks; ++i)
+        pool->PostTask(base::Bind(&RunCounter, base::Unretained(counter)));
+    counter->Wait();
+}
+
+void SetFlag(base::subtle::Atomic32* flag)
+{
+    base::subtle::Release_Store(flag, 1);
+}
+
+void SignalAndSleep(base::WaitableEvent* started, base::subtle::Atomic32* finished)
+{
+    started->Signal();
+    base::PlatformThread::Sleep(base::TimeDelta::FromMilliseconds(50));
+    base::subtle::Release_Store(finished, 1);
+}
+
+// Statistics are updated right after a task returns, so poll for them.
+WorkStealingThreadPool::Statistics WaitForTasksRun(WorkStealingThreadPool* pool, int64 tasks_run, int64 long_running_tasks_run)
+{
+    WorkStealingThreadPool::Statistics statistics;
+    for (int i = 0; i < 10000; ++i) {
+        statistics = pool->GetStatistics();
+        if (statistics.tasks_run >= tasks_run && statistics.long_running_tasks_run >= long_running_tasks_run)
+            break;
+        base::PlatformThread::Sleep(base::TimeDelta::FromMilliseconds(1));
+    }
+    return statistics;
+}
+
+TEST(WorkStealingThreadPoolTest, StartsRequestedThreads)
+{
+    WorkStealingThreadPool pool(3);
+    EXPECT_EQ(3, pool.num_threads());
+}
+
+TEST(WorkStealingThreadPoolTest, IdleWorkersStealFromBusyOne)
+{
+    const int kTasks = 100;
+    WorkStealingThreadPool pool(4);
+    TaskCounter counter(kTasks);
+    pool.PostTask(base::Bind(&PostAndBlock, base::Unretained(&pool), base::Unretained(&counter), kTasks));
+    ASSERT_TRUE(counter.Wait());
+
+    WorkStealingThreadPool::Statistics statistics = WaitForTasksRun(&pool, kTasks + 1, 0);
+    EXPECT_EQ(kTasks + 1, statistics.tasks_run);
+    EXPECT_EQ(kTasks, statistics.tasks_stolen);
+}
+
+TEST(WorkStealingThreadPoolTest, Statistics)
+{
+    const int kTasks = 20;
+    WorkStealingThreadPool pool(2);
+    TaskCounter counter(kTasks + 1);
+    for (int i = 0; i < kTasks; ++i)
+        pool.PostTask(base::Bind(&RunCounter, base::Unretained(&counter)));
+    pool.PostLongRunningTask(base::Bind(&RunCounter, base::Unretained(&counter)));
+    ASSERT_TRUE(counter.Wait());
+
+    WorkStealingThreadPool::Statistics statistics = WaitForTasksRun(&pool, kTasks, 1);
+    EXPECT_EQ(kTasks, statistics.tasks_run);
+    EXPECT_EQ(1, statistics.long_running_tasks_run);
+    EXPECT_EQ(0, statistics.queue_depth);
+    EXPECT_GE(statistics.max_queue_depth, 1);
+    EXPECT_LE(statistics.max_queue_depth, kTasks);
+    EXPECT_GE(statistics.max_queue_time, base::TimeDelta());
+    EXPECT_GE(statistics.total_queue_time, statistics.max_queue_time);
+}
+
+TEST(WorkStealingThreadPoolTest, ShutdownWaitsForRunningTasksAndDropsQueuedOnes)
+{
+    base::WaitableEvent started(true, false);
+    base::subtle::Atomic32 running_task_finished = 0;
+    base::subtle::Atomic32 queued_task_ran = 0;
+    {
+        WorkStealingThreadPool pool(1);
+        pool.PostTask(base::Bind(&SignalAndSleep, base::Unretained(&started), base::Unretained(&running_task_finished)));
+        pool.PostTask(base::Bind(&SetFlag, base::Unretained(&queued_task_ran)));
+        started.Wait();
+    }
+    EXPECT_EQ(1, base::subtle::Acquire_Load(&running_task_finished));
+    EXPECT_EQ(0, base::subtle::Acquire_Load(&queued_task_ran));
+}
+
+} // namespace
+} // namespace v8inspector
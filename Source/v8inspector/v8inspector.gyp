@@ -17,19 +17,93 @@
                 '../wtf/wtf.gyp:wtf',
                 '../chrome/base/base.gyp:base',
                 '../chrome/v8/tools/gyp/v8.gyp:v8',
-                '../chrome/v8/tools/gyp/v8.gyp:v8_libplatform', # for V8InspectorMain
             ],
             'sources': [
+                'CodeCache.cc',
+                'CodeCache.h',
+                'IdleGCScheduler.cc',
+                'IdleGCScheduler.h',
+                'InspectorPlatform.cc',
+                'InspectorPlatform.h',
+                'InspectorWebThread.cc',
+                'InspectorWebThread.h',
+                'LengthPrefixedServer.cc',
+                'LengthPrefixedServer.h',
+                'MappedScriptSource.cc',
+                'MappedScriptSource.h',
+                'OffThreadResponder.cc',
+                'OffThreadResponder.h',
+                'PendingMessageRing.cc',
+                'PendingMessageRing.h',
+                'ProtocolStatistics.cc',
+                'ProtocolStatistics.h',
                 'RemoteDebuggingServer.cc',
                 'RemoteDebuggingServer.h',
+                'RemoteDebuggingTransport.cc',
+                'RemoteDebuggingTransport.h',
+                'StreamedScript.cc',
+                'StreamedScript.h',
                 'V8InspectorMain.cpp',
                 'V8Inspector.cpp',
                 'V8Inspector.h',
+                'WorkStealingThreadPool.cc',
+                'WorkStealingThreadPool.h',
             ],
             'include_dirs': [
                 '..',  # WebKit/Source
                 '../chrome',  # WebKit/Source/chrome
-                '../chrome/v8', # for include/v8-platform.h in include/libplatform/libplatform.h
+                '../chrome/v8', # for include/v8-platform.h
+                '../..', # for public/platform/WebThread.h
+            ],
+            'defines': [
+                'INSIDE_BLINK',
+            ],
+        },
+
+        {
+            'target_name': 'v8inspector_unittests',
+            'type': 'executable',
+            'dependencies': [
+                'http_server',
+                '../config.gyp:config',
+                '../core/core.gyp:webcore_v8inspector',
+                '../wtf/wtf.gyp:wtf',
+                '../chrome/base/base.gyp:base',
+                '../chrome/testing/gtest.gyp:gtest',
+                '../chrome/testing/gtest.gyp:gtest_main',
+                '../chrome/v8/tools/gyp/v8.gyp:v8',
+            ],
+            'sources': [
+                'CodeCache.cc',
+                'CodeCache.h',
+                'CodeCacheTest.cc',
+                'IdleGCScheduler.cc',
+                'IdleGCScheduler.h',
+                'IdleGCSchedulerTest.cc',
+                'LengthPrefixedServer.cc',
+                'LengthPrefixedServer.h',
+                'LengthPrefixedServerTest.cc',
+                'OffThreadResponder.cc',
+                'OffThreadResponder.h',
+                'OffThreadResponderTest.cc',
+                'PendingMessageRing.cc',
+                'PendingMessageRing.h',
+                'PendingMessageRingTest.cc',
+                'ProtocolStatistics.cc',
+                'ProtocolStatistics.h',
+                'ProtocolStatisticsTest.cc',
+                'RemoteDebuggingTransport.cc',
+                'RemoteDebuggingTransport.h',
+                'RemoteDebuggingTransportTest.cc',
+                'WorkStealingThreadPool.cc',
+                'WorkStealingThreadPool.h',
+                'WorkStealingThreadPoolTest.cc',
+            ],
+            'include_dirs': [
+                '..',  # WebKit/Source
+                '../chrome',  # WebKit/Source/chrome
+                '../chrome/v8', # for include/v8.h
+                '../..', # for public/platform/WebThread.h
             ],
             'defines': [
                 'INSIDE_BLINK',
@@ -55,6 +129,8 @@
             '../chrome/net/server/http_server_response_info.h',
             '../chrome/net/server/web_socket.cc',
             '../chrome/net/server/web_socket.h',
+            '../chrome/net/server/web_socket_adaptive_deflate_predictor.cc',
+            '../chrome/net/server/web_socket_adaptive_deflate_predictor.h',
             '../chrome/net/server/web_socket_encoder.cc',
             '../chrome/net/server/web_socket_encoder.h',
 
@@ -67,6 +143,10 @@
             '../chrome/net/socket/tcp_socket.h',
             '../chrome/net/socket/tcp_socket_libevent.cc',
             '../chrome/net/socket/tcp_socket_libevent.h',
+            '../chrome/net/socket/unix_domain_client_socket_posix.cc',
+            '../chrome/net/socket/unix_domain_client_socket_posix.h',
+            '../chrome/net/socket/unix_domain_server_socket_posix.cc',
+            '../chrome/net/socket/unix_domain_server_socket_posix.h',
 
             '../chrome/net/websockets/websocket_deflater.cc',
             '../chrome/net/websockets/websocket_deflater.h',
@@ -76,6 +156,8 @@
             '../chrome/net/websockets/websocket_extension.h',
             '../chrome/net/websockets/websocket_extension_parser.cc',
             '../chrome/net/websockets/websocket_extension_parser.h',
+            '../chrome/net/websockets/websocket_frame.cc',
+            '../chrome/net/websockets/websocket_frame.h',
 
 
             '../chrome/net/base/address_list.cc',
@@ -0,0 +1,42 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef WebTraceLocation_h
+#define WebTraceLocation_h
+
+#include "WebCommon.h"
+
+namespace blink {
+
+// Where a posted task comes from; see base/location.h in Chromium, of which
+// this keeps the parts Blink uses.
+class BLINK_PLATFORM_EXPORT WebTraceLocation {
+public:
+    // The strings are not copied and must live as long as the program.
+    WebTraceLocation(const char* functionName, const char* fileName)
+        : m_functionName(functionName)
+        , m_fileName(fileName)
+    {
+    }
+
+    WebTraceLocation()
+        : m_functionName("unknown")
+        , m_fileName("unknown")
+    {
+    }
+
+    const char* functionName() const { return m_functionName; }
+    const char* fileName() const { return m_fileName; }
+
+private:
+    const char* m_functionName;
+    const char* m_fileName;
+};
+
+} // namespace blink
+
+// Not FROM_HERE, so that embedders may include this next to base/location.h.
+#define BLINK_FROM_HERE ::blink::WebTraceLocation(__FUNCTION__, __FILE__)
+
+#endif // WebTraceLocation_h